@@ -148,6 +148,9 @@ public:
         /// The full path to the root directory for the shader cache. An empty string will disable the cache.
         std::string shaderCachePath = (getRuntimeDirectory() / ".shadercache").string();
 
+        /// The maximum size in bytes of the persistent kernel cache stored in the shader cache directory. A value of 0 indicates no limit.
+        uint64_t maxKernelCacheSize = 1ull << 30;
+
 #if FALCOR_HAS_D3D12
         /// GUID list for experimental features
         std::vector<GUID> experimentalFeatures;
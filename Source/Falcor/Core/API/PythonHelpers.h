@@ -32,6 +32,8 @@
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Scripting/ndarray.h"
 
+#include <fstd/span.h>
+
 #include <optional>
 
 namespace Falcor
@@ -75,6 +77,26 @@ size_t isNdarrayContiguous(const pybind11::ndarray<Args...>& array)
     return true;
 }
 
+/// Contiguous CPU array of N-component vectors (shape [count, N]), used for passing bulk data from Python.
+template<typename T, size_t N>
+using NdarrayVectors = pybind11::ndarray<T, pybind11::shape<pybind11::any, N>, pybind11::c_contig, pybind11::device::cpu>;
+
+/// Contiguous CPU array of scalars of any shape.
+template<typename T>
+using NdarrayScalars = pybind11::ndarray<T, pybind11::c_contig, pybind11::device::cpu>;
+
+/**
+ * Reinterpret a contiguous CPU ndarray as a span of elements of type T without copying.
+ * The span is only valid as long as the ndarray is alive.
+ */
+template<typename T, typename... Args>
+fstd::span<const T> ndarrayToSpan(const pybind11::ndarray<Args...>& array)
+{
+    size_t byteSize = getNdarrayByteSize(array);
+    FALCOR_CHECK(byteSize % sizeof(T) == 0, "Array size ({} bytes) is not a multiple of the element size ({} bytes)", byteSize, sizeof(T));
+    return fstd::span<const T>(reinterpret_cast<const T*>(array.data()), byteSize / sizeof(T));
+}
+
 pybind11::dlpack::dtype dataTypeToDtype(DataType type);
 std::optional<pybind11::dlpack::dtype> resourceFormatToDtype(ResourceFormat format);
 
@@ -26,7 +26,9 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "Utils/Math/FNVHash.h"
 
+#include <cstdint>
 #include <initializer_list>
 #include <map>
 #include <string>
@@ -80,6 +82,39 @@ public:
         return *this;
     }
 
+    /**
+     * Compute the hash of a single macro definition.
+     * @param[in] name The name of macro.
+     * @param[in] value The value of the macro.
+     * @return The 64-bit hash.
+     */
+    static uint64_t hashDefine(const std::string& name, const std::string& value)
+    {
+        FNVHash64 hash;
+        hash.insert(name.data(), name.size());
+        hash.insert(uint8_t(0));
+        hash.insert(value.data(), value.size());
+        // Finalize with a bit mixer, as the hashes of the definitions are summed up.
+        uint64_t h = hash.get();
+        h = (h ^ (h >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+        h = (h ^ (h >> 27)) * UINT64_C(0x94d049bb133111eb);
+        return h ^ (h >> 31);
+    }
+
+    /**
+     * Compute the hash of the list.
+     * The hash is the sum of the hashes of all definitions (see hashDefine()). It does not depend on the order
+     * of the definitions and can be updated incrementally when definitions are added, changed or removed.
+     * @return The 64-bit hash.
+     */
+    uint64_t getHash() const
+    {
+        uint64_t hash = 0;
+        for (const auto& [name, value] : *this)
+            hash += hashDefine(name, value);
+        return hash;
+    }
+
     DefineList() = default;
     DefineList(std::initializer_list<std::pair<const std::string, std::string>> il) : std::map<std::string, std::string>(il) {}
 };
@@ -61,6 +61,9 @@ Program::Program(ref<Device> pDevice, ProgramDesc desc, DefineList defineList)
 {
     mDesc.finalize();
 
+    mDefineListHash = mDefineList.getHash();
+    mTypeConformanceListHash = mTypeConformanceList.getHash();
+
     // If not shader model was requested, use the default shader model for the device.
     if (mDesc.shaderModel == ShaderModel::Unknown)
         mDesc.shaderModel = mpDevice->getDefaultShaderModel();
@@ -86,9 +89,12 @@ Program::~Program()
 {
     mpDevice->getProgramManager()->unregisterProgramForReload(this);
 
-    // Invalidate program versions.
+    // Invalidate program versions. Versions shared with other programs keep their own program alive.
     for (auto& version : mProgramVersions)
-        version.second->mpProgram = nullptr;
+    {
+        if (version.second.pVersion->mpProgram == this)
+            version.second.pVersion->mpProgram = nullptr;
+    }
 }
 
 void Program::validateEntryPoints() const
@@ -151,23 +157,30 @@ std::string Program::getProgramDescString() const
 bool Program::addDefine(const std::string& name, const std::string& value)
 {
     // Make sure that it doesn't exist already
-    if (mDefineList.find(name) != mDefineList.end())
+    auto it = mDefineList.find(name);
+    if (it != mDefineList.end())
     {
-        if (mDefineList[name] == value)
+        if (it->second == value)
         {
             // Same define
             return false;
         }
+        mDefineListHash -= DefineList::hashDefine(name, it->second);
+        it->second = value;
+    }
+    else
+    {
+        mDefineList.emplace(name, value);
     }
+    mDefineListHash += DefineList::hashDefine(name, value);
     markDirty();
-    mDefineList[name] = value;
     return true;
 }
 
 bool Program::addDefines(const DefineList& dl)
 {
     bool dirty = false;
-    for (auto it : dl)
+    for (const auto& it : dl)
     {
         if (addDefine(it.first, it.second))
         {
@@ -179,10 +192,12 @@ bool Program::addDefines(const DefineList& dl)
 
 bool Program::removeDefine(const std::string& name)
 {
-    if (mDefineList.find(name) != mDefineList.end())
+    auto it = mDefineList.find(name);
+    if (it != mDefineList.end())
     {
         markDirty();
-        mDefineList.erase(name);
+        mDefineListHash -= DefineList::hashDefine(it->first, it->second);
+        mDefineList.erase(it);
         return true;
     }
     return false;
@@ -191,7 +206,7 @@ bool Program::removeDefine(const std::string& name)
 bool Program::removeDefines(const DefineList& dl)
 {
     bool dirty = false;
-    for (auto it : dl)
+    for (const auto& it : dl)
     {
         if (removeDefine(it.first))
         {
@@ -209,6 +224,7 @@ bool Program::removeDefines(size_t pos, size_t len, const std::string& str)
         if (pos < it->first.length() && it->first.compare(pos, len, str) == 0)
         {
             markDirty();
+            mDefineListHash -= DefineList::hashDefine(it->first, it->second);
             it = mDefineList.erase(it);
             dirty = true;
         }
@@ -226,6 +242,7 @@ bool Program::setDefines(const DefineList& dl)
     {
         markDirty();
         mDefineList = dl;
+        mDefineListHash = mDefineList.getHash();
         return true;
     }
     return false;
@@ -238,6 +255,7 @@ bool Program::addTypeConformance(const std::string& typeName, const std::string
     {
         markDirty();
         mTypeConformanceList.add(typeName, interfaceType, id);
+        mTypeConformanceListHash = mTypeConformanceList.getHash();
         return true;
     }
     return false;
@@ -250,6 +268,7 @@ bool Program::removeTypeConformance(const std::string& typeName, const std::stri
     {
         markDirty();
         mTypeConformanceList.remove(typeName, interfaceType);
+        mTypeConformanceListHash = mTypeConformanceList.getHash();
         return true;
     }
     return false;
@@ -261,6 +280,7 @@ bool Program::setTypeConformances(const TypeConformanceList& conformances)
     {
         markDirty();
         mTypeConformanceList = conformances;
+        mTypeConformanceListHash = mTypeConformanceList.getHash();
         return true;
     }
     return false;
@@ -292,8 +312,8 @@ const ref<const ProgramVersion>& Program::getActiveVersion() const
 {
     if (mLinkRequired)
     {
-        const auto& it = mProgramVersions.find(ProgramVersionKey{mDefineList, mTypeConformanceList});
-        if (it == mProgramVersions.end())
+        const ref<const ProgramVersion>* ppVersion = findProgramVersion();
+        if (ppVersion == nullptr)
         {
             // Note that link() updates mActiveProgram only if the operation was successful.
             // On error we get false, and mActiveProgram points to the last successfully compiled version.
@@ -303,12 +323,12 @@ const ref<const ProgramVersion>& Program::getActiveVersion() const
             }
             else
             {
-                mProgramVersions[ProgramVersionKey{mDefineList, mTypeConformanceList}] = mpActiveVersion;
+                addProgramVersion(mpActiveVersion);
             }
         }
         else
         {
-            mpActiveVersion = it->second;
+            mpActiveVersion = *ppVersion;
         }
         mLinkRequired = false;
     }
@@ -316,6 +336,33 @@ const ref<const ProgramVersion>& Program::getActiveVersion() const
     return mpActiveVersion;
 }
 
+const ref<const ProgramVersion>* Program::findProgramVersion() const
+{
+    auto [begin, end] = mProgramVersions.equal_range(getProgramVersionHash());
+    for (auto it = begin; it != end; ++it)
+    {
+        const ProgramVersionEntry& entry = it->second;
+        if (entry.defineList == mDefineList && entry.typeConformanceList == mTypeConformanceList)
+            return &entry.pVersion;
+    }
+    return nullptr;
+}
+
+void Program::addProgramVersion(const ref<const ProgramVersion>& pVersion) const
+{
+    auto [begin, end] = mProgramVersions.equal_range(getProgramVersionHash());
+    for (auto it = begin; it != end; ++it)
+    {
+        ProgramVersionEntry& entry = it->second;
+        if (entry.defineList == mDefineList && entry.typeConformanceList == mTypeConformanceList)
+        {
+            entry.pVersion = pVersion;
+            return;
+        }
+    }
+    mProgramVersions.emplace(getProgramVersionHash(), ProgramVersionEntry{mDefineList, mTypeConformanceList, pVersion});
+}
+
 bool Program::link() const
 {
     while (1)
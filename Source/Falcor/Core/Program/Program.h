@@ -126,6 +126,24 @@ public:
         return *this;
     }
 
+    /**
+     * Compute the hash of the list.
+     * @return The 64-bit hash.
+     */
+    uint64_t getHash() const
+    {
+        FNVHash64 hash;
+        for (const auto& [conformance, id] : *this)
+        {
+            hash.insert(conformance.typeName.data(), conformance.typeName.size());
+            hash.insert(uint8_t(0));
+            hash.insert(conformance.interfaceName.data(), conformance.interfaceName.size());
+            hash.insert(uint8_t(0));
+            hash.insert(id);
+        }
+        return hash.get();
+    }
+
     TypeConformanceList() = default;
     TypeConformanceList(std::initializer_list<std::pair<const TypeConformance, uint32_t>> il) : std::map<TypeConformance, uint32_t>(il) {}
 };
@@ -773,21 +791,28 @@ protected:
 
     DefineList mDefineList;
     TypeConformanceList mTypeConformanceList;
+    uint64_t mDefineListHash = 0;          ///< Hash of mDefineList, updated incrementally (see DefineList::getHash()).
+    uint64_t mTypeConformanceListHash = 0; ///< Hash of mTypeConformanceList.
 
-    struct ProgramVersionKey
+    struct ProgramVersionEntry
     {
         DefineList defineList;
         TypeConformanceList typeConformanceList;
-
-        bool operator<(const ProgramVersionKey& rhs) const
-        {
-            return std::tie(defineList, typeConformanceList) < std::tie(rhs.defineList, rhs.typeConformanceList);
-        }
+        ref<const ProgramVersion> pVersion;
     };
 
+    uint64_t getProgramVersionHash() const { return mDefineListHash ^ (mTypeConformanceListHash * UINT64_C(0x9e3779b97f4a7c15)); }
+
+    /// Find the program version for the current defines and type conformances. Returns nullptr if there is none.
+    const ref<const ProgramVersion>* findProgramVersion() const;
+
+    /// Register the program version for the current defines and type conformances.
+    void addProgramVersion(const ref<const ProgramVersion>& pVersion) const;
+
     // We are doing lazy compilation, so these are mutable
     mutable bool mLinkRequired = true;
-    mutable std::map<ProgramVersionKey, ref<const ProgramVersion>> mProgramVersions;
+    /// Program versions by hash of the defines and type conformances. Lists are only compared on hash matches.
+    mutable std::unordered_multimap<uint64_t, ProgramVersionEntry> mProgramVersions;
     mutable ref<const ProgramVersion> mpActiveVersion;
     void markDirty() { mLinkRequired = true; }
 
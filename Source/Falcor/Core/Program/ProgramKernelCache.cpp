@@ -0,0 +1,284 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ProgramKernelCache.h"
+#include "Utils/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const char kEntryExtension[] = ".kernel";
+const char kTempExtension[] = ".tmp";
+const char kLockFileName[] = ".lock";
+
+const char kEntryMagic[4] = {'F', 'K', 'C', 'E'};
+const uint32_t kEntryVersion = 1;
+
+struct EntryHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t size;              ///< Size of the entry data in bytes.
+    ProgramKernelCache::Key key;
+    SHA1::MD checksum;          ///< SHA-1 hash of the entry data.
+};
+
+// When evicting, remove entries until the cache is below this fraction of the size limit,
+// so that eviction does not run on every write once the cache is full.
+const double kEvictionTargetFraction = 0.9;
+
+// Temporary files older than this are left over from crashed processes and are removed.
+const auto kStaleTempFileAge = std::chrono::hours(1);
+
+bool readEntry(const std::filesystem::path& path, const ProgramKernelCache::Key& key, std::vector<uint8_t>& data)
+{
+    std::ifstream ifs(path, std::ios_base::in | std::ios_base::binary);
+    if (!ifs.good())
+        return false;
+
+    EntryHeader header;
+    ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!ifs.good() || std::memcmp(header.magic, kEntryMagic, sizeof(kEntryMagic)) != 0 || header.version != kEntryVersion ||
+        header.key != key)
+        return false;
+
+    data.resize(header.size);
+    ifs.read(reinterpret_cast<char*>(data.data()), header.size);
+    if (!ifs.good() || ifs.peek() != std::ifstream::traits_type::eof())
+        return false;
+
+    return SHA1::compute(data.data(), data.size()) == header.checksum;
+}
+} // namespace
+
+ProgramKernelCache::ProgramKernelCache(const std::filesystem::path& directory, uint64_t maxSize) : mDirectory(directory), mMaxSize(maxSize)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(mDirectory, ec);
+    if (!mLockFile.open(mDirectory / kLockFileName))
+        logWarning("Failed to open kernel cache lock file in '{}'. The kernel cache is not safe to share between processes.", mDirectory);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mLockFile.isOpen())
+        mLockFile.lock(LockFile::LockType::Exclusive);
+    evict();
+    if (mLockFile.isOpen())
+        mLockFile.unlock();
+}
+
+bool ProgramKernelCache::get(const Key& key, std::vector<uint8_t>& data)
+{
+    const auto path = getEntryPath(key);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mLockFile.isOpen())
+        mLockFile.lock(LockFile::LockType::Shared);
+
+    std::error_code ec;
+    bool exists = std::filesystem::exists(path, ec);
+    bool valid = exists && readEntry(path, key, data);
+    if (valid)
+    {
+        // Mark the entry as recently used.
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    }
+
+    if (mLockFile.isOpen())
+        mLockFile.unlock();
+
+    if (exists && !valid)
+    {
+        // Remove the corrupted entry. Another process may have replaced it in the meantime, which is harmless.
+        if (mLockFile.isOpen())
+            mLockFile.lock(LockFile::LockType::Exclusive);
+        std::filesystem::remove(path, ec);
+        if (mLockFile.isOpen())
+            mLockFile.unlock();
+        logWarning("Discarded corrupted kernel cache entry '{}'.", path);
+        mStats.corruptCount++;
+    }
+
+    if (valid)
+    {
+        mStats.hitCount++;
+        return true;
+    }
+    data.clear();
+    mStats.missCount++;
+    return false;
+}
+
+void ProgramKernelCache::set(const Key& key, const void* data, size_t size)
+{
+    const auto path = getEntryPath(key);
+
+    // Write the entry to a uniquely named temporary file first.
+    std::random_device rd;
+    auto tmpPath = path;
+    tmpPath += fmt::format(".{:08x}{}", rd(), kTempExtension);
+
+    EntryHeader header;
+    std::memcpy(header.magic, kEntryMagic, sizeof(kEntryMagic));
+    header.version = kEntryVersion;
+    header.size = size;
+    header.key = key;
+    header.checksum = SHA1::compute(data, size);
+
+    std::error_code ec;
+    {
+        std::ofstream ofs(tmpPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ofs.write(reinterpret_cast<const char*>(data), size);
+        if (!ofs.good())
+        {
+            ofs.close();
+            std::filesystem::remove(tmpPath, ec);
+            logWarning("Failed to write kernel cache entry '{}'.", path);
+            return;
+        }
+    }
+
+    // Move the entry into place. This replaces an existing entry atomically.
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mLockFile.isOpen())
+        mLockFile.lock(LockFile::LockType::Exclusive);
+
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmpPath, ec);
+        logWarning("Failed to write kernel cache entry '{}'.", path);
+    }
+    else
+    {
+        mStats.writeCount++;
+        mSize += sizeof(header) + size;
+        if (mMaxSize > 0 && mSize > mMaxSize)
+            evict();
+    }
+
+    if (mLockFile.isOpen())
+        mLockFile.unlock();
+}
+
+void ProgramKernelCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mLockFile.isOpen())
+        mLockFile.lock(LockFile::LockType::Exclusive);
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(mDirectory, ec))
+    {
+        if (entry.path().extension() == kEntryExtension)
+            std::filesystem::remove(entry.path(), ec);
+    }
+    mSize = 0;
+
+    if (mLockFile.isOpen())
+        mLockFile.unlock();
+}
+
+ProgramKernelCache::Stats ProgramKernelCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void ProgramKernelCache::resetStats()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats = {};
+}
+
+std::filesystem::path ProgramKernelCache::getEntryPath(const Key& key) const
+{
+    return mDirectory / (SHA1::toString(key) + kEntryExtension);
+}
+
+void ProgramKernelCache::evict()
+{
+    // Called with the lock held. Rescan the directory, as other processes may have added or removed entries.
+    struct Entry
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type time;
+        uint64_t size;
+    };
+    std::vector<Entry> entries;
+    uint64_t totalSize = 0;
+
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::error_code ec;
+    for (const auto& dirEntry : std::filesystem::directory_iterator(mDirectory, ec))
+    {
+        const auto& path = dirEntry.path();
+        auto time = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            continue;
+        if (path.extension() == kTempExtension)
+        {
+            if (now - time > kStaleTempFileAge)
+                std::filesystem::remove(path, ec);
+            continue;
+        }
+        if (path.extension() != kEntryExtension)
+            continue;
+        uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec)
+            continue;
+        entries.push_back({path, time, size});
+        totalSize += size;
+    }
+
+    if (mMaxSize > 0 && totalSize > mMaxSize)
+    {
+        // Remove least recently used entries first.
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+        const uint64_t targetSize = uint64_t(mMaxSize * kEvictionTargetFraction);
+        for (const auto& entry : entries)
+        {
+            if (totalSize <= targetSize)
+                break;
+            if (std::filesystem::remove(entry.path, ec))
+            {
+                totalSize -= entry.size;
+                mStats.evictionCount++;
+            }
+        }
+    }
+
+    mSize = totalSize;
+}
+
+} // namespace Falcor
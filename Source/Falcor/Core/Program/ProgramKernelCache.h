@@ -0,0 +1,110 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Platform/LockFile.h"
+#include "Utils/CryptoUtils.h"
+
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Persistent on-disk cache for compiled shader kernels.
+ *
+ * Each entry is stored as a separate file named after its key. Entries contain a checksum
+ * of their data, so truncated or otherwise corrupted files are detected and discarded.
+ * New entries are written to a temporary file and moved into place while holding a lock file,
+ * which makes the cache safe to share between threads and processes.
+ *
+ * The total size of the cache directory is bounded. When the limit is exceeded, the least recently
+ * used entries are evicted. Entries are marked as used by updating their file modification time.
+ */
+class FALCOR_API ProgramKernelCache
+{
+public:
+    using Key = SHA1::MD;
+
+    struct Stats
+    {
+        size_t hitCount = 0;      ///< Number of lookups that found a valid entry.
+        size_t missCount = 0;     ///< Number of lookups that found no valid entry.
+        size_t writeCount = 0;    ///< Number of entries written.
+        size_t evictionCount = 0; ///< Number of entries evicted to stay within the size limit.
+        size_t corruptCount = 0;  ///< Number of corrupted entries that were discarded.
+    };
+
+    /**
+     * Create a cache in the given directory. The directory is created if it doesn't exist.
+     * @param[in] directory Cache directory.
+     * @param[in] maxSize Maximum total size of all entries in bytes. A value of 0 indicates no limit.
+     */
+    ProgramKernelCache(const std::filesystem::path& directory, uint64_t maxSize);
+
+    /**
+     * Look up an entry.
+     * @param[in] key Entry key.
+     * @param[out] data Entry data if found.
+     * @return True if a valid entry was found.
+     */
+    bool get(const Key& key, std::vector<uint8_t>& data);
+
+    /**
+     * Add or replace an entry. Evicts least recently used entries if the cache exceeds its size limit.
+     * @param[in] key Entry key.
+     * @param[in] data Entry data.
+     * @param[in] size Entry data size in bytes.
+     */
+    void set(const Key& key, const void* data, size_t size);
+
+    /// Remove all entries.
+    void clear();
+
+    const std::filesystem::path& getDirectory() const { return mDirectory; }
+    uint64_t getMaxSize() const { return mMaxSize; }
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    std::filesystem::path getEntryPath(const Key& key) const;
+    void evict();
+
+    std::filesystem::path mDirectory;
+    uint64_t mMaxSize;
+    uint64_t mSize = 0; ///< Estimated total size of all entries. Updated when scanning the directory.
+
+    mutable std::mutex mMutex; ///< Serializes use of the lock file within this process.
+    LockFile mLockFile;        ///< Lock file serializing modifications of the cache directory between processes.
+    Stats mStats;
+};
+
+} // namespace Falcor
@@ -33,6 +33,9 @@
 
 #include <slang.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace Falcor
 {
 
@@ -75,6 +78,66 @@ inline std::string getSlangProfileString(ShaderModel shaderModel)
     return fmt::format("sm_{}_{}", getShaderModelMajorVersion(shaderModel), getShaderModelMinorVersion(shaderModel));
 }
 
+inline void updateString(SHA1& sha1, std::string_view str)
+{
+    // Strings are terminated so that adjacent fields can't alias each other.
+    sha1.update(str);
+    sha1.update(uint8_t(0));
+}
+
+inline void updateTypeConformances(SHA1& sha1, const TypeConformanceList& typeConformances)
+{
+    for (const auto& [conformance, id] : typeConformances)
+    {
+        updateString(sha1, conformance.typeName);
+        updateString(sha1, conformance.interfaceName);
+        sha1.update(id);
+    }
+}
+
+/// Compute a hash identifying a compile request, used to deduplicate in-flight requests.
+inline SHA1::MD computeCompileRequestKey(const ProgramDesc& desc, const DefineList& defineList)
+{
+    SHA1 sha1;
+    for (const auto& module : desc.shaderModules)
+    {
+        updateString(sha1, module.name);
+        for (const auto& source : module.sources)
+        {
+            sha1.update(source.type);
+            updateString(sha1, source.path.string());
+            updateString(sha1, source.string);
+        }
+    }
+    for (const auto& group : desc.entryPointGroups)
+    {
+        sha1.update(group.shaderModuleIndex);
+        updateTypeConformances(sha1, group.typeConformances);
+        for (const auto& entryPoint : group.entryPoints)
+        {
+            sha1.update(entryPoint.type);
+            updateString(sha1, entryPoint.name);
+            updateString(sha1, entryPoint.exportName);
+        }
+    }
+    updateTypeConformances(sha1, desc.typeConformances);
+    sha1.update(desc.shaderModel);
+    sha1.update(desc.compilerFlags);
+    for (const auto& arg : desc.compilerArguments)
+        updateString(sha1, arg);
+    sha1.update(desc.maxTraceRecursionDepth);
+    sha1.update(desc.maxPayloadSize);
+    sha1.update(desc.maxAttributeSize);
+    sha1.update(desc.rtPipelineFlags);
+    sha1.update(desc.useSPIRVBackend);
+    for (const auto& [name, value] : defineList)
+    {
+        updateString(sha1, name);
+        updateString(sha1, value);
+    }
+    return sha1.finalize();
+}
+
 inline bool doSlangReflection(
     const ProgramVersion& programVersion,
     slang::IComponentType* pSlangGlobalScope,
@@ -114,6 +177,39 @@ ProgramManager::ProgramManager(Device* pDevice) : mpDevice(pDevice)
 
     addGlobalDefines(globalDefines);
 
+    // Create the persistent kernel cache next to the GFX shader cache.
+    const auto& desc = mpDevice->getDesc();
+    if (!desc.shaderCachePath.empty())
+    {
+        try
+        {
+            mpKernelCache = std::make_shared<ProgramKernelCache>(std::filesystem::path(desc.shaderCachePath) / "kernels", desc.maxKernelCacheSize);
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("Failed to create kernel cache, continuing without it: {}", e.what());
+        }
+    }
+}
+
+const ProgramManager::CompilationStats& ProgramManager::getCompilationStats()
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    if (mpKernelCache)
+    {
+        auto cacheStats = mpKernelCache->getStats();
+        mCompilationStats.kernelCacheHitCount = cacheStats.hitCount;
+        mCompilationStats.kernelCacheMissCount = cacheStats.missCount;
+    }
+    return mCompilationStats;
+}
+
+void ProgramManager::resetCompilationStats()
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mCompilationStats = {};
+    if (mpKernelCache)
+        mpKernelCache->resetStats();
 }
 
 ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& program, std::string& log) const
@@ -205,13 +301,16 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     }
 
     auto descStr = program.getProgramDescString();
-    pVersion->init(program.getDefineList(), pReflector, descStr, pSlangEntryPoints);
+    pVersion->init(program.getDefineList(), pReflector, descStr, pSlangEntryPoints, computeKernelCacheKey(program));
 
     timer.update();
     double time = timer.delta();
-    mCompilationStats.programVersionCount++;
-    mCompilationStats.programVersionTotalTime += time;
-    mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        mCompilationStats.programVersionCount++;
+        mCompilationStats.programVersionTotalTime += time;
+        mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
+    }
     logDebug("Created program version in {:.3f} s: {}", timer.delta(), descStr);
 
     return pVersion;
@@ -220,10 +319,17 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
 ref<const ProgramKernels> ProgramManager::createProgramKernels(
     const Program& program,
     const ProgramVersion& programVersion,
-    const ProgramVars& programVars,
+    const ProgramVars* pProgramVars,
     std::string& log
 ) const
 {
+    // A shared version's Slang session belongs to the global session of the worker that compiled it,
+    // which may be compiling another program right now. Lock the session before the link step.
+    std::unique_lock<std::mutex> sessionLock;
+    if (programVersion.mpSlangSessionMutex)
+        sessionLock = std::unique_lock<std::mutex>(*programVersion.mpSlangSessionMutex);
+    std::lock_guard<std::mutex> linkLock(mLinkMutex);
+
     CpuTimer timer;
     timer.update();
 
@@ -444,13 +550,31 @@ ref<const ProgramKernels> ProgramManager::createProgramKernels(
     doSlangReflection(programVersion, pSpecializedSlangProgram, pLinkedEntryPoints, pReflector, log);
 
     // Create kernel objects for each entry point and cache them here.
+    // The kernel cache key of each entry point extends the program version key with the
+    // type conformances of its group and the entry point itself.
     std::vector<ref<EntryPointKernel>> allKernels;
-    for (const auto& entryPointGroup : program.mDesc.entryPointGroups)
+    for (size_t groupIndex = 0; groupIndex < program.mDesc.entryPointGroups.size(); ++groupIndex)
     {
+        const auto& entryPointGroup = program.mDesc.entryPointGroups[groupIndex];
         for (const auto& entryPoint : entryPointGroup.entryPoints)
         {
             auto pLinkedEntryPoint = pLinkedEntryPoints[entryPoint.globalIndex];
-            ref<EntryPointKernel> kernel = EntryPointKernel::create(pLinkedEntryPoint, entryPoint.type, entryPoint.exportName);
+            ref<EntryPointKernel> kernel;
+            if (mpKernelCache)
+            {
+                SHA1 sha1;
+                sha1.update(programVersion.getKernelCacheKey().data(), programVersion.getKernelCacheKey().size());
+                sha1.update((uint64_t)groupIndex);
+                updateTypeConformances(sha1, entryPointGroup.typeConformances);
+                updateString(sha1, entryPoint.name);
+                updateString(sha1, entryPoint.exportName);
+                sha1.update(entryPoint.type);
+                kernel = EntryPointKernel::create(pLinkedEntryPoint, entryPoint.type, entryPoint.exportName, mpKernelCache, sha1.finalize());
+            }
+            else
+            {
+                kernel = EntryPointKernel::create(pLinkedEntryPoint, entryPoint.type, entryPoint.exportName);
+            }
             if (!kernel)
                 return nullptr;
 
@@ -500,9 +624,12 @@ ref<const ProgramKernels> ProgramManager::createProgramKernels(
 
     timer.update();
     double time = timer.delta();
-    mCompilationStats.programKernelsCount++;
-    mCompilationStats.programKernelsTotalTime += time;
-    mCompilationStats.programKernelsMaxTime = std::max(mCompilationStats.programKernelsMaxTime, time);
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        mCompilationStats.programKernelsCount++;
+        mCompilationStats.programKernelsTotalTime += time;
+        mCompilationStats.programKernelsMaxTime = std::max(mCompilationStats.programKernelsMaxTime, time);
+    }
     logDebug("Created program kernels in {:.3f} s: {}", time, descStr);
 
     return pProgramKernels;
@@ -551,27 +678,39 @@ ref<const EntryPointGroupKernels> ProgramManager::createEntryPointGroupKernels(
 std::string ProgramManager::getHlslLanguagePrelude() const
 {
     Slang::ComPtr<ISlangBlob> prelude;
-    mpDevice->getSlangGlobalSession()->getLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.writeRef());
+    getSlangGlobalSession()->getLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.writeRef());
     return std::string(reinterpret_cast<const char*>(prelude->getBufferPointer()), prelude->getBufferSize());
 }
 
 void ProgramManager::setHlslLanguagePrelude(const std::string& prelude)
 {
+    waitForAsyncCompilations();
+
     mpDevice->getSlangGlobalSession()->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.c_str());
+
+    std::lock_guard<std::mutex> lock(mSlangMutex);
+    mWorkerHlslPrelude = prelude;
+    for (auto& [id, session] : mWorkerSlangGlobalSessions)
+        session.pGlobalSession->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.c_str());
 }
 
 void ProgramManager::registerProgramForReload(Program* program)
 {
+    std::lock_guard<std::mutex> lock(mLoadedProgramsMutex);
     mLoadedPrograms.push_back(program);
 }
 
 void ProgramManager::unregisterProgramForReload(Program* program)
 {
+    std::lock_guard<std::mutex> lock(mLoadedProgramsMutex);
     mLoadedPrograms.erase(std::remove(mLoadedPrograms.begin(), mLoadedPrograms.end(), program), mLoadedPrograms.end());
 }
 
 bool ProgramManager::reloadAllPrograms(bool forceReload)
 {
+    waitForAsyncCompilations();
+
+    std::lock_guard<std::mutex> lock(mLoadedProgramsMutex);
     bool hasReloaded = false;
 
     for (auto program : mLoadedPrograms)
@@ -588,18 +727,21 @@ bool ProgramManager::reloadAllPrograms(bool forceReload)
 
 void ProgramManager::addGlobalDefines(const DefineList& defineList)
 {
+    waitForAsyncCompilations();
     mGlobalDefineList.add(defineList);
     reloadAllPrograms(true);
 }
 
 void ProgramManager::removeGlobalDefines(const DefineList& defineList)
 {
+    waitForAsyncCompilations();
     mGlobalDefineList.remove(defineList);
     reloadAllPrograms(true);
 }
 
 void ProgramManager::setGenerateDebugInfoEnabled(bool enabled)
 {
+    waitForAsyncCompilations();
     mGenerateDebugInfo = enabled;
 }
 
@@ -610,6 +752,7 @@ bool ProgramManager::isGenerateDebugInfoEnabled()
 
 void ProgramManager::setForcedCompilerFlags(ForcedCompilerFlags forcedCompilerFlags)
 {
+    waitForAsyncCompilations();
     mForcedCompilerFlags = forcedCompilerFlags;
     reloadAllPrograms(true);
 }
@@ -619,9 +762,272 @@ ProgramManager::ForcedCompilerFlags ProgramManager::getForcedCompilerFlags()
     return mForcedCompilerFlags;
 }
 
+std::vector<std::shared_future<ref<Program>>> ProgramManager::compileProgramsAsync(const std::vector<CompileRequest>& requests)
+{
+    BS::thread_pool& threadPool = getCompileThreadPool();
+
+    std::vector<std::shared_future<ref<Program>>> futures;
+    futures.reserve(requests.size());
+
+    for (const auto& request : requests)
+    {
+        SHA1::MD key = computeCompileRequestKey(request.desc, request.defineList);
+
+        // Each request gets its own program, as programs are mutable. Only the compiled version is shared.
+        ref<Program> pProgram = Program::create(ref<Device>(mpDevice), request.desc, request.defineList);
+
+        std::shared_future<ref<const ProgramVersion>> versionFuture;
+        {
+            std::lock_guard<std::mutex> lock(mInFlightMutex);
+            if (auto it = mInFlightCompilations.find(key); it != mInFlightCompilations.end())
+            {
+                versionFuture = it->second;
+            }
+            else
+            {
+                auto compile = [this, desc = request.desc, defineList = request.defineList, key]()
+                {
+                    auto removeInFlight = [this, &key]()
+                    {
+                        std::lock_guard<std::mutex> lock(mInFlightMutex);
+                        mInFlightCompilations.erase(key);
+                    };
+
+                    try
+                    {
+                        ref<const ProgramVersion> pVersion = createSharedProgramVersion(desc, defineList);
+                        removeInFlight();
+                        return pVersion;
+                    }
+                    catch (...)
+                    {
+                        removeInFlight();
+                        throw;
+                    }
+                };
+                versionFuture = threadPool.submit(std::move(compile)).share();
+                mInFlightCompilations.emplace(key, versionFuture);
+            }
+        }
+
+        // The version is installed on the thread that waits for the program, so the program is only modified there.
+        auto install = [this, pProgram, versionFuture]()
+        {
+            setActiveProgramVersion(*pProgram, versionFuture.get());
+            return pProgram;
+        };
+        futures.push_back(std::async(std::launch::deferred, std::move(install)).share());
+    }
+
+    return futures;
+}
+
+void ProgramManager::prewarmPrograms()
+{
+    // Collect programs that would need to compile a new program version on their next use.
+    std::vector<Program*> programs;
+    std::vector<CompileRequest> requests;
+    {
+        std::lock_guard<std::mutex> lock(mLoadedProgramsMutex);
+        for (auto pProgram : mLoadedPrograms)
+        {
+            if (!pProgram->mLinkRequired || pProgram->findProgramVersion() != nullptr)
+                continue;
+            ProgramDesc desc = pProgram->mDesc;
+            desc.typeConformances = pProgram->mTypeConformanceList;
+            requests.push_back({std::move(desc), pProgram->mDefineList});
+            programs.push_back(pProgram);
+        }
+    }
+    if (programs.empty())
+        return;
+
+    CpuTimer timer;
+    timer.update();
+
+    // The compiled versions are shared, so they can be installed into the programs that were collected.
+    auto futures = compileProgramsAsync(requests);
+    size_t compiledCount = 0;
+    for (size_t i = 0; i < programs.size(); ++i)
+    {
+        try
+        {
+            ref<Program> pCompiled = futures[i].get();
+            setActiveProgramVersion(*programs[i], pCompiled->mpActiveVersion);
+            compiledCount++;
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("Failed to prewarm program:\n{}\n{}", programs[i]->getProgramDescString(), e.what());
+        }
+    }
+
+    timer.update();
+    logInfo("Prewarmed {} of {} programs in {:.3f} s.", compiledCount, programs.size(), timer.delta());
+}
+
+void ProgramManager::waitForAsyncCompilations()
+{
+    if (mpCompileThreadPool)
+        mpCompileThreadPool->wait_for_tasks();
+}
+
+slang::IGlobalSession* ProgramManager::getSlangGlobalSession() const
+{
+    std::lock_guard<std::mutex> lock(mSlangMutex);
+    auto it = mWorkerSlangGlobalSessions.find(std::this_thread::get_id());
+    return it != mWorkerSlangGlobalSessions.end() ? it->second.pGlobalSession.get() : mpDevice->getSlangGlobalSession();
+}
+
+BS::thread_pool& ProgramManager::getCompileThreadPool()
+{
+    std::lock_guard<std::mutex> lock(mSlangMutex);
+    if (!mpCompileThreadPool)
+    {
+        // Each worker holds its own Slang global session, which is costly in memory, so limit the number of workers.
+        const uint32_t kMaxCompileThreadCount = 8;
+        uint32_t threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, kMaxCompileThreadCount);
+
+        // Capture the prelude here as the device session must not be accessed from the workers.
+        Slang::ComPtr<ISlangBlob> prelude;
+        mpDevice->getSlangGlobalSession()->getLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.writeRef());
+        mWorkerHlslPrelude = std::string(reinterpret_cast<const char*>(prelude->getBufferPointer()), prelude->getBufferSize());
+
+        mpCompileThreadPool = std::make_unique<BS::thread_pool>(threadCount);
+    }
+    return *mpCompileThreadPool;
+}
+
+std::shared_ptr<std::mutex> ProgramManager::initWorkerSlangGlobalSession()
+{
+    std::lock_guard<std::mutex> lock(mSlangMutex);
+    auto& session = mWorkerSlangGlobalSessions[std::this_thread::get_id()];
+    if (!session.pGlobalSession)
+    {
+        if (SLANG_FAILED(slang::createGlobalSession(session.pGlobalSession.writeRef())))
+            FALCOR_THROW("Failed to create Slang global session for compiler worker thread.");
+        session.pGlobalSession->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, mWorkerHlslPrelude.c_str());
+        session.pMutex = std::make_shared<std::mutex>();
+    }
+    return session.pMutex;
+}
+
+ref<const ProgramVersion> ProgramManager::createSharedProgramVersion(const ProgramDesc& desc, const DefineList& defineList)
+{
+    std::shared_ptr<std::mutex> pSessionMutex = initWorkerSlangGlobalSession();
+    std::unique_lock<std::mutex> sessionLock(*pSessionMutex);
+
+    // The version is created from a program of its own, which the version keeps alive.
+    // This keeps the version valid for as long as any of the programs it is shared with use it.
+    // The owner is internal and never relinked, so it is not registered for reloading.
+    ref<Program> pOwner = Program::create(ref<Device>(mpDevice), desc, defineList);
+    unregisterProgramForReload(pOwner.get());
+
+    std::string log;
+    ref<const ProgramVersion> pVersion = createProgramVersion(*pOwner, log);
+    if (!pVersion)
+        FALCOR_THROW("Failed to link program:\n{}\n\n{}", pOwner->getProgramDescString(), log);
+    if (!log.empty())
+        logWarning("Warnings in program:\n{}\n{}", pOwner->getProgramDescString(), log);
+
+    // Link the default kernels while the session is locked by this worker.
+    // The session mutex is only attached afterwards, as createProgramKernels() locks it for later links.
+    pVersion->linkDefaultKernels(mpDevice);
+    const_cast<ProgramVersion&>(*pVersion).mpSharedProgram = pOwner;
+    const_cast<ProgramVersion&>(*pVersion).mpSlangSessionMutex = pSessionMutex;
+
+    return pVersion;
+}
+
+void ProgramManager::setActiveProgramVersion(const Program& program, const ref<const ProgramVersion>& pVersion) const
+{
+    program.mpActiveVersion = pVersion;
+    program.addProgramVersion(pVersion);
+    program.mLinkRequired = false;
+}
+
+SHA1::MD ProgramManager::computeKernelCacheKey(const Program& program) const
+{
+    SHA1 sha1;
+    auto hashString = [&sha1](std::string_view str) { updateString(sha1, str); };
+
+    // Compiler version and target.
+    hashString(spGetBuildTagString());
+    sha1.update(mpDevice->getType());
+    sha1.update(program.mDesc.shaderModel);
+
+    // Compiler options.
+    SlangCompilerFlags compilerFlags = program.mDesc.compilerFlags;
+    compilerFlags &= ~mForcedCompilerFlags.disabled;
+    compilerFlags |= mForcedCompilerFlags.enabled;
+    sha1.update(compilerFlags);
+    sha1.update(mGenerateDebugInfo);
+    sha1.update(getEnvironmentVariable("FALCOR_USE_SLANG_SPIRV_BACKEND") == "1" || program.mDesc.useSPIRVBackend);
+    for (const auto& arg : mGlobalCompilerArguments)
+        hashString(arg);
+    for (const auto& arg : program.mDesc.compilerArguments)
+        hashString(arg);
+    hashString(getHlslLanguagePrelude());
+
+    // Defines and type conformances.
+    for (const auto& [name, value] : mGlobalDefineList)
+    {
+        hashString(name);
+        hashString(value);
+    }
+    for (const auto& [name, value] : program.getDefineList())
+    {
+        hashString(name);
+        hashString(value);
+    }
+    updateTypeConformances(sha1, program.mTypeConformanceList);
+
+    // Shader modules. Source files are covered by the dependency list below.
+    for (const auto& module : program.mDesc.shaderModules)
+    {
+        hashString(module.name);
+        for (const auto& source : module.sources)
+        {
+            sha1.update(source.type);
+            hashString(source.path.string());
+            if (source.type == ProgramDesc::ShaderSource::Type::String)
+                hashString(source.string);
+        }
+    }
+
+    // Content of all source files the program depends on.
+    std::vector<std::pair<std::string, time_t>> dependencies(program.mFileTimeMap.begin(), program.mFileTimeMap.end());
+    std::sort(dependencies.begin(), dependencies.end());
+    for (const auto& [path, time] : dependencies)
+    {
+        hashString(path);
+        SHA1::MD fileHash = getFileHash(path, time);
+        sha1.update(fileHash.data(), fileHash.size());
+    }
+
+    return sha1.finalize();
+}
+
+SHA1::MD ProgramManager::getFileHash(const std::string& path, time_t modifiedTime) const
+{
+    {
+        std::lock_guard<std::mutex> lock(mFileHashesMutex);
+        auto it = mFileHashes.find(path);
+        if (it != mFileHashes.end() && it->second.first == modifiedTime)
+            return it->second.second;
+    }
+
+    std::string content = readFile(path);
+    SHA1::MD hash = SHA1::compute(content.data(), content.size());
+
+    std::lock_guard<std::mutex> lock(mFileHashesMutex);
+    mFileHashes[path] = {modifiedTime, hash};
+    return hash;
+}
+
 SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& program) const
 {
-    slang::IGlobalSession* pSlangGlobalSession = mpDevice->getSlangGlobalSession();
+    slang::IGlobalSession* pSlangGlobalSession = getSlangGlobalSession();
     FALCOR_ASSERT(pSlangGlobalSession);
 
     slang::SessionDesc sessionDesc;
@@ -27,10 +27,20 @@
  **************************************************************************/
 #pragma once
 #include "Program.h"
+#include "ProgramKernelCache.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
+#include "Utils/CryptoUtils.h"
 
+#include <BS_thread_pool/BS_thread_pool.hpp>
+
+#include <atomic>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -58,6 +68,17 @@ public:
         double programKernelsMaxTime = 0.0;
         double programVersionTotalTime = 0.0;
         double programKernelsTotalTime = 0.0;
+        size_t kernelCacheHitCount = 0;  ///< Number of kernels loaded from the persistent kernel cache.
+        size_t kernelCacheMissCount = 0; ///< Number of kernels not found in the persistent kernel cache.
+    };
+
+    /**
+     * Request for asynchronous program compilation.
+     */
+    struct CompileRequest
+    {
+        ProgramDesc desc;
+        DefineList defineList;
     };
 
     ProgramDesc applyForcedCompilerFlags(ProgramDesc desc) const;
@@ -69,7 +90,7 @@ public:
     ref<const ProgramKernels> createProgramKernels(
         const Program& program,
         const ProgramVersion& programVersion,
-        const ProgramVars& programVars,
+        const ProgramVars* pProgramVars,
         std::string& log
     ) const;
 
@@ -141,12 +162,69 @@ public:
      */
     ForcedCompilerFlags getForcedCompilerFlags();
 
-    const CompilationStats& getCompilationStats() { return mCompilationStats; }
-    void resetCompilationStats() { mCompilationStats = {}; }
+    /**
+     * Create and compile a batch of programs asynchronously on the compiler worker pool.
+     * Each request gets its own program. Requests that are identical (same program description and defines)
+     * to a request that is still in flight share the compiled program version and kernels of that request.
+     * The Slang front-end runs concurrently on the workers. Linking and GFX program creation are serialized,
+     * and the Slang objects of a shared version are only used under the mutex of the worker session that owns them.
+     * @param[in] requests List of compile requests.
+     * @return List of futures, one per request. A future returns the program with its active version
+     * set, or rethrows the compilation error. The version is set on the thread that first waits for the future.
+     */
+    std::vector<std::shared_future<ref<Program>>> compileProgramsAsync(const std::vector<CompileRequest>& requests);
+
+    /**
+     * Compile all registered programs that have no program version for their current defines and type conformances.
+     * The programs are compiled in parallel with compileProgramsAsync() and the call returns once all of them are done.
+     * Programs that fail to compile are left untouched and report their errors when they are used.
+     */
+    void prewarmPrograms();
+
+    /**
+     * Wait for all asynchronous compilations to finish.
+     */
+    void waitForAsyncCompilations();
+
+    const CompilationStats& getCompilationStats();
+    void resetCompilationStats();
+
+    /**
+     * Get the persistent kernel cache.
+     * @return The kernel cache, or nullptr if the shader cache is disabled.
+     */
+    ProgramKernelCache* getKernelCache() const { return mpKernelCache.get(); }
 
 private:
     SlangCompileRequest* createSlangCompileRequest(const Program& program) const;
 
+    /**
+     * Compute a hash of everything that affects the kernel code of a program version:
+     * the Slang version, target, source dependencies, defines, type conformances and compiler options.
+     */
+    SHA1::MD computeKernelCacheKey(const Program& program) const;
+
+    /// Get the SHA-1 hash of a source file's content. Hashes are cached until the file is modified.
+    SHA1::MD getFileHash(const std::string& path, time_t modifiedTime) const;
+
+    /// Get the Slang global session to use on the current thread.
+    slang::IGlobalSession* getSlangGlobalSession() const;
+
+    /// Get the compiler worker pool, creating it on first use.
+    BS::thread_pool& getCompileThreadPool();
+
+    /**
+     * Create the Slang global session of the current compiler worker thread if it doesn't exist yet.
+     * @return The mutex guarding the worker's global session and all Slang objects created from it.
+     */
+    std::shared_ptr<std::mutex> initWorkerSlangGlobalSession();
+
+    /// Compile a program version on a compiler worker thread and link its kernels, for sharing between programs.
+    ref<const ProgramVersion> createSharedProgramVersion(const ProgramDesc& desc, const DefineList& defineList);
+
+    /// Make a program version the active version of its program.
+    void setActiveProgramVersion(const Program& program, const ref<const ProgramVersion>& pVersion) const;
+
     Device* mpDevice;
 
     std::vector<Program*> mLoadedPrograms;
@@ -157,7 +235,35 @@ private:
     bool mGenerateDebugInfo = false;
     ForcedCompilerFlags mForcedCompilerFlags;
 
-    mutable uint32_t mHitGroupID = 0;
+    mutable std::atomic<uint32_t> mHitGroupID = 0;
+
+    // Linking and GFX program creation are serialized, as they may run on the main thread and on workers at the same time.
+    mutable std::mutex mLinkMutex;
+
+    std::shared_ptr<ProgramKernelCache> mpKernelCache;
+    mutable std::unordered_map<std::string, std::pair<time_t, SHA1::MD>> mFileHashes;
+    mutable std::mutex mFileHashesMutex;
+
+    mutable std::mutex mStatsMutex;
+    std::mutex mLoadedProgramsMutex;
+
+    // Slang global sessions are not thread-safe, so each compiler worker thread uses its own.
+    // Program versions compiled on a worker keep using the worker's global session after they are handed out,
+    // so the session comes with a mutex that is held while compiling and linking with it.
+    struct WorkerSlangGlobalSession
+    {
+        Slang::ComPtr<slang::IGlobalSession> pGlobalSession;
+        std::shared_ptr<std::mutex> pMutex;
+    };
+    mutable std::mutex mSlangMutex;
+    std::unordered_map<std::thread::id, WorkerSlangGlobalSession> mWorkerSlangGlobalSessions;
+    std::string mWorkerHlslPrelude;
+
+    std::map<SHA1::MD, std::shared_future<ref<const ProgramVersion>>> mInFlightCompilations;
+    std::mutex mInFlightMutex;
+
+    // Declared last so that pending compilations finish before the other members are destroyed.
+    std::unique_ptr<BS::thread_pool> mpCompileThreadPool;
 };
 
 } // namespace Falcor
@@ -169,11 +169,14 @@ ProgramVersion::ProgramVersion(Program* pProgram, slang::IComponentType* pSlangG
     FALCOR_ASSERT(pProgram);
 }
 
+ProgramVersion::~ProgramVersion() = default;
+
 void ProgramVersion::init(
     const DefineList& defineList,
     const ref<const ProgramReflection>& pReflector,
     const std::string& name,
-    const std::vector<Slang::ComPtr<slang::IComponentType>>& pSlangEntryPoints
+    const std::vector<Slang::ComPtr<slang::IComponentType>>& pSlangEntryPoints,
+    const ProgramKernelCache::Key& kernelCacheKey
 )
 {
     FALCOR_ASSERT(pReflector);
@@ -181,6 +184,7 @@ void ProgramVersion::init(
     mpReflector = pReflector;
     mName = name;
     mpSlangEntryPoints = pSlangEntryPoints;
+    mKernelCacheKey = kernelCacheKey;
 }
 
 ref<ProgramVersion> ProgramVersion::createEmpty(Program* pProgram, slang::IComponentType* pSlangGlobalScope)
@@ -226,7 +230,7 @@ ref<const ProgramKernels> ProgramVersion::getKernels(Device* pDevice, ProgramVar
     for (;;)
     {
         std::string log;
-        auto pKernels = pDevice->getProgramManager()->createProgramKernels(*mpProgram, *this, *pVars, log);
+        auto pKernels = pDevice->getProgramManager()->createProgramKernels(*mpProgram, *this, pVars, log);
         if (pKernels)
         {
             // Success
@@ -251,6 +255,21 @@ ref<const ProgramKernels> ProgramVersion::getKernels(Device* pDevice, ProgramVar
     }
 }
 
+void ProgramVersion::linkDefaultKernels(Device* pDevice) const
+{
+    FALCOR_ASSERT(mpProgram);
+
+    std::string log;
+    auto pKernels = pDevice->getProgramManager()->createProgramKernels(*mpProgram, *this, nullptr, log);
+    if (!pKernels)
+        FALCOR_THROW("Failed to link program:\n{}\n\n{}", getName(), log);
+    if (!log.empty())
+        logWarning("Warnings in program:\n{}\n{}", getName(), log);
+
+    // Kernels for vars without specialization arguments use an empty specialization key.
+    mpKernels[""] = pKernels;
+}
+
 slang::ISession* ProgramVersion::getSlangSession() const
 {
     return getSlangGlobalScope()->getSession();
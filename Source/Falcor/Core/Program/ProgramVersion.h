@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "ProgramReflection.h"
+#include "ProgramKernelCache.h"
 #include "DefineList.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
@@ -34,6 +35,7 @@
 #include "Core/API/Types.h"
 #include "Core/API/Handles.h"
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -58,6 +60,8 @@ class FALCOR_API ProgramVersion;
  * Since most users/render-passes do not need to get shader kernel code, we defer
  * the call to slang's `getEntryPointCode` function until it is actually needed.
  * to avoid redundant shader compiler invocation.
+ * If a persistent kernel cache is given, the kernel code is looked up in the cache before invoking
+ * the compiler, and stored in the cache after compilation.
  */
 class FALCOR_API EntryPointKernel : public Object
 {
@@ -81,7 +85,26 @@ public:
         const std::string& entryPointName
     )
     {
-        return ref<EntryPointKernel>(new EntryPointKernel(linkedSlangEntryPoint, type, entryPointName));
+        return ref<EntryPointKernel>(new EntryPointKernel(linkedSlangEntryPoint, type, entryPointName, nullptr, {}));
+    }
+
+    /**
+     * Create a shader object using a persistent kernel cache.
+     * @param[in] linkedSlangEntryPoint The Slang IComponentType that defines the shader entry point.
+     * @param[in] type The Type of the shader
+     * @param[in] pKernelCache Persistent kernel cache.
+     * @param[in] cacheKey Key identifying the kernel code in the cache.
+     * @return If success, a new shader object, otherwise nullptr
+     */
+    static ref<EntryPointKernel> create(
+        Slang::ComPtr<slang::IComponentType> linkedSlangEntryPoint,
+        ShaderType type,
+        const std::string& entryPointName,
+        std::shared_ptr<ProgramKernelCache> pKernelCache,
+        const ProgramKernelCache::Key& cacheKey
+    )
+    {
+        return ref<EntryPointKernel>(new EntryPointKernel(linkedSlangEntryPoint, type, entryPointName, std::move(pKernelCache), cacheKey));
     }
 
     /**
@@ -96,30 +119,62 @@ public:
 
     BlobData getBlobData() const
     {
-        if (!mpBlob)
+        if (!mpBlob && !mHasCachedCode)
         {
-            Slang::ComPtr<ISlangBlob> pDiagnostics;
-            if (SLANG_FAILED(mLinkedSlangEntryPoint->getEntryPointCode(0, 0, mpBlob.writeRef(), pDiagnostics.writeRef())))
+            if (mpKernelCache && mpKernelCache->get(mCacheKey, mCachedCode))
             {
-                FALCOR_THROW(std::string("Shader compilation failed. \n") + (const char*)pDiagnostics->getBufferPointer());
+                mHasCachedCode = true;
+            }
+            else
+            {
+                Slang::ComPtr<ISlangBlob> pDiagnostics;
+                if (SLANG_FAILED(mLinkedSlangEntryPoint->getEntryPointCode(0, 0, mpBlob.writeRef(), pDiagnostics.writeRef())))
+                {
+                    FALCOR_THROW(std::string("Shader compilation failed. \n") + (const char*)pDiagnostics->getBufferPointer());
+                }
+                if (mpKernelCache)
+                    mpKernelCache->set(mCacheKey, mpBlob->getBufferPointer(), mpBlob->getBufferSize());
             }
         }
 
         BlobData result;
-        result.data = mpBlob->getBufferPointer();
-        result.size = mpBlob->getBufferSize();
+        if (mHasCachedCode)
+        {
+            result.data = mCachedCode.data();
+            result.size = mCachedCode.size();
+        }
+        else
+        {
+            result.data = mpBlob->getBufferPointer();
+            result.size = mpBlob->getBufferSize();
+        }
         return result;
     }
 
 protected:
-    EntryPointKernel(Slang::ComPtr<slang::IComponentType> linkedSlangEntryPoint, ShaderType type, const std::string& entryPointName)
-        : mLinkedSlangEntryPoint(linkedSlangEntryPoint), mType(type), mEntryPointName(entryPointName)
+    EntryPointKernel(
+        Slang::ComPtr<slang::IComponentType> linkedSlangEntryPoint,
+        ShaderType type,
+        const std::string& entryPointName,
+        std::shared_ptr<ProgramKernelCache> pKernelCache,
+        const ProgramKernelCache::Key& cacheKey
+    )
+        : mLinkedSlangEntryPoint(linkedSlangEntryPoint)
+        , mType(type)
+        , mEntryPointName(entryPointName)
+        , mpKernelCache(std::move(pKernelCache))
+        , mCacheKey(cacheKey)
     {}
 
     Slang::ComPtr<slang::IComponentType> mLinkedSlangEntryPoint;
     ShaderType mType;
     std::string mEntryPointName;
     mutable Slang::ComPtr<ISlangBlob> mpBlob;
+
+    std::shared_ptr<ProgramKernelCache> mpKernelCache;
+    ProgramKernelCache::Key mCacheKey;
+    mutable std::vector<uint8_t> mCachedCode;
+    mutable bool mHasCachedCode = false;
 };
 
 /**
@@ -209,6 +264,11 @@ public:
      */
     const std::string& getName() const { return mName; }
 
+    /**
+     * Get the key identifying this version's kernel code in the persistent kernel cache.
+     */
+    const ProgramKernelCache::Key& getKernelCacheKey() const { return mKernelCacheKey; }
+
     /**
      * Get the reflection object
      */
@@ -245,6 +305,8 @@ class ProgramVersion : public Object
 {
     FALCOR_OBJECT(ProgramVersion)
 public:
+    ~ProgramVersion();
+
     /**
      * Get the program that this version was created from
      */
@@ -289,19 +351,33 @@ protected:
 
     ProgramVersion(Program* pProgram, slang::IComponentType* pSlangGlobalScope);
 
+    /**
+     * Create the kernels used with vars that have no specialization arguments bound.
+     * Throws if linking fails.
+     */
+    void linkDefaultKernels(Device* pDevice) const;
+
     void init(
         const DefineList& defineList,
         const ref<const ProgramReflection>& pReflector,
         const std::string& name,
-        const std::vector<Slang::ComPtr<slang::IComponentType>>& pSlangEntryPoints
+        const std::vector<Slang::ComPtr<slang::IComponentType>>& pSlangEntryPoints,
+        const ProgramKernelCache::Key& kernelCacheKey
     );
 
     mutable Program* mpProgram;
+    /// Program this version was created from when the version is shared between several programs.
+    /// The version keeps it alive, so that mpProgram stays valid for all of them.
+    ref<const Program> mpSharedProgram;
+    /// Mutex guarding the Slang global session of a shared version. The Slang session, global scope and entry points
+    /// of a shared version belong to the compiler worker that created it, so any thread using them must hold this mutex.
+    std::shared_ptr<std::mutex> mpSlangSessionMutex;
     DefineList mDefines;
     ref<const ProgramReflection> mpReflector;
     std::string mName;
     Slang::ComPtr<slang::IComponentType> mpSlangGlobalScope;
     std::vector<Slang::ComPtr<slang::IComponentType>> mpSlangEntryPoints;
+    ProgramKernelCache::Key mKernelCacheKey = {};
 
     // Cached version of compiled kernels for this program version
     mutable std::unordered_map<std::string, ref<const ProgramKernels>> mpKernels;
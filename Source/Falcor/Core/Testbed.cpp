@@ -100,7 +100,7 @@ void Testbed::frame()
     // Execute the render graph.
     if (mpRenderGraph)
     {
-        mpRenderGraph->getPassesDictionary()[kRenderPassRefreshFlags] = RenderPassRefreshFlags::None;
+        mpRenderGraph->getPassesDictionary().setValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
         mpRenderGraph->execute(pRenderContext);
 
         // Blit main graph output to frame buffer.
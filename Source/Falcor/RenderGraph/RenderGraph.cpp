@@ -32,6 +32,7 @@
 #include "GlobalState.h"
 #include "Core/ObjectPython.h"
 #include "Core/API/Device.h"
+#include "Core/Program/ProgramManager.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
 #include "Utils/Scripting/Scripting.h"
 #include "Utils/Scripting/ScriptBindings.h"
@@ -121,6 +122,7 @@ void RenderGraph::setScene(const ref<Scene>& pScene)
         it.second.pPass->setScene(mpDevice->getRenderContext(), pScene);
     }
     mRecompile = true;
+    mCompilerDeps.compileAllPasses = true;
 }
 
 ref<RenderPass> RenderGraph::createPass(const std::string& passName, const std::string& passType, const Properties& props)
@@ -139,7 +141,11 @@ uint32_t RenderGraph::addPass(const ref<RenderPass>& pPass, const std::string& p
     uint32_t passIndex = mpGraph->addNode();
     mNameToIndex[passName] = passIndex;
 
-    pPass->mPassChangedCB = [this]() { mRecompile = true; };
+    pPass->mPassChangedCB = [this, passIndex]()
+    {
+        mRecompile = true;
+        mCompilerDeps.dirtyPasses.insert(passIndex);
+    };
     pPass->mName = passName;
 
     if (mpScene)
@@ -187,7 +193,11 @@ void RenderGraph::updatePass(const std::string& passName, const Properties& prop
     std::string passTypeName = pOldPass->getType();
     auto pPass = RenderPass::create(passTypeName, mpDevice, props);
     pPassIt->second.pPass = pPass;
-    pPass->mPassChangedCB = [this]() { mRecompile = true; };
+    pPass->mPassChangedCB = [this, index]()
+    {
+        mRecompile = true;
+        mCompilerDeps.dirtyPasses.insert(index);
+    };
     pPass->mName = pOldPass->getName();
 
     if (mpScene)
@@ -425,16 +435,25 @@ bool RenderGraph::compile(RenderContext* pRenderContext, std::string& log)
 {
     if (!mRecompile)
         return true;
-    mpExe = nullptr;
+
+    // Keep the previous executable alive during compilation, so that unchanged passes and resources can be reused.
+    auto pPreviousExe = std::move(mpExe);
 
     try
     {
-        mpExe = RenderGraphCompiler::compile(*this, pRenderContext, mCompilerDeps);
+        mpExe = RenderGraphCompiler::compile(*this, pRenderContext, mCompilerDeps, pPreviousExe.get());
         mRecompile = false;
+        mCompilerDeps.dirtyPasses.clear();
+        mCompilerDeps.compileAllPasses = false;
+
+        // Compile the programs created by the passes in parallel now, instead of one after another on first use.
+        mpDevice->getProgramManager()->prewarmPrograms();
         return true;
     }
     catch (const std::exception& e)
     {
+        // Passes may have been partially compiled, so recompile all of them next time.
+        mCompilerDeps.compileAllPasses = true;
         log = e.what();
         return false;
     }
@@ -657,6 +676,7 @@ void RenderGraph::onResize(const Fbo* pTargetFbo)
 
     // Invalidate the graph. Render passes might change their reflection based on the resize information
     mRecompile = true;
+    mCompilerDeps.compileAllPasses = true;
 }
 
 bool canFieldsConnect(const RenderPassReflection::Field& src, const RenderPassReflection::Field& dst)
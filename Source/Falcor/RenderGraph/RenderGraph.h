@@ -303,6 +303,8 @@ public:
 
     /**
      * Compile the graph.
+     * Only passes that are new, requested recompilation or whose inputs/outputs changed are recompiled,
+     * and resources with unchanged properties are reused from the previous compilation.
      */
     bool compile(RenderContext* pRenderContext, std::string& log);
     bool compile(RenderContext* pRenderContext)
@@ -311,6 +313,12 @@ public:
         return compile(pRenderContext, s);
     }
 
+    /**
+     * Get the report of the last successful compilation, listing what was rebuilt.
+     * @return The report, or nullptr if the graph is not compiled.
+     */
+    const RenderGraphExe::CompileReport* getCompileReport() const { return mpExe ? &mpExe->getCompileReport() : nullptr; }
+
 private:
     struct EdgeData
     {
@@ -30,6 +30,7 @@
 #include "RenderPasses/ResolvePass.h"
 #include "Core/Error.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
+#include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
 
 namespace Falcor
@@ -40,6 +41,12 @@ bool canAutoResolve(const RenderPassReflection::Field& src, const RenderPassRefl
 {
     return src.getSampleCount() > 1 && dst.getSampleCount() == 1;
 }
+
+bool isSameCompileData(const RenderPass::CompileData& a, const RenderPass::CompileData& b)
+{
+    return all(a.defaultTexDims == b.defaultTexDims) && a.defaultTexFormat == b.defaultTexFormat &&
+           a.connectedResources == b.connectedResources;
+}
 } // namespace
 
 RenderGraphCompiler::RenderGraphCompiler(RenderGraph& graph, const Dependencies& dependencies)
@@ -49,7 +56,8 @@ RenderGraphCompiler::RenderGraphCompiler(RenderGraph& graph, const Dependencies&
 std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     RenderGraph& graph,
     RenderContext* pRenderContext,
-    const Dependencies& dependencies
+    const Dependencies& dependencies,
+    const RenderGraphExe* pPreviousExe
 )
 {
     RenderGraphCompiler c = RenderGraphCompiler(graph, dependencies);
@@ -60,21 +68,37 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
         pResourcesCache->registerExternalResource(name, pRes);
 
     c.resolveExecutionOrder();
-    c.compilePasses(pRenderContext);
+    c.compilePasses(pRenderContext, pPreviousExe);
     if (c.insertAutoPasses())
         c.resolveExecutionOrder();
     c.validateGraph();
-    c.allocateResources(pRenderContext->getDevice(), pResourcesCache.get());
+    c.allocateResources(pRenderContext->getDevice(), pResourcesCache.get(), pPreviousExe ? pPreviousExe->mpResourceCache.get() : nullptr);
 
     auto pExe = std::make_unique<RenderGraphExe>();
     pExe->mExecutionList.reserve(c.mExecutionList.size());
 
-    for (auto e : c.mExecutionList)
+    for (const auto& e : c.mExecutionList)
     {
-        pExe->insertPass(e.name, e.pPass);
+        std::vector<std::string> fieldNames;
+        fieldNames.reserve(e.reflector.getFieldCount());
+        for (size_t f = 0; f < e.reflector.getFieldCount(); f++)
+            fieldNames.push_back(e.reflector.getField(f)->getName());
+        // Auto-generated passes are not compiled and have no compile data.
+        auto it = c.mCompileData.find(e.pPass.get());
+        pExe->insertPass(e.name, e.pPass, fieldNames, it != c.mCompileData.end() ? it->second : RenderPass::CompileData{});
     }
     c.restoreCompilationChanges();
     pExe->mpResourceCache = std::move(pResourcesCache);
+    pExe->resolveResources();
+
+    logDebug(
+        "Compiled render graph: {} passes compiled, {} passes reused, {} resources allocated, {} resources reused.",
+        c.mReport.compiledPasses.size(),
+        c.mReport.skippedPassCount,
+        c.mReport.allocatedResources.size(),
+        c.mReport.reusedResourceCount
+    );
+    pExe->mCompileReport = std::move(c.mReport);
     return pExe;
 }
 
@@ -261,7 +285,7 @@ bool RenderGraphCompiler::insertAutoPasses()
     return addedPasses;
 }
 
-void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache)
+void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache, const ResourceCache* pPreviousCache)
 {
     // Build list to look up execution order index from the pass
     std::unordered_map<RenderPass*, uint32_t> passToIndex;
@@ -342,7 +366,9 @@ void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache*
         }
     }
 
-    pResourceCache->allocateResources(pDevice, mDependencies.defaultResourceProps);
+    auto stats = pResourceCache->allocateResources(pDevice, mDependencies.defaultResourceProps, pPreviousCache);
+    mReport.allocatedResources = std::move(stats.allocatedResources);
+    mReport.reusedResourceCount = stats.reusedResourceCount;
 }
 
 void RenderGraphCompiler::restoreCompilationChanges()
@@ -440,20 +466,54 @@ RenderPass::CompileData RenderGraphCompiler::prepPassCompilationData(const PassD
     return compileData;
 }
 
-void RenderGraphCompiler::compilePasses(RenderContext* pRenderContext)
+void RenderGraphCompiler::compilePasses(RenderContext* pRenderContext, const RenderGraphExe* pPreviousExe)
 {
+    // Data each pass was last compiled with. Passes are identified by pointer, which is safe as the previous executable holds references.
+    // This starts with the data of the previous compilation and is updated on every compile() call, including reflection retries below.
+    std::unordered_map<const RenderPass*, const RenderPass::CompileData*> compiledData;
+    const bool skipUnchanged = pPreviousExe && !mDependencies.compileAllPasses;
+    if (skipUnchanged)
+    {
+        for (const auto& pass : pPreviousExe->mExecutionList)
+            compiledData[pass.pPass.get()] = &pass.compileData;
+    }
+
+    auto needsCompile = [&](const PassData& p, const RenderPass::CompileData& compileData)
+    {
+        if (!skipUnchanged || mDependencies.dirtyPasses.count(p.index) != 0)
+            return true;
+        auto it = compiledData.find(p.pPass.get());
+        return it == compiledData.end() || !isSameCompileData(*it->second, compileData);
+    };
+
     while (1)
     {
         std::string log;
         bool success = true;
+        mReport.compiledPasses.clear();
+        mReport.skippedPassCount = 0;
         for (auto& p : mExecutionList)
         {
+            auto compileData = prepPassCompilationData(p);
+            if (!needsCompile(p, compileData))
+            {
+                mCompileData[p.pPass.get()] = std::move(compileData);
+                mReport.skippedPassCount++;
+                continue;
+            }
+
             try
             {
-                p.pPass->compile(pRenderContext, prepPassCompilationData(p));
+                p.pPass->compile(pRenderContext, compileData);
+                auto& storedData = mCompileData[p.pPass.get()];
+                storedData = std::move(compileData);
+                compiledData[p.pPass.get()] = &storedData;
+                mReport.compiledPasses.push_back(p.name);
             }
             catch (const std::exception& e)
             {
+                // The pass state is unknown after a failed compile, so it is always compiled again.
+                compiledData.erase(p.pPass.get());
                 log += std::string(e.what()) + "\n";
                 success = false;
             }
@@ -32,6 +32,8 @@
 #include "RenderGraphExe.h"
 #include "Core/Macros.h"
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -46,8 +48,27 @@ public:
     {
         ResourceCache::DefaultProperties defaultResourceProps;
         ResourceCache::ResourcesMap externalResources;
+        std::unordered_set<uint32_t> dirtyPasses; ///< Node indices of passes that requested recompilation since the last compilation.
+        bool compileAllPasses = true;             ///< Recompile all passes, regardless of whether their compile data changed.
     };
-    static std::unique_ptr<RenderGraphExe> compile(RenderGraph& graph, RenderContext* pRenderContext, const Dependencies& dependencies);
+
+    /**
+     * Compile a render graph.
+     * If a previously compiled graph is given, the graph is compiled incrementally: passes are only recompiled if they are new,
+     * marked dirty, or if their compile data (connected resources, default texture properties) changed. Graph resources
+     * whose properties are unchanged are taken over from the previous compilation instead of being reallocated.
+     * @param[in] graph Render graph.
+     * @param[in] pRenderContext Render context.
+     * @param[in] dependencies Compiler dependencies.
+     * @param[in] pPreviousExe Optional previous compilation result of the same graph.
+     * @return Executable graph.
+     */
+    static std::unique_ptr<RenderGraphExe> compile(
+        RenderGraph& graph,
+        RenderContext* pRenderContext,
+        const Dependencies& dependencies,
+        const RenderGraphExe* pPreviousExe = nullptr
+    );
 
 private:
     RenderGraphCompiler(RenderGraph& graph, const Dependencies& dependencies);
@@ -72,10 +93,13 @@ private:
         std::vector<std::pair<std::string, std::string>> removedEdges;
     } mCompilationChanges;
 
+    std::unordered_map<const RenderPass*, RenderPass::CompileData> mCompileData; ///< Data each pass is compiled with.
+    RenderGraphExe::CompileReport mReport;
+
     void resolveExecutionOrder();
-    void compilePasses(RenderContext* pRenderContext);
+    void compilePasses(RenderContext* pRenderContext, const RenderGraphExe* pPreviousExe);
     bool insertAutoPasses();
-    void allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache);
+    void allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache, const ResourceCache* pPreviousCache);
     void validateGraph() const;
     void restoreCompilationChanges();
     RenderPass::CompileData prepPassCompilationData(const PassData& passData);
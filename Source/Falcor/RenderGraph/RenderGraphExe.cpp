@@ -38,7 +38,7 @@ void RenderGraphExe::execute(const Context& ctx)
     {
         FALCOR_PROFILE(ctx.pRenderContext, pass.name);
 
-        RenderData renderData(pass.name, *mpResourceCache, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
+        RenderData renderData(pass.name, *mpResourceCache, pass.fields, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
         pass.pPass->execute(ctx.pRenderContext, renderData);
     }
 }
@@ -102,9 +102,29 @@ void RenderGraphExe::onHotReload(HotReloadFlags reloaded)
     }
 }
 
-void RenderGraphExe::insertPass(const std::string& name, const ref<RenderPass>& pPass)
+void RenderGraphExe::insertPass(
+    const std::string& name,
+    const ref<RenderPass>& pPass,
+    const std::vector<std::string>& fieldNames,
+    const RenderPass::CompileData& compileData
+)
 {
-    mExecutionList.push_back(Pass(name, pPass));
+    Pass pass(name, pPass);
+    pass.compileData = compileData;
+    pass.fields.reserve(fieldNames.size());
+    for (const auto& fieldName : fieldNames)
+        pass.fields.push_back({fieldName, {}});
+    mExecutionList.push_back(std::move(pass));
+}
+
+void RenderGraphExe::resolveResources()
+{
+    FALCOR_ASSERT(mpResourceCache);
+    for (auto& pass : mExecutionList)
+    {
+        for (auto& field : pass.fields)
+            field.handle = mpResourceCache->resolveResource(pass.name + '.' + field.name);
+    }
 }
 
 ref<Resource> RenderGraphExe::getResource(const std::string& name) const
@@ -115,6 +135,10 @@ ref<Resource> RenderGraphExe::getResource(const std::string& name) const
 
 void RenderGraphExe::setInput(const std::string& name, const ref<Resource>& pResource)
 {
+    // Resolved handles only refer to external resource names known at resolve time.
+    bool isNewName = mpResourceCache->resolveResource(name).externalIndex == ResourceCache::kInvalidIndex;
     mpResourceCache->registerExternalResource(name, pResource);
+    if (isNewName)
+        resolveResources();
 }
 } // namespace Falcor
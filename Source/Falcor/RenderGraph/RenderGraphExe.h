@@ -54,6 +54,17 @@ public:
         ResourceFormat defaultTexFormat;
     };
 
+    /**
+     * Summary of what was rebuilt when the graph was compiled.
+     */
+    struct CompileReport
+    {
+        std::vector<std::string> compiledPasses;     ///< Passes whose compile() function was called.
+        uint32_t skippedPassCount = 0;               ///< Number of passes that were reused without recompiling.
+        std::vector<std::string> allocatedResources; ///< Resources that were created.
+        uint32_t reusedResourceCount = 0;            ///< Number of resources reused from the previous compilation.
+    };
+
     /**
      * Execute the graph
      */
@@ -99,15 +110,33 @@ public:
      */
     void setInput(const std::string& name, const ref<Resource>& pResource);
 
+    /**
+     * Get the report of the compilation that created this object.
+     */
+    const CompileReport& getCompileReport() const { return mCompileReport; }
+
 private:
     friend class RenderGraphCompiler;
 
-    void insertPass(const std::string& name, const ref<RenderPass>& pPass);
+    void insertPass(
+        const std::string& name,
+        const ref<RenderPass>& pPass,
+        const std::vector<std::string>& fieldNames,
+        const RenderPass::CompileData& compileData
+    );
+
+    /**
+     * Resolve the resource handles of all pass fields.
+     * Needs to be called after the resource cache is created, and whenever a new external resource name is registered.
+     */
+    void resolveResources();
 
     struct Pass
     {
         std::string name;
         ref<RenderPass> pPass;
+        std::vector<RenderData::ResolvedField> fields;
+        RenderPass::CompileData compileData; ///< Data the pass was last compiled with.
 
     private:
         friend class RenderGraphExe; // Force RenderGraphCompiler to use insertPass() by hiding this Ctor from it
@@ -116,5 +145,6 @@ private:
 
     std::vector<Pass> mExecutionList;
     std::unique_ptr<ResourceCache> mpResourceCache;
+    CompileReport mCompileReport;
 };
 } // namespace Falcor
@@ -32,15 +32,27 @@ namespace Falcor
 RenderData::RenderData(
     const std::string& passName,
     ResourceCache& resources,
+    const std::vector<ResolvedField>& fields,
     Dictionary& dictionary,
     const uint2& defaultTexDims,
     ResourceFormat defaultTexFormat
 )
-    : mName(passName), mResources(resources), mDictionary(dictionary), mDefaultTexDims(defaultTexDims), mDefaultTexFormat(defaultTexFormat)
+    : mName(passName)
+    , mResources(resources)
+    , mFields(fields)
+    , mDictionary(dictionary)
+    , mDefaultTexDims(defaultTexDims)
+    , mDefaultTexFormat(defaultTexFormat)
 {}
 
 const ref<Resource>& RenderData::getResource(const std::string_view name) const
 {
+    // Passes have few fields, so a linear search over the pre-resolved fields is cheaper than building and hashing the full name.
+    for (const auto& field : mFields)
+    {
+        if (field.name == name)
+            return mResources.getResource(field.handle);
+    }
     return mResources.getResource(fmt::format("{}.{}", mName, name));
 }
 
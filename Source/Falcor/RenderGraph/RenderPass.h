@@ -42,6 +42,7 @@
 #include <memory>
 #include <string_view>
 #include <string>
+#include <vector>
 
 namespace Falcor
 {
@@ -88,9 +89,19 @@ public:
     ResourceFormat getDefaultTextureFormat() const { return mDefaultTexFormat; }
 
 protected:
+    /**
+     * Pass field with its resource handle resolved at graph compile time.
+     */
+    struct ResolvedField
+    {
+        std::string name;                     ///< Field name, not including the pass name.
+        ResourceCache::ResourceHandle handle; ///< Handle of the field's resource.
+    };
+
     RenderData(
         const std::string& passName,
         ResourceCache& resources,
+        const std::vector<ResolvedField>& fields,
         Dictionary& dictionary,
         const uint2& defaultTexDims,
         ResourceFormat defaultTexFormat
@@ -98,6 +109,7 @@ protected:
 
     const std::string& mName;
     ResourceCache& mResources;
+    const std::vector<ResolvedField>& mFields;
     Dictionary& mDictionary;
     uint2 mDefaultTexDims;
     ResourceFormat mDefaultTexFormat;
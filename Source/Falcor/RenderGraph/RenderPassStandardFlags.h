@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Core/Macros.h"
+#include "Utils/Dictionary.h"
 #include <cstdint>
 
 namespace Falcor
@@ -59,4 +60,12 @@ static const char kRenderPassPRNGDimension[] = "_prngDimension";
 static const char kRenderPassGBufferAdjustShadingNormals[] = "_gbufferAdjustShadingNormals";
 
 FALCOR_ENUM_CLASS_OPERATORS(RenderPassRefreshFlags);
+
+/**
+ * Typed keys for the dictionary fields above.
+ * These refer to the same entries as the string keys but avoid hashing the key name on every access.
+ */
+inline const DictionaryKey<RenderPassRefreshFlags> kRenderPassRefreshFlagsKey{kRenderPassRefreshFlags};
+inline const DictionaryKey<uint32_t> kRenderPassPRNGDimensionKey{kRenderPassPRNGDimension};
+inline const DictionaryKey<bool> kRenderPassGBufferAdjustShadingNormalsKey{kRenderPassGBufferAdjustShadingNormals};
 } // namespace Falcor
@@ -41,19 +41,29 @@ void ResourceCache::reset()
 
 const ref<Resource>& ResourceCache::getResource(const std::string& name) const
 {
-    static const ref<Resource> pNull;
-    auto extIt = mExternalResources.find(name);
+    return getResource(resolveResource(name));
+}
 
-    // Search external resources if not found in render graph resources
-    if (extIt == mExternalResources.end())
-    {
-        const auto& it = mNameToIndex.find(name);
-        if (it == mNameToIndex.end())
-            return pNull;
-        return mResourceData[it->second].pResource;
-    }
+ResourceCache::ResourceHandle ResourceCache::resolveResource(const std::string& name) const
+{
+    ResourceHandle handle;
+    if (auto extIt = mExternalNameToIndex.find(name); extIt != mExternalNameToIndex.end())
+        handle.externalIndex = extIt->second;
+    if (auto it = mNameToIndex.find(name); it != mNameToIndex.end())
+        handle.index = it->second;
+    return handle;
+}
 
-    return extIt->second;
+const ref<Resource>& ResourceCache::getResource(const ResourceHandle& handle) const
+{
+    static const ref<Resource> pNull;
+
+    // External resources take precedence over render graph resources
+    if (handle.externalIndex != kInvalidIndex && mExternalResources[handle.externalIndex])
+        return mExternalResources[handle.externalIndex];
+    if (handle.index != kInvalidIndex)
+        return mResourceData[handle.index].pResource;
+    return pNull;
 }
 
 const RenderPassReflection::Field& ResourceCache::getResourceReflection(const std::string& name) const
@@ -64,18 +74,28 @@ const RenderPassReflection::Field& ResourceCache::getResourceReflection(const st
 
 void ResourceCache::registerExternalResource(const std::string& name, const ref<Resource>& pResource)
 {
+    auto it = mExternalNameToIndex.find(name);
     if (pResource)
-        mExternalResources[name] = pResource;
+    {
+        if (it == mExternalNameToIndex.end())
+        {
+            mExternalNameToIndex[name] = (uint32_t)mExternalResources.size();
+            mExternalResources.push_back(pResource);
+        }
+        else
+        {
+            mExternalResources[it->second] = pResource;
+        }
+    }
     else
     {
-        auto it = mExternalResources.find(name);
-        if (it == mExternalResources.end())
+        if (it == mExternalNameToIndex.end() || !mExternalResources[it->second])
         {
             logWarning("ResourceCache::registerExternalResource: '{}' does not exist.", name);
             return;
         }
 
-        mExternalResources.erase(it);
+        mExternalResources[it->second] = nullptr;
     }
 }
 
@@ -191,14 +211,48 @@ inline ref<Resource> createResourceForPass(
     return pResource;
 }
 
-void ResourceCache::allocateResources(ref<Device> pDevice, const DefaultProperties& params)
+ResourceCache::AllocationStats ResourceCache::allocateResources(
+    ref<Device> pDevice,
+    const DefaultProperties& params,
+    const ResourceCache* pPreviousCache
+)
 {
+    AllocationStats stats;
+
+    // Find a resource of the previous cache that was created with identical properties
+    auto findPreviousResource = [&](const ResourceData& data) -> ref<Resource>
+    {
+        if (!pPreviousCache)
+            return nullptr;
+        if (any(pPreviousCache->mDefaultProperties.dims != params.dims) || pPreviousCache->mDefaultProperties.format != params.format)
+            return nullptr;
+        auto it = pPreviousCache->mNameToIndex.find(data.name);
+        if (it == pPreviousCache->mNameToIndex.end())
+            return nullptr;
+        const auto& previousData = pPreviousCache->mResourceData[it->second];
+        if (previousData.name != data.name || previousData.field != data.field || previousData.resolveBindFlags != data.resolveBindFlags)
+            return nullptr;
+        return previousData.pResource;
+    };
+
     for (auto& data : mResourceData)
     {
         if ((data.pResource == nullptr) && (data.field.isValid()))
         {
-            data.pResource = createResourceForPass(pDevice, params, data.field, data.resolveBindFlags, data.name);
+            data.pResource = findPreviousResource(data);
+            if (data.pResource)
+            {
+                stats.reusedResourceCount++;
+            }
+            else
+            {
+                data.pResource = createResourceForPass(pDevice, params, data.field, data.resolveBindFlags, data.name);
+                stats.allocatedResources.push_back(data.name);
+            }
         }
     }
+    mDefaultProperties = params;
+
+    return stats;
 }
 } // namespace Falcor
@@ -42,6 +42,17 @@ class FALCOR_API ResourceCache
 public:
     using ResourcesMap = std::unordered_map<std::string, ref<Resource>>;
 
+    static constexpr uint32_t kInvalidIndex = uint32_t(-1);
+
+    /**
+     * Pre-resolved reference to a resource, see resolveResource().
+     */
+    struct ResourceHandle
+    {
+        uint32_t externalIndex = kInvalidIndex; ///< Index of the external resource slot with the same name.
+        uint32_t index = kInvalidIndex;         ///< Index of the graph-owned resource.
+    };
+
     /**
      * Properties to use during resource creation when its property has not been fully specified.
      */
@@ -78,16 +89,41 @@ public:
      */
     const ref<Resource>& getResource(const std::string& name) const;
 
+    /**
+     * Resolve a resource name into a handle that can be used to access the resource without name lookups.
+     * The handle stays valid until the cache is reset or a new external resource name is registered.
+     */
+    ResourceHandle resolveResource(const std::string& name) const;
+
+    /**
+     * Get a resource by handle. Includes external resources known by the cache.
+     */
+    const ref<Resource>& getResource(const ResourceHandle& handle) const;
+
     /**
      * Get the field-reflection of a resource
      */
     const RenderPassReflection::Field& getResourceReflection(const std::string& name) const;
 
+    /**
+     * Statistics of a call to allocateResources().
+     */
+    struct AllocationStats
+    {
+        std::vector<std::string> allocatedResources; ///< Names of the resources that were created.
+        uint32_t reusedResourceCount = 0;            ///< Number of resources taken over from the previous cache.
+    };
+
     /**
      * Allocate all resources that need to be created/updated.
      * This includes new resources, resources whose properties have been updated since last allocation call.
+     * @param[in] pDevice GPU device.
+     * @param[in] params Default resource properties.
+     * @param[in] pPreviousCache Optional cache of a previous compilation. Resources with the same name and identical properties are reused
+     * instead of being created.
+     * @return Allocation statistics.
      */
-    void allocateResources(ref<Device> pDevice, const DefaultProperties& params);
+    AllocationStats allocateResources(ref<Device> pDevice, const DefaultProperties& params, const ResourceCache* pPreviousCache = nullptr);
 
     /**
      * Clears all registered field/resource properties and allocated resources.
@@ -107,9 +143,12 @@ private:
     // Resources and properties for fields within (and therefore owned by) a render graph
     std::unordered_map<std::string, uint32_t> mNameToIndex;
     std::vector<ResourceData> mResourceData;
+    DefaultProperties mDefaultProperties; // Default properties used by the last allocation
 
-    // References to output resources not to be allocated by the render graph
-    ResourcesMap mExternalResources;
+    // References to output resources not to be allocated by the render graph.
+    // Slots are never removed, so that resolved handles remain valid when a resource is unregistered.
+    std::unordered_map<std::string, uint32_t> mExternalNameToIndex;
+    std::vector<ref<Resource>> mExternalResources;
 };
 
 } // namespace Falcor
@@ -26,8 +26,8 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "EmissivePowerSampler.h"
+#include "Utils/Sampling/AliasTableBuilder.h"
 #include "Utils/Timing/Profiler.h"
-#include <algorithm>
 
 namespace Falcor
 {
@@ -57,11 +57,9 @@ namespace Falcor
             FALCOR_ASSERT(mpLightCollection);
             const auto& triangles = mpLightCollection->getMeshLightTriangles(pRenderContext);
 
-            const size_t numTris = triangles.size();
-            std::vector<float> weights(numTris);
-            for (size_t i = 0; i < numTris; i++) weights[i] = triangles[i].flux;
-
-            mTriangleTable = generateAliasTable(std::move(weights));
+            // Read the flux directly from the triangle list rather than copying it out first.
+            const float* pFlux = triangles.empty() ? nullptr : &triangles[0].flux;
+            mTriangleTable = generateAliasTable(pFlux, triangles.size(), sizeof(ILightCollection::MeshLightTriangle));
 
             mNeedsRebuild = false;
             samplerChanged = true;
@@ -83,89 +81,28 @@ namespace Falcor
     {
     }
 
-    EmissivePowerSampler::AliasTable EmissivePowerSampler::generateAliasTable(std::vector<float> weights)
+    EmissivePowerSampler::AliasTable EmissivePowerSampler::generateAliasTable(const float* pWeights, size_t count, size_t stride)
     {
-        uint32_t N = uint32_t(weights.size());
-        std::uniform_int_distribution<uint32_t> rngDist;
-
-        double sum = 0.0f;
-        for (float f : weights)
-        {
-            sum += f;
-        }
-        for (float& f : weights)
-        {
-            f *= N / float(sum);
-        }
+        AliasTableData table = AliasTableBuilder::build(pWeights, count, stride);
+        uint32_t N = uint32_t(count);
 
-        std::vector<uint32_t> permutation(N);
-        for (uint32_t i = 0; i < N; ++i)
-        {
-            permutation[i] = i;
-        }
-        std::sort(permutation.begin(), permutation.end(), [&](uint32_t a, uint32_t b) { return weights[a] < weights[b]; });
-
-        std::vector<float> thresholds(N);
-        std::vector<uint32_t> redirect(N);
-        std::vector<uint2> merged(N);
         std::vector<uint2> fullTable(N);
-
-        uint32_t head = 0;
-        uint32_t tail = N - 1;
-
-        while (head != tail)
-        {
-            int i = permutation[head];
-            int j = permutation[tail];
-
-            thresholds[i] = weights[i];
-            redirect[i] = j;
-            weights[j] -= 1.0f - weights[i];
-
-            if (head == tail - 1)
-            {
-                thresholds[j] = 1.0f;
-                redirect[j] = j;
-                break;
-            }
-            else if (weights[j] < 1.0f)
-            {
-                std::swap(permutation[head], permutation[tail]);
-                tail--;
-            }
-            else
-            {
-                head++;
-            }
-        }
-
-        for (uint32_t i = 0; i < N; ++i)
-        {
-            permutation[i] = i;
-        }
-
-        for (uint32_t i = 0; i < N; ++i)
-        {
-            uint32_t dst = i + (rngDist(mAliasTableRng) % (N - i));
-            std::swap(thresholds[i], thresholds[dst]);
-            std::swap(redirect[i], redirect[dst]);
-            std::swap(permutation[i], permutation[dst]);
-        }
-
         for (uint32_t i = 0; i < N; ++i)
         {
-            merged[i] = uint2(redirect[i], permutation[i]);
+            // Entry i of the builder always refers to item i.
+            float threshold = table.entries[i].threshold;
+            uint32_t redirect = table.entries[i].alias;
 
             // Pack 16-bit threshold (i.e., a half float) plus 2x 24-bit table entries
-            uint32_t prob = (uint32_t(f32tof16(thresholds[i])) << 16u);
-            uint2 lowPrec = uint2(redirect[i] & 0xFFFFFFu, permutation[i] & 0xFFFFFFu);
+            uint32_t prob = (uint32_t(f32tof16(threshold)) << 16u);
+            uint2 lowPrec = uint2(redirect & 0xFFFFFFu, i & 0xFFFFFFu);
             uint2 mergedEntry = uint2(prob | ((lowPrec.x >> 8u) & 0xFFFFu), ((lowPrec.x & 0xFFu) << 24u) | lowPrec.y);
             fullTable[i] = mergedEntry;
         }
 
         AliasTable result
         {
-            float(sum),
+            float(table.weightSum),
             N,
             mpDevice->createTypedBuffer<uint2>(N),
         };
@@ -29,7 +29,6 @@
 #include "EmissiveLightSampler.h"
 #include "Core/Macros.h"
 #include "Scene/Lights/LightCollection.h"
-#include <random>
 #include <vector>
 
 namespace Falcor
@@ -71,15 +70,16 @@ namespace Falcor
 
     protected:
         /** Generate an alias table
-            \param[in] weights  The weights we'd like to sample each entry proportional to
+            \param[in] pWeights Pointer to the first weight. The weights are sampled proportionally.
+            \param[in] count Number of weights.
+            \param[in] stride Stride between weights in bytes.
             \returns The alias table
         */
-        AliasTable generateAliasTable(std::vector<float> weights);
+        AliasTable generateAliasTable(const float* pWeights, size_t count, size_t stride);
 
         // Internal state
         bool                            mNeedsRebuild = true;   ///< Trigger rebuild on the next call to update(). We should always build on the first call, so the initial value is true.
 
-        std::mt19937                    mAliasTableRng;
         AliasTable                      mTriangleTable;
     };
 }
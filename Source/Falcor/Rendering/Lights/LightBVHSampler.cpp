@@ -48,11 +48,13 @@ namespace Falcor
         }
 
         // Check if light collection has changed.
-        if (mLightCollectionUpdateFlags == ILightCollection::UpdateFlags::LayoutChanged)
+        // Flux changes may cull or un-cull triangles and change the node flux, which requires a rebuild.
+        if (is_set(mLightCollectionUpdateFlags, ILightCollection::UpdateFlags::LayoutChanged) ||
+            is_set(mLightCollectionUpdateFlags, ILightCollection::UpdateFlags::FluxChanged))
         {
             mNeedsRebuild = true;
         }
-        else if (mLightCollectionUpdateFlags == ILightCollection::UpdateFlags::MatrixChanged)
+        else if (is_set(mLightCollectionUpdateFlags, ILightCollection::UpdateFlags::MatrixChanged))
         {
             if (mOptions.buildOptions.allowRefitting) needsRefit = true;
             else mNeedsRebuild = true;
@@ -31,6 +31,7 @@
 #include "Utils/Math/Common.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Scene/Transform.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -155,6 +156,29 @@ namespace Falcor
         return transform;
     }
 
+    float4x4 Animation::evaluateKeyframes(fstd::span<const Keyframe> keyframes, double time)
+    {
+        FALCOR_ASSERT(!keyframes.empty());
+
+        // Find the first keyframe after the current time and interpolate from the one before it.
+        auto it = std::upper_bound(keyframes.begin(), keyframes.end(), time, [](double t, const Keyframe& k) { return t < k.time; });
+        Keyframe interpolated;
+        if (it == keyframes.begin()) interpolated = keyframes.front();
+        else if (it == keyframes.end()) interpolated = keyframes.back();
+        else
+        {
+            const Keyframe& k0 = *(it - 1);
+            const Keyframe& k1 = *it;
+            float t = (float)((time - k0.time) / (k1.time - k0.time));
+            interpolated = interpolateLinear(k0, k1, t);
+        }
+
+        float4x4 T = math::matrixFromTranslation(interpolated.translation);
+        float4x4 R = math::matrixFromQuat(interpolated.rotation);
+        float4x4 S = math::matrixFromScaling(interpolated.scaling);
+        return mul(mul(T, R), S);
+    }
+
     Animation::Keyframe Animation::interpolate(InterpolationMode mode, double time) const
     {
         FALCOR_ASSERT(!mKeyframes.empty());
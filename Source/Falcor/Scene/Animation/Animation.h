@@ -155,6 +155,14 @@ namespace Falcor
         */
         float4x4 animate(double currentTime);
 
+        /** Compute the transform for a list of keyframes using linear interpolation and constant behavior outside the keyframe range.
+            This is used for animated instance sets, which store their keyframes in flat arrays instead of one animation per instance.
+            \param[in] keyframes Keyframes sorted by time. Must not be empty.
+            \param[in] time The current time in seconds.
+            \return Returns the transform matrix for the specified time.
+        */
+        static float4x4 evaluateKeyframes(fstd::span<const Keyframe> keyframes, double time);
+
         /* Render the UI.
         */
         void renderUI(Gui::Widgets& widget);
@@ -27,8 +27,12 @@
  **************************************************************************/
 #include "AnimationController.h"
 #include "Core/API/RenderContext.h"
+#include "Utils/Math/BatchTransform.h"
 #include "Utils/Timing/Profiler.h"
+#include "Utils/NumericRange.h"
 #include "Scene/Scene.h"
+#include <algorithm>
+#include <execution>
 #include <fstream>
 
 namespace Falcor
@@ -51,18 +55,30 @@ namespace Falcor
         , mMatricesChanged(pScene->mSceneGraph.size())
         , mpScene(pScene)
     {
+        // Instance sets place their matrices after the scene graph node matrices.
+        size_t matrixCount = mLocalMatrices.size();
+        for (const auto& set : pScene->mInstanceSets)
+        {
+            FALCOR_ASSERT(set.matrixOffset >= mLocalMatrices.size());
+            matrixCount = std::max(matrixCount, (size_t)set.matrixOffset + set.getInstanceCount());
+            mHasAnimatedInstanceSets = mHasAnimatedInstanceSets || set.isAnimated();
+        }
+        mGlobalMatrices.resize(matrixCount);
+        mInvTransposeGlobalMatrices.resize(matrixCount);
+        mMatricesChanged.resize(matrixCount);
+
         // Create GPU resources.
-        FALCOR_ASSERT(mLocalMatrices.size() <= std::numeric_limits<uint32_t>::max());
+        FALCOR_ASSERT(mGlobalMatrices.size() <= std::numeric_limits<uint32_t>::max());
 
-        if (!mLocalMatrices.empty())
+        if (!mGlobalMatrices.empty())
         {
-            mpWorldMatricesBuffer = mpDevice->createStructuredBuffer(sizeof(float4x4), (uint32_t)mLocalMatrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
+            mpWorldMatricesBuffer = mpDevice->createStructuredBuffer(sizeof(float4x4), (uint32_t)mGlobalMatrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
             mpWorldMatricesBuffer->setName("AnimationController::mpWorldMatricesBuffer");
-            mpPrevWorldMatricesBuffer = mpDevice->createStructuredBuffer(sizeof(float4x4), (uint32_t)mLocalMatrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
+            mpPrevWorldMatricesBuffer = mpDevice->createStructuredBuffer(sizeof(float4x4), (uint32_t)mGlobalMatrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
             mpPrevWorldMatricesBuffer->setName("AnimationController::mpPrevWorldMatricesBuffer");
-            mpInvTransposeWorldMatricesBuffer = mpDevice->createStructuredBuffer(sizeof(float4x4), (uint32_t)mLocalMatrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
+            mpInvTransposeWorldMatricesBuffer = mpDevice->createStructuredBuffer(sizeof(float4x4), (uint32_t)mGlobalMatrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
             mpInvTransposeWorldMatricesBuffer->setName("AnimationController::mpInvTransposeWorldMatricesBuffer");
-            mpPrevInvTransposeWorldMatricesBuffer = mpDevice->createStructuredBuffer(sizeof(float4x4), (uint32_t)mLocalMatrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
+            mpPrevInvTransposeWorldMatricesBuffer = mpDevice->createStructuredBuffer(sizeof(float4x4), (uint32_t)mGlobalMatrices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
             mpPrevInvTransposeWorldMatricesBuffer->setName("AnimationController::mpPrevInvTransposeWorldMatricesBuffer");
         }
 
@@ -91,6 +107,10 @@ namespace Falcor
         {
             mGlobalAnimationLength = std::max(mGlobalAnimationLength, pAnimation->getDuration());
         }
+        for (const auto& set : pScene->mInstanceSets)
+        {
+            for (const auto& keyframe : set.keyframes) mGlobalAnimationLength = std::max(mGlobalAnimationLength, keyframe.time);
+        }
     }
 
     void AnimationController::addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes)
@@ -190,6 +210,7 @@ namespace Falcor
         {
             mLocalMatrices[i] = mpScene->mSceneGraph[i].transform;
         }
+        mInstanceSetTime = 0.0;
     }
 
     bool AnimationController::animate(RenderContext* pRenderContext, double currentTime)
@@ -230,7 +251,7 @@ namespace Falcor
             updateWorldMatrices(true);
             uploadWorldMatrices(true);
 
-            if (!sceneGraph.empty())
+            if (!mGlobalMatrices.empty())
             {
                 FALCOR_ASSERT(mpWorldMatricesBuffer && mpPrevWorldMatricesBuffer);
                 FALCOR_ASSERT(mpInvTransposeWorldMatricesBuffer && mpPrevInvTransposeWorldMatricesBuffer);
@@ -298,13 +319,20 @@ namespace Falcor
             mLocalMatrices[nodeID.get()] = pAnimation->animate(time);
             mMatricesChanged[nodeID.get()] = true;
         }
+
+        // Animated instance sets are evaluated at this time when their world matrices are updated.
+        mInstanceSetTime = time;
+        for (const auto& set : mpScene->mInstanceSets)
+        {
+            if (set.isAnimated()) std::fill_n(mMatricesChanged.begin() + set.matrixOffset, set.getInstanceCount(), true);
+        }
     }
 
     void AnimationController::updateWorldMatrices(bool updateAll)
     {
         const auto& sceneGraph = mpScene->mSceneGraph;
 
-        for (size_t i = 0; i < mGlobalMatrices.size(); i++)
+        for (size_t i = 0; i < sceneGraph.size(); i++)
         {
             // Propagate matrix change flag to children.
             if (sceneGraph[i].parent != NodeID::Invalid())
@@ -321,14 +349,55 @@ namespace Falcor
                 mGlobalMatrices[i] = mul(mGlobalMatrices[sceneGraph[i].parent.get()], mGlobalMatrices[i]);
             }
 
-            mInvTransposeGlobalMatrices[i] = transpose(inverse(mGlobalMatrices[i]));
-
             if (mpSkinningPass)
             {
                 mSkinningMatrices[i] = mul(mGlobalMatrices[i], sceneGraph[i].localToBindSpace);
-                mInvTransposeSkinningMatrices[i] = transpose(inverse(mSkinningMatrices[i]));
             }
         }
+
+        // Compute the inverse transposes of ranges of updated matrices in batches. Both full and partial updates use
+        // the same kernel, so the results don't depend on which path ran.
+        for (size_t i = 0; i < sceneGraph.size();)
+        {
+            size_t offset = i;
+            bool changed = updateAll || mMatricesChanged[i];
+            while (i < sceneGraph.size() && (updateAll || mMatricesChanged[i]) == changed) ++i;
+            if (!changed) continue;
+
+            size_t count = i - offset;
+            inverseTransposeAffine(&mGlobalMatrices[offset], &mInvTransposeGlobalMatrices[offset], count);
+            if (mpSkinningPass)
+            {
+                inverseTransposeAffine(&mSkinningMatrices[offset], &mInvTransposeSkinningMatrices[offset], count);
+            }
+        }
+
+        updateInstanceSetMatrices(updateAll);
+    }
+
+    void AnimationController::updateInstanceSetMatrices(bool updateAll)
+    {
+        // The world matrix of each instance in a set is computed directly from the parent node's global matrix,
+        // so this runs after the scene graph nodes are updated.
+        for (const auto& set : mpScene->mInstanceSets)
+        {
+            const size_t offset = set.matrixOffset;
+            const uint32_t count = set.getInstanceCount();
+            FALCOR_ASSERT(count > 0 && offset + count <= mGlobalMatrices.size());
+
+            bool parentChanged = set.parent != NodeID::Invalid() && mMatricesChanged[set.parent.get()];
+            if (!updateAll && !parentChanged && !mMatricesChanged[offset]) continue;
+
+            const float4x4 parentMatrix = set.parent != NodeID::Invalid() ? mGlobalMatrices[set.parent.get()] : float4x4::identity();
+            auto range = NumericRange<uint32_t>(0, count);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t i)
+            {
+                float4x4 transform = set.isAnimated() ? Animation::evaluateKeyframes(set.getKeyframes(i), mInstanceSetTime) : set.transforms[i];
+                mGlobalMatrices[offset + i] = mul(parentMatrix, mul(transform, set.meshTransform));
+            });
+            inverseTransposeAffine(&mGlobalMatrices[offset], &mInvTransposeGlobalMatrices[offset], count);
+            std::fill_n(mMatricesChanged.begin() + offset, count, true);
+        }
     }
 
     void AnimationController::uploadWorldMatrices(bool uploadAll)
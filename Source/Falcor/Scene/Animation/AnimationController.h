@@ -60,7 +60,7 @@ namespace Falcor
 
         /** Returns true if controller contains animations.
         */
-        bool hasAnimations() const { return mAnimations.size() > 0 || hasAnimatedVertexCaches(); }
+        bool hasAnimations() const { return mAnimations.size() > 0 || mHasAnimatedInstanceSets || hasAnimatedVertexCaches(); }
 
         /** Returns true if controller is handling any skinned meshes.
         */
@@ -118,7 +118,8 @@ namespace Falcor
         const std::vector<float4x4>& getLocalMatrices() const { return mLocalMatrices; }
 
         /** Get the global matrices.
-            These represent the current object-to-world space transform for each scene graph node.
+            These represent the current object-to-world space transform for each scene graph node,
+            followed by the transforms of the instances in the scene's instance sets.
         */
         const std::vector<float4x4>& getGlobalMatrices() const { return mGlobalMatrices; }
 
@@ -151,6 +152,7 @@ namespace Falcor
         void initLocalMatrices();
         void updateLocalMatrices(double time);
         void updateWorldMatrices(bool updateAll = false);
+        void updateInstanceSetMatrices(bool updateAll);
         void uploadWorldMatrices(bool uploadAll = false);
 
         void bindBuffers();
@@ -173,6 +175,8 @@ namespace Falcor
         bool mPrevEnabled = false;      ///< True if animations were enabled in previous frame.
         double mTime = 0.0;             ///< Global time of current frame.
         double mPrevTime = 0.0;         ///< Global time of previous frame.
+        double mInstanceSetTime = 0.0;  ///< Time at which the animated instance sets are evaluated.
+        bool mHasAnimatedInstanceSets = false; ///< True if any instance set has keyframes.
 
         bool mLoopAnimations = true;
         double mGlobalAnimationLength = 0;
@@ -0,0 +1,684 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CpuRayQuery.h"
+#include "Scene.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Timing/TimeReport.h"
+
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <functional>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FALCOR_CPU_RAY_QUERY_SSE 1
+#include <emmintrin.h>
+#else
+#define FALCOR_CPU_RAY_QUERY_SSE 0
+#endif
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kMaxBinCount = 32;
+        const uint32_t kMaxSAHDepth = 48;   ///< Binary split depth after which median splits are used. Bounds the traversal stack size.
+        const uint32_t kStackSize = 256;
+        const uint32_t kMaxTrianglesPerLeaf = 4;
+        const size_t kRaysPerTask = 64;     ///< Number of rays traced sequentially by one parallel task.
+
+        // Minimal 4-wide float vector used for the box and triangle tests.
+#if FALCOR_CPU_RAY_QUERY_SSE
+        struct Float4
+        {
+            __m128 v;
+
+            Float4() = default;
+            Float4(__m128 v_) : v(v_) {}
+            explicit Float4(float s) : v(_mm_set1_ps(s)) {}
+
+            static Float4 load(const float* p) { return _mm_load_ps(p); }
+            void store(float* p) const { _mm_store_ps(p, v); }
+        };
+
+        inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+        inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+        inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+        inline Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+        inline Float4 min4(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+        inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+        inline int maskLE(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmple_ps(a.v, b.v)); }
+        inline int maskGE(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmpge_ps(a.v, b.v)); }
+        inline int maskNE(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmpneq_ps(a.v, b.v)); }
+#else
+        struct Float4
+        {
+            float v[4];
+
+            Float4() = default;
+            explicit Float4(float s) : v{s, s, s, s} {}
+
+            static Float4 load(const float* p) { Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = p[i]; return r; }
+            void store(float* p) const { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+        };
+
+        template<typename Op>
+        inline Float4 apply4(Float4 a, Float4 b, Op op) { Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = op(a.v[i], b.v[i]); return r; }
+        template<typename Op>
+        inline int mask4(Float4 a, Float4 b, Op op) { int m = 0; for (int i = 0; i < 4; ++i) m |= op(a.v[i], b.v[i]) ? (1 << i) : 0; return m; }
+
+        inline Float4 operator+(Float4 a, Float4 b) { return apply4(a, b, [](float x, float y) { return x + y; }); }
+        inline Float4 operator-(Float4 a, Float4 b) { return apply4(a, b, [](float x, float y) { return x - y; }); }
+        inline Float4 operator*(Float4 a, Float4 b) { return apply4(a, b, [](float x, float y) { return x * y; }); }
+        inline Float4 operator/(Float4 a, Float4 b) { return apply4(a, b, [](float x, float y) { return x / y; }); }
+        inline Float4 min4(Float4 a, Float4 b) { return apply4(a, b, [](float x, float y) { return x < y ? x : y; }); }
+        inline Float4 max4(Float4 a, Float4 b) { return apply4(a, b, [](float x, float y) { return x > y ? x : y; }); }
+        inline int maskLE(Float4 a, Float4 b) { return mask4(a, b, [](float x, float y) { return x <= y; }); }
+        inline int maskGE(Float4 a, Float4 b) { return mask4(a, b, [](float x, float y) { return x >= y; }); }
+        inline int maskNE(Float4 a, Float4 b) { return mask4(a, b, [](float x, float y) { return x != y; }); }
+#endif
+
+        /** Ray broadcast to all four lanes.
+        */
+        struct Ray4
+        {
+            Float4 ox, oy, oz;
+            Float4 dx, dy, dz;
+            Float4 idx, idy, idz;
+
+            Ray4(const Ray& ray)
+                : ox(ray.origin.x), oy(ray.origin.y), oz(ray.origin.z)
+                , dx(ray.dir.x), dy(ray.dir.y), dz(ray.dir.z)
+                , idx(1.f / ray.dir.x), idy(1.f / ray.dir.y), idz(1.f / ray.dir.z)
+            {}
+        };
+
+        /** Intersect the ray with the four child boxes of a node (slab test).
+            Returns a bit mask of the boxes that are hit in [tMin, tMax] and their entry distances.
+        */
+        template<typename Node>
+        inline int intersectBoxes(const Node& node, const Ray4& r, float tMin, float tMax, float tEnter[4])
+        {
+            Float4 t0x = (Float4::load(node.minX) - r.ox) * r.idx;
+            Float4 t1x = (Float4::load(node.maxX) - r.ox) * r.idx;
+            Float4 t0y = (Float4::load(node.minY) - r.oy) * r.idy;
+            Float4 t1y = (Float4::load(node.maxY) - r.oy) * r.idy;
+            Float4 t0z = (Float4::load(node.minZ) - r.oz) * r.idz;
+            Float4 t1z = (Float4::load(node.maxZ) - r.oz) * r.idz;
+
+            Float4 enter = max4(max4(min4(t0x, t1x), min4(t0y, t1y)), max4(min4(t0z, t1z), Float4(tMin)));
+            Float4 exit = min4(min4(max4(t0x, t1x), max4(t0y, t1y)), min4(max4(t0z, t1z), Float4(tMax)));
+            enter.store(tEnter);
+            return maskLE(enter, exit);
+        }
+
+        /** Intersect the ray with four triangles (Moller-Trumbore).
+            Returns a bit mask of the triangles that are hit in [tMin, tMax] along with distances and barycentrics.
+        */
+        template<typename Triangle>
+        inline int intersectTriangles(const Triangle& tri, const Ray4& r, float tMin, float tMax, float t[4], float u[4], float v[4])
+        {
+            Float4 e1x = Float4::load(tri.e1x), e1y = Float4::load(tri.e1y), e1z = Float4::load(tri.e1z);
+            Float4 e2x = Float4::load(tri.e2x), e2y = Float4::load(tri.e2y), e2z = Float4::load(tri.e2z);
+
+            // p = cross(dir, e2)
+            Float4 px = r.dy * e2z - r.dz * e2y;
+            Float4 py = r.dz * e2x - r.dx * e2z;
+            Float4 pz = r.dx * e2y - r.dy * e2x;
+            Float4 det = e1x * px + e1y * py + e1z * pz;
+            Float4 invDet = Float4(1.f) / det;
+
+            // s = origin - v0
+            Float4 sx = r.ox - Float4::load(tri.v0x);
+            Float4 sy = r.oy - Float4::load(tri.v0y);
+            Float4 sz = r.oz - Float4::load(tri.v0z);
+            Float4 bu = (sx * px + sy * py + sz * pz) * invDet;
+
+            // q = cross(s, e1)
+            Float4 qx = sy * e1z - sz * e1y;
+            Float4 qy = sz * e1x - sx * e1z;
+            Float4 qz = sx * e1y - sy * e1x;
+            Float4 bv = (r.dx * qx + r.dy * qy + r.dz * qz) * invDet;
+            Float4 bt = (e2x * qx + e2y * qy + e2z * qz) * invDet;
+
+            int mask = maskNE(det, Float4(0.f));
+            mask &= maskGE(bu, Float4(0.f)) & maskGE(bv, Float4(0.f)) & maskLE(bu + bv, Float4(1.f));
+            mask &= maskGE(bt, Float4(tMin)) & maskLE(bt, Float4(tMax));
+
+            bt.store(t);
+            bu.store(u);
+            bv.store(v);
+            return mask;
+        }
+    }
+
+    CpuRayQuery::CpuRayQuery(std::vector<MeshDesc> meshes, std::vector<InstanceDesc> instances, const Options& options)
+        : mOptions(options)
+    {
+        build(std::move(meshes), std::move(instances));
+    }
+
+    CpuRayQuery::CpuRayQuery(const Scene& scene, const Options& options)
+        : mOptions(options)
+    {
+        const auto& staticData = scene.getMeshStaticData();
+        const auto& indexData = scene.getMeshIndexData();
+
+        // Fetch the positions and indices of all meshes.
+        std::vector<MeshDesc> meshes(scene.getMeshCount());
+        auto range = NumericRange<uint32_t>(0, scene.getMeshCount());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t meshIndex)
+        {
+            const auto& desc = scene.getMesh(MeshID(meshIndex));
+            MeshDesc& mesh = meshes[meshIndex];
+
+            mesh.positions.resize(desc.vertexCount);
+            if (scene.hasQuantizedVertices())
+            {
+                for (uint32_t i = 0; i < desc.vertexCount; ++i)
+                    mesh.positions[i] = scene.getMeshVertex(MeshID(meshIndex), i).position;
+            }
+            else
+            {
+                for (uint32_t i = 0; i < desc.vertexCount; ++i)
+                    mesh.positions[i] = staticData[(size_t)desc.vbOffset + i].position;
+            }
+
+            if (desc.useVertexIndices())
+            {
+                const uint8_t* indexData8 = reinterpret_cast<const uint8_t*>(&indexData[desc.ibOffset]);
+                mesh.indices.resize(desc.indexCount);
+                for (uint32_t i = 0; i < desc.indexCount; ++i)
+                {
+                    mesh.indices[i] = desc.use16BitIndices()
+                        ? reinterpret_cast<const uint16_t*>(indexData8)[i]
+                        : reinterpret_cast<const uint32_t*>(indexData8)[i];
+                }
+            }
+        });
+
+        // Gather the triangle mesh instances using the current transforms.
+        const auto& globalMatrices = scene.getAnimationController()->getGlobalMatrices();
+        std::vector<InstanceDesc> instances;
+        for (uint32_t instanceID = 0; instanceID < scene.getGeometryInstanceCount(); ++instanceID)
+        {
+            const auto& instance = scene.getGeometryInstance(instanceID);
+            if (instance.getType() != GeometryType::TriangleMesh) continue;
+            instances.push_back({ instance.geometryID, instanceID, globalMatrices[instance.globalMatrixID] });
+        }
+
+        build(std::move(meshes), std::move(instances));
+    }
+
+    CpuRayQuery::Hit CpuRayQuery::traceRay(const Ray& ray) const
+    {
+        Hit hit;
+        hit.t = ray.tMax;
+        if (!traceTLAS<false>(ray, hit)) return Hit();
+        return hit;
+    }
+
+    bool CpuRayQuery::traceVisibilityRay(const Ray& ray) const
+    {
+        Hit hit;
+        hit.t = ray.tMax;
+        return traceTLAS<true>(ray, hit);
+    }
+
+    void CpuRayQuery::traceRays(const Ray* rays, Hit* hits, size_t count) const
+    {
+        auto range = NumericRange<size_t>(0, (count + kRaysPerTask - 1) / kRaysPerTask);
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t task)
+        {
+            size_t end = std::min(count, (task + 1) * kRaysPerTask);
+            for (size_t i = task * kRaysPerTask; i < end; ++i) hits[i] = traceRay(rays[i]);
+        });
+    }
+
+    void CpuRayQuery::traceVisibilityRays(const Ray* rays, bool* visible, size_t count) const
+    {
+        auto range = NumericRange<size_t>(0, (count + kRaysPerTask - 1) / kRaysPerTask);
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t task)
+        {
+            size_t end = std::min(count, (task + 1) * kRaysPerTask);
+            for (size_t i = task * kRaysPerTask; i < end; ++i) visible[i] = !traceVisibilityRay(rays[i]);
+        });
+    }
+
+    void CpuRayQuery::setInstanceTransforms(const std::vector<float4x4>& transforms)
+    {
+        FALCOR_CHECK(transforms.size() == mInstances.size(), "Expected {} transforms, got {}.", mInstances.size(), transforms.size());
+        buildTLAS(transforms);
+    }
+
+    CpuRayQuery::BVH4 CpuRayQuery::buildBVH4(const std::vector<AABB>& primBounds, uint32_t maxLeafSize, const Options& options)
+    {
+        BVH4 bvh;
+        const uint32_t primCount = (uint32_t)primBounds.size();
+        if (primCount == 0) return bvh;
+
+        bvh.primitives.resize(primCount);
+        std::iota(bvh.primitives.begin(), bvh.primitives.end(), 0);
+
+        std::vector<float3> centroids(primCount);
+        for (uint32_t i = 0; i < primCount; ++i) centroids[i] = primBounds[i].center();
+
+        const uint32_t binCount = std::clamp(options.binCount, 2u, kMaxBinCount);
+
+        struct Range
+        {
+            uint32_t begin;
+            uint32_t end;
+            uint32_t depth;
+            AABB bounds;
+
+            uint32_t count() const { return end - begin; }
+        };
+
+        auto computeBounds = [&](uint32_t begin, uint32_t end)
+        {
+            AABB bounds;
+            for (uint32_t i = begin; i < end; ++i) bounds.include(primBounds[bvh.primitives[i]]);
+            return bounds;
+        };
+
+        // Split a range in two using binned SAH. Returns the split position in ]begin, end[.
+        auto split = [&](const Range& range) -> uint32_t
+        {
+            const uint32_t median = range.begin + range.count() / 2;
+            if (range.depth >= kMaxSAHDepth) return median;
+
+            AABB centroidBounds;
+            for (uint32_t i = range.begin; i < range.end; ++i) centroidBounds.include(centroids[bvh.primitives[i]]);
+            const float3 extent = centroidBounds.extent();
+
+            auto getBin = [&](uint32_t prim, int axis, float scale)
+            {
+                float offset = (centroids[prim][axis] - centroidBounds.minPoint[axis]) * scale;
+                return std::min((uint32_t)offset, binCount - 1);
+            };
+
+            float bestCost = std::numeric_limits<float>::infinity();
+            int bestAxis = -1;
+            uint32_t bestBin = 0;
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (!(extent[axis] > 0.f)) continue;
+                const float scale = binCount / extent[axis];
+
+                std::array<AABB, kMaxBinCount> binBounds;
+                std::array<uint32_t, kMaxBinCount> binCounts = {};
+                for (uint32_t i = range.begin; i < range.end; ++i)
+                {
+                    uint32_t prim = bvh.primitives[i];
+                    uint32_t bin = getBin(prim, axis, scale);
+                    binBounds[bin].include(primBounds[prim]);
+                    binCounts[bin]++;
+                }
+
+                // Sweep from the right to compute the cost of the right side of each split.
+                std::array<float, kMaxBinCount> rightArea;
+                std::array<uint32_t, kMaxBinCount> rightCount;
+                AABB accBounds;
+                uint32_t accCount = 0;
+                for (uint32_t bin = binCount - 1; bin > 0; --bin)
+                {
+                    accBounds.include(binBounds[bin]);
+                    accCount += binCounts[bin];
+                    rightArea[bin] = accBounds.valid() ? accBounds.area() : 0.f;
+                    rightCount[bin] = accCount;
+                }
+
+                // Sweep from the left and evaluate the split after each bin.
+                accBounds.invalidate();
+                accCount = 0;
+                for (uint32_t bin = 0; bin < binCount - 1; ++bin)
+                {
+                    accBounds.include(binBounds[bin]);
+                    accCount += binCounts[bin];
+                    if (accCount == 0 || rightCount[bin + 1] == 0) continue;
+                    float cost = accBounds.area() * accCount + rightArea[bin + 1] * rightCount[bin + 1];
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestBin = bin;
+                    }
+                }
+            }
+
+            // All centroids coincide, split in the middle.
+            if (bestAxis < 0) return median;
+
+            const float scale = binCount / extent[bestAxis];
+            auto it = std::partition(bvh.primitives.begin() + range.begin, bvh.primitives.begin() + range.end,
+                [&](uint32_t prim) { return getBin(prim, bestAxis, scale) <= bestBin; });
+            uint32_t mid = (uint32_t)(it - bvh.primitives.begin());
+            return (mid == range.begin || mid == range.end) ? median : mid;
+        };
+
+        // Recursively build 4-wide nodes. Each node is created by splitting the range
+        // into up to four children, always splitting the child with the largest surface area.
+        std::function<uint32_t(const Range&)> buildNode = [&](const Range& range) -> uint32_t
+        {
+            if (range.count() <= maxLeafSize)
+            {
+                uint32_t leafIndex = (uint32_t)bvh.leaves.size();
+                bvh.leaves.push_back({ range.begin, range.count() });
+                return kLeafFlag | leafIndex;
+            }
+
+            std::array<Range, 4> children;
+            children[0] = range;
+            uint32_t childCount = 1;
+            while (childCount < 4)
+            {
+                int best = -1;
+                float bestArea = -1.f;
+                for (uint32_t i = 0; i < childCount; ++i)
+                {
+                    if (children[i].count() > maxLeafSize && children[i].bounds.area() > bestArea)
+                    {
+                        best = (int)i;
+                        bestArea = children[i].bounds.area();
+                    }
+                }
+                if (best < 0) break;
+
+                Range r = children[best];
+                uint32_t mid = split(r);
+                children[best] = { r.begin, mid, r.depth + 1, computeBounds(r.begin, mid) };
+                children[childCount++] = { mid, r.end, r.depth + 1, computeBounds(mid, r.end) };
+            }
+
+            uint32_t nodeIndex = (uint32_t)bvh.nodes.size();
+            bvh.nodes.emplace_back();
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                uint32_t childRef = i < childCount ? buildNode(children[i]) : kInvalidIndex;
+                AABB bounds = i < childCount ? children[i].bounds : AABB(float3(std::numeric_limits<float>::infinity()));
+
+                // Note: The node is fetched after building the child since the node list may have been reallocated.
+                Node4& node = bvh.nodes[nodeIndex];
+                node.minX[i] = bounds.minPoint.x;
+                node.minY[i] = bounds.minPoint.y;
+                node.minZ[i] = bounds.minPoint.z;
+                node.maxX[i] = bounds.maxPoint.x;
+                node.maxY[i] = bounds.maxPoint.y;
+                node.maxZ[i] = bounds.maxPoint.z;
+                node.child[i] = childRef;
+            }
+            return nodeIndex;
+        };
+
+        bvh.root = buildNode({ 0, primCount, 0, computeBounds(0, primCount) });
+        return bvh;
+    }
+
+    void CpuRayQuery::build(std::vector<MeshDesc> meshes, std::vector<InstanceDesc> instances)
+    {
+        TimeReport timeReport;
+
+        // Build one BLAS per mesh.
+        mBLAS.resize(meshes.size());
+        mMeshBounds.resize(meshes.size());
+
+        auto buildBLAS = [&](uint32_t meshIndex)
+        {
+            const MeshDesc& mesh = meshes[meshIndex];
+            const bool indexed = !mesh.indices.empty();
+            const uint32_t triangleCount = (uint32_t)((indexed ? mesh.indices.size() : mesh.positions.size()) / 3);
+
+            auto getVertex = [&](uint32_t triangleIndex, uint32_t vertex)
+            {
+                uint32_t index = triangleIndex * 3 + vertex;
+                return mesh.positions[indexed ? mesh.indices[index] : index];
+            };
+
+            std::vector<AABB> primBounds(triangleCount);
+            AABB meshBounds;
+            for (uint32_t i = 0; i < triangleCount; ++i)
+            {
+                primBounds[i] = AABB(getVertex(i, 0)).include(getVertex(i, 1)).include(getVertex(i, 2));
+                meshBounds.include(primBounds[i]);
+            }
+
+            BLAS& blas = mBLAS[meshIndex];
+            blas.bvh = buildBVH4(primBounds, kMaxTrianglesPerLeaf, mOptions);
+            mMeshBounds[meshIndex] = meshBounds;
+
+            // Store one triangle packet per leaf.
+            blas.triangles.resize(blas.bvh.leaves.size());
+            for (size_t leafIndex = 0; leafIndex < blas.bvh.leaves.size(); ++leafIndex)
+            {
+                const Leaf& leaf = blas.bvh.leaves[leafIndex];
+                Triangle4& tri = blas.triangles[leafIndex];
+                for (uint32_t lane = 0; lane < 4; ++lane)
+                {
+                    float3 v0(0.f), e1(0.f), e2(0.f);
+                    uint32_t primitiveIndex = kInvalidIndex;
+                    if (lane < leaf.count)
+                    {
+                        primitiveIndex = blas.bvh.primitives[leaf.first + lane];
+                        v0 = getVertex(primitiveIndex, 0);
+                        e1 = getVertex(primitiveIndex, 1) - v0;
+                        e2 = getVertex(primitiveIndex, 2) - v0;
+                    }
+                    tri.v0x[lane] = v0.x; tri.v0y[lane] = v0.y; tri.v0z[lane] = v0.z;
+                    tri.e1x[lane] = e1.x; tri.e1y[lane] = e1.y; tri.e1z[lane] = e1.z;
+                    tri.e2x[lane] = e2.x; tri.e2y[lane] = e2.y; tri.e2z[lane] = e2.z;
+                    tri.primitiveIndex[lane] = primitiveIndex;
+                }
+            }
+
+            // The triangle packets hold all data needed for traversal.
+            blas.bvh.primitives.clear();
+            blas.bvh.primitives.shrink_to_fit();
+        };
+
+        auto range = NumericRange<uint32_t>(0, (uint32_t)meshes.size());
+        if (mOptions.parallelBuild) std::for_each(std::execution::par, range.begin(), range.end(), buildBLAS);
+        else std::for_each(range.begin(), range.end(), buildBLAS);
+        timeReport.measure("Building BLASes");
+
+        // Build the TLAS.
+        std::vector<float4x4> transforms(instances.size());
+        mInstances.resize(instances.size());
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            FALCOR_CHECK(instances[i].meshIndex < meshes.size(), "Instance {} references invalid mesh {}.", i, instances[i].meshIndex);
+            mInstances[i].meshIndex = instances[i].meshIndex;
+            mInstances[i].instanceID = instances[i].instanceID;
+            transforms[i] = instances[i].transform;
+        }
+        buildTLAS(transforms);
+        timeReport.measure("Building TLAS");
+
+        // Compute stats.
+        mStats = {};
+        mStats.meshCount = (uint32_t)mBLAS.size();
+        mStats.instanceCount = (uint32_t)mInstances.size();
+        for (const auto& blas : mBLAS)
+        {
+            mStats.blasNodeCount += blas.bvh.nodes.size();
+            mStats.blasLeafCount += blas.bvh.leaves.size();
+            for (const auto& tri : blas.triangles)
+                for (uint32_t lane = 0; lane < 4; ++lane) mStats.triangleCount += tri.primitiveIndex[lane] != kInvalidIndex ? 1 : 0;
+            mStats.memoryInBytes += blas.bvh.nodes.size() * sizeof(Node4) + blas.bvh.leaves.size() * sizeof(Leaf) + blas.triangles.size() * sizeof(Triangle4);
+        }
+        mStats.memoryInBytes += mTLAS.nodes.size() * sizeof(Node4) + mTLAS.leaves.size() * sizeof(Leaf) + mTLAS.primitives.size() * sizeof(uint32_t);
+        mStats.memoryInBytes += mInstances.size() * sizeof(Instance);
+
+        logDebug("CpuRayQuery: Built {} BLASes with {} triangles and a TLAS with {} instances ({} bytes).",
+            mStats.meshCount, mStats.triangleCount, mStats.instanceCount, mStats.memoryInBytes);
+        timeReport.printToLog();
+    }
+
+    void CpuRayQuery::buildTLAS(const std::vector<float4x4>& transforms)
+    {
+        FALCOR_ASSERT(transforms.size() == mInstances.size());
+
+        // Only instances of non-empty meshes are added to the TLAS.
+        std::vector<AABB> primBounds;
+        std::vector<uint32_t> instanceIndices;
+        mBounds.invalidate();
+        for (size_t i = 0; i < mInstances.size(); ++i)
+        {
+            Instance& instance = mInstances[i];
+            instance.worldToObject = inverse(transforms[i]);
+
+            const AABB& meshBounds = mMeshBounds[instance.meshIndex];
+            if (!meshBounds.valid()) continue;
+
+            AABB bounds = meshBounds.transform(transforms[i]);
+            primBounds.push_back(bounds);
+            instanceIndices.push_back((uint32_t)i);
+            mBounds.include(bounds);
+        }
+
+        mTLAS = buildBVH4(primBounds, 1, mOptions);
+        for (auto& prim : mTLAS.primitives) prim = instanceIndices[prim];
+        mStats.tlasNodeCount = (uint32_t)mTLAS.nodes.size();
+    }
+
+    template<bool kAnyHit>
+    bool CpuRayQuery::traceBLAS(const BLAS& blas, const Ray& ray, Hit& hit, uint32_t instanceID) const
+    {
+        if (blas.bvh.root == kInvalidIndex) return false;
+
+        const Ray4 ray4(ray);
+        uint32_t stack[kStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = blas.bvh.root;
+        bool found = false;
+
+        while (stackSize > 0)
+        {
+            uint32_t ref = stack[--stackSize];
+
+            if (ref & kLeafFlag)
+            {
+                const Triangle4& tri = blas.triangles[ref & ~kLeafFlag];
+                float t[4], u[4], v[4];
+                int mask = intersectTriangles(tri, ray4, ray.tMin, hit.t, t, u, v);
+                for (uint32_t lane = 0; lane < 4; ++lane)
+                {
+                    if (!(mask & (1 << lane)) || t[lane] > hit.t) continue;
+                    hit.t = t[lane];
+                    hit.barycentrics = float2(u[lane], v[lane]);
+                    hit.instanceID = instanceID;
+                    hit.primitiveIndex = tri.primitiveIndex[lane];
+                    found = true;
+                    if (kAnyHit) return true;
+                }
+                continue;
+            }
+
+            const Node4& node = blas.bvh.nodes[ref];
+            float tEnter[4];
+            int mask = intersectBoxes(node, ray4, ray.tMin, hit.t, tEnter);
+
+            // Push the hit children so that the closest child is popped first.
+            uint32_t order[4];
+            uint32_t hitCount = 0;
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                if (!(mask & (1 << i)) || node.child[i] == kInvalidIndex) continue;
+                uint32_t j = hitCount++;
+                while (j > 0 && tEnter[order[j - 1]] < tEnter[i]) { order[j] = order[j - 1]; --j; }
+                order[j] = i;
+            }
+            FALCOR_ASSERT(stackSize + hitCount <= kStackSize);
+            for (uint32_t i = 0; i < hitCount; ++i) stack[stackSize++] = node.child[order[i]];
+        }
+
+        return found;
+    }
+
+    template<bool kAnyHit>
+    bool CpuRayQuery::traceTLAS(const Ray& ray, Hit& hit) const
+    {
+        if (mTLAS.root == kInvalidIndex) return false;
+
+        const Ray4 ray4(ray);
+        uint32_t stack[kStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = mTLAS.root;
+        bool found = false;
+
+        while (stackSize > 0)
+        {
+            uint32_t ref = stack[--stackSize];
+
+            if (ref & kLeafFlag)
+            {
+                const Leaf& leaf = mTLAS.leaves[ref & ~kLeafFlag];
+                for (uint32_t i = leaf.first; i < leaf.first + leaf.count; ++i)
+                {
+                    const Instance& instance = mInstances[mTLAS.primitives[i]];
+
+                    // Transform the ray to object space. The direction is not normalized so that hit distances are preserved.
+                    Ray objectRay;
+                    objectRay.origin = transformPoint(instance.worldToObject, ray.origin);
+                    objectRay.dir = transformVector(instance.worldToObject, ray.dir);
+                    objectRay.tMin = ray.tMin;
+                    objectRay.tMax = hit.t;
+
+                    if (traceBLAS<kAnyHit>(mBLAS[instance.meshIndex], objectRay, hit, instance.instanceID))
+                    {
+                        found = true;
+                        if (kAnyHit) return true;
+                    }
+                }
+                continue;
+            }
+
+            const Node4& node = mTLAS.nodes[ref];
+            float tEnter[4];
+            int mask = intersectBoxes(node, ray4, ray.tMin, hit.t, tEnter);
+
+            uint32_t order[4];
+            uint32_t hitCount = 0;
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                if (!(mask & (1 << i)) || node.child[i] == kInvalidIndex) continue;
+                uint32_t j = hitCount++;
+                while (j > 0 && tEnter[order[j - 1]] < tEnter[i]) { order[j] = order[j - 1]; --j; }
+                order[j] = i;
+            }
+            FALCOR_ASSERT(stackSize + hitCount <= kStackSize);
+            for (uint32_t i = 0; i < hitCount; ++i) stack[stackSize++] = node.child[order[i]];
+        }
+
+        return found;
+    }
+}
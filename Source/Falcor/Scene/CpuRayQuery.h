@@ -0,0 +1,234 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Ray.h"
+#include "Utils/Math/Vector.h"
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+    class Scene;
+
+    /** CPU ray query engine for triangle geometry.
+
+        The geometry is organized in a two-level hierarchy: one 4-wide BVH per mesh
+        in object space (BLAS), and one 4-wide BVH over all mesh instances in world
+        space (TLAS). Nodes store the bounds of their four children in SoA layout and
+        leaves store up to four triangles in SoA layout, so that box and triangle tests
+        are done four at a time (using SSE when available, with a scalar fallback).
+        The BLASes are built with a binned SAH builder, in parallel over meshes.
+
+        The query engine can be created from a Scene, in which case the mesh data
+        (meshStaticData/meshIndexData) and the current instance transforms are used.
+        This is useful for picking and for validating GPU results on the CPU.
+        It can also be created from user supplied meshes, which allows CPU reference
+        renders in headless unit tests.
+
+        Vertex animations and skinning are not taken into account. Instance transforms
+        can be updated with setInstanceTransforms(), which only rebuilds the TLAS.
+    */
+    class FALCOR_API CpuRayQuery
+    {
+    public:
+        static constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+        struct Options
+        {
+            uint32_t binCount = 16;         ///< Number of bins used for the SAH split search.
+            bool parallelBuild = true;      ///< Build the BLASes in parallel.
+        };
+
+        /** Triangle mesh in object space.
+        */
+        struct MeshDesc
+        {
+            std::vector<float3> positions;  ///< Vertex positions.
+            std::vector<uint32_t> indices;  ///< Triangle list vertex indices. If empty, the positions are a non-indexed triangle list.
+        };
+
+        /** Instance of a mesh.
+        */
+        struct InstanceDesc
+        {
+            uint32_t meshIndex = 0;                 ///< Index of the instanced mesh.
+            uint32_t instanceID = 0;                ///< User defined ID returned in hits.
+            float4x4 transform = float4x4::identity(); ///< Object-to-world transform.
+        };
+
+        /** Ray hit information.
+        */
+        struct Hit
+        {
+            float t = std::numeric_limits<float>::infinity(); ///< Hit distance along the ray.
+            float2 barycentrics = float2(0.f);      ///< Barycentrics (u, v) of vertices 1 and 2 of the hit triangle.
+            uint32_t instanceID = kInvalidIndex;    ///< Instance ID of the hit instance.
+            uint32_t primitiveIndex = kInvalidIndex; ///< Triangle index within the mesh.
+
+            bool isValid() const { return instanceID != kInvalidIndex; }
+        };
+
+        struct Stats
+        {
+            uint32_t meshCount = 0;
+            uint32_t instanceCount = 0;
+            uint64_t triangleCount = 0;
+            uint64_t blasNodeCount = 0;
+            uint64_t blasLeafCount = 0;
+            uint32_t tlasNodeCount = 0;
+            uint64_t memoryInBytes = 0;
+        };
+
+        /** Create the query engine from user supplied meshes and instances.
+            \param[in] meshes List of meshes.
+            \param[in] instances List of mesh instances.
+            \param[in] options Build options.
+        */
+        CpuRayQuery(std::vector<MeshDesc> meshes, std::vector<InstanceDesc> instances, const Options& options);
+
+        /** Create the query engine from the triangle meshes in a scene.
+            Hits report the scene's geometry instance ID in Hit::instanceID.
+            \param[in] scene Scene.
+            \param[in] options Build options.
+        */
+        CpuRayQuery(const Scene& scene, const Options& options);
+
+        /** Trace a ray and return the closest hit.
+            \param[in] ray Ray in world space. Hits are reported in [tMin, tMax].
+            \return Closest hit or an invalid hit if nothing was hit.
+        */
+        Hit traceRay(const Ray& ray) const;
+
+        /** Trace a visibility ray.
+            \param[in] ray Ray in world space.
+            \return True if anything was hit in [tMin, tMax].
+        */
+        bool traceVisibilityRay(const Ray& ray) const;
+
+        /** Trace a batch of rays.
+            The batch is split into fixed size chunks that are traced in parallel. Within a chunk,
+            rays are traced one at a time (there is no packet traversal), so the SIMD width is only
+            used for the per-ray box and triangle tests.
+            \param[in] rays Rays in world space.
+            \param[out] hits Closest hits, one per ray.
+            \param[in] count Number of rays.
+        */
+        void traceRays(const Ray* rays, Hit* hits, size_t count) const;
+
+        /** Trace a batch of visibility rays.
+            The batch is split into fixed size chunks that are traced in parallel, one ray at a time.
+            \param[in] rays Rays in world space.
+            \param[out] visible Set to false if the ray hit anything, true otherwise.
+            \param[in] count Number of rays.
+        */
+        void traceVisibilityRays(const Ray* rays, bool* visible, size_t count) const;
+
+        /** Update the instance transforms and rebuild the TLAS.
+            \param[in] transforms Object-to-world transforms, one per instance.
+        */
+        void setInstanceTransforms(const std::vector<float4x4>& transforms);
+
+        /** Get the world space bounds of all instances.
+        */
+        const AABB& getBounds() const { return mBounds; }
+
+        const Stats& getStats() const { return mStats; }
+
+    private:
+        /** 4-wide BVH node. Children bounds are stored in SoA layout.
+            Child references are either an inner node index, a leaf (kLeafFlag | leaf index) or kInvalidIndex.
+        */
+        struct alignas(16) Node4
+        {
+            float minX[4], minY[4], minZ[4];
+            float maxX[4], maxY[4], maxZ[4];
+            uint32_t child[4];
+        };
+
+        /** Up to 4 triangles in SoA layout. Unused lanes have zero edges and never report hits.
+        */
+        struct alignas(16) Triangle4
+        {
+            float v0x[4], v0y[4], v0z[4];
+            float e1x[4], e1y[4], e1z[4];
+            float e2x[4], e2y[4], e2z[4];
+            uint32_t primitiveIndex[4];
+        };
+
+        /** Range of primitives referenced by a leaf.
+        */
+        struct Leaf
+        {
+            uint32_t first;
+            uint32_t count;
+        };
+
+        struct BVH4
+        {
+            std::vector<Node4> nodes;
+            std::vector<Leaf> leaves;
+            std::vector<uint32_t> primitives; ///< Primitive indices referenced by leaves.
+            uint32_t root = kInvalidIndex;
+        };
+
+        struct BLAS
+        {
+            BVH4 bvh;
+            std::vector<Triangle4> triangles; ///< One triangle packet per leaf.
+        };
+
+        struct Instance
+        {
+            uint32_t meshIndex;
+            uint32_t instanceID;
+            float4x4 worldToObject;
+        };
+
+        static constexpr uint32_t kLeafFlag = 0x80000000;
+
+        static BVH4 buildBVH4(const std::vector<AABB>& primBounds, uint32_t maxLeafSize, const Options& options);
+        void build(std::vector<MeshDesc> meshes, std::vector<InstanceDesc> instances);
+        void buildTLAS(const std::vector<float4x4>& transforms);
+
+        template<bool kAnyHit>
+        bool traceBLAS(const BLAS& blas, const Ray& ray, Hit& hit, uint32_t instanceID) const;
+        template<bool kAnyHit>
+        bool traceTLAS(const Ray& ray, Hit& hit) const;
+
+        Options mOptions;
+        std::vector<BLAS> mBLAS;
+        std::vector<AABB> mMeshBounds;        ///< Object space mesh bounds.
+        std::vector<Instance> mInstances;
+        BVH4 mTLAS;
+        AABB mBounds;
+        Stats mStats;
+    };
+}
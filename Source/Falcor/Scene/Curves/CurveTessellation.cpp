@@ -32,7 +32,11 @@
 #include "Utils/Math/CubicSpline.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Math/Quaternion.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
 #include <cmath>
+#include <execution>
+#include <vector>
 
 namespace Falcor
 {
@@ -59,21 +63,43 @@ namespace Falcor
 
     struct CubicSplineCache
     {
-        CubicSpline<float3> optSplinePoints;
-        CubicSpline<float>  optSplineWidths;
-        CubicSpline<float2> optSplineUVs;
-
         CubicSpline<float3> splinePoints;
         CubicSpline<float>  splineWidths;
         CubicSpline<float2> splineUVs;
     };
 
+    // Scratch memory used by one task while tessellating its strands.
+    struct StrandScratch
+    {
+        StrandArrays strandArrays;              // Control points with consecutive duplicates removed.
+        StrandArrays optimizedStrandArrays;     // Subdivided and decimated strand samples.
+        CubicSplineCache splineCache;
+        fast_vector<float> params;              // Spline parameters of the samples kept in one segment.
+    };
+
+    // Placement of the kept strands in the input and output arrays.
+    struct StrandLayout
+    {
+        uint32_t strandCount = 0;               // Number of kept strands.
+        std::vector<uint32_t> pointOffsets;     // Offset of each kept strand in the input arrays.
+        std::vector<uint32_t> sampleOffsets;    // Offset of the first output sample of each kept strand (exclusive prefix sum, strandCount + 1 entries).
+
+        uint32_t getSampleCount(uint32_t s) const { return sampleOffsets[s + 1] - sampleOffsets[s]; }
+        uint32_t getTotalSampleCount() const { return sampleOffsets[strandCount]; }
+        // Each strand has one segment less than samples, so the segments of strand s start at sampleOffsets[s] - s.
+        uint32_t getSegmentOffset(uint32_t s) const { return sampleOffsets[s] - s; }
+        uint32_t getTotalSegmentCount() const { return sampleOffsets[strandCount] - strandCount; }
+    };
+
     namespace
     {
         // Curves tessellated to quad-tubes have the width somewhere between curveWidth and (curveWidth / sqrt(2)), depending on the viewing angle.
         // To achieve curveWidth on average, however, we need to scale the initial curveWidth by 1.11 (the number was deducted numerically).
         const float kMeshCompensationScale = 1.11f;
 
+        // Number of strands processed sequentially by one parallel task.
+        const uint32_t kStrandsPerTask = 64;
+
         float4 transformSphere(const float4x4& xform, const float4& sphere)
         {
             // Spheres are represented as (center.x, center.y, center.z, radius).
@@ -98,14 +124,78 @@ namespace Falcor
             return std::max(w, (float)std::numeric_limits<float16_t>::min());
         }
 
-        void optimizeStrandGeometry(CubicSplineCache& splineCache, const CurveArrays& curveArrays, StrandArrays& strandArrays, StrandArrays& optimizedStrandArrays, uint32_t pointOffset, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
+        /// Number of control points left in a strand after removing consecutive duplicates.
+        uint32_t countUniqueControlPoints(const float3* controlPoints, uint32_t vertexCount)
+        {
+            uint32_t count = 1;
+            for (uint32_t j = 0; j < vertexCount - 1; j++)
+            {
+                if (any(controlPoints[j] != controlPoints[j + 1])) count++;
+            }
+            return count;
+        }
+
+        /// Compute where each kept strand reads its input and writes its output.
+        /// The output sample counts only depend on the number of unique control points, so they are computed in parallel
+        /// and turned into offsets with a prefix sum. This lets the strands be tessellated independently afterwards.
+        StrandLayout computeStrandLayout(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand)
+        {
+            StrandLayout layout;
+            layout.strandCount = div_round_up(strandCount, keepOneEveryXStrands);
+            layout.pointOffsets.resize(layout.strandCount);
+            layout.sampleOffsets.resize(layout.strandCount + 1);
+
+            // Skipped strands still occupy the input arrays.
+            uint32_t pointOffset = 0;
+            for (uint32_t s = 0; s < layout.strandCount; s++)
+            {
+                layout.pointOffsets[s] = pointOffset;
+                uint32_t i = s * keepOneEveryXStrands;
+                for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+            }
+
+            auto range = NumericRange<uint32_t>(0, layout.strandCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t s)
+            {
+                uint32_t vertexCount = vertexCountsPerStrand[s * keepOneEveryXStrands];
+                uint32_t uniqueCount = countUniqueControlPoints(controlPoints + layout.pointOffsets[s], vertexCount);
+                layout.sampleOffsets[s] = div_round_up(subdivPerSegment * (uniqueCount - 1), keepOneEveryXVerticesPerStrand) + 1;
+            });
+
+            uint32_t sampleOffset = 0;
+            for (uint32_t s = 0; s <= layout.strandCount; s++)
+            {
+                uint32_t sampleCount = layout.sampleOffsets[s];
+                layout.sampleOffsets[s] = sampleOffset;
+                sampleOffset += sampleCount;
+            }
+
+            return layout;
+        }
+
+        /// Run func(scratch, s) for all kept strands. Strands are processed in parallel in chunks of kStrandsPerTask,
+        /// each chunk using its own scratch memory.
+        template<typename F>
+        void forEachStrand(const StrandLayout& layout, F func)
+        {
+            uint32_t taskCount = div_round_up(layout.strandCount, kStrandsPerTask);
+            auto range = NumericRange<uint32_t>(0, taskCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t task)
+            {
+                StrandScratch scratch;
+                uint32_t end = std::min(layout.strandCount, (task + 1) * kStrandsPerTask);
+                for (uint32_t s = task * kStrandsPerTask; s < end; s++) func(scratch, s);
+            });
+        }
+
+        void removeDuplicateControlPoints(const CurveArrays& curveArrays, StrandArrays& strandArrays, uint32_t pointOffset, uint32_t vertexCount)
         {
             strandArrays.controlPoints.clear();
             strandArrays.UVs.clear();
             strandArrays.widths.clear();
 
             // Optimize geometry by removing duplicates.
-            for (uint32_t j = 0; j < strandArrays.vertexCount - 1; j++)
+            for (uint32_t j = 0; j < vertexCount - 1; j++)
             {
                 if (any(curveArrays.controlPoints[pointOffset + j] != curveArrays.controlPoints[pointOffset + j + 1]))
                 {
@@ -116,54 +206,64 @@ namespace Falcor
             }
 
             // Add the last control point.
-            strandArrays.controlPoints.push_back(curveArrays.controlPoints[pointOffset + strandArrays.vertexCount - 1]);
-            strandArrays.widths.push_back(curveArrays.widths[pointOffset + strandArrays.vertexCount - 1]);
-            if (curveArrays.UVs) strandArrays.UVs.push_back(curveArrays.UVs[pointOffset + strandArrays.vertexCount - 1]);
-
-            optimizedStrandArrays.vertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
+            strandArrays.controlPoints.push_back(curveArrays.controlPoints[pointOffset + vertexCount - 1]);
+            strandArrays.widths.push_back(curveArrays.widths[pointOffset + vertexCount - 1]);
+            if (curveArrays.UVs) strandArrays.UVs.push_back(curveArrays.UVs[pointOffset + vertexCount - 1]);
 
-            const CubicSpline<float3>& splinePoints = splineCache.optSplinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.optSplineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+            strandArrays.vertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
+        }
 
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+        /// Evaluate a spline at the kept samples of a strand.
+        /// Each segment is subdivided at t = k / subdivPerSegment, and one of every keepOneEveryXVerticesPerStrand samples along the strand is kept.
+        /// The last vertex is always kept. The kept samples of a segment are evaluated in one batch.
+        template<typename T>
+        void sampleStrand(const CubicSpline<T>& spline, uint32_t controlPointCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, fast_vector<float>& params, T* results)
+        {
+            for (uint32_t j = 0; j < controlPointCount - 1; j++)
             {
-                for (uint32_t k = 0; k < subdivPerSegment; k++)
+                // Sample k of segment j is sample (j * subdivPerSegment + k) along the strand.
+                uint32_t firstKept = (keepOneEveryXVerticesPerStrand - (j * subdivPerSegment) % keepOneEveryXVerticesPerStrand) % keepOneEveryXVerticesPerStrand;
+                params.clear();
+                for (uint32_t k = firstKept; k < subdivPerSegment; k += keepOneEveryXVerticesPerStrand)
                 {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(j, t));
-                        optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(j, t)));
-                    }
-                    tmpCount++;
+                    params.push_back((float)k / (float)subdivPerSegment);
                 }
+
+                spline.interpolate(j, params.data(), (uint32_t)params.size(), results);
+                results += params.size();
             }
 
             // Always keep the last vertex.
-            optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
-            optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f)));
+            *results = spline.interpolate(controlPointCount - 2, 1.f);
+        }
+
+        void optimizeStrandGeometry(StrandScratch& scratch, const CurveArrays& curveArrays, uint32_t pointOffset, uint32_t vertexCount, uint32_t sampleCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
+        {
+            StrandArrays& strandArrays = scratch.strandArrays;
+            StrandArrays& optimizedStrandArrays = scratch.optimizedStrandArrays;
+
+            removeDuplicateControlPoints(curveArrays, strandArrays, pointOffset, vertexCount);
+
+            optimizedStrandArrays.vertexCount = strandArrays.vertexCount;
+            optimizedStrandArrays.controlPoints.resize(sampleCount);
+            optimizedStrandArrays.widths.resize(sampleCount);
+
+            const CubicSpline<float3>& splinePoints = scratch.splineCache.splinePoints.setup(strandArrays.controlPoints.data(), strandArrays.vertexCount);
+            const CubicSpline<float>& splineWidths = scratch.splineCache.splineWidths.setup(strandArrays.widths.data(), strandArrays.vertexCount);
+
+            sampleStrand(splinePoints, strandArrays.vertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, scratch.params, optimizedStrandArrays.controlPoints.data());
+            sampleStrand(splineWidths, strandArrays.vertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, scratch.params, optimizedStrandArrays.widths.data());
+            for (uint32_t j = 0; j < sampleCount; j++)
+            {
+                optimizedStrandArrays.widths[j] = sanitizeWidth(kMeshCompensationScale * widthScale * optimizedStrandArrays.widths[j]);
+            }
 
             // Texture coordinates.
             if (curveArrays.UVs)
             {
-                const CubicSpline<float2>& splineUVs = splineCache.optSplineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
-                {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
-                    {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
-                    }
-                }
-
-                // Always keep the last vertex.
-                optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+                optimizedStrandArrays.UVs.resize(sampleCount);
+                const CubicSpline<float2>& splineUVs = scratch.splineCache.splineUVs.setup(strandArrays.UVs.data(), strandArrays.vertexCount);
+                sampleStrand(splineUVs, strandArrays.vertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, scratch.params, optimizedStrandArrays.UVs.data());
             }
         }
 
@@ -203,7 +303,7 @@ namespace Falcor
             FALCOR_ASSERT_LT(std::abs(length(t) - 1.f), 1e-3f);
         }
 
-        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t j)
+        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, const StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t vertexOffset, uint32_t j)
         {
             // Mesh vertices, normals, tangents, and texCrds (if any).
             for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
@@ -212,31 +312,34 @@ namespace Falcor
                 float3 vNormal = std::cos(phi) * s + std::sin(phi) * t;
 
                 float curveRadius = 0.5f * optimizedStrandArrays.widths[j];
-                result.vertices.push_back(optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal);
-                result.normals.push_back(vNormal);
-                result.tangents.push_back(float4(fwd.x, fwd.y, fwd.z, 1));
-                result.radii.push_back(curveRadius);
+                result.vertices[vertexOffset + k] = optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal;
+                result.normals[vertexOffset + k] = vNormal;
+                result.tangents[vertexOffset + k] = float4(fwd.x, fwd.y, fwd.z, 1);
+                result.radii[vertexOffset + k] = curveRadius;
 
                 if (curveArrays.UVs)
                 {
-                    result.texCrds.push_back(optimizedStrandArrays.UVs[j]);
+                    result.texCrds[vertexOffset + k] = optimizedStrandArrays.UVs[j];
                 }
             }
         }
 
-        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
+        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t faceOffset, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
         {
+            uint32_t* faceVertexCounts = result.faceVertexCounts.data() + faceOffset;
+            uint32_t* faceVertexIndices = result.faceVertexIndices.data() + 3 * faceOffset;
+
             for (uint32_t k = 0; k < quadCountLimit; k++)
             {
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k);
+                *faceVertexCounts++ = 3;
+                *faceVertexIndices++ = meshVertexOffset + multiplier * j * pointCountPerCrossSection + k;
+                *faceVertexIndices++ = meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+                *faceVertexIndices++ = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+
+                *faceVertexCounts++ = 3;
+                *faceVertexIndices++ = meshVertexOffset + multiplier * j * pointCountPerCrossSection + k;
+                *faceVertexIndices++ = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+                *faceVertexIndices++ = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k;
             }
         }
     }
@@ -250,93 +353,49 @@ namespace Falcor
         FALCOR_ASSERT(degree == 1);
         result.degree = degree;
 
-        uint32_t pointCounts = 0;
-        uint32_t segCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            pointCounts += tmpPointCount;
-            segCounts += tmpPointCount - 1;
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.indices.reserve(segCounts);
-        result.points.reserve(pointCounts);
-        result.radius.reserve(pointCounts);
-        result.texCrds.reserve(pointCounts);
-
-        uint32_t pointOffset = 0;
+        // Strands are tessellated in parallel, each one writing to its own range of the preallocated output arrays.
+        // The output is identical to tessellating the strands one after the other.
+        StrandLayout layout = computeStrandLayout(strandCount, vertexCountsPerStrand, controlPoints, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand);
+        result.indices.resize(layout.getTotalSegmentCount());
+        result.points.resize(layout.getTotalSampleCount());
+        result.radius.resize(layout.getTotalSampleCount());
+        if (UVs) result.texCrds.resize(layout.getTotalSampleCount());
 
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
         CurveArrays curveArrays(controlPoints, widths, UVs);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+        forEachStrand(layout, [&](StrandScratch& scratch, uint32_t strandIndex)
         {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+            StrandArrays& strandArrays = scratch.strandArrays;
+            removeDuplicateControlPoints(curveArrays, strandArrays, layout.pointOffsets[strandIndex], vertexCountsPerStrand[strandIndex * keepOneEveryXStrands]);
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            const uint32_t sampleOffset = layout.sampleOffsets[strandIndex];
+            const uint32_t sampleCount = layout.getSampleCount(strandIndex);
+            float3* points = result.points.data() + sampleOffset;
+            float* radius = result.radius.data() + sampleOffset;
 
-            const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+            const CubicSpline<float3>& splinePoints = scratch.splineCache.splinePoints.setup(strandArrays.controlPoints.data(), strandArrays.vertexCount);
+            const CubicSpline<float>& splineWidths = scratch.splineCache.splineWidths.setup(strandArrays.widths.data(), strandArrays.vertexCount);
+            sampleStrand(splinePoints, strandArrays.vertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, scratch.params, points);
+            sampleStrand(splineWidths, strandArrays.vertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, scratch.params, radius);
 
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+            for (uint32_t j = 0; j < sampleCount; j++)
             {
-                for (uint32_t k = 0; k < subdivPerSegment; k++)
-                {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        result.indices.push_back((uint32_t)result.points.size());
-
-                        // Pre-transform curve points.
-                        float4 sph = transformSphere(xform, float4(splinePoints.interpolate(j, t), sanitizeWidth(splineWidths.interpolate(j, t) * 0.5f * widthScale)));
-
-                        result.points.push_back(sph.xyz());
-                        result.radius.push_back(sph.w);
-                    }
-                    tmpCount++;
-                }
+                // Pre-transform curve points.
+                float4 sph = transformSphere(xform, float4(points[j], sanitizeWidth(radius[j] * 0.5f * widthScale)));
+                points[j] = sph.xyz();
+                radius[j] = sph.w;
             }
 
-            // Always keep the last vertex.
-            float4 sph = transformSphere(xform, float4(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f), sanitizeWidth(splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f) * 0.5f * widthScale)));
-            result.points.push_back(sph.xyz());
-            result.radius.push_back(sph.w);
+            uint32_t* indices = result.indices.data() + layout.getSegmentOffset(strandIndex);
+            for (uint32_t j = 0; j < sampleCount - 1; j++) indices[j] = sampleOffset + j;
 
             // Texture coordinates.
             if (UVs)
             {
-                const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
-                {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
-                    {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            result.texCrds.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
-                    }
-                }
-
-                // Always keep the last vertex.
-                result.texCrds.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+                const CubicSpline<float2>& splineUVs = scratch.splineCache.splineUVs.setup(strandArrays.UVs.data(), strandArrays.vertexCount);
+                sampleStrand(splineUVs, strandArrays.vertexCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, scratch.params, result.texCrds.data() + sampleOffset);
             }
-
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
-        }
+        });
 
         return result;
     }
@@ -344,47 +403,30 @@ namespace Falcor
     CurveTessellation::MeshResult CurveTessellation::convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection)
     {
         MeshResult result;
-        uint32_t vertexCounts = 0;
-        uint32_t faceCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            vertexCounts += pointCountPerCrossSection * tmpPointCount;
-            faceCounts += 2 * pointCountPerCrossSection * (tmpPointCount - 1);
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.vertices.reserve(vertexCounts);
-        result.normals.reserve(vertexCounts);
-        result.tangents.reserve(vertexCounts);
-        result.texCrds.reserve(vertexCounts);
-        result.radii.reserve(vertexCounts);
-        result.faceVertexCounts.reserve(faceCounts);
-        result.faceVertexIndices.reserve(faceCounts * 3);
-
-        uint32_t pointOffset = 0;
-        uint32_t meshVertexOffset = 0;
-
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
-        CurveArrays curveArrays(controlPoints, widths, UVs);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
+        // Strands are tessellated in parallel, each one writing to its own range of the preallocated output arrays.
+        // The output is identical to tessellating the strands one after the other.
+        StrandLayout layout = computeStrandLayout(strandCount, vertexCountsPerStrand, controlPoints, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand);
+        const uint32_t vertexCounts = pointCountPerCrossSection * layout.getTotalSampleCount();
+        const uint32_t faceCounts = 2 * pointCountPerCrossSection * layout.getTotalSegmentCount();
+        result.vertices.resize(vertexCounts);
+        result.normals.resize(vertexCounts);
+        result.tangents.resize(vertexCounts);
+        if (UVs) result.texCrds.resize(vertexCounts);
+        result.radii.resize(vertexCounts);
+        result.faceVertexCounts.resize(faceCounts);
+        result.faceVertexIndices.resize(faceCounts * 3);
 
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+        CurveArrays curveArrays(controlPoints, widths, UVs);
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+        forEachStrand(layout, [&](StrandScratch& scratch, uint32_t strandIndex)
+        {
+            const uint32_t sampleCount = layout.getSampleCount(strandIndex);
+            optimizeStrandGeometry(scratch, curveArrays, layout.pointOffsets[strandIndex], vertexCountsPerStrand[strandIndex * keepOneEveryXStrands], sampleCount, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            const StrandArrays& optimizedStrandArrays = scratch.optimizedStrandArrays;
 
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+            const uint32_t meshVertexOffset = pointCountPerCrossSection * layout.sampleOffsets[strandIndex];
+            const uint32_t faceOffset = 2 * pointCountPerCrossSection * layout.getSegmentOffset(strandIndex);
 
             // Build the initial frame.
             float3 fwd, s, t;
@@ -392,25 +434,23 @@ namespace Falcor
             FALCOR_ASSERT_LT(std::abs(length(fwd) - 1.f), 1e-3f);
             buildFrame(fwd, s, t);
 
-            // Create mesh.
-            for (uint32_t j = 0; j < optimizedStrandArrays.controlPoints.size(); j++)
+            // Create mesh. The frame is propagated along the strand, so the cross-sections of a strand are processed in order.
+            for (uint32_t j = 0; j < sampleCount; j++)
             {
                 // Update the curve's frame vectors: [fwd, s, t]
                 updateCurveFrame(optimizedStrandArrays, fwd, s, t, j);
 
                 // Mesh vertices, normals, tangents, and texCrds (if any).
-                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, j);
+                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, meshVertexOffset + j * pointCountPerCrossSection, j);
 
                 // Mesh faces.
-                if (j < optimizedStrandArrays.controlPoints.size() - 1)
+                if (j < sampleCount - 1)
                 {
                     uint32_t quadCountLimit = pointCountPerCrossSection;
-                    connectFaceVertices(result, meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
+                    connectFaceVertices(result, faceOffset + 2 * quadCountLimit * j, meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
                 }
             }
-
-            meshVertexOffset += pointCountPerCrossSection * (uint32_t)optimizedStrandArrays.controlPoints.size();
-        }
+        });
 
         return result;
     }
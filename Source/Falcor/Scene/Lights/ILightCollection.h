@@ -58,6 +58,15 @@ namespace Falcor
             None                = 0u,   ///< Nothing was changed.
             MatrixChanged       = 1u,   ///< Mesh instance transform changed.
             LayoutChanged       = 2u,   ///< MeshLightData layouts have changed.
+            FluxChanged         = 4u,   ///< Flux of some triangles changed (see getChangedTriangleRanges()).
+        };
+
+        /** Range of mesh light triangles.
+        */
+        struct TriangleRange
+        {
+            uint32_t offset = 0;    ///< Index of the first triangle.
+            uint32_t count = 0;     ///< Number of triangles.
         };
 
         struct UpdateStatus
@@ -158,6 +167,11 @@ namespace Falcor
         */
         virtual void prepareSyncCPUData(RenderContext* pRenderContext) const = 0;
 
+        /** Returns the ranges of triangles whose flux changed in the last update that signaled UpdateFlags::FluxChanged.
+            The ranges are sorted and non-overlapping.
+        */
+        virtual const std::vector<TriangleRange>& getChangedTriangleRanges() const = 0;
+
         /** Get the total GPU memory usage in bytes.
         */
         virtual uint64_t getMemoryUsageInBytes() const = 0;
@@ -34,6 +34,7 @@
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Timing/Profiler.h"
 
+#include <algorithm>
 #include <fstream>
 
 namespace Falcor
@@ -48,6 +49,8 @@ namespace Falcor
         const char kBuildTriangleListFile[] = "Scene/Lights/BuildTriangleList.cs.slang";
         const char kUpdateTriangleVerticesFile[] = "Scene/Lights/UpdateTriangleVertices.cs.slang";
         const char kFinalizeIntegrationFile[] = "Scene/Lights/FinalizeIntegration.cs.slang";
+
+        const uint32_t kInvalidActiveIndex = ~0u;
     }
 
     LightCollection::LightCollection(ref<Device> pDevice, RenderContext* pRenderContext, Scene* pScene)
@@ -85,6 +88,17 @@ namespace Falcor
             pUpdateStatus->lightsUpdateInfo.reserve(mMeshLights.size());
         }
 
+        // Finalize the list of active triangles once the flux of the last emissive material update has been read back.
+        // The fence check keeps this from stalling on the GPU. Otherwise we try again next frame.
+        bool activeTrianglesChanged = false;
+        if (mActiveTriangleListPending && mStagingBufferValid && mpStagingFence->getCurrentValue() >= mpStagingFence->getSignaledValue())
+        {
+            updateActiveTriangleList(pRenderContext);
+            mActiveTriangleListPending = false;
+            mStatsValid = false;
+            activeTrianglesChanged = true;
+        }
+
         // Update transform matrices and check for updates.
         // TODO: Move per-mesh instance update flags into Scene. Return just a list of mesh lights that have changed.
         std::vector<uint32_t> updatedLights;
@@ -108,10 +122,68 @@ namespace Falcor
         {
             updateTrianglePositions(pRenderContext, *mpScene, updatedLights);
             mUpdateFlagsSignal(UpdateFlags::MatrixChanged);
-            return true;
         }
 
-        return false;
+        // Keep a readback in flight for finalizing the active triangle list.
+        if (mActiveTriangleListPending && !mStagingBufferValid) prepareSyncCPUData(pRenderContext);
+
+        return activeTrianglesChanged || !updatedLights.empty();
+    }
+
+    bool LightCollection::updateEmissiveMaterials(RenderContext* pRenderContext, const std::vector<MaterialID>& materialIDs)
+    {
+        FALCOR_PROFILE(pRenderContext, "LightCollection::updateEmissiveMaterials()");
+
+        // Collect the mesh lights using the changed materials.
+        // The set of mesh lights is fixed, so we bail out if a used material became emissive or non-emissive.
+        std::vector<uint32_t> updatedLights;
+        for (const MaterialID materialID : materialIDs)
+        {
+            const uint32_t index = materialID.get();
+            auto pMaterial = mpScene->getMaterial(materialID)->toBasicMaterial();
+            bool isEmissive = pMaterial && pMaterial->isEmissive();
+            bool isUsed = index < mMaterialUsedByMeshes.size() && mMaterialUsedByMeshes[index];
+            bool hasMeshLights = index < mMaterialMeshLights.size() && !mMaterialMeshLights[index].empty();
+
+            if (isUsed && isEmissive != hasMeshLights) return false;
+            if (!hasMeshLights) continue;
+
+            // The integrator uses a point sampler matching the material sampler, which is setup at creation.
+            if (pMaterial->getEmissiveTexture() && pMaterial->getDefaultTextureSampler() != mpSamplerState) return false;
+
+            updatedLights.insert(updatedLights.end(), mMaterialMeshLights[index].begin(), mMaterialMeshLights[index].end());
+        }
+
+        // Merge the triangles of the updated mesh lights into ranges.
+        // The mesh lights are laid out consecutively in the triangle list.
+        std::sort(updatedLights.begin(), updatedLights.end());
+        mChangedTriangleRanges.clear();
+        for (uint32_t lightIdx : updatedLights)
+        {
+            const MeshLightData& meshLight = mMeshLights[lightIdx];
+            if (meshLight.triangleCount == 0) continue;
+            if (!mChangedTriangleRanges.empty() && mChangedTriangleRanges.back().offset + mChangedTriangleRanges.back().count == meshLight.triangleOffset)
+            {
+                mChangedTriangleRanges.back().count += meshLight.triangleCount;
+            }
+            else
+            {
+                mChangedTriangleRanges.push_back({ meshLight.triangleOffset, meshLight.triangleCount });
+            }
+        }
+        if (mChangedTriangleRanges.empty()) return true;
+
+        // Re-integrate the affected triangles and start reading back their flux, without waiting for it.
+        integrateEmissive(pRenderContext, *mpScene, mChangedTriangleRanges);
+        readBackFluxData(pRenderContext, mChangedTriangleRanges);
+
+        // Until the flux is back on the CPU, all updated triangles are kept active. Triangles that turned black
+        // are sampled with zero contribution until update() rebuilds the list from the new flux.
+        if (activateTriangles(mChangedTriangleRanges)) updateActiveTriangleBuffers();
+        mActiveTriangleListPending = true;
+
+        mUpdateFlagsSignal(UpdateFlags::FluxChanged);
+        return true;
     }
 
     void LightCollection::initIntegrator(RenderContext* pRenderContext, const Scene& scene)
@@ -175,6 +247,10 @@ namespace Falcor
         mpSamplerState = nullptr;
         mTriangleCount = 0;
 
+        mMaterialMeshLights.clear();
+        mMaterialMeshLights.resize(scene.getMaterialCount());
+        mMaterialUsedByMeshes.assign(scene.getMaterialCount(), false);
+
         // Create mesh lights for all emissive mesh instances.
         for (uint32_t instanceID = 0; instanceID < scene.getGeometryInstanceCount(); instanceID++)
         {
@@ -187,6 +263,7 @@ namespace Falcor
 
             // Only mesh lights with basic materials are supported.
             auto pMaterial = scene.getMaterial(MaterialID::fromSlang( instanceData.materialID ))->toBasicMaterial();
+            mMaterialUsedByMeshes[instanceData.materialID] = true;
 
             if (pMaterial && pMaterial->isEmissive())
             {
@@ -197,6 +274,7 @@ namespace Falcor
                 meshLight.triangleOffset = mTriangleCount;
                 meshLight.materialID = instanceData.materialID;
 
+                mMaterialMeshLights[instanceData.materialID].push_back((uint32_t)mMeshLights.size());
                 mMeshLights.push_back(meshLight);
                 mTriangleCount += meshLight.triangleCount;
 
@@ -241,7 +319,7 @@ namespace Falcor
 
             // Pre-integrate emissive triangles.
             // TODO: We might want to redo this in update() for animated meshes or after scale changes as that affects the flux.
-            integrateEmissive(pRenderContext, scene);
+            integrateEmissive(pRenderContext, scene, { TriangleRange{ 0, mTriangleCount } });
 
             timeReport.measure("LightCollection::build integrate emissive");
 
@@ -314,11 +392,13 @@ namespace Falcor
         }
     }
 
-    void LightCollection::integrateEmissive(RenderContext* pRenderContext, const Scene& scene)
+    void LightCollection::integrateEmissive(RenderContext* pRenderContext, const Scene& scene, const std::vector<TriangleRange>& ranges)
     {
         FALCOR_ASSERT(mTriangleCount > 0);
         FALCOR_ASSERT(mMeshLights.size() > 0);
 
+        // The intermediate buffers are indexed by triangle index, so only the given ranges of them are used.
+
         // Prepare program vars.
         {
             mIntegrator.pVars = ProgramVars::create(mpDevice, mIntegrator.pProgram.get());
@@ -346,7 +426,11 @@ namespace Falcor
 
             // Execute.
             mIntegrator.pProgram->addDefine("INTEGRATOR_PASS", "1");
-            pRenderContext->draw(mIntegrator.pState.get(), mIntegrator.pVars.get(), mTriangleCount, 0);
+            for (const auto& range : ranges)
+            {
+                var["CB"]["gTriangleOffset"] = range.offset;
+                pRenderContext->draw(mIntegrator.pState.get(), mIntegrator.pVars.get(), range.count, 0);
+            }
         }
 
         // 2nd pass: Rasterize emissive triangles in texture space to sum up their texels.
@@ -369,7 +453,11 @@ namespace Falcor
 
             // Execute.
             mIntegrator.pProgram->addDefine("INTEGRATOR_PASS", "2");
-            pRenderContext->draw(mIntegrator.pState.get(), mIntegrator.pVars.get(), mTriangleCount, 0);
+            for (const auto& range : ranges)
+            {
+                var["CB"]["gTriangleOffset"] = range.offset;
+                pRenderContext->draw(mIntegrator.pState.get(), mIntegrator.pVars.get(), range.count, 0);
+            }
         }
 
         // 3rd pass: Finalize the per-triangle flux values.
@@ -385,12 +473,16 @@ namespace Falcor
             var["gTriangleData"] = mpTriangleData;
             var["gFluxData"] = mpFluxData;
 
-            var["CB"]["gTriangleCount"] = mTriangleCount;
-
             // Execute.
             FALCOR_ASSERT(mpFinalizeIntegration->getThreadGroupSize().y == 1);
-            uint32_t rows = div_round_up(mTriangleCount, mpFinalizeIntegration->getThreadGroupSize().x);
-            mpFinalizeIntegration->execute(pRenderContext, mpFinalizeIntegration->getThreadGroupSize().x, rows);
+            for (const auto& range : ranges)
+            {
+                var["CB"]["gTriangleOffset"] = range.offset;
+                var["CB"]["gTriangleCount"] = range.count;
+
+                uint32_t rows = div_round_up(range.count, mpFinalizeIntegration->getThreadGroupSize().x);
+                mpFinalizeIntegration->execute(pRenderContext, mpFinalizeIntegration->getThreadGroupSize().x, rows);
+            }
         }
 #if 0
         // Output a list of per-triangle results to file for debugging purposes.
@@ -494,15 +586,13 @@ namespace Falcor
     void LightCollection::updateActiveTriangleList(RenderContext* pRenderContext)
     {
         // This function updates the list of active (non-culled) triangles based on the pre-integrated flux.
-        // We currently run this as part of initialization. To support animated emissive textures and/or
-        // dynamically changing emissive intensities, it should be run as part of update().
-        // In that case, we may want to move it to the GPU to avoid syncing the data to the CPU first.
+        // It runs as part of initialization, and in update() once the flux changed by an emissive material
+        // update has been read back. We may want to move it to the GPU to avoid syncing the data to the CPU first.
 
         // Read back the current data. This is potentially expensive.
         syncCPUData(pRenderContext);
 
         const uint32_t triCount = (uint32_t)mMeshLightTriangles.size();
-        const uint32_t kInvalidActiveIndex = ~0u;
 
         mTriToActiveList.clear();
         mTriToActiveList.resize(triCount, kInvalidActiveIndex);
@@ -519,7 +609,29 @@ namespace Falcor
             }
         }
 
+        updateActiveTriangleBuffers();
+    }
+
+    bool LightCollection::activateTriangles(const std::vector<TriangleRange>& ranges)
+    {
+        bool activated = false;
+        for (const auto& range : ranges)
+        {
+            for (uint32_t triIdx = range.offset; triIdx < range.offset + range.count; triIdx++)
+            {
+                if (mTriToActiveList[triIdx] != kInvalidActiveIndex) continue;
+                mTriToActiveList[triIdx] = (uint32_t)mActiveTriangleList.size();
+                mActiveTriangleList.push_back(triIdx);
+                activated = true;
+            }
+        }
+        return activated;
+    }
+
+    void LightCollection::updateActiveTriangleBuffers()
+    {
         FALCOR_ASSERT(mActiveTriangleList.size() <= std::numeric_limits<uint32_t>::max());
+        const uint32_t triCount = (uint32_t)mTriToActiveList.size();
         const uint32_t activeCount = (uint32_t)mActiveTriangleList.size();
 
         // Update GPU buffer.
@@ -547,6 +659,30 @@ namespace Falcor
         }
     }
 
+    void LightCollection::readBackFluxData(RenderContext* pRenderContext, const std::vector<TriangleRange>& ranges)
+    {
+        // The CPU-side flux data is read back from the staging buffer on the next sync.
+        mCPUInvalidData |= CPUOutOfDateFlags::FluxData;
+
+        // If the staging buffer is out of date, schedule a full copy.
+        if (!mStagingBufferValid || !mpStagingBuffer)
+        {
+            prepareSyncCPUData(pRenderContext);
+            return;
+        }
+
+        // Otherwise copy the flux of the updated triangles into the flux part of the staging buffer.
+        // The triangle data part is left untouched, as it may hold a pending copy.
+        const uint64_t fluxOffset = mpTriangleData->getSize();
+        for (const auto& range : ranges)
+        {
+            uint64_t offset = range.offset * sizeof(EmissiveFlux);
+            pRenderContext->copyBufferRegion(mpStagingBuffer.get(), fluxOffset + offset, mpFluxData.get(), offset, range.count * sizeof(EmissiveFlux));
+        }
+        pRenderContext->submit(false);
+        pRenderContext->signal(mpStagingFence.get());
+    }
+
     void LightCollection::updateTrianglePositions(RenderContext* pRenderContext, const Scene& scene, const std::vector<uint32_t>& updatedLights)
     {
         // This pass pre-transforms all emissive triangles into world space and updates their area and face normals.
@@ -28,6 +28,7 @@
 #pragma once
 #include "MeshLightData.slang"
 #include "ILightCollection.h"
+#include "Scene/SceneIDs.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
 #include "Core/API/Buffer.h"
@@ -84,6 +85,17 @@ namespace Falcor
         */
         bool update(RenderContext* pRenderContext, UpdateStatus* pUpdateStatus = nullptr) override;
 
+        /** Updates the flux of the mesh lights after emissive material changes.
+            The emission is re-integrated only for the triangles of mesh lights using the changed materials.
+            The new flux is read back asynchronously. Until it arrives, the updated triangles are all kept in the
+            list of active triangles, and the list is rebuilt by a later call to update(). Samplers are notified
+            with UpdateFlags::FluxChanged and can query the changed triangles with getChangedTriangleRanges().
+            \param[in] pRenderContext The render context.
+            \param[in] materialIDs IDs of the materials whose emissive properties changed.
+            \return False if the set of mesh lights changed (e.g. a used material became emissive), in which case the light collection needs to be recreated.
+        */
+        bool updateEmissiveMaterials(RenderContext* pRenderContext, const std::vector<MaterialID>& materialIDs);
+
         /** Bind the light collection data to a given shader var
             \param[in] var The shader variable to set the data into.
         */
@@ -115,6 +127,8 @@ namespace Falcor
         */
         void prepareSyncCPUData(RenderContext* pRenderContext) const override { copyDataToStagingBuffer(pRenderContext); }
 
+        const std::vector<TriangleRange>& getChangedTriangleRanges() const override { return mChangedTriangleRanges; }
+
         /** Get the total GPU memory usage in bytes.
         */
         uint64_t getMemoryUsageInBytes() const override;
@@ -139,10 +153,13 @@ namespace Falcor
         void build(RenderContext* pRenderContext, const Scene& scene);
         void prepareTriangleData(RenderContext* pRenderContext, const Scene& scene);
         void prepareMeshData(const Scene& scene);
-        void integrateEmissive(RenderContext* pRenderContext, const Scene& scene);
+        void integrateEmissive(RenderContext* pRenderContext, const Scene& scene, const std::vector<TriangleRange>& ranges);
         void computeStats(RenderContext* pRenderContext) const;
         void buildTriangleList(RenderContext* pRenderContext, const Scene& scene);
         void updateActiveTriangleList(RenderContext* pRenderContext);
+        bool activateTriangles(const std::vector<TriangleRange>& ranges);
+        void updateActiveTriangleBuffers();
+        void readBackFluxData(RenderContext* pRenderContext, const std::vector<TriangleRange>& ranges);
         void updateTrianglePositions(RenderContext* pRenderContext, const Scene& scene, const std::vector<uint32_t>& updatedLights);
 
         void copyDataToStagingBuffer(RenderContext* pRenderContext) const;
@@ -154,6 +171,9 @@ namespace Falcor
 
         std::vector<MeshLightData>              mMeshLights;            ///< List of all mesh lights.
         uint32_t                                mTriangleCount = 0;     ///< Total number of triangles in all mesh lights (= mMeshLightTriangles.size()). This may include culled triangles.
+        std::vector<std::vector<uint32_t>>      mMaterialMeshLights;    ///< Indices of the mesh lights using each material.
+        std::vector<bool>                       mMaterialUsedByMeshes;  ///< True for materials used by any triangle mesh instance.
+        std::vector<TriangleRange>              mChangedTriangleRanges; ///< Triangles whose flux changed in the last emissive material update.
 
         mutable std::vector<MeshLightTriangle>  mMeshLightTriangles;    ///< List of all pre-processed mesh light triangles.
         mutable std::vector<uint32_t>           mActiveTriangleList;    ///< List of active (non-culled) emissive triangles.
@@ -191,6 +211,7 @@ namespace Falcor
 
         mutable CPUOutOfDateFlags               mCPUInvalidData = CPUOutOfDateFlags::None;  ///< Flags indicating which CPU data is valid.
         mutable bool                            mStagingBufferValid = true;                 ///< Flag to indicate if the contents of the staging buffer is up-to-date.
+        bool                                    mActiveTriangleListPending = false;         ///< True if the active triangle list needs to be rebuilt once the flux has been read back.
 
         UpdateFlagsSignal mUpdateFlagsSignal;
     };
@@ -26,11 +26,15 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "MERLFile.h"
+#include "Core/Platform/MemoryMappedFile.h"
 #include "Utils/Logger.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/SharedCache.h"
 #include "Utils/Image/ImageIO.h"
 #include "Scene/Material/MERLMaterial.h"
 #include "Scene/Material/DiffuseSpecularUtils.h"
 #include "Rendering/Materials/BSDFIntegrator.h"
+#include <cstring>
 #include <fstream>
 
 namespace Falcor
@@ -48,20 +52,171 @@ namespace Falcor
         const double kBlueScale = 1.66 / 1500.0;
 
         const uint32_t kAlbedoLUTSize = MERLMaterialData::kAlbedoLUTSize;
+
+        const size_t kSampleCount = kBRDFSamplingResThetaH * kBRDFSamplingResThetaD * kBRDFSamplingResPhiD / 2;
+
+        // Largest finite fp16 value. Samples are clamped to this value when converted.
+        const float kMaxFloat16 = 65504.f;
+
+        static_assert(sizeof(float16_t3) == 6, "Expected tightly packed fp16 samples");
+
+        // Cache file with the BRDF samples converted to fp16, stored next to the MERL file.
+        const char kCacheFileExtension[] = "merl16";
+        const char kCacheFileMagic[8] = { 'M', 'E', 'R', 'L', 'F', 'P', '1', '6' };
+        const uint32_t kCacheFileVersion = 1;
+
+        struct CacheFileHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t sampleCount;
+            uint64_t sourceSize;    ///< Size of the MERL file the cache was created from.
+            int64_t sourceTime;     ///< Last write time of the MERL file the cache was created from.
+            char hash[40];          ///< SHA-1 hash of the BRDF data in hexadecimal notation.
+        };
+
+        static_assert(sizeof(CacheFileHeader) % 4 == 0, "Sample data in cache file must be 4-byte aligned");
+
+        void writeCacheFile(const std::filesystem::path& cachePath, const CacheFileHeader& header, fstd::span<const float16_t3> samples)
+        {
+            // Write to a temporary file first so that other processes never map a partially written file.
+            auto tmpPath = cachePath;
+            tmpPath += ".tmp";
+            {
+                std::ofstream ofs(tmpPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+                ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                ofs.write(reinterpret_cast<const char*>(samples.data()), samples.size_bytes());
+                if (!ofs.good())
+                {
+                    logWarning("MERLFile: Failed to write cache file '{}'.", cachePath);
+                    ofs.close();
+                    std::error_code ec;
+                    std::filesystem::remove(tmpPath, ec);
+                    return;
+                }
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(tmpPath, cachePath, ec);
+            if (ec)
+            {
+                logWarning("MERLFile: Failed to write cache file '{}': {}", cachePath, ec.message());
+                std::filesystem::remove(tmpPath, ec);
+                return;
+            }
+            logInfo("Saved MERL BRDF cache to '{}'.", cachePath);
+        }
+    }
+
+    /** BRDF samples shared between all MERLFile objects that loaded identical data.
+        The samples are either owned or point into a memory-mapped cache file.
+    */
+    struct MERLFile::BRDFData
+    {
+        std::vector<float16_t3> samples;                ///< Converted samples. Empty if the data is memory-mapped.
+        std::unique_ptr<MemoryMappedFile> pMappedFile;  ///< Memory-mapped cache file.
+        fstd::span<const float16_t3> view;              ///< View of the samples.
+    };
+
+    std::shared_ptr<const MERLFile::BRDFData> MERLFile::acquireData(const std::string& hash, const std::function<std::shared_ptr<const BRDFData>()>& init)
+    {
+        // Process-wide cache of loaded BRDFs keyed by content hash. Entries are released when no longer referenced.
+        static SharedCache<const BRDFData, std::string> sBRDFCache;
+        return sBRDFCache.acquire(hash, init);
     }
 
-    MERLFile::MERLFile(const std::filesystem::path& path)
+    MERLFile::MERLFile(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory)
     {
-        if (!loadBRDF(path))
+        if (!loadBRDF(path, cacheDirectory))
             FALCOR_THROW("Failed to load MERL BRDF from '{}'", path);
     }
 
-    bool MERLFile::loadBRDF(const std::filesystem::path& path)
+    bool MERLFile::loadBRDF(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory)
     {
         mDesc = {};
-        mData.clear();
+        mpData.reset();
         mAlbedoLUT.clear();
+        mCacheDirectory = cacheDirectory;
+
+        std::error_code ec;
+        const uint64_t fileSize = std::filesystem::file_size(path, ec);
+        const int64_t fileTime = ec ? 0 : (int64_t)std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        if (ec)
+        {
+            logWarning("MERLFile: Failed to open file '{}'.", path);
+            return false;
+        }
+
+        mDesc.path = path;
+        mDesc.name = path.stem().string();
+
+        // Use the converted data in the cache file if it is up to date, otherwise load and convert the MERL file.
+        const auto cachePath = getCachePath(kCacheFileExtension);
+        if (!loadCacheFile(cachePath, fileSize, fileTime) && !loadMERLFile(path, cachePath, fileSize, fileTime))
+        {
+            mDesc = {};
+            return false;
+        }
+
+        // Load JSON sidecar file if it exists.
+        const auto jsonPath = std::filesystem::path(path).replace_extension("json");
+        if (!DiffuseSpecularUtils::loadJSONData(jsonPath, mDesc.extraData))
+            logWarning("MERLFile: Failed to load associated JSON data for BRDF '{}'.", mDesc.name);
+
+        logInfo("Loaded MERL BRDF '{}'.", mDesc.name);
+        return true;
+    }
+
+    fstd::span<const float16_t3> MERLFile::getData() const
+    {
+        return mpData ? mpData->view : fstd::span<const float16_t3>();
+    }
+
+    bool MERLFile::loadCacheFile(const std::filesystem::path& cachePath, uint64_t fileSize, int64_t fileTime)
+    {
+        CacheFileHeader header = {};
+        {
+            std::ifstream ifs(cachePath, std::ios_base::in | std::ios_base::binary);
+            if (!ifs.good())
+                return false;
+            ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!ifs.good())
+                return false;
+        }
+
+        // Reject cache files from other versions or created from a different MERL file.
+        if (std::memcmp(header.magic, kCacheFileMagic, sizeof(kCacheFileMagic)) != 0 || header.version != kCacheFileVersion ||
+            header.sampleCount != kSampleCount || header.sourceSize != fileSize || header.sourceTime != fileTime)
+        {
+            return false;
+        }
+
+        const std::string hash(header.hash, sizeof(header.hash));
+        mpData = acquireData(hash, [&]() -> std::shared_ptr<const BRDFData>
+        {
+            auto pMappedFile = std::make_unique<MemoryMappedFile>(cachePath, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+            if (!pMappedFile->isOpen() || pMappedFile->getSize() != sizeof(CacheFileHeader) + kSampleCount * sizeof(float16_t3))
+                return nullptr;
+
+            auto pData = std::make_shared<BRDFData>();
+            const uint8_t* pMapped = reinterpret_cast<const uint8_t*>(pMappedFile->getData());
+            pData->view = fstd::span<const float16_t3>(reinterpret_cast<const float16_t3*>(pMapped + sizeof(CacheFileHeader)), kSampleCount);
+            pData->pMappedFile = std::move(pMappedFile);
+            return pData;
+        });
+
+        if (!mpData)
+        {
+            logWarning("MERLFile: Failed to map cache file '{}'.", cachePath);
+            return false;
+        }
 
+        mDesc.hash = hash;
+        return true;
+    }
+
+    bool MERLFile::loadMERLFile(const std::filesystem::path& path, const std::filesystem::path& cachePath, uint64_t fileSize, int64_t fileTime)
+    {
         std::ifstream ifs(path, std::ios_base::in | std::ios_base::binary);
         if (!ifs.good())
         {
@@ -74,7 +229,7 @@ namespace Falcor
         ifs.read(reinterpret_cast<char*>(dims), sizeof(int) * 3);
 
         size_t n = (size_t)dims[0] * dims[1] * dims[2];
-        if (n != kBRDFSamplingResThetaH * kBRDFSamplingResThetaD * kBRDFSamplingResPhiD / 2)
+        if (n != kSampleCount)
         {
             logWarning("MERLFile: Dimensions don't match in file '{}'.", path);
             return false;
@@ -89,35 +244,51 @@ namespace Falcor
             return false;
         }
 
-        mDesc.path = path;
-        mDesc.name = path.stem().string();
-
-        prepareData(dims, data);
+        // Identify the BRDF by its content so that identical files share the converted data.
+        SHA1 sha1;
+        sha1.update(dims, sizeof(dims));
+        sha1.update(data.data(), data.size() * sizeof(double));
+        const std::string hash = SHA1::toString(sha1.finalize());
 
-        // Load JSON sidecar file if it exists.
-        const auto jsonPath = std::filesystem::path(path).replace_extension("json");
-        if (!DiffuseSpecularUtils::loadJSONData(jsonPath, mDesc.extraData))
-            logWarning("MERLFile: Failed to load associated JSON data for BRDF '{}'.", mDesc.name);
+        mpData = acquireData(hash, [&]()
+        {
+            auto pData = std::make_shared<BRDFData>();
+            pData->samples = prepareData(dims, data);
+            pData->view = pData->samples;
+            return pData;
+        });
+        mDesc.hash = hash;
+
+        // Write the cache file so that subsequent runs can map the converted data directly.
+        CacheFileHeader header = {};
+        std::memcpy(header.magic, kCacheFileMagic, sizeof(kCacheFileMagic));
+        header.version = kCacheFileVersion;
+        header.sampleCount = (uint32_t)kSampleCount;
+        header.sourceSize = fileSize;
+        header.sourceTime = fileTime;
+        FALCOR_ASSERT(hash.size() == sizeof(header.hash));
+        std::memcpy(header.hash, hash.data(), sizeof(header.hash));
+        writeCacheFile(cachePath, header, mpData->view);
 
-        logInfo("Loaded MERL BRDF '{}'.", mDesc.name);
         return true;
     }
 
-    void MERLFile::prepareData(const int dims[3], const std::vector<double>& data)
+    std::vector<float16_t3> MERLFile::prepareData(const int dims[3], const std::vector<double>& data) const
     {
-        // Convert BRDF samples to fp32 precision and interleave RGB channels.
+        // Convert BRDF samples to fp16 precision and interleave RGB channels.
         const size_t n = (size_t)dims[0] * dims[1] * dims[2];
 
         FALCOR_ASSERT(data.size() == 3 * n);
-        mData.resize(n);
+        std::vector<float16_t3> samples(n);
 
         size_t negCount = 0;
         size_t infCount = 0;
         size_t nanCount = 0;
+        size_t clampCount = 0;
 
         for (size_t i = 0; i < n; i++)
         {
-            float3& v = mData[i];
+            float3 v;
 
             // Extract RGB and apply scaling.
             v.x = static_cast<float>(data[i] * kRedScale);
@@ -135,11 +306,23 @@ namespace Falcor
 
             if (isInf || isNaN) v = float3(0.f);
             else if (isNeg) v = max(v, float3(0.f));
+
+            // Clamp to the fp16 range.
+            if (any(v > float3(kMaxFloat16)))
+            {
+                clampCount++;
+                v = min(v, float3(kMaxFloat16));
+            }
+
+            samples[i] = float16_t3(v);
         }
 
         if (negCount > 0) logWarning("MERL BRDF {} has {} samples with negative values. Clamped to zero.", mDesc.name, negCount);
         if (infCount > 0) logWarning("MERL BRDF {} has {} samples with inf values. Sample set to zero.", mDesc.name, infCount);
         if (nanCount > 0) logWarning("MERL BRDF {} has {} samples with NaN values. Sample set to zero.", mDesc.name, nanCount);
+        if (clampCount > 0) logWarning("MERL BRDF {} has {} samples exceeding the fp16 range. Clamped to {}.", mDesc.name, clampCount, kMaxFloat16);
+
+        return samples;
     }
 
     const std::vector<float4>& MERLFile::prepareAlbedoLUT(ref<Device> pDevice)
@@ -148,7 +331,7 @@ namespace Falcor
             return mAlbedoLUT;
 
         FALCOR_CHECK(!mDesc.path.empty(), "No BRDF loaded");
-        const auto texPath = mDesc.path.replace_extension("dds");
+        const auto texPath = getCachePath("dds");
 
         // Try loading cached albedo lookup table.
         if (std::filesystem::is_regular_file(texPath))
@@ -212,4 +395,10 @@ namespace Falcor
         for (uint32_t i = 0; i < binCount; i++)
             mAlbedoLUT[i] = float4(albedos[i], 1.f);
     }
+
+    std::filesystem::path MERLFile::getCachePath(const char* extension) const
+    {
+        auto fileName = std::filesystem::path(mDesc.path.filename()).replace_extension(extension);
+        return mCacheDirectory.empty() ? mDesc.path.parent_path() / fileName : mCacheDirectory / fileName;
+    }
 }
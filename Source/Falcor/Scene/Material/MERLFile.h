@@ -30,8 +30,11 @@
 #include "Core/API/Formats.h"
 #include "Utils/Math/Vector.h"
 #include "Scene/Material/DiffuseSpecularData.slang"
+#include <fstd/span.h>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <string>
 
 namespace Falcor
 {
@@ -39,6 +42,11 @@ namespace Falcor
 
     /** Class for loading a measured material from the MERL BRDF database.
         Additional metadata is loaded along with the BRDF if available.
+
+        The BRDF samples are stored in RGB fp16 format. Loaded data is kept in a process-wide cache
+        keyed by a hash of the file content, so identical files are only stored once in memory.
+        On first load the converted samples are written to a cache file next to the MERL file (or in a given cache directory),
+        which is memory-mapped on subsequent loads instead of converting the original file again.
     */
     class FALCOR_API MERLFile
     {
@@ -48,6 +56,7 @@ namespace Falcor
             std::string name;                   ///< Name of the BRDF.
             std::filesystem::path path;         ///< Full path to the loaded BRDF.
             DiffuseSpecularData extraData = {}; ///< Parameters for a best fit BRDF approximation.
+            std::string hash;                   ///< SHA-1 hash of the BRDF data in hexadecimal notation.
         };
 
         static constexpr ResourceFormat kAlbedoLUTFormat = ResourceFormat::RGBA32Float;
@@ -56,14 +65,16 @@ namespace Falcor
 
         /** Constructs a new object and loads a MERL BRDF. Throws on error.
             \param[in] path Path to the binary MERL file.
+            \param[in] cacheDirectory Directory for the converted sample and albedo LUT cache files. If empty, they are stored next to the MERL file.
         */
-        MERLFile(const std::filesystem::path& path);
+        MERLFile(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory = {});
 
         /** Loads a MERL BRDF.
             \param[in] path Path to the binary MERL file.
+            \param[in] cacheDirectory Directory for the converted sample and albedo LUT cache files. If empty, they are stored next to the MERL file.
             \return True if the BRDF was successfully loaded.
         */
-        bool loadBRDF(const std::filesystem::path& path);
+        bool loadBRDF(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory = {});
 
         /** Prepare an albedo lookup table.
             The table is loaded from disk or recomputed if needed.
@@ -73,14 +84,25 @@ namespace Falcor
         const std::vector<float4>& prepareAlbedoLUT(ref<Device> pDevice);
 
         const Desc& getDesc() const { return mDesc; }
-        const std::vector<float3>& getData() const { return mData; }
+
+        /** Get the BRDF samples in RGB fp16 format.
+            The data is shared between all MERLFile objects that loaded identical data.
+        */
+        fstd::span<const float16_t3> getData() const;
 
     private:
-        void prepareData(const int dims[3], const std::vector<double>& data);
+        struct BRDFData;
+
+        static std::shared_ptr<const BRDFData> acquireData(const std::string& hash, const std::function<std::shared_ptr<const BRDFData>()>& init);
+        bool loadCacheFile(const std::filesystem::path& cachePath, uint64_t fileSize, int64_t fileTime);
+        bool loadMERLFile(const std::filesystem::path& path, const std::filesystem::path& cachePath, uint64_t fileSize, int64_t fileTime);
+        std::vector<float16_t3> prepareData(const int dims[3], const std::vector<double>& data) const;
         void computeAlbedoLUT(ref<Device> pDevice, const size_t binCount);
+        std::filesystem::path getCachePath(const char* extension) const;
 
-        Desc mDesc;                     ///< BRDF description and sampling parameters.
-        std::vector<float3> mData;      ///< BRDF data in RGB float format.
-        std::vector<float4> mAlbedoLUT; ///< Precomputed albedo lookup table.
+        Desc mDesc;                                 ///< BRDF description and sampling parameters.
+        std::shared_ptr<const BRDFData> mpData;     ///< BRDF data in RGB fp16 format, shared between identical files.
+        std::vector<float4> mAlbedoLUT;             ///< Precomputed albedo lookup table.
+        std::filesystem::path mCacheDirectory;      ///< Directory for cache files, or empty to store them next to the MERL file.
     };
 }
@@ -71,9 +71,10 @@ namespace Falcor
         mData.extraData = merlFile.getDesc().extraData;
 
         // Create GPU buffer.
-        const auto& brdf = merlFile.getData();
-        FALCOR_CHECK(!brdf.empty() && sizeof(brdf[0]) == sizeof(float3), "Expected BRDF data in float3 format.");
-        mpBRDFData = mpDevice->createBuffer(brdf.size() * sizeof(brdf[0]), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, brdf.data());
+        const auto brdf = merlFile.getData();
+        FALCOR_CHECK(!brdf.empty(), "Expected BRDF data.");
+        FALCOR_CHECK(brdf.size_bytes() % 4 == 0, "Expected BRDF data size to be a multiple of 4 bytes.");
+        mpBRDFData = mpDevice->createBuffer(brdf.size_bytes(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, brdf.data());
 
         // Create sampler for albedo LUT.
         Sampler::Desc desc;
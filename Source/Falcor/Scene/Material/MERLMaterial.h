@@ -65,7 +65,7 @@ namespace Falcor
         std::string mBRDFName;              ///< This is the file basename without extension.
 
         MERLMaterialData mData;             ///< Material parameters.
-        ref<Buffer> mpBRDFData;             ///< GPU buffer holding all BRDF data as float3 array.
+        ref<Buffer> mpBRDFData;             ///< GPU buffer holding all BRDF data as packed RGB fp16 array.
         ref<Texture> mpAlbedoLUT;           ///< Precomputed albedo lookup table.
         ref<Sampler> mpLUTSampler;          ///< Sampler for accessing the LUT texture.
     };
@@ -73,9 +73,9 @@ namespace Falcor
             extraData[i] = merlFile.getDesc().extraData;
 
             // Copy BRDF samples into shared data buffer.
-            const auto& brdf = merlFile.getData();
-            FALCOR_CHECK(!brdf.empty() && sizeof(brdf[0]) == sizeof(float3), "Expected BRDF data in float3 format.");
-            desc.byteSize = brdf.size() * sizeof(brdf[0]);
+            const auto brdf = merlFile.getData();
+            FALCOR_CHECK(!brdf.empty(), "Expected BRDF data.");
+            desc.byteSize = brdf.size_bytes();
             desc.byteOffset = buffer.allocate(desc.byteSize);
             buffer.setBlob(brdf.data(), desc.byteOffset, desc.byteSize);
 
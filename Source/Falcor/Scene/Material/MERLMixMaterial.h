@@ -86,7 +86,7 @@ namespace Falcor
         std::vector<BRDFDesc> mBRDFs;       ///< List of loaded BRDFs.
 
         MERLMixMaterialData mData;          ///< Material parameters.
-        ref<Buffer> mpBRDFData;             ///< GPU buffer holding all BRDF data as float3 arrays.
+        ref<Buffer> mpBRDFData;             ///< GPU buffer holding all BRDF data as packed RGB fp16 arrays.
         ref<Texture> mpAlbedoLUT;           ///< Precomputed albedo lookup table.
         ref<Sampler> mpLUTSampler;          ///< Sampler for accessing the LUT texture.
         ref<Sampler> mpIndexSampler;        ///< Sampler for accessing the index map.
@@ -30,6 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include "Utils/Timing/Profiler.h"
 #include "MaterialTypeRegistry.h"
 #include "Scene/Lights/LightProfile.h"
 #include <numeric>
@@ -476,6 +477,7 @@ namespace Falcor
         std::fill(mMaterialsUpdateFlags.begin(), mMaterialsUpdateFlags.end(), Material::UpdateFlags::None);
 
         auto updateMaterial = [&](const MaterialID materialID) {
+            FALCOR_PROFILE_CPU("updateMaterial");
             auto& pMaterial = getMaterial(materialID);
             if (pMaterial->mpDevice != mpDevice)
                 FALCOR_THROW("Material '{}' was created with a different device than the MaterialSystem.", pMaterial->getName());
@@ -536,6 +538,7 @@ namespace Falcor
             {
                 if (forceUpdate || is_set(mMaterialsUpdateFlags[materialID], Material::UpdateFlags::DataChanged))
                 {
+                    FALCOR_PROFILE_CPU("uploadMaterial");
                     uploadMaterial(materialID);
                 }
             }
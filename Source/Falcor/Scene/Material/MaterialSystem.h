@@ -228,6 +228,15 @@ namespace Falcor
         */
         const ref<Material>& getMaterial(const MaterialID materialID) const;
 
+        /** Get the update flags of a material from the last call to update().
+            \param[in] materialID The material ID.
+            \return The material update flags, or None if the material was added after the last update.
+        */
+        Material::UpdateFlags getMaterialUpdates(const MaterialID materialID) const
+        {
+            return materialID.get() < mMaterialsUpdateFlags.size() ? mMaterialsUpdateFlags[materialID.get()] : Material::UpdateFlags::None;
+        }
+
         /** Get a material by name.
             \return The material, or nullptr if material doesn't exist.
         */
@@ -66,7 +66,16 @@ namespace Falcor
         );
 
         // Store assignment to material for later.
+        std::lock_guard<std::mutex> lock(mMutex);
         mTextureAssignments.emplace_back(TextureAssignment{ pMaterial, slot, handle });
+        mPendingSlots[pMaterial.get()] |= 1u << (uint32_t)slot;
+    }
+
+    bool MaterialTextureLoader::isTexturePending(const Material* pMaterial, Material::TextureSlot slot) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mPendingSlots.find(pMaterial);
+        return it != mPendingSlots.end() && (it->second & (1u << (uint32_t)slot)) != 0;
     }
 
     void MaterialTextureLoader::assignTextures()
@@ -80,5 +89,6 @@ namespace Falcor
             assignment.pMaterial->setTexture(assignment.textureSlot, pTexture);
         }
         mTextureAssignments.clear();
+        mPendingSlots.clear();
     }
 }
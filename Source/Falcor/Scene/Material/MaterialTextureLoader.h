@@ -30,6 +30,8 @@
 #include "Scene/Material/Material.h"
 #include "Utils/Image/TextureManager.h"
 #include <filesystem>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace Falcor
@@ -55,6 +57,13 @@ namespace Falcor
         */
         void loadTexture(const ref<Material>& pMaterial, Material::TextureSlot slot, const std::filesystem::path& path);
 
+        /** Check if a texture load has been requested for a material slot, but not yet assigned.
+            \param[in] pMaterial Material.
+            \param[in] slot Texture slot.
+            \return True if a texture is pending for the slot.
+        */
+        bool isTexturePending(const Material* pMaterial, Material::TextureSlot slot) const;
+
         void finishLoading()
         {
             assignTextures();
@@ -71,6 +80,8 @@ namespace Falcor
 
         bool mUseSrgb;
         std::vector<TextureAssignment> mTextureAssignments;
+        std::unordered_map<const Material*, uint32_t> mPendingSlots; ///< Bit mask of slots with pending textures per material.
+        mutable std::mutex mMutex;
         TextureManager& mTextureManager;
     };
 }
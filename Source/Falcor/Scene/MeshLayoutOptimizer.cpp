@@ -0,0 +1,411 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshLayoutOptimizer.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = 0xffffffff;
+        const uint32_t kMaxCacheSize = 64;
+
+        // Vertex scoring parameters from "Linear-Speed Vertex Cache Optimisation", Tom Forsyth, 2006.
+        const float kCacheDecayPower = 1.5f;
+        const float kLastTriangleScore = 0.75f;
+        const float kValenceBoostScale = 2.f;
+        const float kValenceBoostPower = 0.5f;
+
+        /** Triangles adjacent to each vertex in CSR layout.
+            The first liveCount[v] entries of each vertex list are the triangles that have not been consumed yet.
+        */
+        struct Adjacency
+        {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> triangles;
+            std::vector<uint32_t> liveCount;
+
+            Adjacency(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount)
+                : offsets(vertexCount + 1, 0)
+                , triangles(indexCount)
+                , liveCount(vertexCount, 0)
+            {
+                for (uint32_t i = 0; i < indexCount; i++)
+                {
+                    FALCOR_ASSERT(indices[i] < vertexCount);
+                    liveCount[indices[i]]++;
+                }
+                for (uint32_t v = 0; v < vertexCount; v++) offsets[v + 1] = offsets[v] + liveCount[v];
+
+                std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                for (uint32_t i = 0; i < indexCount; i++) triangles[fill[indices[i]]++] = i / 3;
+            }
+
+            const uint32_t* begin(uint32_t v) const { return triangles.data() + offsets[v]; }
+            const uint32_t* end(uint32_t v) const { return triangles.data() + offsets[v] + liveCount[v]; }
+
+            /** Remove a triangle from the live triangles of a vertex.
+            */
+            void remove(uint32_t v, uint32_t triangle)
+            {
+                uint32_t* list = triangles.data() + offsets[v];
+                uint32_t& count = liveCount[v];
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    if (list[i] == triangle)
+                    {
+                        list[i] = list[count - 1];
+                        list[count - 1] = triangle;
+                        count--;
+                        return;
+                    }
+                }
+                FALCOR_UNREACHABLE();
+            }
+        };
+
+        /** Vertex scores, tabulated for the cache positions and the most common valences.
+        */
+        struct VertexScoreTable
+        {
+            static constexpr uint32_t kMaxTabulatedValence = 32;
+
+            float cacheScores[kMaxCacheSize];
+            float valenceScores[kMaxTabulatedValence + 1];
+
+            VertexScoreTable(uint32_t cacheSize)
+            {
+                for (uint32_t i = 0; i < cacheSize; i++)
+                {
+                    // The vertices of the last triangle get a fixed score, so that the next triangle doesn't just reuse the same edge.
+                    cacheScores[i] = i < 3 ? kLastTriangleScore : std::pow(1.f - (float)(i - 3) / (float)(cacheSize - 3), kCacheDecayPower);
+                }
+                for (uint32_t i = 1; i <= kMaxTabulatedValence; i++) valenceScores[i] = computeValenceScore(i);
+            }
+
+            /** Boost vertices with few remaining triangles, to get rid of lone triangles early.
+            */
+            static float computeValenceScore(uint32_t valence) { return kValenceBoostScale * std::pow((float)valence, -kValenceBoostPower); }
+
+            float getScore(int32_t cachePosition, uint32_t valence) const
+            {
+                // Vertices without remaining triangles are never used for scoring.
+                if (valence == 0) return -1.f;
+
+                float score = cachePosition >= 0 ? cacheScores[cachePosition] : 0.f;
+                score += valence <= kMaxTabulatedValence ? valenceScores[valence] : computeValenceScore(valence);
+                return score;
+            }
+        };
+    }
+
+    MeshLayoutOptimizer::CacheStats MeshLayoutOptimizer::analyzeVertexCache(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        FALCOR_CHECK(indexCount % 3 == 0, "Index count ({}) must be a multiple of 3.", indexCount);
+        FALCOR_CHECK(cacheSize > 0, "Cache size must be larger than 0.");
+
+        CacheStats stats;
+        stats.triangleCount = indexCount / 3;
+
+        // A vertex is in the FIFO cache if less than cacheSize vertices have been inserted since it was inserted.
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t time = cacheSize + 1;
+        for (uint32_t i = 0; i < indexCount; i++)
+        {
+            uint32_t v = indices[i];
+            FALCOR_ASSERT(v < vertexCount);
+            if (timestamps[v] == 0) stats.vertexCount++;
+            if (time - timestamps[v] > cacheSize)
+            {
+                timestamps[v] = time++;
+                stats.cacheMissCount++;
+            }
+        }
+
+        return stats;
+    }
+
+    void MeshLayoutOptimizer::optimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        FALCOR_CHECK(indexCount % 3 == 0, "Index count ({}) must be a multiple of 3.", indexCount);
+        cacheSize = std::clamp(cacheSize, 4u, kMaxCacheSize);
+
+        const uint32_t triangleCount = indexCount / 3;
+        if (triangleCount == 0) return;
+
+        Adjacency adjacency(indices, indexCount, vertexCount);
+
+        VertexScoreTable scoreTable(cacheSize);
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) vertexScores[v] = scoreTable.getScore(-1, adjacency.liveCount[v]);
+
+        auto computeTriangleScore = [&](uint32_t t)
+        {
+            return vertexScores[indices[3 * t]] + vertexScores[indices[3 * t + 1]] + vertexScores[indices[3 * t + 2]];
+        };
+
+        uint32_t bestTriangle = 0;
+        float bestScore = computeTriangleScore(0);
+        for (uint32_t t = 1; t < triangleCount; t++)
+        {
+            float score = computeTriangleScore(t);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestTriangle = t;
+            }
+        }
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> result(indexCount);
+        uint32_t cache[kMaxCacheSize + 3];
+        uint32_t newCache[kMaxCacheSize + 3];
+        uint32_t cacheCount = 0;
+        uint32_t cursor = 0;
+
+        for (uint32_t i = 0; i < triangleCount; i++)
+        {
+            if (bestTriangle == kInvalidIndex)
+            {
+                // Dead end, continue with the next triangle in input order.
+                while (emitted[cursor]) cursor++;
+                bestTriangle = cursor;
+            }
+
+            const uint32_t t = bestTriangle;
+            const uint32_t tri[3] = { indices[3 * t], indices[3 * t + 1], indices[3 * t + 2] };
+            std::copy(tri, tri + 3, result.data() + 3 * i);
+            emitted[t] = true;
+
+            for (uint32_t v : tri) adjacency.remove(v, t);
+
+            // Put the triangle vertices at the front of the cache, followed by the previous entries.
+            uint32_t newCacheCount = 0;
+            for (uint32_t v : tri)
+            {
+                if (std::find(newCache, newCache + newCacheCount, v) == newCache + newCacheCount) newCache[newCacheCount++] = v;
+            }
+            for (uint32_t j = 0; j < cacheCount; j++)
+            {
+                uint32_t v = cache[j];
+                if (v != tri[0] && v != tri[1] && v != tri[2]) newCache[newCacheCount++] = v;
+            }
+
+            // Update the scores of all vertices that moved in or out of the cache.
+            for (uint32_t j = 0; j < newCacheCount; j++)
+            {
+                uint32_t v = newCache[j];
+                cachePositions[v] = j < cacheSize ? (int32_t)j : -1;
+                vertexScores[v] = scoreTable.getScore(cachePositions[v], adjacency.liveCount[v]);
+            }
+
+            cacheCount = std::min(newCacheCount, cacheSize);
+            std::copy(newCache, newCache + cacheCount, cache);
+
+            // Pick the best triangle among the ones using vertices in the cache.
+            bestTriangle = kInvalidIndex;
+            bestScore = -std::numeric_limits<float>::infinity();
+            for (uint32_t j = 0; j < cacheCount; j++)
+            {
+                uint32_t v = cache[j];
+                for (const uint32_t* it = adjacency.begin(v); it != adjacency.end(v); ++it)
+                {
+                    float score = computeTriangleScore(*it);
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = *it;
+                    }
+                }
+            }
+        }
+
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    std::vector<MeshLayoutOptimizer::Meshlet> MeshLayoutOptimizer::buildMeshlets(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        FALCOR_CHECK(indexCount % 3 == 0, "Index count ({}) must be a multiple of 3.", indexCount);
+        FALCOR_CHECK(maxVertices >= 3 && maxTriangles >= 1, "Invalid meshlet limits ({} vertices, {} triangles).", maxVertices, maxTriangles);
+
+        const uint32_t triangleCount = indexCount / 3;
+        std::vector<Meshlet> meshlets;
+        if (triangleCount == 0) return meshlets;
+
+        Adjacency adjacency(indices, indexCount, vertexCount);
+        std::vector<bool> assigned(triangleCount, false);
+        std::vector<uint32_t> vertexMeshlet(vertexCount, kInvalidIndex); // Last meshlet referencing each vertex.
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> result;
+        result.reserve(indexCount);
+
+        auto countNewVertices = [&](uint32_t t, uint32_t meshletIndex)
+        {
+            const uint32_t* tri = indices + 3 * t;
+            uint32_t count = 0;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                bool isDuplicate = (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+                if (!isDuplicate && vertexMeshlet[tri[k]] != meshletIndex) count++;
+            }
+            return count;
+        };
+
+        uint32_t cursor = 0;
+        while (result.size() < indexCount)
+        {
+            const uint32_t meshletIndex = (uint32_t)meshlets.size();
+            Meshlet meshlet;
+            meshlet.triangleOffset = (uint32_t)(result.size() / 3);
+
+            // Seed the meshlet with a triangle next to the previous meshlet if possible, otherwise with the next triangle in input order.
+            uint32_t t = kInvalidIndex;
+            for (uint32_t candidate : candidates)
+            {
+                if (!assigned[candidate])
+                {
+                    t = candidate;
+                    break;
+                }
+            }
+            if (t == kInvalidIndex)
+            {
+                while (assigned[cursor]) cursor++;
+                t = cursor;
+            }
+            candidates.clear();
+
+            // Grow the meshlet over shared vertices, preferring triangles that add the fewest new vertices.
+            while (t != kInvalidIndex)
+            {
+                assigned[t] = true;
+                meshlet.triangleCount++;
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    uint32_t v = indices[3 * t + k];
+                    result.push_back(v);
+                    adjacency.remove(v, t);
+                    if (vertexMeshlet[v] != meshletIndex)
+                    {
+                        vertexMeshlet[v] = meshletIndex;
+                        meshlet.vertexCount++;
+                        candidates.insert(candidates.end(), adjacency.begin(v), adjacency.end(v));
+                    }
+                }
+
+                t = kInvalidIndex;
+                if (meshlet.triangleCount == maxTriangles) break;
+
+                uint32_t bestNewVertexCount = 4;
+                for (size_t c = 0; c < candidates.size();)
+                {
+                    uint32_t candidate = candidates[c];
+                    if (assigned[candidate])
+                    {
+                        candidates[c] = candidates.back();
+                        candidates.pop_back();
+                        continue;
+                    }
+                    uint32_t newVertexCount = countNewVertices(candidate, meshletIndex);
+                    if (meshlet.vertexCount + newVertexCount <= maxVertices && newVertexCount < bestNewVertexCount)
+                    {
+                        bestNewVertexCount = newVertexCount;
+                        t = candidate;
+                        if (newVertexCount == 0) break;
+                    }
+                    c++;
+                }
+            }
+
+            meshlets.push_back(meshlet);
+        }
+
+        // Optimize the triangle order within each meshlet, using meshlet local vertex indices.
+        std::vector<uint32_t> localIndices;
+        std::vector<uint32_t> localVertices;
+        std::vector<uint32_t> globalToLocal(vertexCount, kInvalidIndex);
+        for (const Meshlet& meshlet : meshlets)
+        {
+            uint32_t* meshletIndices = result.data() + 3 * meshlet.triangleOffset;
+            const uint32_t meshletIndexCount = 3 * meshlet.triangleCount;
+
+            localIndices.resize(meshletIndexCount);
+            localVertices.clear();
+            for (uint32_t i = 0; i < meshletIndexCount; i++)
+            {
+                uint32_t v = meshletIndices[i];
+                if (globalToLocal[v] == kInvalidIndex)
+                {
+                    globalToLocal[v] = (uint32_t)localVertices.size();
+                    localVertices.push_back(v);
+                }
+                localIndices[i] = globalToLocal[v];
+            }
+            FALCOR_ASSERT(localVertices.size() == meshlet.vertexCount);
+
+            optimizeVertexCache(localIndices.data(), meshletIndexCount, (uint32_t)localVertices.size());
+
+            for (uint32_t i = 0; i < meshletIndexCount; i++) meshletIndices[i] = localVertices[localIndices[i]];
+            for (uint32_t v : localVertices) globalToLocal[v] = kInvalidIndex;
+        }
+
+        std::copy(result.begin(), result.end(), indices);
+        return meshlets;
+    }
+
+    std::vector<uint32_t> MeshLayoutOptimizer::optimizeVertexFetch(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount)
+    {
+        std::vector<uint32_t> remap(vertexCount, kInvalidIndex);
+        std::vector<uint32_t> vertexOrder;
+        vertexOrder.reserve(vertexCount);
+
+        for (uint32_t i = 0; i < indexCount; i++)
+        {
+            uint32_t v = indices[i];
+            FALCOR_ASSERT(v < vertexCount);
+            if (remap[v] == kInvalidIndex)
+            {
+                remap[v] = (uint32_t)vertexOrder.size();
+                vertexOrder.push_back(v);
+            }
+            indices[i] = remap[v];
+        }
+
+        // Keep unreferenced vertices at the end.
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            if (remap[v] == kInvalidIndex) vertexOrder.push_back(v);
+        }
+
+        return vertexOrder;
+    }
+}
@@ -0,0 +1,140 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Optimizes the memory layout of indexed triangle meshes for rasterization.
+
+        Three steps are provided, which are normally applied in this order:
+        - optimizeVertexCache() reorders triangles to improve post-transform vertex cache reuse.
+          It implements Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+        - buildMeshlets() is an alternative to the above that groups triangles into meshlet-sized
+          clusters (bounded number of vertices and triangles) grown over shared vertices, and then
+          optimizes the triangle order within each cluster. The clusters are stored as consecutive
+          triangle ranges in the index buffer.
+        - optimizeVertexFetch() reorders vertices in the order they are first referenced, so that
+          vertex fetches stream through memory.
+
+        Triangles are only reordered, the vertex order within each triangle (and thus the winding) is kept.
+        The result of each step is deterministic.
+    */
+    class FALCOR_API MeshLayoutOptimizer
+    {
+    public:
+        static constexpr uint32_t kDefaultCacheSize = 32;           ///< Simulated cache size used when optimizing the triangle order.
+        static constexpr uint32_t kDefaultAnalysisCacheSize = 16;   ///< FIFO cache size used when reporting cache statistics.
+        static constexpr uint32_t kDefaultMaxMeshletVertices = 64;
+        static constexpr uint32_t kDefaultMaxMeshletTriangles = 124;
+
+        /** Post-transform vertex cache statistics of an index buffer.
+        */
+        struct CacheStats
+        {
+            uint64_t triangleCount = 0;
+            uint64_t vertexCount = 0;       ///< Number of referenced vertices.
+            uint64_t cacheMissCount = 0;    ///< Number of vertex shader invocations.
+
+            /** Average cache miss ratio, i.e., vertex shader invocations per triangle (0.5 to 3, lower is better).
+            */
+            float getACMR() const { return triangleCount > 0 ? (float)cacheMissCount / (float)triangleCount : 0.f; }
+
+            /** Average transformed vertex ratio, i.e., vertex shader invocations per vertex (1 is optimal).
+            */
+            float getATVR() const { return vertexCount > 0 ? (float)cacheMissCount / (float)vertexCount : 0.f; }
+
+            CacheStats& operator+=(const CacheStats& other)
+            {
+                triangleCount += other.triangleCount;
+                vertexCount += other.vertexCount;
+                cacheMissCount += other.cacheMissCount;
+                return *this;
+            }
+        };
+
+        /** Range of triangles forming a meshlet.
+        */
+        struct Meshlet
+        {
+            uint32_t triangleOffset = 0;    ///< Index of the first triangle.
+            uint32_t triangleCount = 0;
+            uint32_t vertexCount = 0;       ///< Number of unique vertices referenced by the meshlet.
+        };
+
+        /** Compute post-transform vertex cache statistics using a FIFO cache.
+            \param[in] indices Triangle list indices.
+            \param[in] indexCount Number of indices. Must be a multiple of 3.
+            \param[in] vertexCount Number of vertices.
+            \param[in] cacheSize Number of entries in the simulated FIFO cache.
+            \return Cache statistics.
+        */
+        static CacheStats analyzeVertexCache(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = kDefaultAnalysisCacheSize);
+
+        /** Reorder triangles to improve post-transform vertex cache reuse.
+            \param[in,out] indices Triangle list indices, reordered in place.
+            \param[in] indexCount Number of indices. Must be a multiple of 3.
+            \param[in] vertexCount Number of vertices.
+            \param[in] cacheSize Number of entries in the simulated LRU cache.
+        */
+        static void optimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = kDefaultCacheSize);
+
+        /** Reorder triangles into meshlet-sized clusters, with vertex cache optimized triangle order within each cluster.
+            \param[in,out] indices Triangle list indices, reordered in place.
+            \param[in] indexCount Number of indices. Must be a multiple of 3.
+            \param[in] vertexCount Number of vertices.
+            \param[in] maxVertices Max number of unique vertices per meshlet (at least 3).
+            \param[in] maxTriangles Max number of triangles per meshlet (at least 1).
+            \return List of meshlets, in index buffer order.
+        */
+        static std::vector<Meshlet> buildMeshlets(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t maxVertices = kDefaultMaxMeshletVertices, uint32_t maxTriangles = kDefaultMaxMeshletTriangles);
+
+        /** Reorder vertices in the order they are first referenced by the index buffer.
+            Unreferenced vertices are kept and placed last, in their original order.
+            \param[in,out] indices Triangle list indices, remapped in place to the new vertex order.
+            \param[in] indexCount Number of indices.
+            \param[in] vertexCount Number of vertices.
+            \return Vertex order, i.e., for each new vertex index the old vertex index. Apply it to the vertex data with applyVertexOrder().
+        */
+        static std::vector<uint32_t> optimizeVertexFetch(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount);
+
+        /** Permute vertex data according to a vertex order returned by optimizeVertexFetch().
+            \param[in,out] vertices Vertex data.
+            \param[in] vertexOrder Old vertex index for each new vertex index.
+        */
+        template<typename T>
+        static void applyVertexOrder(std::vector<T>& vertices, const std::vector<uint32_t>& vertexOrder)
+        {
+            std::vector<T> reordered(vertexOrder.size());
+            for (size_t i = 0; i < vertexOrder.size(); i++) reordered[i] = vertices[vertexOrder[i]];
+            vertices = std::move(reordered);
+        }
+    };
+}
@@ -0,0 +1,520 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "PLYReader.h"
+#include <fmt/format.h>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace Falcor
+{
+    namespace
+    {
+        enum class ScalarType
+        {
+            Invalid,
+            Int8,
+            UInt8,
+            Int16,
+            UInt16,
+            Int32,
+            UInt32,
+            Float32,
+            Float64,
+        };
+
+        ScalarType parseScalarType(std::string_view name)
+        {
+            if (name == "char" || name == "int8") return ScalarType::Int8;
+            if (name == "uchar" || name == "uint8") return ScalarType::UInt8;
+            if (name == "short" || name == "int16") return ScalarType::Int16;
+            if (name == "ushort" || name == "uint16") return ScalarType::UInt16;
+            if (name == "int" || name == "int32") return ScalarType::Int32;
+            if (name == "uint" || name == "uint32") return ScalarType::UInt32;
+            if (name == "float" || name == "float32") return ScalarType::Float32;
+            if (name == "double" || name == "float64") return ScalarType::Float64;
+            return ScalarType::Invalid;
+        }
+
+        size_t getScalarSize(ScalarType type)
+        {
+            switch (type)
+            {
+            case ScalarType::Int8:
+            case ScalarType::UInt8: return 1;
+            case ScalarType::Int16:
+            case ScalarType::UInt16: return 2;
+            case ScalarType::Int32:
+            case ScalarType::UInt32:
+            case ScalarType::Float32: return 4;
+            case ScalarType::Float64: return 8;
+            default: return 0;
+            }
+        }
+
+        template<typename T>
+        T loadUnaligned(const uint8_t* p)
+        {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            return value;
+        }
+
+        double readScalar(const uint8_t* p, ScalarType type)
+        {
+            switch (type)
+            {
+            case ScalarType::Int8: return (double)loadUnaligned<int8_t>(p);
+            case ScalarType::UInt8: return (double)loadUnaligned<uint8_t>(p);
+            case ScalarType::Int16: return (double)loadUnaligned<int16_t>(p);
+            case ScalarType::UInt16: return (double)loadUnaligned<uint16_t>(p);
+            case ScalarType::Int32: return (double)loadUnaligned<int32_t>(p);
+            case ScalarType::UInt32: return (double)loadUnaligned<uint32_t>(p);
+            case ScalarType::Float32: return (double)loadUnaligned<float>(p);
+            case ScalarType::Float64: return loadUnaligned<double>(p);
+            default: return 0.0;
+            }
+        }
+
+        /** Read an integer scalar. Returns false for negative values.
+        */
+        bool readIndex(const uint8_t* p, ScalarType type, uint32_t& value)
+        {
+            switch (type)
+            {
+            case ScalarType::UInt8: value = loadUnaligned<uint8_t>(p); return true;
+            case ScalarType::UInt16: value = loadUnaligned<uint16_t>(p); return true;
+            case ScalarType::UInt32: value = loadUnaligned<uint32_t>(p); return true;
+            default:
+            {
+                double d = readScalar(p, type);
+                if (d < 0.0 || d > (double)std::numeric_limits<uint32_t>::max()) return false;
+                value = (uint32_t)d;
+                return true;
+            }
+            }
+        }
+
+        struct Property
+        {
+            std::string name;
+            ScalarType type = ScalarType::Invalid;
+            bool isList = false;
+            ScalarType countType = ScalarType::Invalid;
+        };
+
+        struct Element
+        {
+            std::string name;
+            uint64_t count = 0;
+            std::vector<Property> properties;
+
+            bool hasLists() const
+            {
+                for (const auto& p : properties) if (p.isList) return true;
+                return false;
+            }
+
+            /** Size of a single element in bytes. Only valid if there are no list properties.
+            */
+            size_t getStride() const
+            {
+                size_t stride = 0;
+                for (const auto& p : properties) stride += getScalarSize(p.type);
+                return stride;
+            }
+
+            /** Byte offset of a named property or -1 if not found. Only valid if there are no list properties.
+            */
+            int64_t getOffset(std::string_view name, ScalarType& type) const
+            {
+                size_t offset = 0;
+                for (const auto& p : properties)
+                {
+                    if (p.name == name)
+                    {
+                        type = p.type;
+                        return (int64_t)offset;
+                    }
+                    offset += getScalarSize(p.type);
+                }
+                return -1;
+            }
+        };
+
+        /** Split a header line into whitespace separated tokens.
+        */
+        std::vector<std::string_view> tokenize(std::string_view line)
+        {
+            std::vector<std::string_view> tokens;
+            size_t i = 0;
+            while (i < line.size())
+            {
+                while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+                size_t start = i;
+                while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') ++i;
+                if (i > start) tokens.push_back(line.substr(start, i - start));
+            }
+            return tokens;
+        }
+
+        struct Reader
+        {
+            const uint8_t* pData;
+            size_t size;
+            size_t pos = 0;
+            PLYReader::Result result;
+
+            PLYReader::Result& fail(PLYReader::Status status, std::string error)
+            {
+                result.status = status;
+                result.error = std::move(error);
+                result.vertices.clear();
+                result.indices.clear();
+                return result;
+            }
+
+            bool readLine(std::string_view& line)
+            {
+                if (pos >= size) return false;
+                const char* pStart = reinterpret_cast<const char*>(pData + pos);
+                const void* pEnd = std::memchr(pStart, '\n', size - pos);
+                size_t length = pEnd ? (size_t)(reinterpret_cast<const char*>(pEnd) - pStart) : size - pos;
+                line = std::string_view(pStart, length);
+                pos += length + (pEnd ? 1 : 0);
+                return true;
+            }
+
+            PLYReader::Result& read()
+            {
+                // Parse header.
+                std::vector<Element> elements;
+                std::string_view line;
+                if (!readLine(line) || tokenize(line) != std::vector<std::string_view>{"ply"})
+                    return fail(PLYReader::Status::Error, "Missing 'ply' magic");
+
+                bool binaryLittleEndian = false;
+                bool endOfHeader = false;
+                while (!endOfHeader && readLine(line))
+                {
+                    auto tokens = tokenize(line);
+                    if (tokens.empty()) continue;
+                    const auto& keyword = tokens[0];
+                    if (keyword == "format")
+                    {
+                        if (tokens.size() < 2) return fail(PLYReader::Status::Error, "Invalid 'format' declaration");
+                        if (tokens[1] != "binary_little_endian")
+                            return fail(PLYReader::Status::Unsupported, fmt::format("Unsupported format '{}'", tokens[1]));
+                        binaryLittleEndian = true;
+                    }
+                    else if (keyword == "element")
+                    {
+                        if (tokens.size() != 3) return fail(PLYReader::Status::Error, "Invalid 'element' declaration");
+                        Element element;
+                        element.name = std::string(tokens[1]);
+                        try
+                        {
+                            element.count = std::stoull(std::string(tokens[2]));
+                        }
+                        catch (const std::exception&)
+                        {
+                            return fail(PLYReader::Status::Error, fmt::format("Invalid element count '{}'", tokens[2]));
+                        }
+                        elements.push_back(std::move(element));
+                    }
+                    else if (keyword == "property")
+                    {
+                        if (elements.empty()) return fail(PLYReader::Status::Error, "Property declared before element");
+                        Property property;
+                        if (tokens.size() == 5 && tokens[1] == "list")
+                        {
+                            property.isList = true;
+                            property.countType = parseScalarType(tokens[2]);
+                            property.type = parseScalarType(tokens[3]);
+                            property.name = std::string(tokens[4]);
+                            if (property.countType == ScalarType::Invalid || property.countType == ScalarType::Float32 || property.countType == ScalarType::Float64)
+                                return fail(PLYReader::Status::Error, fmt::format("Invalid list count type '{}'", tokens[2]));
+                        }
+                        else if (tokens.size() == 3)
+                        {
+                            property.type = parseScalarType(tokens[1]);
+                            property.name = std::string(tokens[2]);
+                        }
+                        else
+                        {
+                            return fail(PLYReader::Status::Error, "Invalid 'property' declaration");
+                        }
+                        if (property.type == ScalarType::Invalid)
+                            return fail(PLYReader::Status::Error, fmt::format("Invalid type for property '{}'", property.name));
+                        elements.back().properties.push_back(std::move(property));
+                    }
+                    else if (keyword == "end_header")
+                    {
+                        endOfHeader = true;
+                    }
+                    // Ignore 'comment', 'obj_info' and unknown keywords.
+                }
+
+                if (!endOfHeader) return fail(PLYReader::Status::Error, "Missing 'end_header'");
+                if (!binaryLittleEndian) return fail(PLYReader::Status::Unsupported, "Missing or unsupported format");
+
+                // Read element data in declaration order.
+                bool foundVertices = false;
+                bool foundFaces = false;
+                for (const auto& element : elements)
+                {
+                    bool ok = true;
+                    if (element.name == "vertex" && !foundVertices)
+                    {
+                        if (element.hasLists()) return fail(PLYReader::Status::Unsupported, "List properties on vertices are not supported");
+                        ok = readVertices(element);
+                        foundVertices = true;
+                    }
+                    else if (element.name == "face" && !foundFaces)
+                    {
+                        ok = readFaces(element);
+                        foundFaces = true;
+                    }
+                    else
+                    {
+                        ok = skipElement(element);
+                    }
+                    if (!ok) return result;
+                }
+
+                if (!foundVertices) return fail(PLYReader::Status::Error, "Missing 'vertex' element");
+                if (!foundFaces) return fail(PLYReader::Status::Unsupported, "Missing 'face' element");
+
+                result.status = PLYReader::Status::Success;
+                return result;
+            }
+
+            bool readVertices(const Element& element)
+            {
+                const size_t stride = element.getStride();
+                if (stride == 0 || element.count > (size - pos) / stride)
+                {
+                    fail(PLYReader::Status::Error, "Unexpected end of file in 'vertex' element");
+                    return false;
+                }
+                if (element.count > std::numeric_limits<uint32_t>::max())
+                {
+                    fail(PLYReader::Status::Error, "Too many vertices");
+                    return false;
+                }
+
+                struct Attrib
+                {
+                    int64_t offset = -1;
+                    ScalarType type = ScalarType::Invalid;
+                };
+                auto find = [&element](std::initializer_list<std::string_view> names)
+                {
+                    Attrib a;
+                    for (auto name : names)
+                    {
+                        a.offset = element.getOffset(name, a.type);
+                        if (a.offset >= 0) break;
+                    }
+                    return a;
+                };
+
+                Attrib xyz[3] = { find({"x"}), find({"y"}), find({"z"}) };
+                Attrib nrm[3] = { find({"nx"}), find({"ny"}), find({"nz"}) };
+                Attrib uv[2] = { find({"u", "s", "texture_u", "texture_s"}), find({"v", "t", "texture_v", "texture_t"}) };
+
+                if (xyz[0].offset < 0 || xyz[1].offset < 0 || xyz[2].offset < 0)
+                {
+                    fail(PLYReader::Status::Error, "Missing vertex position properties");
+                    return false;
+                }
+                result.hasNormals = nrm[0].offset >= 0 && nrm[1].offset >= 0 && nrm[2].offset >= 0;
+                result.hasTexCoords = uv[0].offset >= 0 && uv[1].offset >= 0;
+
+                // Fast path for the common layout of tightly packed float attributes.
+                auto isFloat = [](const Attrib& a) { return a.type == ScalarType::Float32; };
+                const bool allFloat = isFloat(xyz[0]) && isFloat(xyz[1]) && isFloat(xyz[2]) &&
+                    (!result.hasNormals || (isFloat(nrm[0]) && isFloat(nrm[1]) && isFloat(nrm[2]))) &&
+                    (!result.hasTexCoords || (isFloat(uv[0]) && isFloat(uv[1])));
+
+                auto& vertices = result.vertices;
+                vertices.resize(element.count);
+                const uint8_t* p = pData + pos;
+                for (size_t i = 0; i < vertices.size(); ++i, p += stride)
+                {
+                    auto& v = vertices[i];
+                    if (allFloat)
+                    {
+                        v.position = float3(loadUnaligned<float>(p + xyz[0].offset), loadUnaligned<float>(p + xyz[1].offset), loadUnaligned<float>(p + xyz[2].offset));
+                        v.normal = result.hasNormals ? float3(loadUnaligned<float>(p + nrm[0].offset), loadUnaligned<float>(p + nrm[1].offset), loadUnaligned<float>(p + nrm[2].offset)) : float3(0.f);
+                        v.texCoord = result.hasTexCoords ? float2(loadUnaligned<float>(p + uv[0].offset), 1.f - loadUnaligned<float>(p + uv[1].offset)) : float2(0.f);
+                    }
+                    else
+                    {
+                        auto get = [p](const Attrib& a) { return (float)readScalar(p + a.offset, a.type); };
+                        v.position = float3(get(xyz[0]), get(xyz[1]), get(xyz[2]));
+                        v.normal = result.hasNormals ? float3(get(nrm[0]), get(nrm[1]), get(nrm[2])) : float3(0.f);
+                        v.texCoord = result.hasTexCoords ? float2(get(uv[0]), 1.f - get(uv[1])) : float2(0.f);
+                    }
+                }
+                pos += element.count * stride;
+                return true;
+            }
+
+            bool readFaces(const Element& element)
+            {
+                // Find the vertex index list. All other properties are skipped.
+                const Property* pIndexProperty = nullptr;
+                for (const auto& p : element.properties)
+                {
+                    if (p.isList && (p.name == "vertex_indices" || p.name == "vertex_index"))
+                    {
+                        pIndexProperty = &p;
+                        break;
+                    }
+                }
+                if (!pIndexProperty)
+                {
+                    fail(PLYReader::Status::Error, "Missing 'vertex_indices' face property");
+                    return false;
+                }
+                if (getScalarSize(pIndexProperty->type) == 0 || pIndexProperty->type == ScalarType::Float32 || pIndexProperty->type == ScalarType::Float64)
+                {
+                    fail(PLYReader::Status::Error, "Invalid vertex index type");
+                    return false;
+                }
+
+                const uint32_t vertexCount = (uint32_t)result.vertices.size();
+                auto& indices = result.indices;
+                // Reserve assuming triangles, the common case.
+                if (element.count <= (size - pos) / 4) indices.reserve(element.count * 3);
+
+                uint32_t polygon[256];
+                std::vector<uint32_t> largePolygon;
+
+                for (uint64_t face = 0; face < element.count; ++face)
+                {
+                    for (const auto& property : element.properties)
+                    {
+                        if (!property.isList)
+                        {
+                            size_t bytes = getScalarSize(property.type);
+                            if (bytes > size - pos) return unexpectedEnd();
+                            pos += bytes;
+                            continue;
+                        }
+
+                        const size_t countSize = getScalarSize(property.countType);
+                        if (countSize > size - pos) return unexpectedEnd();
+                        uint32_t count = 0;
+                        if (!readIndex(pData + pos, property.countType, count))
+                        {
+                            fail(PLYReader::Status::Error, "Invalid list count");
+                            return false;
+                        }
+                        pos += countSize;
+
+                        const size_t itemSize = getScalarSize(property.type);
+                        if (count > (size - pos) / itemSize) return unexpectedEnd();
+
+                        if (&property != pIndexProperty)
+                        {
+                            pos += count * itemSize;
+                            continue;
+                        }
+
+                        uint32_t* pPolygon = polygon;
+                        if (count > std::size(polygon))
+                        {
+                            largePolygon.resize(count);
+                            pPolygon = largePolygon.data();
+                        }
+                        for (uint32_t i = 0; i < count; ++i, pos += itemSize)
+                        {
+                            if (!readIndex(pData + pos, property.type, pPolygon[i]) || pPolygon[i] >= vertexCount)
+                            {
+                                fail(PLYReader::Status::Error, fmt::format("Vertex index out of bounds in face {}", face));
+                                return false;
+                            }
+                        }
+
+                        // Triangulate as a fan. Degenerate faces with fewer than 3 vertices are skipped.
+                        for (uint32_t i = 2; i < count; ++i)
+                        {
+                            indices.push_back(pPolygon[0]);
+                            indices.push_back(pPolygon[i - 1]);
+                            indices.push_back(pPolygon[i]);
+                        }
+                    }
+                }
+                return true;
+            }
+
+            bool skipElement(const Element& element)
+            {
+                if (!element.hasLists())
+                {
+                    const size_t stride = element.getStride();
+                    if (stride > 0 && element.count > (size - pos) / stride) return unexpectedEnd();
+                    pos += element.count * stride;
+                    return true;
+                }
+                for (uint64_t i = 0; i < element.count; ++i)
+                {
+                    for (const auto& property : element.properties)
+                    {
+                        uint32_t count = 1;
+                        if (property.isList)
+                        {
+                            const size_t countSize = getScalarSize(property.countType);
+                            if (countSize > size - pos || !readIndex(pData + pos, property.countType, count)) return unexpectedEnd();
+                            pos += countSize;
+                        }
+                        const size_t itemSize = getScalarSize(property.type);
+                        if (count > (size - pos) / itemSize) return unexpectedEnd();
+                        pos += count * itemSize;
+                    }
+                }
+                return true;
+            }
+
+            bool unexpectedEnd()
+            {
+                fail(PLYReader::Status::Error, "Unexpected end of file");
+                return false;
+            }
+        };
+    }
+
+    PLYReader::Result PLYReader::read(const void* pData, size_t size)
+    {
+        Reader reader{ reinterpret_cast<const uint8_t*>(pData), size };
+        return std::move(reader.read());
+    }
+}
@@ -0,0 +1,74 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "TriangleMesh.h"
+#include "Core/Macros.h"
+#include <string>
+
+namespace Falcor
+{
+    /** Streaming reader for binary little-endian PLY triangle meshes.
+
+        The reader parses the header and then reads the vertex and face elements
+        directly from the given memory (typically a memory-mapped file) into the
+        TriangleMesh vertex/index layout. Polygons are triangulated as fans, which
+        for quads results in the triangles (0,1,2) and (0,2,3).
+
+        Only binary little-endian files are supported. ASCII and big-endian files,
+        as well as files with unusual layouts (e.g. list properties on vertices),
+        are reported as unsupported so that the caller can fall back to a more
+        general importer.
+    */
+    class FALCOR_API PLYReader
+    {
+    public:
+        enum class Status
+        {
+            Success,        ///< The mesh was successfully read.
+            Unsupported,    ///< The file is a PLY variant not handled by this reader.
+            Error,          ///< The file is malformed.
+        };
+
+        struct Result
+        {
+            Status status = Status::Error;
+            std::string error;                  ///< Error message if status is not Success.
+            TriangleMesh::VertexList vertices;  ///< Vertices. Texture coordinates are flipped (v' = 1 - v) to match the ASSIMP import path.
+            TriangleMesh::IndexList indices;    ///< Triangle list indices.
+            bool hasNormals = false;            ///< True if the file contains vertex normals.
+            bool hasTexCoords = false;          ///< True if the file contains texture coordinates.
+        };
+
+        /** Read a PLY mesh from memory.
+            \param[in] pData Pointer to the file data.
+            \param[in] size Size of the file data in bytes.
+            \return Read result.
+        */
+        static Result read(const void* pData, size_t size);
+    };
+}
@@ -0,0 +1,451 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFBrickGrid.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/MathConstants.slangh"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kFileMagic[4] = { 'S', 'D', 'F', 'B' };
+        const uint32_t kFileVersion = 1;
+
+        // Limits that keep the brick grid size and the per-brick data size within 32 bits.
+        const uint32_t kMaxGridWidth = 1024;
+        const uint32_t kMaxBrickWidth = 255;
+
+        struct FileHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t gridWidth;
+            uint32_t brickWidth;
+            float bandWidth;
+            uint32_t brickCount;
+        };
+
+        struct BrickHeader
+        {
+            uint32_t brickIndex;
+            uint32_t quantization;
+            float minValue;
+            float maxValue;
+        };
+
+        size_t getValueSize(SDFBrickGrid::Quantization quantization)
+        {
+            switch (quantization)
+            {
+            case SDFBrickGrid::Quantization::None: return sizeof(float);
+            case SDFBrickGrid::Quantization::UNorm16: return sizeof(uint16_t);
+            case SDFBrickGrid::Quantization::UNorm8: return sizeof(uint8_t);
+            default: FALCOR_UNREACHABLE(); return 0;
+            }
+        }
+
+        template<typename T>
+        void encodeUNorm(const std::vector<float>& values, float minValue, float maxValue, uint8_t* pDst)
+        {
+            const float maxCode = float(std::numeric_limits<T>::max());
+            const float scale = maxValue > minValue ? maxCode / (maxValue - minValue) : 0.f;
+            T* pCodes = reinterpret_cast<T*>(pDst);
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                pCodes[i] = T(std::clamp(std::round((values[i] - minValue) * scale), 0.f, maxCode));
+            }
+        }
+
+        template<typename T>
+        void decodeUNorm(const uint8_t* pSrc, uint32_t count, float minValue, float maxValue, float* values)
+        {
+            const float scale = (maxValue - minValue) / float(std::numeric_limits<T>::max());
+            const T* pCodes = reinterpret_cast<const T*>(pSrc);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                values[i] = minValue + float(pCodes[i]) * scale;
+            }
+        }
+
+        /** Write all corner values of a brick grid into a dense array.
+            Empty bricks are written first so that stored bricks take precedence for shared boundary values.
+        */
+        template<typename T, typename Convert>
+        void writeDenseValues(const SDFBrickGrid& grid, std::vector<T>& values, Convert convert)
+        {
+            const uint32_t gridWidth = grid.getGridWidth();
+            const uint32_t brickWidth = grid.getBrickWidth();
+            const uint32_t brickGridWidth = grid.getBrickGridWidth();
+            const size_t gridWidthInValues = gridWidth + 1;
+            values.resize(gridWidthInValues * gridWidthInValues * gridWidthInValues);
+
+            const T insideValue = convert(-grid.getBandWidth());
+            const T outsideValue = convert(grid.getBandWidth());
+
+            for (uint32_t bz = 0; bz < brickGridWidth; bz++)
+            {
+                for (uint32_t by = 0; by < brickGridWidth; by++)
+                {
+                    for (uint32_t bx = 0; bx < brickGridWidth; bx++)
+                    {
+                        uint32_t brickIndex = bx + brickGridWidth * (by + brickGridWidth * bz);
+                        T value = grid.isEmptyBrickInside(brickIndex) ? insideValue : outsideValue;
+
+                        size_t xBegin = bx * brickWidth;
+                        size_t xEnd = std::min(xBegin + brickWidth, size_t(gridWidth)) + 1;
+                        for (uint32_t z = bz * brickWidth; z <= std::min((bz + 1) * brickWidth, gridWidth); z++)
+                        {
+                            for (uint32_t y = by * brickWidth; y <= std::min((by + 1) * brickWidth, gridWidth); y++)
+                            {
+                                auto row = values.begin() + gridWidthInValues * (y + gridWidthInValues * z);
+                                std::fill(row + xBegin, row + xEnd, value);
+                            }
+                        }
+                    }
+                }
+            }
+
+            const uint32_t brickWidthInValues = brickWidth + 1;
+            std::vector<float> brickValues(grid.getBrickValueCount());
+            for (uint32_t i = 0; i < grid.getBrickCount(); i++)
+            {
+                grid.decodeBrick(i, brickValues.data());
+
+                uint32_t brickIndex = grid.getBrick(i).brickIndex;
+                uint32_t x0 = (brickIndex % brickGridWidth) * brickWidth;
+                uint32_t y0 = ((brickIndex / brickGridWidth) % brickGridWidth) * brickWidth;
+                uint32_t z0 = (brickIndex / (brickGridWidth * brickGridWidth)) * brickWidth;
+
+                for (uint32_t z = 0; z < brickWidthInValues && z0 + z <= gridWidth; z++)
+                {
+                    for (uint32_t y = 0; y < brickWidthInValues && y0 + y <= gridWidth; y++)
+                    {
+                        for (uint32_t x = 0; x < brickWidthInValues && x0 + x <= gridWidth; x++)
+                        {
+                            values[(x0 + x) + gridWidthInValues * ((y0 + y) + gridWidthInValues * (z0 + z))] =
+                                convert(brickValues[x + brickWidthInValues * (y + brickWidthInValues * z)]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    SDFBrickGrid SDFBrickGrid::createFromValues(const std::vector<float>& cornerValues, uint32_t gridWidth, const Options& options)
+    {
+        const size_t gridWidthInValues = gridWidth + 1;
+        FALCOR_CHECK(cornerValues.size() == gridWidthInValues * gridWidthInValues * gridWidthInValues, "'cornerValues' must contain (gridWidth + 1)^3 values.");
+
+        SDFBrickGrid grid;
+        grid.init(gridWidth, options);
+        for (uint32_t bz = 0; bz < grid.mBrickGridWidth; bz++)
+        {
+            grid.addBrickLayer(bz, cornerValues.data() + bz * options.brickWidth * gridWidthInValues * gridWidthInValues, options);
+        }
+        return grid;
+    }
+
+    bool SDFBrickGrid::convertDenseFile(const std::filesystem::path& densePath, const std::filesystem::path& sparsePath, const Options& options)
+    {
+        std::ifstream file(densePath, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+        {
+            logWarning("SDFBrickGrid::convertDenseFile() file '{}' could not be opened!", densePath);
+            return false;
+        }
+
+        uint32_t gridWidth = 0;
+        file.read(reinterpret_cast<char*>(&gridWidth), sizeof(uint32_t));
+        const size_t gridWidthInValues = gridWidth + 1;
+        const size_t planeValueCount = gridWidthInValues * gridWidthInValues;
+        if (!file || gridWidth == 0 || gridWidth > kMaxGridWidth || std::filesystem::file_size(densePath) < sizeof(uint32_t) + planeValueCount * gridWidthInValues * sizeof(float))
+        {
+            logWarning("SDFBrickGrid::convertDenseFile() file '{}' is not a valid SDF grid file!", densePath);
+            return false;
+        }
+
+        SDFBrickGrid grid;
+        grid.init(gridWidth, options);
+
+        // Read one layer of bricks at a time. Consecutive layers share a plane of values.
+        std::vector<float> planes((options.brickWidth + 1) * planeValueCount);
+        for (uint32_t bz = 0; bz < grid.mBrickGridWidth; bz++)
+        {
+            uint32_t z0 = bz * options.brickWidth;
+            uint32_t planeCount = std::min(options.brickWidth, gridWidth - z0) + 1;
+            file.seekg(sizeof(uint32_t) + z0 * planeValueCount * sizeof(float));
+            file.read(reinterpret_cast<char*>(planes.data()), planeCount * planeValueCount * sizeof(float));
+            if (!file)
+            {
+                logWarning("SDFBrickGrid::convertDenseFile() failed to read from '{}'!", densePath);
+                return false;
+            }
+            grid.addBrickLayer(bz, planes.data(), options);
+        }
+
+        return grid.writeToFile(sparsePath);
+    }
+
+    bool SDFBrickGrid::isBrickGridFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        char magic[4] = {};
+        file.read(magic, sizeof(magic));
+        return file && std::memcmp(magic, kFileMagic, sizeof(kFileMagic)) == 0;
+    }
+
+    bool SDFBrickGrid::readFromFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+        {
+            logWarning("SDFBrickGrid::readFromFile() file '{}' could not be opened!", path);
+            return false;
+        }
+
+        FileHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 || header.version != kFileVersion || header.gridWidth == 0 || header.brickWidth == 0)
+        {
+            logWarning("SDFBrickGrid::readFromFile() file '{}' is not a valid sparse SDF grid file!", path);
+            return false;
+        }
+
+        // Validate the header before allocating anything based on it.
+        if (header.gridWidth > kMaxGridWidth || header.brickWidth > kMaxBrickWidth)
+        {
+            logWarning("SDFBrickGrid::readFromFile() file '{}' has an unsupported grid width {} or brick width {}!", path, header.gridWidth, header.brickWidth);
+            return false;
+        }
+
+        // The sign mask and all bricks must fit in the file. Each brick takes at least its header and one byte per value.
+        std::error_code ec;
+        const uint64_t fileSize = std::filesystem::file_size(path, ec);
+        const uint64_t headerBrickGridWidth = (header.gridWidth + header.brickWidth - 1) / header.brickWidth;
+        const uint64_t headerBrickGridCount = headerBrickGridWidth * headerBrickGridWidth * headerBrickGridWidth;
+        const uint64_t signMaskSize = (headerBrickGridCount + 31) / 32 * sizeof(uint32_t);
+        const uint64_t brickValueCount = uint64_t(header.brickWidth + 1) * (header.brickWidth + 1) * (header.brickWidth + 1);
+        const uint64_t minBrickSize = sizeof(BrickHeader) + brickValueCount * getValueSize(Quantization::UNorm8);
+        if (ec || header.brickCount > headerBrickGridCount || fileSize < sizeof(header) + signMaskSize + header.brickCount * minBrickSize)
+        {
+            logWarning("SDFBrickGrid::readFromFile() file '{}' is truncated or corrupt!", path);
+            return false;
+        }
+
+        Options options;
+        options.brickWidth = header.brickWidth;
+        init(header.gridWidth, options);
+        mBandWidth = header.bandWidth;
+
+        file.read(reinterpret_cast<char*>(mSignMask.data()), mSignMask.size() * sizeof(uint32_t));
+
+        const uint32_t brickGridCount = mBrickGridWidth * mBrickGridWidth * mBrickGridWidth;
+        const uint32_t valueCount = getBrickValueCount();
+        uint64_t remainingSize = fileSize - sizeof(header) - signMaskSize;
+        mBricks.reserve(header.brickCount);
+        for (uint32_t i = 0; i < header.brickCount && file; i++)
+        {
+            BrickHeader brickHeader;
+            file.read(reinterpret_cast<char*>(&brickHeader), sizeof(brickHeader));
+            if (brickHeader.brickIndex >= brickGridCount || brickHeader.quantization > (uint32_t)Quantization::UNorm8) break;
+
+            const uint64_t brickDataSize = valueCount * getValueSize((Quantization)brickHeader.quantization);
+            if (remainingSize < sizeof(BrickHeader) + brickDataSize) break;
+            remainingSize -= sizeof(BrickHeader) + brickDataSize;
+
+            Brick brick;
+            brick.brickIndex = brickHeader.brickIndex;
+            brick.quantization = (Quantization)brickHeader.quantization;
+            brick.minValue = brickHeader.minValue;
+            brick.maxValue = brickHeader.maxValue;
+            brick.dataOffset = mData.size();
+
+            mData.resize(mData.size() + brickDataSize);
+            file.read(reinterpret_cast<char*>(mData.data() + brick.dataOffset), mData.size() - brick.dataOffset);
+            mBricks.push_back(brick);
+        }
+
+        if (!file || mBricks.size() != header.brickCount)
+        {
+            logWarning("SDFBrickGrid::readFromFile() file '{}' is truncated or corrupt!", path);
+            *this = SDFBrickGrid();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SDFBrickGrid::writeToFile(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        if (!file.is_open())
+        {
+            logWarning("SDFBrickGrid::writeToFile() file '{}' could not be opened!", path);
+            return false;
+        }
+
+        FileHeader header;
+        std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+        header.version = kFileVersion;
+        header.gridWidth = mGridWidth;
+        header.brickWidth = mBrickWidth;
+        header.bandWidth = mBandWidth;
+        header.brickCount = getBrickCount();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(mSignMask.data()), mSignMask.size() * sizeof(uint32_t));
+
+        const uint32_t valueCount = getBrickValueCount();
+        for (const Brick& brick : mBricks)
+        {
+            BrickHeader brickHeader = { brick.brickIndex, (uint32_t)brick.quantization, brick.minValue, brick.maxValue };
+            file.write(reinterpret_cast<const char*>(&brickHeader), sizeof(brickHeader));
+            file.write(reinterpret_cast<const char*>(mData.data() + brick.dataOffset), valueCount * getValueSize(brick.quantization));
+        }
+
+        return file.good();
+    }
+
+    void SDFBrickGrid::decodeBrick(uint32_t index, float* values) const
+    {
+        FALCOR_ASSERT(index < mBricks.size());
+        const Brick& brick = mBricks[index];
+        const uint8_t* pData = mData.data() + brick.dataOffset;
+        const uint32_t valueCount = getBrickValueCount();
+
+        switch (brick.quantization)
+        {
+        case Quantization::None: std::memcpy(values, pData, valueCount * sizeof(float)); break;
+        case Quantization::UNorm16: decodeUNorm<uint16_t>(pData, valueCount, brick.minValue, brick.maxValue, values); break;
+        case Quantization::UNorm8: decodeUNorm<uint8_t>(pData, valueCount, brick.minValue, brick.maxValue, values); break;
+        default: FALCOR_UNREACHABLE();
+        }
+    }
+
+    void SDFBrickGrid::getNormalizedValues(float normalizationFactor, std::vector<int8_t>& values) const
+    {
+        writeDenseValues(*this, values, [normalizationFactor](float value)
+        {
+            float normalizedValue = std::clamp(value * normalizationFactor, -1.0f, 1.0f);
+            float integerScale = normalizedValue * float(INT8_MAX);
+            return integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+        });
+    }
+
+    void SDFBrickGrid::getDenseValues(std::vector<float>& values) const
+    {
+        writeDenseValues(*this, values, [](float value) { return value; });
+    }
+
+    void SDFBrickGrid::init(uint32_t gridWidth, const Options& options)
+    {
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be larger than 0.");
+        FALCOR_CHECK(options.brickWidth > 0, "'brickWidth' must be larger than 0.");
+        FALCOR_CHECK(gridWidth <= kMaxGridWidth, "'gridWidth' ({}) must not be larger than {}.", gridWidth, kMaxGridWidth);
+        FALCOR_CHECK(options.brickWidth <= kMaxBrickWidth, "'brickWidth' ({}) must not be larger than {}.", options.brickWidth, kMaxBrickWidth);
+
+        mGridWidth = gridWidth;
+        mBrickWidth = options.brickWidth;
+        mBrickGridWidth = (gridWidth + options.brickWidth - 1) / options.brickWidth;
+        mBandWidth = options.narrowBandThickness * 0.5f * float(M_SQRT3) / gridWidth;
+
+        uint32_t brickGridCount = mBrickGridWidth * mBrickGridWidth * mBrickGridWidth;
+        mSignMask.assign((brickGridCount + 31) / 32, 0);
+        mBricks.clear();
+        mData.clear();
+    }
+
+    void SDFBrickGrid::addBrickLayer(uint32_t brickZ, const float* pPlanes, const Options& options)
+    {
+        const size_t gridWidthInValues = mGridWidth + 1;
+        const uint32_t brickWidthInValues = mBrickWidth + 1;
+        const uint32_t z0 = brickZ * mBrickWidth;
+
+        std::vector<float> brickValues(getBrickValueCount());
+        for (uint32_t by = 0; by < mBrickGridWidth; by++)
+        {
+            for (uint32_t bx = 0; bx < mBrickGridWidth; bx++)
+            {
+                const uint32_t x0 = bx * mBrickWidth;
+                const uint32_t y0 = by * mBrickWidth;
+
+                // Gather the brick values. Values outside the grid replicate the grid border.
+                bool allInside = true;
+                bool allOutside = true;
+                for (uint32_t z = 0; z < brickWidthInValues; z++)
+                {
+                    for (uint32_t y = 0; y < brickWidthInValues; y++)
+                    {
+                        for (uint32_t x = 0; x < brickWidthInValues; x++)
+                        {
+                            size_t plane = std::min(z0 + z, mGridWidth) - z0;
+                            size_t row = std::min(y0 + y, mGridWidth);
+                            size_t column = std::min(x0 + x, mGridWidth);
+                            float value = pPlanes[column + gridWidthInValues * (row + gridWidthInValues * plane)];
+
+                            allInside = allInside && value <= -mBandWidth;
+                            allOutside = allOutside && value >= mBandWidth;
+                            brickValues[x + brickWidthInValues * (y + brickWidthInValues * z)] = std::clamp(value, -mBandWidth, mBandWidth);
+                        }
+                    }
+                }
+
+                const uint32_t brickIndex = bx + mBrickGridWidth * (by + mBrickGridWidth * brickZ);
+                if (allInside || allOutside)
+                {
+                    if (allInside) mSignMask[brickIndex / 32] |= 1u << (brickIndex % 32);
+                    continue;
+                }
+
+                Brick brick;
+                brick.brickIndex = brickIndex;
+                brick.quantization = options.quantization;
+                brick.minValue = *std::min_element(brickValues.begin(), brickValues.end());
+                brick.maxValue = *std::max_element(brickValues.begin(), brickValues.end());
+                brick.dataOffset = mData.size();
+
+                mData.resize(mData.size() + brickValues.size() * getValueSize(brick.quantization));
+                uint8_t* pDst = mData.data() + brick.dataOffset;
+                switch (brick.quantization)
+                {
+                case Quantization::None: std::memcpy(pDst, brickValues.data(), brickValues.size() * sizeof(float)); break;
+                case Quantization::UNorm16: encodeUNorm<uint16_t>(brickValues, brick.minValue, brick.maxValue, pDst); break;
+                case Quantization::UNorm8: encodeUNorm<uint8_t>(brickValues, brick.minValue, brick.maxValue, pDst); break;
+                default: FALCOR_UNREACHABLE();
+                }
+
+                mBricks.push_back(brick);
+            }
+        }
+    }
+}
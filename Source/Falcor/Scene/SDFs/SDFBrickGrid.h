@@ -0,0 +1,184 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace Falcor
+{
+    /** Sparse narrow-band SDF grid, stored as a set of bricks.
+
+        The grid of (gridWidth + 1)^3 corner values is divided into bricks of brickWidth^3 voxels, i.e. (brickWidth + 1)^3 values,
+        where neighboring bricks share their boundary values. Only bricks that contain values inside the narrow band are stored.
+        A brick is empty if all of its values have the same sign and an absolute value of at least the band width,
+        in which case only its sign is stored (one bit per brick). Stored values are clamped to [-bandWidth, bandWidth].
+
+        The band width defaults to half a voxel diagonal, which is the range that the SDFSVS, SDFSBS and SDFSVO grids can represent.
+        For these grids a brick grid without quantization holds the same information as the dense grid.
+
+        Each stored brick can optionally be quantized to 8 or 16 bits relative to the value range of the brick.
+
+        File format (.sdfb, little endian):
+            FileHeader
+            uint32_t signMask[(brickGridWidth^3 + 31) / 32]   One bit per brick, set if an empty brick is inside the surface.
+            For each stored brick:
+                BrickHeader
+                (brickWidth + 1)^3 values as float, uint16_t or uint8_t depending on the quantization, with x varying fastest.
+    */
+    class FALCOR_API SDFBrickGrid
+    {
+    public:
+        enum class Quantization : uint32_t
+        {
+            None = 0,       ///< 32-bit float values.
+            UNorm16 = 1,    ///< 16-bit values relative to the value range of the brick.
+            UNorm8 = 2,     ///< 8-bit values relative to the value range of the brick.
+        };
+
+        struct Options
+        {
+            uint32_t brickWidth = 8;                        ///< Width of a brick in voxels.
+            float narrowBandThickness = 1.f;                ///< Narrow band thickness in half voxel diagonals.
+            Quantization quantization = Quantization::None; ///< Quantization of the stored bricks.
+        };
+
+        struct Brick
+        {
+            uint32_t brickIndex = 0;                        ///< Linear index of the brick in the brick grid.
+            Quantization quantization = Quantization::None; ///< Quantization of the brick values.
+            float minValue = 0.f;                           ///< Smallest value in the brick, used for dequantization.
+            float maxValue = 0.f;                           ///< Largest value in the brick, used for dequantization.
+            uint64_t dataOffset = 0;                        ///< Byte offset of the brick values in the data blob.
+        };
+
+        SDFBrickGrid() = default;
+
+        /** Create a brick grid from dense corner values.
+            \param[in] cornerValues The corner values for all voxels in the grid, (gridWidth + 1)^3 values.
+            \param[in] gridWidth The grid width in voxels, at most 1024. The brick width is at most 255.
+            \param[in] options Conversion options.
+            \return The brick grid.
+        */
+        static SDFBrickGrid createFromValues(const std::vector<float>& cornerValues, uint32_t gridWidth, const Options& options);
+
+        /** Convert a dense .sdfg file to a sparse .sdfb file.
+            The dense file is streamed one layer of bricks at a time, so the dense grid is never fully loaded into memory.
+            \param[in] densePath The path of the .sdfg file.
+            \param[in] sparsePath The path of the .sdfb file to write.
+            \param[in] options Conversion options.
+            \return true if the file was converted, otherwise false.
+        */
+        static bool convertDenseFile(const std::filesystem::path& densePath, const std::filesystem::path& sparsePath, const Options& options);
+
+        /** Check if a file is a sparse brick grid file.
+            \param[in] path The path of the file.
+            \return true if the file starts with the .sdfb file header magic.
+        */
+        static bool isBrickGridFile(const std::filesystem::path& path);
+
+        /** Read a brick grid from a .sdfb file. Files with a grid or brick width above the supported maximum are rejected.
+            \param[in] path The path of the file.
+            \return true if the file could be read, otherwise false.
+        */
+        bool readFromFile(const std::filesystem::path& path);
+
+        /** Write the brick grid to a .sdfb file.
+            \param[in] path The path of the file.
+            \return true if the file could be written, otherwise false.
+        */
+        bool writeToFile(const std::filesystem::path& path) const;
+
+        /** Returns the width of the grid in voxels.
+        */
+        uint32_t getGridWidth() const { return mGridWidth; }
+
+        /** Returns the width of a brick in voxels.
+        */
+        uint32_t getBrickWidth() const { return mBrickWidth; }
+
+        /** Returns the width of the brick grid in bricks.
+        */
+        uint32_t getBrickGridWidth() const { return mBrickGridWidth; }
+
+        /** Returns the half width of the narrow band in the local space of the grid.
+        */
+        float getBandWidth() const { return mBandWidth; }
+
+        /** Returns the number of stored bricks.
+        */
+        uint32_t getBrickCount() const { return (uint32_t)mBricks.size(); }
+
+        /** Returns a stored brick.
+        */
+        const Brick& getBrick(uint32_t index) const { return mBricks[index]; }
+
+        /** Returns the number of values per brick, (brickWidth + 1)^3.
+        */
+        uint32_t getBrickValueCount() const { uint32_t w = mBrickWidth + 1; return w * w * w; }
+
+        /** Returns true if the brick at a given brick grid index is empty and inside the surface.
+        */
+        bool isEmptyBrickInside(uint32_t brickIndex) const { return (mSignMask[brickIndex / 32] >> (brickIndex % 32)) & 1u; }
+
+        /** Decode the values of a stored brick.
+            \param[in] index Index of the stored brick.
+            \param[out] values Decoded values, (brickWidth + 1)^3 values with x varying fastest.
+        */
+        void decodeBrick(uint32_t index, float* values) const;
+
+        /** Write the grid as normalized snorm8 corner values, as used by the sparse SDF grid types.
+            The dense float grid is never materialized.
+            \param[in] normalizationFactor Factor that maps distances to normalized distances, which are clamped to [-1, 1].
+            \param[out] values (gridWidth + 1)^3 normalized values.
+        */
+        void getNormalizedValues(float normalizationFactor, std::vector<int8_t>& values) const;
+
+        /** Write the grid as dense float corner values. Values outside the narrow band are set to +-bandWidth.
+            \param[out] values (gridWidth + 1)^3 values.
+        */
+        void getDenseValues(std::vector<float>& values) const;
+
+        /** Returns the size of the stored brick data in bytes.
+        */
+        size_t getDataSize() const { return mData.size(); }
+
+    private:
+        void init(uint32_t gridWidth, const Options& options);
+        void addBrickLayer(uint32_t brickZ, const float* pPlanes, const Options& options);
+
+        uint32_t mGridWidth = 0;
+        uint32_t mBrickWidth = 0;
+        uint32_t mBrickGridWidth = 0;
+        float mBandWidth = 0.f;
+        std::vector<uint32_t> mSignMask;
+        std::vector<Brick> mBricks;
+        std::vector<uint8_t> mData;
+    };
+}
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SDFGrid.h"
+#include "SDFBrickGrid.h"
 #include "GlobalState.h"
 #include "NormalizedDenseSDFGrid/NDSDFGrid.h"
 #include "SparseVoxelSet/SDFSVS.h"
@@ -268,8 +269,35 @@ namespace Falcor
         setValuesInternal(cornerValues);
     }
 
+    void SDFGrid::setValues(const SDFBrickGrid& brickGrid)
+    {
+        uint32_t gridWidth = brickGrid.getGridWidth();
+
+        // All types except SBS need to have a gridWidth that is a power of 2.
+        Type type = getType();
+        if (type != Type::SparseBrickSet)
+        {
+            FALCOR_CHECK(isPowerOf2(gridWidth), "'gridWidth' ({}) must be a power of 2 for SDFGrid type of {}", gridWidth, getTypeName(type));
+        }
+
+        mGridWidth = gridWidth;
+
+        setValuesInternal(brickGrid);
+    }
+
     bool SDFGrid::loadValuesFromFile(const std::filesystem::path& path)
     {
+        if (SDFBrickGrid::isBrickGridFile(path))
+        {
+            SDFBrickGrid brickGrid;
+            if (!brickGrid.readFromFile(path)) return false;
+
+            setValues(brickGrid);
+
+            mInitializedWithPrimitives = false;
+            return true;
+        }
+
         std::ifstream file(path, std::ios::in | std::ios::binary);
 
         if (file.is_open())
@@ -292,6 +320,13 @@ namespace Falcor
         return false;
     }
 
+    void SDFGrid::setValuesInternal(const SDFBrickGrid& brickGrid)
+    {
+        std::vector<float> cornerValues;
+        brickGrid.getDenseValues(cornerValues);
+        setValuesInternal(cornerValues);
+    }
+
     void SDFGrid::generateCheeseValues(uint32_t gridWidth, uint32_t seed)
     {
         const float kHalfCheeseExtent = 0.4f;
@@ -492,11 +527,35 @@ namespace Falcor
             [](SDFGrid& self, const std::filesystem::path& path) { return self.loadValuesFromFile(getActiveAssetResolver().resolvePath(path)); },
             "path"_a
         ); // PYTHONDEPRECATED
+        sdfGrid.def_static("convertValuesFileToSparse",
+            [](const std::filesystem::path& densePath, const std::filesystem::path& sparsePath, uint32_t brickWidth, float narrowBandThickness, uint32_t quantizationBits)
+            {
+                SDFBrickGrid::Options options;
+                options.brickWidth = brickWidth;
+                options.narrowBandThickness = narrowBandThickness;
+                switch (quantizationBits)
+                {
+                case 32: options.quantization = SDFBrickGrid::Quantization::None; break;
+                case 16: options.quantization = SDFBrickGrid::Quantization::UNorm16; break;
+                case 8: options.quantization = SDFBrickGrid::Quantization::UNorm8; break;
+                default: FALCOR_THROW("'quantizationBits' ({}) must be 8, 16 or 32.", quantizationBits);
+                }
+                return SDFBrickGrid::convertDenseFile(getActiveAssetResolver().resolvePath(densePath), sparsePath, options);
+            },
+            "densePath"_a, "sparsePath"_a, "brickWidth"_a = 8, "narrowBandThickness"_a = 1.f, "quantizationBits"_a = 32
+        );
         sdfGrid.def("loadPrimitivesFromFile",
             [](SDFGrid& self, const std::filesystem::path& path, uint32_t gridWidth) { return self.loadPrimitivesFromFile(getActiveAssetResolver().resolvePath(path), gridWidth); },
             "path"_a, "gridWidth"_a
         ); // PYTHONDEPRECATED
         sdfGrid.def("generateCheeseValues", &SDFGrid::generateCheeseValues, "gridWidth"_a, "seed"_a);
+        sdfGrid.def("buildOnCPU",
+            [](SDFGrid& self)
+            {
+                FALCOR_CHECK(self.getType() == SDFGrid::Type::SparseBrickSet, "buildOnCPU() is only supported for sparse brick sets.");
+                static_cast<SDFSBS&>(self).buildOnCPU();
+            }
+        );
         sdfGrid.def_property("name", &SDFGrid::getName, &SDFGrid::setName);
     }
 
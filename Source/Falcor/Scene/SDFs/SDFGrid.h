@@ -41,6 +41,7 @@
 namespace Falcor
 {
     class RenderContext;
+    class SDFBrickGrid;
     struct ShaderVar;
 
     /** SDF grid base class, stored by distance values at grid cell/voxel corners.
@@ -123,8 +124,14 @@ namespace Falcor
         */
         void setValues(const std::vector<float>& cornerValues, uint32_t gridWidth);
 
+        /** Set the signed distance values of the SDF grid from a sparse brick grid.
+            \param[in] brickGrid The sparse brick grid, see SDFBrickGrid.
+        */
+        void setValues(const SDFBrickGrid& brickGrid);
+
         /** Set the signed distance values of the SDF grid from a file.
-            \param[in] path The path of a .sdfg file.
+            Sparse .sdfb files (see SDFBrickGrid) are detected by their header and never expanded to a dense float grid.
+            \param[in] path The path of a .sdfg or .sdfb file.
             \return true if the values could be set, otherwise false.
         */
         bool loadValuesFromFile(const std::filesystem::path& path);
@@ -236,6 +243,10 @@ namespace Falcor
     protected:
         virtual void setValuesInternal(const std::vector<float>& cornerValues) = 0;
 
+        /** Set the values from a sparse brick grid. The default implementation expands the brick grid to dense values.
+        */
+        virtual void setValuesInternal(const SDFBrickGrid& brickGrid);
+
         void createEvaluatePrimitivesPass(bool writeToTexture3D, bool mergeWithSDField);
 
         void updatePrimitivesBuffer();
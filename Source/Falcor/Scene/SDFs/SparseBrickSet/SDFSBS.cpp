@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SDFSBS.h"
+#include "Scene/SDFs/SDFBrickGrid.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Core/API/IndirectCommands.h"
@@ -99,6 +100,14 @@ namespace Falcor
 
     SDFGrid::UpdateFlags SDFSBS::update(RenderContext* pRenderContext)
     {
+        // Brick sets built on the CPU are static until their primitives change, after which they are rebuilt on the GPU.
+        if (mpBrickSetData)
+        {
+            if (!mPrimitivesDirty) return UpdateFlags::None;
+            mpBrickSetData.reset();
+            mpBrickTexture.reset();
+        }
+
         // No update is performed if the SDF grid isn't dirty or isn't constructed from primitives and should not be created as an empty grid.
         bool isEmpty = mPrimitives.empty() && !mpSDFGridTexture && !mWasEmpty;
         if ((!mPrimitivesDirty || (mPrimitives.empty() && !mHasGridRepresentation)) && !isEmpty) return UpdateFlags::None;
@@ -116,6 +125,15 @@ namespace Falcor
     {
         FALCOR_ASSERT(pRenderContext);
 
+        // Upload the brick set if it was built on the CPU.
+        if (mpBrickSetData && !mPrimitivesDirty)
+        {
+            createResourcesFromBrickSetData();
+            allocatePrimitiveBits();
+            return;
+        }
+        mpBrickSetData.reset();
+
         // Update grid texture, if user loads an sdf-file.
         if (!mSDField.empty())
         {
@@ -167,6 +185,65 @@ namespace Falcor
         var["normalizationFactor"] = 0.5f * float(M_SQRT3) / mGridWidth;
     }
 
+    void SDFSBS::setBrickSetData(SDFSBSBuilder::Data data)
+    {
+        FALCOR_CHECK(data.brickWidth == mBrickWidth && data.compressed == mCompressed, "Brick set data was built with a brick width ({}) or compression that doesn't match the SDFSBS", data.brickWidth);
+
+        mpBrickSetData = std::make_unique<SDFSBSBuilder::Data>(std::move(data));
+        mGridWidth = mpBrickSetData->gridWidth;
+        mPrimitivesDirty = false;
+    }
+
+    SDFSBSBuilder::Data SDFSBS::buildBrickSetData() const
+    {
+        if (mpBrickSetData && !mPrimitivesDirty) return *mpBrickSetData;
+
+        SDFSBSBuilder::Options options;
+        options.brickWidth = mBrickWidth;
+        options.compressed = mCompressed;
+
+        if (!mSDField.empty())
+        {
+            FALCOR_CHECK(mPrimitives.empty(), "Building an SDFSBS from both values and primitives on the CPU is not supported.");
+            return SDFSBSBuilder::buildFromSDField(mSDField, mGridWidth, options);
+        }
+
+        FALCOR_CHECK(!mpSDFGridTexture, "The values of the SDFSBS have already been uploaded to the GPU and can't be built on the CPU.");
+
+        // If the SBS has neither primitives nor values, this builds a single empty brick.
+        return SDFSBSBuilder::buildFromPrimitives(mPrimitives, mGridWidth != 0 ? mGridWidth : mDefaultGridWidth, options);
+    }
+
+    void SDFSBS::createResourcesFromBrickSetData()
+    {
+        const SDFSBSBuilder::Data& data = *mpBrickSetData;
+
+        mGridWidth = data.gridWidth;
+        mVirtualBricksPerAxis = data.virtualBricksPerAxis;
+        mBrickCount = data.brickCount;
+        mBricksPerAxis = data.bricksPerAxis;
+        mBrickTextureDimensions = data.brickTextureDimensions;
+
+        mpIndirectionTexture = mpDevice->createTexture3D(mVirtualBricksPerAxis, mVirtualBricksPerAxis, mVirtualBricksPerAxis, ResourceFormat::R32Uint, 1, data.indirection.data(), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+        mpIndirectionTexture->setName("SDFSBS::IndirectionTextureValues");
+
+        mpBrickAABBsBuffer = mpDevice->createStructuredBuffer(sizeof(AABB), mBrickCount, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, data.brickAABBs.data(), false);
+
+        if (mCompressed)
+        {
+            mpBrickTexture = mpDevice->createTexture2D(mBrickTextureDimensions.x, mBrickTextureDimensions.y, ResourceFormat::BC4Snorm, 1, 1, data.brickTexture.data());
+        }
+        else
+        {
+            mpBrickTexture = mpDevice->createTexture2D(mBrickTextureDimensions.x, mBrickTextureDimensions.y, ResourceFormat::R8Snorm, 1, 1, data.brickTexture.data(), ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource);
+        }
+
+        // The values and primitives are built into the brick set.
+        mSDField.clear();
+        mWasEmpty = false;
+        mPrimitivesDirty = false;
+    }
+
     void SDFSBS::createResourcesFromSDField(RenderContext* pRenderContext, bool deleteScratchData)
     {
         FALCOR_ASSERT(mpSDFGridTexture && mpSDFGridTexture->getWidth() == mGridWidth + 1);
@@ -977,6 +1054,7 @@ namespace Falcor
         uint32_t gridWidthInValues = mGridWidth + 1;
         uint32_t valueCount = gridWidthInValues * gridWidthInValues * gridWidthInValues;
         mSDField.resize(valueCount);
+        mpBrickSetData.reset();
 
         // The grid is in the size [-1, 1] thus the longest distance that can be stored is sqrt(3) (the length from corner to corner)
         float normalizationFactor = 2.0f * mGridWidth / float(M_SQRT3);
@@ -988,6 +1066,13 @@ namespace Falcor
         }
     }
 
+    void SDFSBS::setValuesInternal(const SDFBrickGrid& brickGrid)
+    {
+        // Normalize the values directly from the bricks without expanding them to a dense float grid.
+        mpBrickSetData.reset();
+        brickGrid.getNormalizedValues(2.0f * mGridWidth / float(M_SQRT3), mSDField);
+    }
+
     void SDFSBS::createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int8_t>& sdField)
     {
         FALCOR_CHECK(!sdField.empty(), "Cannot create SDF grid texture from empty values vector");
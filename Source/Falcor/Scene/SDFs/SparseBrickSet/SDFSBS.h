@@ -28,8 +28,10 @@
 #pragma once
 
 #include "Core/Pass/ComputePass.h"
+#include "SDFSBSBuilder.h"
 #include "Scene/SDFs/SDFGrid.h"
 #include "Utils/Algorithm/PrefixSum.h"
+#include <memory>
 
 namespace Falcor
 {
@@ -53,8 +55,26 @@ namespace Falcor
 
         uint32_t getVirtualBrickCoordsBitCount() const { return mVirtualBrickCoordsBitCount; }
         uint32_t getBrickLocalVoxelCoordsBrickCount() const { return mBrickLocalVoxelCoordsBitCount; }
+        uint32_t getBrickWidth() const { return mBrickWidth; }
         bool isCompressed() const { return mCompressed; }
 
+        /** Build the brick set on the CPU from the current values or primitives, see SDFSBSBuilder.
+            createResources() then uploads the result instead of running the GPU build passes.
+        */
+        void buildOnCPU() { setBrickSetData(buildBrickSetData()); }
+
+        /** Set brick set data built on the CPU, e.g., loaded from the scene cache.
+            createResources() uploads the data instead of running the GPU build passes.
+            \param[in] data Brick set data, must have been built with the brick width and compression of this SDFSBS.
+        */
+        void setBrickSetData(SDFSBSBuilder::Data data);
+
+        /** Get the brick set data for the current values or primitives.
+            Returns the data set with setBrickSetData() if available, otherwise builds it on the CPU.
+            Throws if the values have already been uploaded to the GPU, or if both values and primitives are used.
+        */
+        SDFSBSBuilder::Data buildBrickSetData() const;
+
         virtual size_t getSize() const override;
         virtual uint32_t getMaxPrimitiveIDBits() const override;
         virtual Type getType() const override { return Type::SparseBrickSet; }
@@ -64,12 +84,16 @@ namespace Falcor
         virtual const ref<Buffer>& getAABBBuffer() const override { return mpBrickAABBsBuffer; }
         virtual uint32_t getAABBCount() const override { return mBrickCount; }
 
+        const ref<Texture>& getIndirectionTexture() const { return mpIndirectionTexture; }
+        const ref<Texture>& getBrickTexture() const { return mpBrickTexture; }
+
         virtual void bindShaderData(const ShaderVar& var) const override;
 
         virtual float getResolutionScalingFactor() const override { return mResolutionScalingFactor; };
         virtual void resetResolutionScalingFactor() override { mResolutionScalingFactor = 1.0f; };
 
     protected:
+        void createResourcesFromBrickSetData();
         void createResourcesFromSDField(RenderContext* pRenderContext, bool deleteScratchData);
         SDFGrid::UpdateFlags createResourcesFromPrimitivesAndSDField(RenderContext* pRenderContext, bool deleteScratchData);
 
@@ -79,6 +103,7 @@ namespace Falcor
         void allocatePrimitiveBits();
 
         virtual void setValuesInternal(const std::vector<float>& cornerValues) override;
+        virtual void setValuesInternal(const SDFBrickGrid& brickGrid) override;
 
         void createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int8_t>& sdField);
 
@@ -89,6 +114,7 @@ namespace Falcor
     private:
         // CPU data.
         std::vector<int8_t> mSDField;
+        std::unique_ptr<SDFSBSBuilder::Data> mpBrickSetData;    ///< Brick set data built on the CPU, uploaded instead of building on the GPU.
 
         // Specs.
         uint32_t mDefaultGridWidth = 0;                 ///< The grid width used if the grid was not loaded from a file (it is empty).
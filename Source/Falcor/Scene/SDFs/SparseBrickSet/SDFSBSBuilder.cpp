@@ -0,0 +1,550 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFSBSBuilder.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Math/MathConstants.slangh"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Width of a BC4 block, see SDFSBSCreateBricksFromSDField.cs.slang.
+        const uint32_t kCompressionWidth = 4;
+
+        // Chunk width used when building from primitives, see SDFSBS.cpp.
+        const uint32_t kChunkWidth = 4;
+
+        template<typename Func>
+        void forEachIndex(bool parallel, uint32_t count, Func func)
+        {
+            auto range = NumericRange<uint32_t>(0, count);
+            if (parallel) std::for_each(std::execution::par, range.begin(), range.end(), func);
+            else std::for_each(range.begin(), range.end(), func);
+        }
+
+        /** Convert a normalized value to snorm8 as done by the GPU build passes.
+        */
+        int32_t toSnorm(float value)
+        {
+            float intScale = value * 127.f;
+            return int32_t(intScale >= 0.f ? intScale + 0.5f : intScale - 0.5f);
+        }
+
+        // CPU versions of the shapes in Utils/SDF/SDF3DShapes.slang.
+
+        float sdfSphere(float3 p, float r)
+        {
+            return length(p) - r;
+        }
+
+        float sdfEllipsoid(float3 p, float3 r)
+        {
+            float k0 = length(p / r);
+            float k1 = length(p / (r * r));
+            return k0 * (k0 - 1.f) / k1;
+        }
+
+        float sdfBox(float3 p, float3 b)
+        {
+            float3 q = abs(p) - b;
+            return length(max(q, float3(0.f))) + std::min(std::max(std::max(q.x, q.y), q.z), 0.f);
+        }
+
+        float sdfTorus(float3 p, float r)
+        {
+            return length(float2(length(float2(p.x, p.z)) - r, p.y));
+        }
+
+        float sdfCone(float3 p, float tan, float h)
+        {
+            float2 q = h * float2(tan, -1.f);
+            float2 w = float2(length(float2(p.x, p.z)), p.y - 0.5f * h);
+            float2 a = w - q * math::saturate(dot(w, q) / dot(q, q));
+            float2 b = w - q * float2(math::saturate(w.x / q.x), 1.f);
+            float k = sign(q.y);
+            float d = std::min(dot(a, a), dot(b, b));
+            float s = std::max(k * (w.x * q.y - w.y * q.x), k * (w.y - q.y));
+            return std::sqrt(d) * sign(s);
+        }
+
+        float sdfCapsule(float3 p, float hl)
+        {
+            p.y -= std::clamp(p.y, -hl, hl);
+            return length(p);
+        }
+
+        // CPU versions of the operations in Utils/SDF/SDFOperations.slang.
+
+        float smin(float a, float b, float k)
+        {
+            float h = std::max(k - std::abs(a - b), 0.f);
+            return std::min(a, b) - h * h * 0.25f / k;
+        }
+
+        float smax(float a, float b, float k)
+        {
+            float h = std::max(k - std::abs(a - b), 0.f);
+            return std::max(a, b) + h * h * 0.25f / k;
+        }
+
+        float evalShape(const SDF3DPrimitive& primitive, float3 p)
+        {
+            // Same (transposed) semantic as SDF3DPrimitive::evalShape() in SDF3DPrimitive.slang.
+            p = mul(transpose(primitive.invRotationScale), p - primitive.translation);
+            float d = FLT_MAX;
+
+            switch (primitive.shapeType)
+            {
+            case SDF3DShapeType::Sphere:    d = sdfSphere(p, primitive.shapeData.x); break;
+            case SDF3DShapeType::Ellipsoid: d = sdfEllipsoid(p, primitive.shapeData); break;
+            case SDF3DShapeType::Box:       d = sdfBox(p, primitive.shapeData); break;
+            case SDF3DShapeType::Torus:     d = sdfTorus(p, primitive.shapeData.x); break;
+            case SDF3DShapeType::Cone:      d = sdfCone(p, primitive.shapeData.x, primitive.shapeData.y); break;
+            case SDF3DShapeType::Capsule:   d = sdfCapsule(p, primitive.shapeData.x); break;
+            default: FALCOR_UNREACHABLE();
+            }
+
+            // Apply blobbing.
+            return d - primitive.shapeBlobbing;
+        }
+
+        float evalOperation(SDFOperationType operationType, float d, float dShape, float smoothing)
+        {
+            switch (operationType)
+            {
+            case SDFOperationType::Union:                 return std::min(d, dShape);
+            case SDFOperationType::Subtraction:           return std::max(d, -dShape);
+            case SDFOperationType::Intersection:          return std::max(d, dShape);
+            case SDFOperationType::SmoothUnion:           return smin(d, dShape, smoothing);
+            case SDFOperationType::SmoothSubtraction:     return smax(d, -dShape, smoothing);
+            case SDFOperationType::SmoothIntersection:    return smax(d, dShape, smoothing);
+            default: FALCOR_UNREACHABLE(); return d;
+            }
+        }
+
+        // CPU version of the BC4 encoder in BC4Encode.slang.
+
+        void fixRange(int32_t& minValue, int32_t& maxValue, int32_t steps)
+        {
+            if (maxValue - minValue < steps)
+            {
+                maxValue = std::min(minValue + steps, 127);
+                minValue = maxValue - minValue < steps ? std::max(-128, maxValue - steps) : minValue;
+            }
+        }
+
+        void rowRange(const int32_t row[4], int32_t& min5, int32_t& max5, int32_t& min7, int32_t& max7)
+        {
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                min7 = std::min(row[i], min7);
+                max7 = std::max(row[i], max7);
+                min5 = row[i] != -128 && row[i] < min5 ? row[i] : min5;
+                max5 = row[i] != 127 && row[i] > max5 ? row[i] : max5;
+            }
+        }
+
+        int32_t fitCodes(const int32_t block[16], const int32_t codes[8], uint32_t indices[16])
+        {
+            // Fit each value to the codebook.
+            int32_t err = 0;
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                // Find the least error and corresponding index.
+                int32_t least = std::numeric_limits<int32_t>::max();
+                uint32_t index = 0;
+                for (uint32_t j = 0; j < 8; ++j)
+                {
+                    int32_t dist = block[i] - codes[j];
+                    dist *= dist;
+                    if (dist < least)
+                    {
+                        least = dist;
+                        index = j;
+                    }
+                }
+
+                indices[i] = index;
+                err += least;
+            }
+            return err;
+        }
+
+        uint64_t writeAlphaBlock(int32_t alpha0, int32_t alpha1, const uint32_t indices[16])
+        {
+            uint64_t compressedBlock = 0;
+            compressedBlock |= uint64_t(alpha0 & 0xff);
+            compressedBlock |= uint64_t(alpha1 & 0xff) << 8;
+
+            // Pack the indices with 3 bits each.
+            for (uint32_t i = 0; i < 16; ++i) compressedBlock |= uint64_t(indices[i] & 0x7) << (3 * i + 16);
+            return compressedBlock;
+        }
+
+        uint64_t writeAlphaBlock5(int32_t alpha0, int32_t alpha1, const uint32_t indices[16])
+        {
+            if (alpha0 <= alpha1) return writeAlphaBlock(alpha0, alpha1, indices);
+
+            // Swap the endpoints and remap the indices.
+            uint32_t swappedIndices[16];
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint32_t index = indices[i];
+                if (index == 0)         swappedIndices[i] = 1;
+                else if (index == 1)    swappedIndices[i] = 0;
+                else if (index <= 5)    swappedIndices[i] = 7 - index;
+                else                    swappedIndices[i] = index;
+            }
+            return writeAlphaBlock(alpha1, alpha0, swappedIndices);
+        }
+
+        uint64_t writeAlphaBlock7(int32_t alpha0, int32_t alpha1, const uint32_t indices[16])
+        {
+            if (alpha0 >= alpha1) return writeAlphaBlock(alpha0, alpha1, indices);
+
+            // Swap the endpoints and remap the indices.
+            uint32_t swappedIndices[16];
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint32_t index = indices[i];
+                if (index == 0)         swappedIndices[i] = 1;
+                else if (index == 1)    swappedIndices[i] = 0;
+                else                    swappedIndices[i] = 9 - index;
+            }
+            return writeAlphaBlock(alpha1, alpha0, swappedIndices);
+        }
+
+        /** Build a sparse brick set, mirroring the GPU passes in SDFSBS.
+            \param[in] gridWidth The virtual grid width in voxels.
+            \param[in] virtualBricksPerAxis Number of virtual bricks along each axis.
+            \param[in] options Build options.
+            \param[in] divideByGridWidth Compute AABBs by dividing by the grid width (primitives pass) instead of multiplying with its reciprocal (SD field pass).
+            \param[in] getValue Returns the normalized value at the given grid coords, called for coords <= gridWidth.
+        */
+        template<typename GetValue>
+        SDFSBSBuilder::Data build(uint32_t gridWidth, uint32_t virtualBricksPerAxis, const SDFSBSBuilder::Options& options, bool divideByGridWidth, GetValue getValue)
+        {
+            FALCOR_CHECK(options.brickWidth > 0, "'brickWidth' must be larger than 0");
+            FALCOR_CHECK(!options.compressed || (options.brickWidth + 1) % kCompressionWidth == 0, "'brickWidth' ({}) must be a multiple of 4 minus 1 for compressed SDFSBSs", options.brickWidth);
+
+            const uint32_t brickWidth = options.brickWidth;
+            const uint32_t brickWidthInValues = brickWidth + 1;
+            const uint32_t virtualBrickCount = virtualBricksPerAxis * virtualBricksPerAxis * virtualBricksPerAxis;
+
+            auto getVirtualBrickCoords = [&](uint32_t virtualBrickID)
+            {
+                return uint3(virtualBrickID % virtualBricksPerAxis, (virtualBrickID / virtualBricksPerAxis) % virtualBricksPerAxis, virtualBrickID / (virtualBricksPerAxis * virtualBricksPerAxis));
+            };
+
+            // Evaluates the values of a brick, returns the number of values along each axis that lie inside the grid.
+            auto loadBrickValues = [&](uint3 brickGridCoords, std::vector<float>& values)
+            {
+                uint3 extent = min(uint3(brickWidthInValues), uint3(gridWidth + 1) - brickGridCoords);
+                values.resize(brickWidthInValues * brickWidthInValues * brickWidthInValues);
+                for (uint32_t z = 0; z < extent.z; ++z)
+                    for (uint32_t y = 0; y < extent.y; ++y)
+                        for (uint32_t x = 0; x < extent.x; ++x)
+                            values[x + brickWidthInValues * (y + brickWidthInValues * z)] = getValue(brickGridCoords + uint3(x, y, z));
+                return extent;
+            };
+
+            // Assign brick validity. If any voxel in a brick contains surface, the brick is valid.
+            std::vector<uint32_t> validity(virtualBrickCount, 0);
+            forEachIndex(options.parallel, virtualBrickCount, [&](uint32_t virtualBrickID)
+            {
+                std::vector<float> values;
+                uint3 valueExtent = loadBrickValues(getVirtualBrickCoords(virtualBrickID) * brickWidth, values);
+                uint3 voxelExtent = min(valueExtent - 1u, uint3(brickWidth));
+
+                for (uint32_t z = 0; z < voxelExtent.z; ++z)
+                {
+                    for (uint32_t y = 0; y < voxelExtent.y; ++y)
+                    {
+                        for (uint32_t x = 0; x < voxelExtent.x; ++x)
+                        {
+                            bool anyInside = false;
+                            bool anyOutside = false;
+                            for (uint32_t c = 0; c < 8; ++c)
+                            {
+                                float value = values[(x + (c & 1)) + brickWidthInValues * ((y + ((c >> 1) & 1)) + brickWidthInValues * (z + (c >> 2)))];
+                                anyInside |= value <= 0.f;
+                                anyOutside |= value >= 0.f;
+                            }
+
+                            if (anyInside && anyOutside)
+                            {
+                                validity[virtualBrickID] = 1;
+                                return;
+                            }
+                        }
+                    }
+                }
+            });
+
+            SDFSBSBuilder::Data data;
+            data.gridWidth = gridWidth;
+            data.brickWidth = brickWidth;
+            data.compressed = options.compressed;
+            data.virtualBricksPerAxis = virtualBricksPerAxis;
+
+            // Create the indirection data using an exclusive prefix sum over the validity.
+            // If no brick is valid, create one empty brick for the renderer to be happy, as done by the GPU build.
+            if (std::find(validity.begin(), validity.end(), 1u) == validity.end()) validity[0] = 1;
+
+            data.indirection.resize(virtualBrickCount);
+            std::vector<uint32_t> virtualBrickIDs;
+            for (uint32_t virtualBrickID = 0; virtualBrickID < virtualBrickCount; ++virtualBrickID)
+            {
+                if (validity[virtualBrickID])
+                {
+                    data.indirection[virtualBrickID] = (uint32_t)virtualBrickIDs.size();
+                    virtualBrickIDs.push_back(virtualBrickID);
+                }
+                else
+                {
+                    data.indirection[virtualBrickID] = std::numeric_limits<uint32_t>::max();
+                }
+            }
+            data.brickCount = (uint32_t)virtualBrickIDs.size();
+
+            // Lay out the bricks in the brick texture, see SDFSBS::createResourcesFromSDField().
+            uint32_t bricksAlongX = (uint32_t)std::ceil(std::sqrt((float)data.brickCount / brickWidthInValues));
+            uint32_t bricksAlongY = (uint32_t)std::ceil((float)data.brickCount / bricksAlongX);
+            data.bricksPerAxis = uint2(bricksAlongX, bricksAlongY);
+            data.brickTextureDimensions = uint2(brickWidthInValues * brickWidthInValues * bricksAlongX, brickWidthInValues * bricksAlongY);
+
+            const uint32_t blocksPerRow = data.brickTextureDimensions.x / kCompressionWidth;
+            if (options.compressed) data.brickTexture.resize(size_t(blocksPerRow) * (data.brickTextureDimensions.y / kCompressionWidth) * sizeof(uint64_t), 0);
+            else data.brickTexture.resize(size_t(data.brickTextureDimensions.x) * data.brickTextureDimensions.y, 0);
+
+            // Create bricks and brick AABBs.
+            data.brickAABBs.resize(data.brickCount);
+            forEachIndex(options.parallel, data.brickCount, [&](uint32_t brickID)
+            {
+                uint3 virtualBrickCoords = getVirtualBrickCoords(virtualBrickIDs[brickID]);
+                uint3 brickGridCoords = virtualBrickCoords * brickWidth;
+
+                // Calculate the AABB min and max corners for the brick.
+                float3 brickAABBMin;
+                float3 brickAABBMax;
+                if (divideByGridWidth)
+                {
+                    brickAABBMin = -0.5f + float3(brickGridCoords) / float(gridWidth);
+                    brickAABBMax = min(brickAABBMin + brickWidth / float(gridWidth), float3(0.5f));
+                }
+                else
+                {
+                    const float oneOverGridWidth = 1.f / float(gridWidth);
+                    brickAABBMin = -0.5f + float3(brickGridCoords) * oneOverGridWidth;
+                    brickAABBMax = min(brickAABBMin + float(brickWidth) * oneOverGridWidth, float3(0.5f));
+                }
+                data.brickAABBs[brickID] = AABB(brickAABBMin, brickAABBMax);
+
+                // Convert the brick values to snorm. Values at or outside the virtual grid width are set to 1.
+                std::vector<float> values;
+                loadBrickValues(brickGridCoords, values);
+                auto getSnormValue = [&](uint32_t x, uint32_t y, uint32_t z)
+                {
+                    if (any(brickGridCoords + uint3(x, y, z) >= gridWidth)) return 127;
+                    return toSnorm(values[x + brickWidthInValues * (y + brickWidthInValues * z)]);
+                };
+
+                // Calculate the min corner of the brick in the brick texture.
+                uint2 brickTextureCoords = uint2(brickID % bricksAlongX, brickID / bricksAlongX) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues);
+
+                for (uint32_t z = 0; z < brickWidthInValues; ++z)
+                {
+                    if (options.compressed)
+                    {
+                        for (uint32_t y = 0; y < brickWidthInValues; y += kCompressionWidth)
+                        {
+                            for (uint32_t x = 0; x < brickWidthInValues; x += kCompressionWidth)
+                            {
+                                int32_t block[16];
+                                for (uint32_t bY = 0; bY < kCompressionWidth; ++bY)
+                                    for (uint32_t bX = 0; bX < kCompressionWidth; ++bX)
+                                        block[bY * kCompressionWidth + bX] = getSnormValue(x + bX, y + bY, z);
+
+                                uint2 blockTextureCoords = (brickTextureCoords + uint2(x + z * brickWidthInValues, y)) / kCompressionWidth;
+                                uint64_t compressedBlock = SDFSBSBuilder::compressBC4Block(block);
+                                std::memcpy(&data.brickTexture[(size_t(blockTextureCoords.y) * blocksPerRow + blockTextureCoords.x) * sizeof(uint64_t)], &compressedBlock, sizeof(uint64_t));
+                            }
+                        }
+                    }
+                    else
+                    {
+                        for (uint32_t y = 0; y < brickWidthInValues; ++y)
+                        {
+                            for (uint32_t x = 0; x < brickWidthInValues; ++x)
+                            {
+                                uint2 texelCoords = brickTextureCoords + uint2(x + z * brickWidthInValues, y);
+                                data.brickTexture[size_t(texelCoords.y) * data.brickTextureDimensions.x + texelCoords.x] = uint8_t(int8_t(getSnormValue(x, y, z)));
+                            }
+                        }
+                    }
+                }
+            });
+
+            return data;
+        }
+    }
+
+    SDFSBSBuilder::Data SDFSBSBuilder::buildFromSDField(const std::vector<int8_t>& sdField, uint32_t gridWidth, const Options& options)
+    {
+        const uint32_t gridWidthInValues = gridWidth + 1;
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be larger than 0");
+        FALCOR_CHECK(sdField.size() == size_t(gridWidthInValues) * gridWidthInValues * gridWidthInValues, "'sdField' size ({}) does not match 'gridWidth' ({})", sdField.size(), gridWidth);
+
+        uint32_t virtualBricksPerAxis = (uint32_t)std::ceil(float(gridWidth) / options.brickWidth);
+
+        // Values are read as R8Snorm texels.
+        auto getValue = [&](uint3 coords)
+        {
+            return std::max(float(sdField[coords.x + gridWidthInValues * (coords.y + gridWidthInValues * size_t(coords.z))]) / 127.f, -1.f);
+        };
+
+        return build(gridWidth, virtualBricksPerAxis, options, false, getValue);
+    }
+
+    SDFSBSBuilder::Data SDFSBSBuilder::buildFromCornerValues(const std::vector<float>& cornerValues, uint32_t gridWidth, const Options& options)
+    {
+        const size_t valueCount = size_t(gridWidth + 1) * (gridWidth + 1) * (gridWidth + 1);
+        FALCOR_CHECK(cornerValues.size() == valueCount, "'cornerValues' size ({}) does not match 'gridWidth' ({})", cornerValues.size(), gridWidth);
+
+        // Quantize the values as done by SDFSBS::setValuesInternal().
+        std::vector<int8_t> sdField(valueCount);
+        float normalizationFactor = 2.0f * gridWidth / float(M_SQRT3);
+        for (size_t v = 0; v < valueCount; v++)
+        {
+            float normalizedValue = std::clamp(cornerValues[v] * normalizationFactor, -1.0f, 1.0f);
+            float integerScale = normalizedValue * float(INT8_MAX);
+            sdField[v] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+        }
+
+        return buildFromSDField(sdField, gridWidth, options);
+    }
+
+    SDFSBSBuilder::Data SDFSBSBuilder::buildFromPrimitives(const std::vector<SDF3DPrimitive>& primitives, uint32_t gridWidth, const Options& options)
+    {
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be larger than 0");
+
+        // Calculate the grid width that forms a grid of chunks of bricks, see SDFSBS::createResourcesFromPrimitivesAndSDField().
+        uint32_t subdivisionCount = (uint32_t)std::ceil(std::log2((float)gridWidth / options.brickWidth) / std::log2((float)kChunkWidth));
+        uint32_t virtualBricksPerAxis = (uint32_t)std::pow((float)kChunkWidth, (float)subdivisionCount);
+        gridWidth = options.brickWidth * virtualBricksPerAxis;
+
+        const float kRootThree = std::sqrt(3.f);
+        auto getValue = [&](uint3 coords)
+        {
+            const float3 p = -0.5f + float3(coords) / float(gridWidth);
+            float sd = evalPrimitives(primitives, p, FLT_MAX);
+
+            // Normalize the distance such that +-1 represent the half voxel distance to its diagonal.
+            return std::clamp(sd * 2.0f * float(gridWidth) / kRootThree, -1.0f, 1.0f);
+        };
+
+        return build(gridWidth, virtualBricksPerAxis, options, true, getValue);
+    }
+
+    float SDFSBSBuilder::evalPrimitives(const std::vector<SDF3DPrimitive>& primitives, float3 p, float d)
+    {
+        for (const SDF3DPrimitive& primitive : primitives)
+        {
+            d = evalOperation(primitive.operationType, d, evalShape(primitive, p), primitive.operationSmoothing);
+        }
+        return d;
+    }
+
+    uint64_t SDFSBSBuilder::compressBC4Block(const int32_t block[16])
+    {
+        // Get the range for 5-alpha and 7-alpha interpolation.
+        int32_t min5 = 127;
+        int32_t max5 = -128;
+        int32_t min7 = 127;
+        int32_t max7 = -128;
+
+        for (uint32_t row = 0; row < 4; ++row) rowRange(block + 4 * row, min5, max5, min7, max7);
+
+        min5 = std::min(min5, max5);
+        min7 = std::min(min7, max7);
+
+        // Fix the range to be the minimum in each case.
+        fixRange(min5, max5, 5);
+        fixRange(min7, max7, 7);
+
+        // Set up the 5-alpha code book.
+        int32_t codes5[8];
+        codes5[0] = min5;
+        codes5[1] = max5;
+        for (int32_t i = 1; i < 5; ++i) codes5[1 + i] = ((5 - i) * min5 + i * max5) / 5;
+        codes5[6] = -128;
+        codes5[7] = 127;
+
+        // Set up the 7-alpha code book.
+        int32_t codes7[8];
+        codes7[0] = min7;
+        codes7[1] = max7;
+        for (int32_t i = 1; i < 7; ++i) codes7[1 + i] = ((7 - i) * min7 + i * max7) / 7;
+
+        // Fit the data to both code books and use the one with the least error.
+        uint32_t indices5[16];
+        uint32_t indices7[16];
+        int32_t err5 = fitCodes(block, codes5, indices5);
+        int32_t err7 = fitCodes(block, codes7, indices7);
+
+        return err5 <= err7 ? writeAlphaBlock5(min5, max5, indices5) : writeAlphaBlock7(min7, max7, indices7);
+    }
+
+    void SDFSBSBuilder::decompressBC4Block(uint64_t compressedBlock, int32_t block[16])
+    {
+        int32_t alpha0 = int8_t(compressedBlock & 0xff);
+        int32_t alpha1 = int8_t((compressedBlock >> 8) & 0xff);
+
+        int32_t codes[8];
+        codes[0] = alpha0;
+        codes[1] = alpha1;
+        if (alpha0 > alpha1)
+        {
+            for (int32_t i = 1; i < 7; ++i) codes[1 + i] = (int32_t)std::lround(((7 - i) * alpha0 + i * alpha1) / 7.f);
+        }
+        else
+        {
+            for (int32_t i = 1; i < 5; ++i) codes[1 + i] = (int32_t)std::lround(((5 - i) * alpha0 + i * alpha1) / 5.f);
+            codes[6] = -127;
+            codes[7] = 127;
+        }
+
+        for (uint32_t i = 0; i < 16; ++i) block[i] = codes[(compressedBlock >> (3 * i + 16)) & 0x7];
+    }
+}
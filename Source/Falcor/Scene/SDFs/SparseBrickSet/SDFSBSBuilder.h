@@ -0,0 +1,120 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Scene/SDFs/SDF3DPrimitiveCommon.slang"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** CPU builder for SDF sparse brick sets (SDFSBS).
+
+        Produces the same brick AABBs, indirection texture and brick texture as the GPU build passes in SDFSBS,
+        so that sparse brick sets can be built without a GPU, tested headlessly and stored in the scene cache.
+        The build is parallelized over bricks.
+
+        Bricks are assigned IDs in virtual brick order. When building from an SD field this matches the GPU build exactly.
+        When building from primitives, the GPU build appends bricks in a non-deterministic order, so the brick IDs differ
+        but the set of bricks and their values are the same (up to floating-point differences in the primitive evaluation).
+    */
+    class FALCOR_API SDFSBSBuilder
+    {
+    public:
+        struct Options
+        {
+            uint32_t brickWidth = 7;    ///< The width of a brick in voxels.
+            bool compressed = false;    ///< Compress the brick texture using BC4. brickWidth + 1 must be a multiple of 4.
+            bool parallel = true;       ///< Build in parallel over bricks.
+        };
+
+        /** Sparse brick set data, laid out as the GPU resources of SDFSBS.
+        */
+        struct Data
+        {
+            uint32_t gridWidth = 0;                     ///< The (virtual) grid width in voxels.
+            uint32_t brickWidth = 0;                    ///< The width of a brick in voxels.
+            bool compressed = false;                    ///< True if the brick texture is BC4 compressed.
+            uint32_t virtualBricksPerAxis = 0;          ///< Number of virtual bricks along each axis.
+            uint32_t brickCount = 0;                    ///< Number of bricks.
+            uint2 bricksPerAxis = uint2(0);             ///< Number of bricks along each axis of the brick texture.
+            uint2 brickTextureDimensions = uint2(0);    ///< Dimensions of the brick texture in texels.
+            std::vector<uint32_t> indirection;          ///< Brick ID for each virtual brick (x varying fastest), UINT32_MAX for empty bricks.
+            std::vector<AABB> brickAABBs;               ///< AABB for each brick.
+            std::vector<uint8_t> brickTexture;          ///< R8Snorm texels, or BC4Snorm blocks (8 bytes per 4x4 texels) if compressed.
+        };
+
+        /** Build a sparse brick set from an SD field, as stored by SDFSBS when values are set.
+            \param[in] sdField Normalized snorm8 corner values, (gridWidth + 1)^3 values with x varying fastest.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] options Build options.
+            \return The sparse brick set data.
+        */
+        static Data buildFromSDField(const std::vector<int8_t>& sdField, uint32_t gridWidth, const Options& options);
+
+        /** Build a sparse brick set from corner values.
+            The values are normalized and quantized in the same way as SDFGrid::setValues() does for SDFSBS.
+            \param[in] cornerValues Signed distances at the voxel corners, (gridWidth + 1)^3 values with x varying fastest.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] options Build options.
+            \return The sparse brick set data.
+        */
+        static Data buildFromCornerValues(const std::vector<float>& cornerValues, uint32_t gridWidth, const Options& options);
+
+        /** Build a sparse brick set from SDF primitives.
+            As for the GPU build, the grid width is increased to brickWidth * 4^n to encapsulate the requested width.
+            \param[in] primitives The SDF primitives.
+            \param[in] gridWidth The targeted grid width, the resulting grid may be larger.
+            \param[in] options Build options.
+            \return The sparse brick set data.
+        */
+        static Data buildFromPrimitives(const std::vector<SDF3DPrimitive>& primitives, uint32_t gridWidth, const Options& options);
+
+        /** Evaluate SDF primitives at a point, as done by the GPU build passes.
+            \param[in] primitives The SDF primitives.
+            \param[in] p Position in grid space [-0.5, 0.5]^3.
+            \param[in] d Distance to combine the primitives with.
+            \return The signed distance.
+        */
+        static float evalPrimitives(const std::vector<SDF3DPrimitive>& primitives, float3 p, float d);
+
+        /** Compress a 4x4 block of snorm8 values using BC4, as done by BC4Encode.slang.
+            \param[in] block Values in row-major order.
+            \return The compressed block.
+        */
+        static uint64_t compressBC4Block(const int32_t block[16]);
+
+        /** Decompress a BC4 snorm block.
+            \param[in] compressedBlock The compressed block.
+            \param[out] block Decompressed snorm8 values in row-major order.
+        */
+        static void decompressBC4Block(uint64_t compressedBlock, int32_t block[16]);
+    };
+}
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SDFSVO.h"
+#include "Scene/SDFs/SDFBrickGrid.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Utils/Math/MathHelpers.h"
@@ -422,4 +423,12 @@ namespace Falcor
             mValues[v] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
         }
     }
+
+    void SDFSVO::setValuesInternal(const SDFBrickGrid& brickGrid)
+    {
+        mLevelCount = bitScanReverse(mGridWidth) + 1;
+
+        // Normalize the values directly from the bricks without expanding them to a dense float grid.
+        brickGrid.getNormalizedValues(mGridWidth / (0.5f * float(M_SQRT3)), mValues);
+    }
 }
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SDFSVS.h"
+#include "Scene/SDFs/SDFBrickGrid.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Utils/Math/MathHelpers.h"
@@ -174,4 +175,10 @@ namespace Falcor
             mValues[v] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
         }
     }
+
+    void SDFSVS::setValuesInternal(const SDFBrickGrid& brickGrid)
+    {
+        // Normalize the values directly from the bricks without expanding them to a dense float grid.
+        brickGrid.getNormalizedValues(2.0f * mGridWidth / float(M_SQRT3), mValues);
+    }
 }
@@ -57,6 +57,7 @@ namespace Falcor
 
     protected:
         virtual void setValuesInternal(const std::vector<float>& cornerValues) override;
+        virtual void setValuesInternal(const SDFBrickGrid& brickGrid) override;
 
     private:
         // CPU data.
@@ -73,6 +73,9 @@ namespace Falcor
         const std::string kIndexBufferName = "indexData";
         const std::string kVertexBufferName = "vertices";
         const std::string kPrevVertexBufferName = "prevVertices";
+        const std::string kQuantizedVertexBufferName = "quantizedVertices";
+        const std::string kVertexQuantizationBufferName = "vertexQuantization";
+        const std::string kQuantizedVertexPagesBufferName = "pages";
         const std::string kProceduralPrimAABBBufferName = "proceduralPrimitiveAABBs";
         const std::string kCurveBufferName = "curves";
         const std::string kCurveIndexBufferName = "curveIndices";
@@ -177,6 +180,7 @@ namespace Falcor
         mGrids = std::move(sceneData.grids);
         mpEnvMap = sceneData.pEnvMap;
         mSceneGraph = std::move(sceneData.sceneGraph);
+        mInstanceSets = std::move(sceneData.instanceSets);
         mMetadata = std::move(sceneData.metadata);
 
         // Merge all geometry instance lists into one.
@@ -215,6 +219,47 @@ namespace Falcor
         mMeshStaticData.setBufferCountDefinePrefix("SCENE_VERTEX");
         mMeshStaticData.createGpuBuffers(mpDevice, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex);
 
+        mMeshQuantizedData = std::move(sceneData.meshQuantizedData);
+        mMeshVertexQuantization = std::move(sceneData.meshVertexQuantization);
+        mMeshQuantizedData.setBufferCountDefinePrefix("SCENE_QUANTIZED_VERTEX");
+        if (hasQuantizedVertices())
+        {
+            FALCOR_CHECK(mMeshVertexQuantization.size() == mMeshDesc.size(), "Quantized vertices require quantization parameters for each mesh.");
+
+            // Create the page tables for looking up the mesh from a global vertex index. Each mesh starts on a new page.
+            std::vector<std::vector<uint32_t>> pages(mMeshQuantizedData.getBufferCount());
+            for (uint32_t bufferIndex = 0; bufferIndex < (uint32_t)pages.size(); ++bufferIndex)
+            {
+                const size_t vertexCount = mMeshQuantizedData.getCpuBuffer(bufferIndex).size();
+                FALCOR_CHECK(vertexCount % PackedQuantizedVertexData::kPageSize == 0, "Quantized vertex data must consist of whole pages.");
+                pages[bufferIndex].resize(vertexCount / PackedQuantizedVertexData::kPageSize, 0);
+            }
+            for (uint32_t meshID = 0; meshID < (uint32_t)mMeshDesc.size(); ++meshID)
+            {
+                const auto& mesh = mMeshDesc[meshID];
+                const uint32_t elementIndex = mMeshQuantizedData.getElementIndex(mesh.vbOffset);
+                FALCOR_ASSERT(elementIndex % PackedQuantizedVertexData::kPageSize == 0);
+                uint32_t firstPage = elementIndex >> PackedQuantizedVertexData::kPageBits;
+                uint32_t pageCount = div_round_up(mesh.vertexCount, PackedQuantizedVertexData::kPageSize);
+                std::fill_n(pages[mMeshQuantizedData.getBufferIndex(mesh.vbOffset)].begin() + firstPage, pageCount, meshID);
+            }
+
+            mMeshQuantizedData.createGpuBuffers(mpDevice, ResourceBindFlags::ShaderResource | ResourceBindFlags::Vertex);
+            mpVertexQuantizationBuffer = mpDevice->createStructuredBuffer(sizeof(VertexQuantization), (uint32_t)mMeshVertexQuantization.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, mMeshVertexQuantization.data(), false);
+            mpVertexQuantizationBuffer->setName("Scene::mpVertexQuantizationBuffer");
+
+            for (size_t bufferIndex = 0; bufferIndex < pages.size(); ++bufferIndex)
+            {
+                ref<Buffer> pPages;
+                if (!pages[bufferIndex].empty())
+                {
+                    pPages = mpDevice->createStructuredBuffer(sizeof(uint32_t), (uint32_t)pages[bufferIndex].size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, pages[bufferIndex].data(), false);
+                    pPages->setName(fmt::format("Scene::mQuantizedVertexPagesBuffers[{}]", bufferIndex));
+                }
+                mQuantizedVertexPagesBuffers.push_back(std::move(pPages));
+            }
+        }
+
         // Setup additional resources.
         mFrontClockwiseRS[RasterizerState::CullMode::None] = RasterizerState::create(RasterizerState::Desc().setFrontCounterCW(false).setCullMode(RasterizerState::CullMode::None));
         mFrontClockwiseRS[RasterizerState::CullMode::Back] = RasterizerState::create(RasterizerState::Desc().setFrontCounterCW(false).setCullMode(RasterizerState::CullMode::Back));
@@ -279,7 +324,7 @@ namespace Falcor
         return ref<Scene>(new Scene(pDevice, std::move(sceneData)));
     }
 
-    void Scene::updateSceneDefines()
+    DefineList Scene::getStaticSceneDefines() const
     {
         DefineList defines;
 
@@ -290,20 +335,52 @@ namespace Falcor
         defines.add("SCENE_HAS_32BIT_INDICES", mHas32BitIndices ? "1" : "0");
         mMeshIndexData.getShaderDefines(defines);
         mMeshStaticData.getShaderDefines(defines);
+        mMeshQuantizedData.getShaderDefines(defines);
+        defines.add("SCENE_HAS_QUANTIZED_VERTICES", hasQuantizedVertices() ? "1" : "0");
 
         defines.add(mHitInfo.getDefines());
         defines.add(getSceneSDFGridDefines());
 
+        return defines;
+    }
+
+    DefineList Scene::computeSceneDefines() const
+    {
+        DefineList defines = mStaticSceneDefines;
+
         // The following defines may change at runtime.
         defines.add("SCENE_DIFFUSE_ALBEDO_MULTIPLIER", std::to_string(mRenderSettings.diffuseAlbedoMultiplier));
         defines.add("SCENE_GEOMETRY_TYPES", std::to_string((uint32_t)mGeometryTypes));
 
-        defines.add(mpMaterials->getDefines());
+        defines.add(mMaterialDefines);
+
+        return defines;
+    }
+
+    bool Scene::updateSceneDefines()
+    {
+        // Only rebuild the defines if any of the state they depend on changed since the last update.
+        // The material defines are refreshed in updateMaterials() when the materials change.
+        if (!mSceneDefinesDirty &&
+            mSceneDefinesState.diffuseAlbedoMultiplier == mRenderSettings.diffuseAlbedoMultiplier &&
+            mSceneDefinesState.geometryTypes == mGeometryTypes)
+        {
+            return false;
+        }
+
+        mSceneDefinesDirty = false;
+        mSceneDefinesState.diffuseAlbedoMultiplier = mRenderSettings.diffuseAlbedoMultiplier;
+        mSceneDefinesState.geometryTypes = mGeometryTypes;
 
-        mSceneDefines = defines;
+        DefineList defines = computeSceneDefines();
+        if (defines == mSceneDefines)
+            return false;
+
+        mSceneDefines = std::move(defines);
+        return true;
     }
 
-    DefineList Scene::getSceneDefines() const
+    const DefineList& Scene::getSceneDefines() const
     {
         return mSceneDefines;
     }
@@ -434,7 +511,7 @@ namespace Falcor
     void Scene::createMeshVao(uint32_t drawCount, const std::vector<SkinningVertexData>& skinningData)
     {
         if (drawCount == 0) return;
-        if (mMeshIndexData.getBufferCount() > 1 || mMeshStaticData.getBufferCount() > 1)
+        if (mMeshIndexData.getBufferCount() > 1 || mMeshStaticData.getBufferCount() > 1 || mMeshQuantizedData.getBufferCount() > 1)
         {
             logWarning("MeshVao cannot be created, rasterization will not be available.");
             return;
@@ -444,7 +521,7 @@ namespace Falcor
         if (!mMeshIndexData.empty())
             pIB = mMeshIndexData.getGpuBuffer(0);
 
-        ref<Buffer> pStaticBuffer = mMeshStaticData.getGpuBuffer(0);
+        ref<Buffer> pStaticBuffer = hasQuantizedVertices() ? mMeshQuantizedData.getGpuBuffer(0) : mMeshStaticData.getGpuBuffer(0);
 
         Vao::BufferVec pVBs(kVertexBufferCount);
         pVBs[kStaticDataBufferIndex] = pStaticBuffer;
@@ -477,10 +554,20 @@ namespace Falcor
         ref<VertexLayout> pLayout = VertexLayout::create();
 
         // Add the packed static vertex data layout.
+        // Quantized vertices are decoded in the vertex shader using the per-mesh quantization parameters.
         ref<VertexBufferLayout> pStaticLayout = VertexBufferLayout::create();
-        pStaticLayout->addElement(VERTEX_POSITION_NAME, offsetof(PackedStaticVertexData, position), ResourceFormat::RGB32Float, 1, VERTEX_POSITION_LOC);
-        pStaticLayout->addElement(VERTEX_PACKED_NORMAL_TANGENT_CURVE_RADIUS_NAME, offsetof(PackedStaticVertexData, packedNormalTangentCurveRadius), ResourceFormat::RGB32Float, 1, VERTEX_PACKED_NORMAL_TANGENT_CURVE_RADIUS_LOC);
-        pStaticLayout->addElement(VERTEX_TEXCOORD_NAME, offsetof(PackedStaticVertexData, texCrd), ResourceFormat::RG32Float, 1, VERTEX_TEXCOORD_LOC);
+        if (hasQuantizedVertices())
+        {
+            pStaticLayout->addElement(VERTEX_POSITION_NAME, offsetof(PackedQuantizedVertexData, position), ResourceFormat::RGBA16Snorm, 1, VERTEX_POSITION_LOC);
+            pStaticLayout->addElement(VERTEX_PACKED_NORMAL_TANGENT_CURVE_RADIUS_NAME, offsetof(PackedQuantizedVertexData, normal), ResourceFormat::RG32Uint, 1, VERTEX_PACKED_NORMAL_TANGENT_CURVE_RADIUS_LOC);
+            pStaticLayout->addElement(VERTEX_TEXCOORD_NAME, offsetof(PackedQuantizedVertexData, texCrd), ResourceFormat::RG16Float, 1, VERTEX_TEXCOORD_LOC);
+        }
+        else
+        {
+            pStaticLayout->addElement(VERTEX_POSITION_NAME, offsetof(PackedStaticVertexData, position), ResourceFormat::RGB32Float, 1, VERTEX_POSITION_LOC);
+            pStaticLayout->addElement(VERTEX_PACKED_NORMAL_TANGENT_CURVE_RADIUS_NAME, offsetof(PackedStaticVertexData, packedNormalTangentCurveRadius), ResourceFormat::RGB32Float, 1, VERTEX_PACKED_NORMAL_TANGENT_CURVE_RADIUS_LOC);
+            pStaticLayout->addElement(VERTEX_TEXCOORD_NAME, offsetof(PackedStaticVertexData, texCrd), ResourceFormat::RG32Float, 1, VERTEX_TEXCOORD_LOC);
+        }
         pLayout->addBufferLayout(kStaticDataBufferIndex, pStaticLayout);
 
         // Add the draw ID layout.
@@ -597,9 +684,9 @@ namespace Falcor
                 // Load vertices from global vertex buffer.
                 // Note that the mesh local vbOffset is added to address into the global vertex buffer.
                 StaticVertexData vertices[3];
-                vertices[0] = mMeshStaticData[(size_t)desc.vbOffset + vidx[0]].unpack();
-                vertices[1] = mMeshStaticData[(size_t)desc.vbOffset + vidx[1]].unpack();
-                vertices[2] = mMeshStaticData[(size_t)desc.vbOffset + vidx[2]].unpack();
+                vertices[0] = getMeshVertex(MeshID(meshIndex), vidx[0]);
+                vertices[1] = getMeshVertex(MeshID(meshIndex), vidx[1]);
+                vertices[2] = getMeshVertex(MeshID(meshIndex), vidx[2]);
 
                 int2 v0 = int2(std::floor(vertices[0].texCrd[0]), std::floor(vertices[0].texCrd[1]));
                 int2 v1 = int2(std::floor(vertices[1].texCrd[0]), std::floor(vertices[1].texCrd[1]));
@@ -826,6 +913,13 @@ namespace Falcor
         if (hasIndexBuffer())
             mMeshIndexData.bindShaderData(var[kIndexBufferName]);
         mMeshStaticData.bindShaderData(var[kVertexBufferName]);
+        if (hasQuantizedVertices())
+        {
+            mMeshQuantizedData.bindShaderData(var[kQuantizedVertexBufferName]);
+            for (size_t i = 0; i < mQuantizedVertexPagesBuffers.size(); ++i)
+                var[kQuantizedVertexBufferName][kQuantizedVertexPagesBufferName][i] = mQuantizedVertexPagesBuffers[i];
+            var[kVertexQuantizationBufferName] = mpVertexQuantizationBuffer;
+        }
         var[kPrevVertexBufferName] = mpAnimationController->getPrevVertexData();
 
         if (mpCurveVao != nullptr)
@@ -1243,8 +1337,9 @@ namespace Falcor
         // Prepare scene defines.
         // These are currently assumed not to change beyond this point.
         // The defines are needed by the functions below for setting up the scene parameter block.
+        mStaticSceneDefines = getStaticSceneDefines();
+        mSceneDefinesDirty = true;
         updateSceneDefines();
-        mPrevSceneDefines = mSceneDefines;
 
         // Prepare and upload resources.
         // The order of these calls is important as there are dependencies between them.
@@ -1282,8 +1377,8 @@ namespace Falcor
         prepareUI();
 
         // Validate assumption that scene defines didn't change.
-        updateSceneDefines();
-        FALCOR_CHECK(mSceneDefines == mPrevSceneDefines, "Scene defines changed unexpectedly");
+        FALCOR_CHECK(!updateSceneDefines(), "Scene defines changed unexpectedly");
+        FALCOR_CHECK(getStaticSceneDefines() == mStaticSceneDefines, "Static scene defines changed unexpectedly");
 
         mFinalized = true;
     }
@@ -1384,6 +1479,10 @@ namespace Falcor
 
         s.indexMemoryInBytes += mMeshIndexData.getByteSize();
         s.vertexMemoryInBytes += mMeshStaticData.getByteSize();
+        s.vertexMemoryInBytes += mMeshQuantizedData.getByteSize();
+        s.geometryMemoryInBytes += mpVertexQuantizationBuffer ? mpVertexQuantizationBuffer->getSize() : 0;
+        for (const auto& pPages : mQuantizedVertexPagesBuffers)
+            s.geometryMemoryInBytes += pPages ? pPages->getSize() : 0;
 
         if (mpMeshVao)
         {
@@ -1758,6 +1857,10 @@ namespace Falcor
         {
             flags |= IScene::UpdateFlags::MaterialsChanged;
 
+            // Update material defines. The scene defines are rebuilt in the next call to updateSceneDefines().
+            mMaterialDefines = mpMaterials->getDefines();
+            mSceneDefinesDirty = true;
+
             // Bind materials parameter block to scene.
             if (mpSceneBlock)
             {
@@ -1847,11 +1950,9 @@ namespace Falcor
 
         // Update scene defines.
         // These are currently assumed not to change beyond this point.
-        updateSceneDefines();
-        if (mSceneDefines != mPrevSceneDefines)
+        if (updateSceneDefines())
         {
             mUpdates |= IScene::UpdateFlags::SceneDefinesChanged;
-            mPrevSceneDefines = mSceneDefines;
             mpSceneBlock = nullptr;
         }
 
@@ -1914,20 +2015,33 @@ namespace Falcor
         // Update light collection
         if (mpLightCollection)
         {
-            // If emissive material properties changed we recreate the light collection.
-            // This can be expensive and should be optimized by letting the light collection internally update its data structures.
+            if (mpLightCollection->update(pRenderContext))
+                mUpdates |= IScene::UpdateFlags::LightCollectionChanged;
+
+            // If emissive material properties changed we update the flux of the affected mesh lights in place.
+            // The light collection is only recreated if the set of mesh lights changed.
             if (is_set(mUpdates, IScene::UpdateFlags::EmissiveMaterialsChanged))
             {
-                mpLightCollection = nullptr;
-                getLightCollection(pRenderContext);
+                std::vector<MaterialID> materialIDs;
+                for (uint32_t materialIdx = 0; materialIdx < mpMaterials->getMaterialCount(); ++materialIdx)
+                {
+                    MaterialID materialID{ materialIdx };
+                    if (is_set(mpMaterials->getMaterialUpdates(materialID), Material::UpdateFlags::EmissiveChanged))
+                        materialIDs.push_back(materialID);
+                }
+
+                if (!mpLightCollection->updateEmissiveMaterials(pRenderContext, materialIDs))
+                {
+                    mpLightCollection = nullptr;
+                    getLightCollection(pRenderContext);
+                }
                 mUpdates |= IScene::UpdateFlags::LightCollectionChanged;
             }
-            else
-            {
-                if (mpLightCollection->update(pRenderContext))
-                    mUpdates |= IScene::UpdateFlags::LightCollectionChanged;
-                mSceneStats.emissiveMemoryInBytes = mpLightCollection->getMemoryUsageInBytes();
-            }
+
+            // Updates may reallocate the active triangle list and change its size, so rebind the light collection.
+            if (is_set(mUpdates, IScene::UpdateFlags::LightCollectionChanged))
+                mpLightCollection->bindShaderData(mpSceneBlock->getRootVar()["lightCollection"]);
+            mSceneStats.emissiveMemoryInBytes = mpLightCollection->getMemoryUsageInBytes();
         }
         else if (!mpLightCollection)
         {
@@ -1947,8 +2061,8 @@ namespace Falcor
         }
 
         // Validate assumption that scene defines didn't change.
-        updateSceneDefines();
-        FALCOR_CHECK(mSceneDefines == mPrevSceneDefines, "Scene defines changed unexpectedly");
+        FALCOR_CHECK(!updateSceneDefines(), "Scene defines changed unexpectedly");
+        FALCOR_ASSERT(computeSceneDefines() == mSceneDefines);
 
         mUpdateFlagsSignal(mUpdates);
         return mUpdates;
@@ -2818,6 +2932,44 @@ namespace Falcor
                 return mpBlasStaticWorldMatrices;
             };
 
+            // Quantized vertex positions are decoded by a per-mesh transform as part of the BLAS build.
+            // For static meshes the transform is combined with the object-to-world transform.
+            auto getDequantizationMatricesBuffer = [&]()
+            {
+                if (!mpBlasDequantizationMatrices)
+                {
+                    std::vector<float4x4> matrices(mMeshDesc.size());
+                    for (size_t meshID = 0; meshID < mMeshDesc.size(); ++meshID)
+                    {
+                        const VertexQuantization& q = mMeshVertexQuantization[meshID];
+                        matrices[meshID] = mul(math::matrixFromTranslation(q.center), math::matrixFromScaling(q.halfExtent));
+                    }
+                    for (const auto& meshGroup : mMeshGroups)
+                    {
+                        if (!meshGroup.isStatic) continue;
+                        for (MeshID meshID : meshGroup.meshList)
+                        {
+                            uint32_t instanceID = mMeshIdToInstanceIds[meshID.get()][0];
+                            uint32_t matrixID = mGeometryInstanceData[instanceID].globalMatrixID;
+                            matrices[meshID.get()] = mul(globalMatrices[matrixID], matrices[meshID.get()]);
+                        }
+                    }
+
+                    std::vector<float4x4> transposedMatrices;
+                    transposedMatrices.reserve(matrices.size());
+                    for (const auto& m : matrices) transposedMatrices.push_back(transpose(m));
+
+                    // Only the first three rows of each transposed matrix are read by the BLAS build.
+                    uint32_t float4Count = (uint32_t)transposedMatrices.size() * 4;
+                    mpBlasDequantizationMatrices = mpDevice->createStructuredBuffer(sizeof(float4), float4Count, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, transposedMatrices.data(), false);
+                    mpBlasDequantizationMatrices->setName("Scene::mpBlasDequantizationMatrices");
+
+                    // Transition the resource to non-pixel shader state as expected by DXR.
+                    pRenderContext->resourceBarrier(mpBlasDequantizationMatrices.get(), Resource::State::NonPixelShader);
+                }
+                return mpBlasDequantizationMatrices;
+            };
+
             // Iterate over the mesh groups. One BLAS will be created for each group.
             // Each BLAS may contain multiple geometries.
             for (size_t i = 0; i < mMeshGroups.size(); i++)
@@ -2873,10 +3025,21 @@ namespace Falcor
                         desc.flags = pMaterial->isOpaque() ? RtGeometryFlags::Opaque : RtGeometryFlags::None;
 
                         // Set the position data
-                        desc.content.triangles.vertexData = mMeshStaticData.getGpuAddress(mesh.vbOffset);
-                        desc.content.triangles.vertexStride = sizeof(PackedStaticVertexData);
+                        if (hasQuantizedVertices())
+                        {
+                            // The dequantization transform replaces the static pre-transform set up above.
+                            desc.content.triangles.transform3x4 = getDequantizationMatricesBuffer()->getGpuAddress() + meshID.get() * 64ull;
+                            desc.content.triangles.vertexData = mMeshQuantizedData.getGpuAddress(mesh.vbOffset);
+                            desc.content.triangles.vertexStride = sizeof(PackedQuantizedVertexData);
+                            desc.content.triangles.vertexFormat = ResourceFormat::RGBA16Snorm;
+                        }
+                        else
+                        {
+                            desc.content.triangles.vertexData = mMeshStaticData.getGpuAddress(mesh.vbOffset);
+                            desc.content.triangles.vertexStride = sizeof(PackedStaticVertexData);
+                            desc.content.triangles.vertexFormat = ResourceFormat::RGB32Float;
+                        }
                         desc.content.triangles.vertexCount = mesh.vertexCount;
-                        desc.content.triangles.vertexFormat = ResourceFormat::RGB32Float;
 
                         // Set index data
                         if (!mMeshIndexData.empty())
@@ -3191,6 +3354,12 @@ namespace Falcor
             if (pVb)
                 pRenderContext->resourceBarrier(pVb.get(), Resource::State::NonPixelShader);
         }
+        for (size_t i = 0; i < mMeshQuantizedData.getBufferCount(); ++i)
+        {
+            ref<Buffer> pVb = mMeshQuantizedData.getGpuBuffer(i);
+            if (pVb)
+                pRenderContext->resourceBarrier(pVb.get(), Resource::State::NonPixelShader);
+        }
 
         for (size_t i = 0; i < mMeshIndexData.getBufferCount(); ++i)
         {
@@ -3876,6 +4045,16 @@ namespace Falcor
         return mSceneGraph[nodeID.get()].parent;
     }
 
+    NodeID Scene::getMatrixNodeID(uint32_t matrixID) const
+    {
+        if (matrixID < mSceneGraph.size()) return NodeID{ matrixID };
+
+        // Instance sets are sorted by matrix offset.
+        auto it = std::upper_bound(mInstanceSets.begin(), mInstanceSets.end(), matrixID, [](uint32_t id, const InstanceSet& set) { return id < set.matrixOffset; });
+        FALCOR_CHECK(it != mInstanceSets.begin() && matrixID < std::prev(it)->matrixOffset + std::prev(it)->getInstanceCount(), "'matrixID' ({}) is out of range", matrixID);
+        return std::prev(it)->parent;
+    }
+
     void Scene::setEnvMap(ref<EnvMap> pEnvMap)
     {
         if (mpEnvMap == pEnvMap) return;
@@ -4078,8 +4257,18 @@ namespace Falcor
         mpLoadMeshPass->execute(mpDevice->getRenderContext(), std::max(meshDesc.vertexCount, meshDesc.getTriangleCount()), 1, 1);
     }
 
+    StaticVertexData Scene::getMeshVertex(MeshID meshID, uint32_t vertexIndex) const
+    {
+        const auto& meshDesc = getMesh(meshID);
+        FALCOR_ASSERT(vertexIndex < meshDesc.vertexCount);
+        if (hasQuantizedVertices())
+            return mMeshQuantizedData[(size_t)meshDesc.vbOffset + vertexIndex].unpack(mMeshVertexQuantization[meshID.get()]);
+        return mMeshStaticData[(size_t)meshDesc.vbOffset + vertexIndex].unpack();
+    }
+
     void Scene::setMeshVertices(MeshID meshID, const std::map<std::string, ref<Buffer>>& buffers)
     {
+        FALCOR_CHECK(!hasQuantizedVertices(), "Cannot set mesh vertices on a scene with quantized vertices.");
         if (!mpUpdateMeshPass)
             mpUpdateMeshPass = ComputePass::create(mpDevice, kMeshIOShaderFilename, "setMeshVertices", getSceneDefines());
         const auto& meshDesc = getMesh(meshID);
@@ -122,6 +122,7 @@ namespace Falcor
 
         using SplitVertexBuffer = SplitBuffer<PackedStaticVertexData, false>;
         using SplitIndexBuffer = SplitBuffer<uint32_t, true>;
+        using SplitQuantizedVertexBuffer = SplitBuffer<PackedQuantizedVertexData, false>;
 
         static constexpr uint32_t kMaxBonesPerVertex = 4;
         static constexpr uint32_t kInvalidAttributeIndex = -1;
@@ -237,6 +238,25 @@ namespace Falcor
             float4x4 localToBindSpace;  ///< For bones. Skeleton to bind space transformation. AKA the inverse-bind transform.
         };
 
+        /** Set of mesh instances sharing a parent node.
+            The instances don't have scene graph nodes. Each instance gets its own world matrix, placed after the
+            scene graph node matrices in the global matrix buffers, which is used directly for the TLAS instance.
+        */
+        struct InstanceSet
+        {
+            std::string name;
+            NodeID parent{ NodeID::Invalid() };                 ///< Parent node, or invalid if the instance transforms are in world space.
+            float4x4 meshTransform = float4x4::identity();      ///< Transform applied to the meshes before the instance transform.
+            std::vector<float4x4> transforms;                   ///< Transform per instance, if not animated.
+            std::vector<Animation::Keyframe> keyframes;         ///< Keyframes per instance, keyframesPerInstance consecutive keyframes for each instance, if animated.
+            uint32_t keyframesPerInstance = 0;                  ///< Number of keyframes per instance, or zero if the transforms are static.
+            uint32_t matrixOffset = 0;                          ///< Global matrix ID of the first instance. Assigned by SceneBuilder.
+
+            bool isAnimated() const { return keyframesPerInstance > 0; }
+            uint32_t getInstanceCount() const { return isAnimated() ? uint32_t(keyframes.size() / keyframesPerInstance) : uint32_t(transforms.size()); }
+            fstd::span<const Animation::Keyframe> getKeyframes(uint32_t index) const { return { keyframes.data() + size_t(index) * keyframesPerInstance, keyframesPerInstance }; }
+        };
+
         /** Full set of required data to create a scene object.
             This data is typically prepared by SceneBuilder before creating a Scene object.
         */
@@ -256,6 +276,7 @@ namespace Falcor
             ref<EnvMap> pEnvMap;                                    ///< Environment map.
             std::vector<Node> sceneGraph;                           ///< Scene graph nodes.
             std::vector<ref<Animation>> animations;                 ///< List of animations.
+            std::vector<InstanceSet> instanceSets;                  ///< List of mesh instance sets.
             Metadata metadata;                                      ///< Scene meadata.
 
             // Mesh data
@@ -275,8 +296,12 @@ namespace Falcor
 
             /// Vertex indices for all meshes in either 32-bit or 16-bit format packed tightly, decided per mesh.
             SplitIndexBuffer meshIndexData;
-            /// Vertex attributes for all meshes in packed format.
+            /// Vertex attributes for all meshes in packed format. Empty if the vertices are quantized.
             SplitVertexBuffer meshStaticData;
+            /// Vertex attributes for all meshes in quantized format, split into buffers like meshStaticData. Each mesh starts on a page of PackedQuantizedVertexData::kPageSize vertices.
+            SplitQuantizedVertexBuffer meshQuantizedData;
+            /// Per-mesh parameters for decoding quantized vertex positions. Empty if the vertices are not quantized.
+            std::vector<VertexQuantization> meshVertexQuantization;
             /// Additional vertex attributes for skinned meshes.
             std::vector<SkinningVertexData> meshSkinningData;
 
@@ -422,7 +447,7 @@ namespace Falcor
             The user is responsible to check for this and update all programs that access the scene.
             \return List of shader defines.
         */
-        DefineList getSceneDefines() const;
+        const DefineList& getSceneDefines() const;
 
         /** Get type conformances.
             These type conformances must be set on all programs that access the scene.
@@ -654,6 +679,17 @@ namespace Falcor
         */
         const MeshDesc& getMesh(MeshID meshID) const { return mMeshDesc[meshID.get()]; }
 
+        /** Check whether the mesh vertices are stored in quantized format (see SceneBuilder::Flags::QuantizeVertices).
+        */
+        bool hasQuantizedVertices() const { return !mMeshVertexQuantization.empty(); }
+
+        /** Get the data of a mesh vertex on the CPU. Works for both the full and the quantized vertex format.
+            \param[in] meshID Mesh ID.
+            \param[in] vertexIndex Vertex index relative to the start of the mesh.
+            \return Unpacked vertex data.
+        */
+        StaticVertexData getMeshVertex(MeshID meshID, uint32_t vertexIndex) const;
+
         /** Get mesh vertex and index data.
             \param[in] meshID Mesh ID.
             \param[in] buffers Map of buffers containing mesh data: "triangleIndices", "positions", and "texcrds" are required.
@@ -1011,6 +1047,10 @@ namespace Falcor
         */
         std::vector<ref<Animation>>& getAnimations() { return mpAnimationController->getAnimations(); }
 
+        /** Get the scene's mesh instance sets.
+        */
+        const std::vector<InstanceSet>& getInstanceSets() const { return mInstanceSets; }
+
         /** Returns true if scene has animation data.
         */
         bool hasAnimation() const { return mpAnimationController->hasAnimations(); }
@@ -1060,6 +1100,11 @@ namespace Falcor
         */
         NodeID getParentNodeID(NodeID nodeID) const;
 
+        /** Returns the scene graph node that a global matrix is computed from.
+            \return Node ID of the node, the parent node of the instance set for instance set matrices, or kInvalidNode if the matrix is in world space.
+        */
+        NodeID getMatrixNodeID(uint32_t matrixID) const;
+
         std::string getScript(const std::string& sceneVar);
 
         uint64_t getMemoryUsageInBytes() const { return getSceneStats().getTotalMemory(); }
@@ -1110,7 +1155,12 @@ namespace Falcor
         void createCurveVao(const std::vector<uint32_t>& indexData, const std::vector<StaticCurveVertexData>& staticData);
         void createMeshUVTiles(const std::vector<MeshDesc>& meshDesc);
 
-        void updateSceneDefines();
+        /** Update the scene defines if any of the state they depend on changed.
+            \return True if the scene defines changed.
+        */
+        bool updateSceneDefines();
+        DefineList computeSceneDefines() const;
+        DefineList getStaticSceneDefines() const;
         DefineList getSceneSDFGridDefines() const;
 
         /** Set the SDF grid config if this scene contains any SDF grid geometry.
@@ -1253,6 +1303,7 @@ namespace Falcor
         std::vector<std::vector<Rectangle>> mMeshUVTiles;           ///< Bounding tiles for the mesh UVs
         std::vector<MeshGroup> mMeshGroups;                         ///< Groups of meshes. Each group maps to a BLAS for ray tracing.
         std::vector<std::string> mMeshNames;                        ///< Mesh names, indxed by mesh ID
+        std::vector<InstanceSet> mInstanceSets;                     ///< Mesh instance sets. Their matrices follow the scene graph node matrices.
         std::vector<Node> mSceneGraph;                              ///< For each index i, the array element indicates the parent node. Indices are in relation to mLocalToWorldMatrices.
 
         /// For Python bindings of triangle meshes.
@@ -1319,12 +1370,21 @@ namespace Falcor
         RenderSettings mRenderSettings;                             ///< Render settings.
         RenderSettings mPrevRenderSettings;
         DefineList mSceneDefines;                           ///< Current list of defines that need to be set on any program accessing the scene.
-        DefineList mPrevSceneDefines;                       ///< List of defines for the previous frame.
+        DefineList mStaticSceneDefines;                     ///< Scene defines that don't change after the scene is finalized.
+        DefineList mMaterialDefines;                        ///< Material system defines, refreshed when the materials change.
+        bool mSceneDefinesDirty = true;                     ///< True if the scene defines need to be rebuilt.
+        struct
+        {
+            float diffuseAlbedoMultiplier = 1.f;
+            GeometryTypeFlags geometryTypes = GeometryTypeFlags(0);
+        } mSceneDefinesState;                               ///< State the current scene defines were built from.
         TypeConformanceList mTypeConformances;             ///< Current list of type conformances that need to be set on any program accessing the scene.
 
         // Scene block resources
         ref<Buffer> mpGeometryInstancesBuffer;
         ref<Buffer> mpMeshesBuffer;
+        ref<Buffer> mpVertexQuantizationBuffer;
+        std::vector<ref<Buffer>> mQuantizedVertexPagesBuffers;  ///< Page tables of the quantized vertex buffers, one per buffer in mMeshQuantizedData.
         ref<Buffer> mpCurvesBuffer;
         ref<Buffer> mpCustomPrimitivesBuffer;
         ref<Buffer> mpLightsBuffer;
@@ -1429,6 +1489,7 @@ namespace Falcor
         std::vector<BlasGroup> mBlasGroups;                 ///< BLAS group data.
         ref<Buffer> mpBlasScratch;                          ///< Scratch buffer used for BLAS builds.
         ref<Buffer> mpBlasStaticWorldMatrices;              ///< Object-to-world transform matrices in row-major format. Only valid for static meshes.
+        ref<Buffer> mpBlasDequantizationMatrices;           ///< Per-mesh transforms from quantized positions to object (or world, for static meshes) space in row-major format.
         bool mBlasDataValid = false;                        ///< Flag to indicate if the BLAS data is valid. This will be reset when geometry is changed.
         bool mRebuildBlas = true;                           ///< Flag to indicate BLASes need to be rebuilt.
 
@@ -1439,6 +1500,8 @@ namespace Falcor
         /// Used for very large scenes
         SplitIndexBuffer mMeshIndexData;
         SplitVertexBuffer mMeshStaticData;
+        SplitQuantizedVertexBuffer mMeshQuantizedData;
+        std::vector<VertexQuantization> mMeshVertexQuantization;
 
         UpdateFlagsSignal mUpdateFlagsSignal;
     public:
@@ -1451,5 +1514,10 @@ namespace Falcor
         {
             return mMeshStaticData;
         }
+
+        const SplitIndexBuffer& getMeshIndexData() const
+        {
+            return mMeshIndexData;
+        }
     };
 }
@@ -28,10 +28,14 @@
 #include "SceneBuilder.h"
 #include "SceneCache.h"
 #include "Importer.h"
+#include "MeshLayoutOptimizer.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
+#include "Core/API/PythonHelpers.h"
 #include "Utils/Logger.h"
+#include "Utils/Math/BatchTransform.h"
 #include "Utils/Math/Common.h"
+#include "Utils/Math/FNVHash.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Scripting/ScriptBindings.h"
@@ -39,9 +43,12 @@
 #include "Utils/ObjectIDPython.h"
 #include "Utils/NumericRange.h"
 #include <mikktspace.h>
+#include <atomic>
 #include <filesystem>
 #include <cmath>
+#include <cstring>
 #include <execution>
+#include <numeric>
 
 namespace Falcor
 {
@@ -62,10 +69,23 @@ namespace Falcor
             else return 2;
         }
 
+        // Default number of faces per chunk when generating tangents on multiple threads.
+        const uint32_t kTangentChunkFaceCount = 1 << 16;
+
+        // Spread the lower 10 bits of a value so that there are two zero bits between each bit (for 30-bit Morton codes).
+        uint32_t expandBits(uint32_t v)
+        {
+            v = (v * 0x00010001u) & 0xFF0000FFu;
+            v = (v * 0x00000101u) & 0x0F00F00Fu;
+            v = (v * 0x00000011u) & 0xC30C30C3u;
+            v = (v * 0x00000005u) & 0x49249249u;
+            return v;
+        }
+
         class MikkTSpaceWrapper
         {
         public:
-            static std::vector<float4> generateTangents(const SceneBuilder::Mesh& mesh)
+            static std::vector<float4> generateTangents(const SceneBuilder::Mesh& mesh, uint32_t chunkFaceCount)
             {
                 if (!mesh.normals.pData || !mesh.positions.pData || !mesh.texCrds.pData || !mesh.pIndices)
                 {
@@ -73,29 +93,83 @@ namespace Falcor
                     return {};
                 }
 
-                // Generate new tangent space.
-                SMikkTSpaceInterface mikktspace = {};
-                mikktspace.m_getNumFaces = [](const SMikkTSpaceContext* pContext) { return ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getFaceCount(); };
-                mikktspace.m_getNumVerticesOfFace = [](const SMikkTSpaceContext* pContext, int32_t face) { return 3; };
-                mikktspace.m_getPosition = [](const SMikkTSpaceContext* pContext, float position[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getPosition(position, face, vert); };
-                mikktspace.m_getNormal = [](const SMikkTSpaceContext* pContext, float normal[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getNormal(normal, face, vert); };
-                mikktspace.m_getTexCoord = [](const SMikkTSpaceContext* pContext, float texCrd[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getTexCrd(texCrd, face, vert); };
-                mikktspace.m_setTSpaceBasic = [](const SMikkTSpaceContext* pContext, const float tangent[], float sign, int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->setTangent(tangent, sign, face, vert); };
-
                 MikkTSpaceWrapper wrapper(mesh);
-                SMikkTSpaceContext context = {};
-                context.m_pInterface = &mikktspace;
-                context.m_pUserData = &wrapper;
-
-                if (genTangSpaceDefault(&context) == false)
+                // Meshes with fewer than two chunks of faces are processed at once.
+                if (mesh.faceCount / 2 < chunkFaceCount || !wrapper.generateTangentsChunked(chunkFaceCount))
                 {
-                    FALCOR_THROW("MikkTSpace failed to generate tangents for the mesh '{}'.", mesh.name);
+                    Chunk chunk = { &wrapper };
+                    if (!chunk.generate()) FALCOR_THROW("MikkTSpace failed to generate tangents for the mesh '{}'.", mesh.name);
                 }
 
-                return wrapper.mTangents;
+                return std::move(wrapper.mTangents);
             }
 
         private:
+            static constexpr uint32_t kWholeMesh = 0xffffffff;
+
+            /** Subset of the faces of a mesh processed by one MikkTSpace invocation.
+                Tangents are only written for the faces owned by the chunk.
+
+                An isolated sentinel triangle is appended after the faces. MikkTSpace doesn't sort the edges that start
+                at the highest welded vertex index when building the face adjacency, which makes the result at that vertex
+                depend on the rest of the input. The sentinel owns that vertex, so all mesh faces are connected correctly.
+                Its normals are NaN so that it is never welded to any mesh vertex.
+            */
+            struct Chunk
+            {
+                MikkTSpaceWrapper* pWrapper = nullptr;
+                uint32_t chunkIndex = kWholeMesh;   ///< Index of the chunk, or kWholeMesh to process all faces.
+                const uint32_t* pFaces = nullptr;   ///< Faces to process in increasing order. Only used for chunks.
+                uint32_t faceCount = 0;
+
+                uint32_t getMeshFaceCount() const { return chunkIndex == kWholeMesh ? pWrapper->mMesh.faceCount : faceCount; }
+                bool isSentinel(int32_t face) const { return (uint32_t)face == getMeshFaceCount(); }
+                uint32_t getFace(int32_t face) const { return chunkIndex == kWholeMesh ? (uint32_t)face : pFaces[face]; }
+
+                bool generate()
+                {
+                    SMikkTSpaceInterface mikktspace = {};
+                    mikktspace.m_getNumFaces = [](const SMikkTSpaceContext* pContext) { return ((Chunk*)(pContext->m_pUserData))->getFaceCount(); };
+                    mikktspace.m_getNumVerticesOfFace = [](const SMikkTSpaceContext* pContext, int32_t face) { return 3; };
+                    mikktspace.m_getPosition = [](const SMikkTSpaceContext* pContext, float position[], int32_t face, int32_t vert) { ((Chunk*)(pContext->m_pUserData))->getPosition(position, face, vert); };
+                    mikktspace.m_getNormal = [](const SMikkTSpaceContext* pContext, float normal[], int32_t face, int32_t vert) { ((Chunk*)(pContext->m_pUserData))->getNormal(normal, face, vert); };
+                    mikktspace.m_getTexCoord = [](const SMikkTSpaceContext* pContext, float texCrd[], int32_t face, int32_t vert) { ((Chunk*)(pContext->m_pUserData))->getTexCrd(texCrd, face, vert); };
+                    mikktspace.m_setTSpaceBasic = [](const SMikkTSpaceContext* pContext, const float tangent[], float sign, int32_t face, int32_t vert) { ((Chunk*)(pContext->m_pUserData))->setTangent(tangent, sign, face, vert); };
+
+                    SMikkTSpaceContext context = {};
+                    context.m_pInterface = &mikktspace;
+                    context.m_pUserData = this;
+                    return genTangSpaceDefault(&context);
+                }
+
+                int32_t getFaceCount() const { return (int32_t)getMeshFaceCount() + 1; }
+
+                void getPosition(float position[], int32_t face, int32_t vert) const
+                {
+                    if (isSentinel(face)) *reinterpret_cast<float3*>(position) = float3(vert == 1, vert == 2, 0.f);
+                    else pWrapper->getPosition(position, getFace(face), vert);
+                }
+
+                void getNormal(float normal[], int32_t face, int32_t vert) const
+                {
+                    if (isSentinel(face)) *reinterpret_cast<float3*>(normal) = float3(std::numeric_limits<float>::quiet_NaN());
+                    else pWrapper->getNormal(normal, getFace(face), vert);
+                }
+
+                void getTexCrd(float texCrd[], int32_t face, int32_t vert) const
+                {
+                    if (isSentinel(face)) *reinterpret_cast<float2*>(texCrd) = float2(vert == 1, vert == 2);
+                    else pWrapper->getTexCrd(texCrd, getFace(face), vert);
+                }
+
+                void setTangent(const float tangent[], float sign, int32_t face, int32_t vert)
+                {
+                    if (isSentinel(face)) return;
+                    uint32_t f = getFace(face);
+                    if (chunkIndex == kWholeMesh || pWrapper->mFaceChunks[f] == chunkIndex) pWrapper->setTangent(tangent, sign, f, vert);
+                }
+            };
+
             MikkTSpaceWrapper(const SceneBuilder::Mesh& mesh)
                 : mMesh(mesh)
             {
@@ -134,15 +208,140 @@ namespace Falcor
                 }
 
             }
+
+            /** Generate tangents in spatially coherent chunks of faces in parallel.
+                MikkTSpace only shares tangent space between face corners with identical position, normal and texture coordinate.
+                Each chunk is therefore processed together with all faces that have a corner at the same position as one of its corners,
+                which gives the same result as processing the whole mesh at once. Only the tangents of the chunk's own faces are kept.
+                \return False if the chunks overlap too much, in which case the mesh should be processed at once.
+            */
+            bool generateTangentsChunked(uint32_t chunkFaceCount)
+            {
+                const uint32_t faceCount = mMesh.faceCount;
+                const uint32_t cornerCount = faceCount * 3;
+
+                // Position bits for grouping corners. Negative zero is folded into positive zero as they compare equal.
+                auto getPositionBits = [&](uint32_t corner)
+                {
+                    const float3 p = mPositions[corner] + float3(0.f);
+                    return uint3(math::asuint(p.x), math::asuint(p.y), math::asuint(p.z));
+                };
+
+                // Sort faces along a Morton curve through their centroids.
+                AABB bounds;
+                for (const float3& p : mPositions)
+                {
+                    if (!any(isnan(p) || isinf(p))) bounds.include(p);
+                }
+                if (!bounds.valid()) return false;
+                const float3 extent = max(bounds.extent(), float3(std::numeric_limits<float>::min()));
+
+                std::vector<uint64_t> faceKeys(faceCount);
+                NumericRange<uint32_t> faceRange(0, faceCount);
+                std::for_each(std::execution::par_unseq, faceRange.begin(), faceRange.end(), [&](uint32_t face)
+                {
+                    float3 c = (mPositions[3 * face] + mPositions[3 * face + 1] + mPositions[3 * face + 2]) / 3.f;
+                    float3 u = clamp((c - bounds.minPoint) / extent, float3(0.f), float3(1.f));
+                    if (any(isnan(u))) u = float3(0.f);
+                    uint32_t code = (expandBits(uint32_t(u.x * 1023.f)) << 2) | (expandBits(uint32_t(u.y * 1023.f)) << 1) | expandBits(uint32_t(u.z * 1023.f));
+                    faceKeys[face] = (uint64_t(code) << 32) | face;
+                });
+                std::sort(std::execution::par_unseq, faceKeys.begin(), faceKeys.end());
+
+                const uint32_t chunkCount = div_round_up(faceCount, chunkFaceCount);
+                std::vector<uint32_t> sortedFaces(faceCount);
+                mFaceChunks.resize(faceCount);
+                for (uint32_t i = 0; i < faceCount; i++)
+                {
+                    sortedFaces[i] = (uint32_t)faceKeys[i];
+                    mFaceChunks[sortedFaces[i]] = i / chunkFaceCount;
+                }
+                faceKeys = {};
+
+                // Group corners with identical positions.
+                struct CornerKey
+                {
+                    uint3 position;
+                    uint32_t corner;
+                    bool operator<(const CornerKey& other) const
+                    {
+                        if (position.x != other.position.x) return position.x < other.position.x;
+                        if (position.y != other.position.y) return position.y < other.position.y;
+                        if (position.z != other.position.z) return position.z < other.position.z;
+                        return corner < other.corner;
+                    }
+                };
+                std::vector<CornerKey> cornerKeys(cornerCount);
+                NumericRange<uint32_t> cornerRange(0, cornerCount);
+                std::for_each(std::execution::par_unseq, cornerRange.begin(), cornerRange.end(), [&](uint32_t corner) { cornerKeys[corner] = { getPositionBits(corner), corner }; });
+                std::sort(std::execution::par_unseq, cornerKeys.begin(), cornerKeys.end());
+
+                std::vector<uint32_t> corners(cornerCount); // Corners sorted by position.
+                std::vector<uint32_t> cornerGroups(cornerCount); // Group index of each corner.
+                std::vector<uint32_t> groupOffsets; // Start of each group in the sorted corners.
+                for (uint32_t i = 0; i < cornerCount; i++)
+                {
+                    if (i == 0 || any(cornerKeys[i].position != cornerKeys[i - 1].position)) groupOffsets.push_back(i);
+                    corners[i] = cornerKeys[i].corner;
+                    cornerGroups[corners[i]] = (uint32_t)groupOffsets.size() - 1;
+                }
+                groupOffsets.push_back(cornerCount);
+                cornerKeys = {};
+
+                // Collect the faces of each chunk, including the neighboring faces.
+                std::vector<std::vector<uint32_t>> chunkFaces(chunkCount);
+                NumericRange<uint32_t> chunkRange(0, chunkCount);
+                std::for_each(std::execution::par, chunkRange.begin(), chunkRange.end(), [&](uint32_t chunkIndex)
+                {
+                    std::vector<uint32_t>& faces = chunkFaces[chunkIndex];
+                    std::vector<bool> isAdded(faceCount, false);
+                    const uint32_t begin = chunkIndex * chunkFaceCount;
+                    const uint32_t end = std::min(begin + chunkFaceCount, faceCount);
+                    for (uint32_t i = begin; i < end; i++)
+                    {
+                        for (uint32_t vert = 0; vert < 3; vert++)
+                        {
+                            uint32_t group = cornerGroups[3 * sortedFaces[i] + vert];
+                            for (uint32_t j = groupOffsets[group]; j < groupOffsets[group + 1]; j++)
+                            {
+                                uint32_t face = corners[j] / 3;
+                                if (!isAdded[face])
+                                {
+                                    isAdded[face] = true;
+                                    faces.push_back(face);
+                                }
+                            }
+                        }
+                    }
+                    // Keep the faces in mesh order, as the MikkTSpace results depend on the face order.
+                    std::sort(faces.begin(), faces.end());
+                });
+
+                // Fall back to processing the mesh at once if many faces share positions (e.g. degenerate geometry).
+                size_t totalFaceCount = 0;
+                for (const auto& faces : chunkFaces) totalFaceCount += faces.size();
+                if (totalFaceCount > 2 * size_t(faceCount)) return false;
+
+                std::atomic<bool> success = true;
+                std::for_each(std::execution::par, chunkRange.begin(), chunkRange.end(), [&](uint32_t chunkIndex)
+                {
+                    Chunk chunk = { this, chunkIndex, chunkFaces[chunkIndex].data(), (uint32_t)chunkFaces[chunkIndex].size() };
+                    if (!chunk.generate()) success = false;
+                });
+                if (!success) FALCOR_THROW("MikkTSpace failed to generate tangents for the mesh '{}'.", mMesh.name);
+
+                return true;
+            }
+
             const SceneBuilder::Mesh& mMesh;
             std::vector<float4> mTangents;
             std::vector<float3> mPositions;
-            int32_t getFaceCount() const { return (int32_t)mMesh.faceCount; }
-            void getPosition(float position[], int32_t face, int32_t vert) const { FALCOR_ASSERT_LT(size_t(face) * 3 + vert, mPositions.size()); memcpy(position, mPositions.data() + (face * 3 + vert), sizeof(float3)); }
-            void getNormal(float normal[], int32_t face, int32_t vert) { *reinterpret_cast<float3*>(normal) = mMesh.getNormal(face, vert); }
-            void getTexCrd(float texCrd[], int32_t face, int32_t vert) { *reinterpret_cast<float2*>(texCrd) = mMesh.getTexCrd(face, vert); }
+            std::vector<uint32_t> mFaceChunks; ///< Chunk index of each face when generating tangents in chunks.
+            void getPosition(float position[], uint32_t face, int32_t vert) const { FALCOR_ASSERT_LT(size_t(face) * 3 + vert, mPositions.size()); memcpy(position, mPositions.data() + (face * 3 + vert), sizeof(float3)); }
+            void getNormal(float normal[], uint32_t face, int32_t vert) const { *reinterpret_cast<float3*>(normal) = mMesh.getNormal(face, vert); }
+            void getTexCrd(float texCrd[], uint32_t face, int32_t vert) const { *reinterpret_cast<float2*>(texCrd) = mMesh.getTexCrd(face, vert); }
 
-            void setTangent(const float tangent[], float sign, int32_t face, int32_t vert)
+            void setTangent(const float tangent[], float sign, uint32_t face, int32_t vert)
             {
                 float3 T = *reinterpret_cast<const float3*>(tangent);
                 mTangents[face * 3 + vert] = float4(normalize(T), sign);
@@ -354,6 +553,7 @@ namespace Falcor
         prepareSceneGraph();
         prepareMeshes();
         removeUnusedMeshes();
+        removeDuplicateMeshes();
         flattenStaticMeshInstances();
         pretransformStaticMeshes();
         unifyTriangleWinding();
@@ -362,6 +562,7 @@ namespace Falcor
         createMeshGroups();
         optimizeGeometry();
         sortMeshes();
+        optimizeVertexLayout();
         createGlobalBuffers();
         createCurveGlobalBuffers();
         collectVolumeGrids();
@@ -372,6 +573,7 @@ namespace Falcor
         optimizeMaterials();
         removeDuplicateMaterials();
         quantizeTexCoords();
+        quantizeVertices();
 
         timeReport.measure("Optimizing materials");
 
@@ -505,7 +707,23 @@ namespace Falcor
             pTangents = &localTangents;
         if (!(is_set(mFlags, Flags::UseOriginalTangentSpace) || mesh.useOriginalTangentSpace) || !mesh.tangents.pData)
         {
-            generateTangents(mesh, *pTangents);
+            if (requiresTangentSpace(mesh.pMaterial))
+            {
+                generateTangents(mesh, *pTangents);
+            }
+            else if (mesh.normals.pData)
+            {
+                // The material is not affected by the tangent direction. Use an arbitrary tangent orthonormal to the normal.
+                pTangents->resize(mesh.indexCount);
+                NumericRange<uint32_t> range(0, mesh.indexCount);
+                std::for_each(std::execution::par_unseq, range.begin(), range.end(), [&](uint32_t fvIndex)
+                {
+                    float3 normal = mesh.getNormal(fvIndex / 3, fvIndex % 3);
+                    (*pTangents)[fvIndex] = float4(perp_stark(normal), 1.f);
+                });
+                mesh.tangents.pData = pTangents->data();
+                mesh.tangents.frequency = Mesh::AttributeFrequency::FaceVarying;
+            }
         }
 
         // Pretransform the texture coordinates, rather than transforming them at runtime.
@@ -697,9 +915,24 @@ namespace Falcor
         return processedMesh;
     }
 
-    void SceneBuilder::generateTangents(Mesh& mesh, std::vector<float4>& tangents)
+    bool SceneBuilder::requiresTangentSpace(const ref<Material>& pMaterial) const
     {
-        tangents = MikkTSpaceWrapper::generateTangents(mesh);
+        if (!is_set(mFlags, Flags::SkipTangentsWithoutNormalMaps)) return true;
+
+        // The standard material is isotropic. The tangent frame is only used for normal and displacement mapping.
+        if (pMaterial->getType() != MaterialType::Standard) return true;
+
+        for (auto slot : { Material::TextureSlot::Normal, Material::TextureSlot::Displacement })
+        {
+            if (pMaterial->getTexture(slot)) return true;
+            if (mpMaterialTextureLoader && mpMaterialTextureLoader->isTexturePending(pMaterial.get(), slot)) return true;
+        }
+        return false;
+    }
+
+    void SceneBuilder::generateTangents(Mesh& mesh, std::vector<float4>& tangents, uint32_t chunkFaceCount)
+    {
+        tangents = MikkTSpaceWrapper::generateTangents(mesh, chunkFaceCount > 0 ? chunkFaceCount : kTangentChunkFaceCount);
         if (!tangents.empty())
         {
             FALCOR_ASSERT(tangents.size() == mesh.indexCount);
@@ -1091,6 +1324,36 @@ namespace Falcor
         return newNodeID;
     }
 
+    NodeID SceneBuilder::addNodes(fstd::span<const float4x4> transforms, fstd::span<const NodeID> parents)
+    {
+        FALCOR_CHECK(parents.empty() || parents.size() == transforms.size(), "'parents' has {} elements, expected {}", parents.size(), transforms.size());
+
+        NodeID firstNodeID{ mSceneGraph.size() };
+        mSceneGraph.reserve(mSceneGraph.size() + transforms.size());
+
+        Node node;
+        node.meshBind = float4x4::identity();
+        node.localToBindPose = float4x4::identity();
+        for (size_t i = 0; i < transforms.size(); ++i)
+        {
+            node.transform = transforms[i];
+            node.parent = parents.empty() ? NodeID::Invalid() : parents[i];
+            addNode(node);
+        }
+
+        return firstNodeID;
+    }
+
+    void SceneBuilder::addMeshInstances(fstd::span<const NodeID> nodeIDs, fstd::span<const MeshID> meshIDs)
+    {
+        FALCOR_CHECK(meshIDs.size() == nodeIDs.size() || meshIDs.size() == 1, "'meshIDs' has {} elements, expected 1 or {}", meshIDs.size(), nodeIDs.size());
+
+        for (size_t i = 0; i < nodeIDs.size(); ++i)
+        {
+            addMeshInstance(nodeIDs[i], meshIDs.size() == 1 ? meshIDs[0] : meshIDs[i]);
+        }
+    }
+
     void SceneBuilder::addMeshInstance(NodeID nodeID, MeshID meshID)
     {
         FALCOR_CHECK(nodeID.get() < mSceneGraph.size(), "'nodeID' ({}) is out of range", nodeID);
@@ -1100,6 +1363,32 @@ namespace Falcor
         mMeshes[meshID.get()].instances.insert(nodeID);
     }
 
+    void SceneBuilder::addMeshInstanceSet(Scene::InstanceSet set, fstd::span<const MeshID> meshIDs)
+    {
+        FALCOR_CHECK(set.parent == NodeID::Invalid() || set.parent.get() < mSceneGraph.size(), "'set.parent' ({}) is out of range", set.parent);
+        FALCOR_CHECK(!set.isAnimated() || (set.transforms.empty() && set.keyframes.size() % set.keyframesPerInstance == 0),
+            "Instance set '{}' must have either transforms or {} keyframes per instance", set.name, set.keyframesPerInstance);
+        FALCOR_CHECK(set.getInstanceCount() > 0, "Instance set '{}' has no instances", set.name);
+        FALCOR_CHECK(isMatrixValid(set.meshTransform) && isMatrixAffine(set.meshTransform), "Instance set '{}' mesh transform is not a valid affine matrix", set.name);
+        for (const auto& transform : set.transforms)
+        {
+            FALCOR_CHECK(isMatrixValid(transform) && isMatrixAffine(transform), "Instance set '{}' has a transform that is not a valid affine matrix", set.name);
+        }
+
+        const uint32_t setIndex = (uint32_t)mSceneData.instanceSets.size();
+        for (MeshID meshID : meshIDs)
+        {
+            FALCOR_CHECK(meshID.get() < mMeshes.size(), "'meshID' ({}) is out of range", meshID);
+            FALCOR_CHECK(!mMeshes[meshID.get()].isSkinned(), "Skinned mesh '{}' cannot be added to instance set '{}'", mMeshes[meshID.get()].name, set.name);
+            mMeshes[meshID.get()].instanceSets.insert(setIndex);
+        }
+
+        // The instance matrices are computed from the parent's global matrix, so the parent node is kept as is.
+        if (set.parent != NodeID::Invalid()) mSceneGraph[set.parent.get()].dontOptimize = true;
+
+        mSceneData.instanceSets.push_back(std::move(set));
+    }
+
     void SceneBuilder::addCurveInstance(NodeID nodeID, CurveID curveID)
     {
         FALCOR_CHECK(nodeID.get() < mSceneGraph.size(), "'nodeID' ({}) is out of range", nodeID);
@@ -1408,9 +1697,9 @@ namespace Falcor
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
             auto& mesh = mMeshes[meshID.get()];
-            if (mesh.instances.empty())
+            if (mesh.instances.empty() && mesh.instanceSets.empty())
             {
-                logWarning("Mesh with ID {} named '{}' is not referenced by any scene graph nodes.", meshID, mesh.name);
+                logWarning("Mesh with ID {} named '{}' is not referenced by any scene graph nodes or instance sets.", meshID, mesh.name);
                 unusedCount++;
             }
         }
@@ -1427,7 +1716,7 @@ namespace Falcor
             for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)meshCount; ++meshID)
             {
                 auto& mesh = mMeshes[meshID.get()];
-                if (mesh.instances.empty()) continue; // Skip unused meshes
+                if (mesh.instances.empty() && mesh.instanceSets.empty()) continue; // Skip unused meshes
 
                 // Get new mesh ID.
                 const MeshID newMeshID(meshes.size());
@@ -1467,6 +1756,147 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::removeDuplicateMeshes()
+    {
+        // Importers often emit the same mesh data multiple times, e.g. when several shapes reference the same file.
+        // This function collapses meshes with identical vertex/index data and equal materials into a single mesh
+        // that is instanced by all nodes referencing any of the duplicates.
+        // Dynamic meshes are excluded as their vertices are updated per mesh at runtime.
+
+        if (is_set(mFlags, Flags::DontMergeMeshes) || mMeshes.size() < 2) return;
+
+        auto isMergeable = [](const MeshSpec& mesh)
+        {
+            return !mesh.isDynamic() && mesh.skeletonNodeID == NodeID::Invalid();
+        };
+
+        // Material duplicates are only removed later in removeDuplicateMaterials(), so compare the materials by value.
+        // Each material is mapped to the first material equal to it, unless materials are not merged.
+        const auto& materials = mSceneData.pMaterials->getMaterials();
+        std::vector<MaterialID> canonicalMaterialIDs(materials.size());
+        for (MaterialID materialID{ 0 }; materialID.get() < materials.size(); ++materialID)
+        {
+            canonicalMaterialIDs[materialID.get()] = materialID;
+            if (is_set(mFlags, Flags::DontMergeMaterials)) continue;
+            for (MaterialID otherID{ 0 }; otherID < materialID; ++otherID)
+            {
+                if (canonicalMaterialIDs[otherID.get()] == otherID && materials[otherID.get()]->isEqual(materials[materialID.get()]))
+                {
+                    canonicalMaterialIDs[materialID.get()] = otherID;
+                    break;
+                }
+            }
+        }
+
+        // Hash the geometry of all mergeable meshes.
+        std::vector<uint64_t> hashes(mMeshes.size(), 0);
+        auto range = NumericRange<uint32_t>(0, (uint32_t)mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t meshIndex)
+        {
+            const auto& mesh = mMeshes[meshIndex];
+            if (!isMergeable(mesh)) return;
+
+            FNVHash64 hash;
+            hash.insert(mesh.topology);
+            hash.insert(canonicalMaterialIDs[mesh.materialId.get()]);
+            hash.insert(mesh.vertexCount);
+            hash.insert(mesh.indexCount);
+            hash.insert(mesh.use16BitIndices);
+            hash.insert(mesh.isFrontFaceCW);
+            hash.insert(mesh.isDisplaced);
+            hash.insert(mesh.indexData.data(), mesh.indexData.size() * sizeof(uint32_t));
+            hash.insert(mesh.staticData.data(), mesh.staticData.size() * sizeof(StaticVertexData));
+            hashes[meshIndex] = hash.get();
+        });
+
+        auto isSameGeometry = [&](const MeshSpec& a, const MeshSpec& b)
+        {
+            return a.topology == b.topology && canonicalMaterialIDs[a.materialId.get()] == canonicalMaterialIDs[b.materialId.get()] &&
+                a.vertexCount == b.vertexCount && a.indexCount == b.indexCount &&
+                a.use16BitIndices == b.use16BitIndices && a.isFrontFaceCW == b.isFrontFaceCW && a.isDisplaced == b.isDisplaced &&
+                a.indexData == b.indexData &&
+                a.staticData.size() == b.staticData.size() &&
+                std::memcmp(a.staticData.data(), b.staticData.data(), a.staticData.size() * sizeof(StaticVertexData)) == 0;
+        };
+
+        // Find the first mesh with identical geometry for each mesh.
+        // Meshes sharing a node or instance set with their duplicate are kept separate to avoid instancing a mesh twice at the same transform.
+        std::vector<MeshID> canonicalMeshIDs(mMeshes.size());
+        std::unordered_map<uint64_t, std::vector<MeshID>> meshesByHash;
+        size_t duplicateCount = 0;
+        uint64_t duplicateVertexCount = 0;
+        uint64_t duplicateTriangleCount = 0;
+
+        for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
+        {
+            auto& mesh = mMeshes[meshID.get()];
+            canonicalMeshIDs[meshID.get()] = meshID;
+            if (!isMergeable(mesh)) continue;
+
+            auto& candidates = meshesByHash[hashes[meshID.get()]];
+            for (MeshID candidateID : candidates)
+            {
+                auto& candidate = mMeshes[candidateID.get()];
+                if (!isSameGeometry(candidate, mesh)) continue;
+
+                bool sharesNode = std::any_of(mesh.instances.begin(), mesh.instances.end(), [&](NodeID nodeID) { return candidate.instances.count(nodeID) > 0; });
+                bool sharesSet = std::any_of(mesh.instanceSets.begin(), mesh.instanceSets.end(), [&](uint32_t setIndex) { return candidate.instanceSets.count(setIndex) > 0; });
+                if (sharesNode || sharesSet) continue;
+
+                canonicalMeshIDs[meshID.get()] = candidateID;
+                candidate.instances.insert(mesh.instances.begin(), mesh.instances.end());
+                candidate.instanceSets.insert(mesh.instanceSets.begin(), mesh.instanceSets.end());
+                duplicateCount++;
+                duplicateVertexCount += mesh.vertexCount;
+                duplicateTriangleCount += mesh.getTriangleCount();
+                break;
+            }
+            if (canonicalMeshIDs[meshID.get()] == meshID) candidates.push_back(meshID);
+        }
+
+        if (duplicateCount == 0) return;
+
+        // Rebuild the mesh list and remap the mesh IDs.
+        const size_t meshCount = mMeshes.size();
+        std::vector<MeshID> newMeshIDs(meshCount);
+        MeshList meshes;
+        meshes.reserve(meshCount - duplicateCount);
+
+        for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)meshCount; ++meshID)
+        {
+            if (canonicalMeshIDs[meshID.get()] != meshID) continue;
+            newMeshIDs[meshID.get()] = MeshID(meshes.size());
+            meshes.push_back(std::move(mMeshes[meshID.get()]));
+        }
+        for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)meshCount; ++meshID)
+        {
+            newMeshIDs[meshID.get()] = newMeshIDs[canonicalMeshIDs[meshID.get()].get()];
+        }
+
+        for (auto& node : mSceneGraph)
+        {
+            for (auto& meshID : node.meshes) meshID = newMeshIDs[meshID.get()];
+        }
+        for (auto& cachedMesh : mSceneData.cachedMeshes)
+        {
+            cachedMesh.meshID = newMeshIDs[cachedMesh.meshID.get()];
+        }
+        for (auto& cache : mSceneData.cachedCurves)
+        {
+            if (cache.tessellationMode != CurveTessellationMode::LinearSweptSphere)
+            {
+                cache.geometryID = CurveOrMeshID{ newMeshIDs[cache.geometryID.get()] };
+            }
+        }
+
+        mMeshes = std::move(meshes);
+
+        logInfo(
+            "Removed {} duplicate meshes ({} vertices, {} triangles). {} unique meshes remain.",
+            duplicateCount, duplicateVertexCount, duplicateTriangleCount, mMeshes.size()
+        );
+    }
+
     void SceneBuilder::flattenStaticMeshInstances()
     {
         // This function optionally flattens all instanced non-skinned mesh instances to
@@ -1486,7 +1916,8 @@ namespace Falcor
             auto& mesh = mMeshes[meshID.get()];
 
             // Skip non-instanced and dynamic meshes.
-            if (mesh.instances.size() == 1 || mesh.isDynamic())
+            // Meshes in instance sets are skipped as well, as the sets exist to avoid per-instance data.
+            if (mesh.instances.size() == 1 || mesh.isDynamic() || !mesh.instanceSets.empty())
             {
                 continue;
             }
@@ -1668,8 +2099,9 @@ namespace Falcor
             auto& mesh = mMeshes[meshID.get()];
 
             // Skip instanced/animated/skinned meshes.
-            FALCOR_ASSERT(!mesh.instances.empty());
-            if (mesh.instances.size() > 1 || isNodeAnimated(*mesh.instances.begin()) || mesh.isDynamic()) continue;
+            if (mesh.isInstanced()) continue;
+            FALCOR_ASSERT(mesh.instances.size() == 1);
+            if (isNodeAnimated(*mesh.instances.begin()) || mesh.isDynamic()) continue;
 
             FALCOR_ASSERT(mesh.skinningData.empty());
             mesh.isStatic = true;
@@ -1700,14 +2132,18 @@ namespace Falcor
                 float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
                 float3x3 transform3x3 = float3x3(transform);
 
-                for (auto& v : mesh.staticData)
+                // Transform positions, normals and tangents in batches. The tangent's xyz components are transformed in place, leaving w unchanged.
+                // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
+                // Leaving that out for now for consistency with the shader code that needs the same fix.
+                auto& data = mesh.staticData;
+                const size_t stride = sizeof(StaticVertexData);
+                transformPoints(transform, &data[0].position, &data[0].position, data.size(), stride, stride);
+                transformNormals(invTranspose3x3, &data[0].normal, &data[0].normal, data.size(), stride, stride);
+                float3* pTangents = reinterpret_cast<float3*>(&data[0].tangent);
+                transformNormals(transform3x3, pTangents, pTangents, data.size(), stride, stride);
+
+                for (auto& v : data)
                 {
-                    v.position = transformPoint(transform, v.position);
-                    v.normal = normalize(transformVector(invTranspose3x3, v.normal));
-                    v.tangent = float4(normalize(transformVector(transform3x3, v.tangent.xyz())), v.tangent.w);
-                    // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
-                    // Leaving that out for now for consistency with the shader code that needs the same fix.
-
                     v.curveRadius = length(transformVector(transform3x3, float3(v.curveRadius, 0.f, 0.f)));
                 }
 
@@ -1863,7 +2299,7 @@ namespace Falcor
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
             auto& mesh = mMeshes[meshID.get()];
-            if (mesh.instances.size() > 1) continue; // Only processing non-instanced meshes here
+            if (mesh.isInstanced()) continue; // Only processing non-instanced meshes here
 
             FALCOR_ASSERT(mesh.instances.size() == 1);
             NodeID nodeID = *mesh.instances.begin();
@@ -1885,23 +2321,25 @@ namespace Falcor
         FALCOR_ASSERT(staticMeshes.size() + staticDisplacedMeshes.size() + dynamicDisplacedMeshes.size() + nonInstancedDynamicMeshCount == nonInstancedMeshCount);
 
         // Classify instanced meshes.
-        // The instanced meshes are grouped based on their lists of instances.
+        // The instanced meshes are grouped based on their lists of instance nodes and instance sets.
         // Meshes with an identical set of instances can be placed together in a BLAS.
-        std::map<std::set<NodeID>, meshList> instancesToMeshList;
-        std::map<std::set<NodeID>, meshList> displacedInstancesToMeshList;
+        using instanceList = std::pair<std::set<NodeID>, std::set<uint32_t>>;
+        std::map<instanceList, meshList> instancesToMeshList;
+        std::map<instanceList, meshList> displacedInstancesToMeshList;
         size_t instancedMeshCount = 0;
 
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
             auto& mesh = mMeshes[meshID.get()];
-            if (mesh.instances.size() <= 1) continue; // Only processing instanced meshes here
+            if (!mesh.isInstanced()) continue; // Only processing instanced meshes here
 
             // Mark displaced meshes.
             const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId);
             if (pMaterial->isDisplaced()) mesh.isDisplaced = true;
 
-            if (mesh.isDisplaced) displacedInstancesToMeshList[mesh.instances].push_back(meshID);
-            else instancesToMeshList[mesh.instances].push_back(meshID);
+            instanceList instances{ mesh.instances, mesh.instanceSets };
+            if (mesh.isDisplaced) displacedInstancesToMeshList[instances].push_back(meshID);
+            else instancesToMeshList[instances].push_back(meshID);
             instancedMeshCount++;
         }
 
@@ -2014,6 +2452,7 @@ namespace Falcor
             spec.isStatic = mesh.isStatic;
             spec.isFrontFaceCW = mesh.isFrontFaceCW;
             spec.instances = mesh.instances;
+            spec.instanceSets = mesh.instanceSets;
             FALCOR_ASSERT(mesh.isDynamic() == false);
             FALCOR_ASSERT(mesh.skinningVertexCount == 0);
             return spec;
@@ -2414,6 +2853,79 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::optimizeVertexLayout()
+    {
+        // This function optimizes the index and vertex order of triangle meshes for rasterization.
+        // Triangles are reordered for post-transform vertex cache reuse (optionally in meshlet-sized clusters),
+        // and vertices are then reordered in the order they are first referenced to improve vertex fetch locality.
+        // Vertex-animated meshes are skipped as their vertices are addressed by index from outside the scene builder.
+
+        const bool useMeshlets = is_set(mFlags, Flags::UseMeshletLayout);
+        if (!is_set(mFlags, Flags::OptimizeVertexLayout) && !useMeshlets) return;
+
+        struct MeshStats
+        {
+            bool optimized = false;
+            MeshLayoutOptimizer::CacheStats before;
+            MeshLayoutOptimizer::CacheStats after;
+            size_t meshletCount = 0;
+        };
+        std::vector<MeshStats> meshStats(mMeshes.size());
+
+        NumericRange<uint32_t> range(0, (uint32_t)mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t meshIndex)
+        {
+            MeshSpec& mesh = mMeshes[meshIndex];
+            if (mesh.topology != Vao::Topology::TriangleList || mesh.indexCount == 0 || mesh.isAnimated) return;
+
+            const uint32_t vertexCount = (uint32_t)mesh.staticData.size();
+            std::vector<uint32_t> indices(mesh.indexCount);
+            for (uint32_t i = 0; i < mesh.indexCount; i++) indices[i] = mesh.getIndex(i);
+
+            MeshStats& stats = meshStats[meshIndex];
+            stats.optimized = true;
+            stats.before = MeshLayoutOptimizer::analyzeVertexCache(indices.data(), mesh.indexCount, vertexCount);
+
+            if (useMeshlets) stats.meshletCount = MeshLayoutOptimizer::buildMeshlets(indices.data(), mesh.indexCount, vertexCount).size();
+            else MeshLayoutOptimizer::optimizeVertexCache(indices.data(), mesh.indexCount, vertexCount);
+
+            std::vector<uint32_t> vertexOrder = MeshLayoutOptimizer::optimizeVertexFetch(indices.data(), mesh.indexCount, vertexCount);
+            MeshLayoutOptimizer::applyVertexOrder(mesh.staticData, vertexOrder);
+
+            if (mesh.isSkinned())
+            {
+                // Skinned vertices reference the static vertices by index. Keep them in the same order as the static vertices.
+                std::vector<uint32_t> newIndices(vertexOrder.size());
+                for (uint32_t i = 0; i < (uint32_t)vertexOrder.size(); i++) newIndices[vertexOrder[i]] = i;
+                if (mesh.skinningData.size() == mesh.staticData.size()) MeshLayoutOptimizer::applyVertexOrder(mesh.skinningData, vertexOrder);
+                for (auto& v : mesh.skinningData) v.staticIndex = newIndices[v.staticIndex];
+            }
+
+            stats.after = MeshLayoutOptimizer::analyzeVertexCache(indices.data(), mesh.indexCount, vertexCount);
+
+            mesh.indexData = mesh.use16BitIndices ? compact16BitIndices(indices) : std::move(indices);
+        });
+
+        size_t optimizedMeshCount = 0;
+        size_t meshletCount = 0;
+        MeshLayoutOptimizer::CacheStats before;
+        MeshLayoutOptimizer::CacheStats after;
+        for (const auto& stats : meshStats)
+        {
+            if (!stats.optimized) continue;
+            optimizedMeshCount++;
+            meshletCount += stats.meshletCount;
+            before += stats.before;
+            after += stats.after;
+        }
+
+        if (optimizedMeshCount == 0) return;
+
+        logInfo("Optimized vertex layout of {} out of {} meshes ({} triangles{}). ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f} (FIFO cache with {} entries).",
+            optimizedMeshCount, mMeshes.size(), after.triangleCount, useMeshlets ? fmt::format(", {} meshlets", meshletCount) : "",
+            before.getACMR(), after.getACMR(), before.getATVR(), after.getATVR(), MeshLayoutOptimizer::kDefaultAnalysisCacheSize);
+    }
+
     void SceneBuilder::createGlobalBuffers()
     {
         FALCOR_ASSERT(mSceneData.meshIndexData.empty());
@@ -2641,6 +3153,115 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::quantizeVertices()
+    {
+        if (!is_set(mFlags, Flags::QuantizeVertices) || mMeshes.empty()) return;
+
+        // The quantized format is used for the whole scene, so all meshes must be eligible.
+        // Dynamic meshes are excluded as their vertices are written on the GPU in the full format,
+        // and curves tessellated into meshes need the curve radius which is not stored.
+        for (const auto& mesh : mMeshes)
+        {
+            bool hasCurveRadius = false;
+            for (uint32_t i = 0; i < mesh.staticVertexCount && !hasCurveRadius; ++i)
+            {
+                hasCurveRadius = mSceneData.meshStaticData[(size_t)mesh.staticVertexOffset + i].unpack().curveRadius > 0.f;
+            }
+            if (mesh.isDynamic() || hasCurveRadius)
+            {
+                logWarning("Mesh '{}' is {}, vertices will not be quantized.", mesh.name, mesh.isDynamic() ? "dynamic" : "generated from curves");
+                return;
+            }
+        }
+
+        // Assign vertex offsets. Each mesh starts on a new page so the mesh ID can be looked up from a global vertex index.
+        // Like the full format, the data is split into multiple buffers if it exceeds the GPU buffer size limit.
+        const uint32_t kPageSize = PackedQuantizedVertexData::kPageSize;
+        Scene::SplitQuantizedVertexBuffer quantizedData;
+        quantizedData.setName("meshQuantizedData");
+        std::vector<uint32_t> vertexOffsets(mMeshes.size());
+        for (size_t meshID = 0; meshID < mMeshes.size(); ++meshID)
+        {
+            vertexOffsets[meshID] = quantizedData.insertEmpty(div_round_up(mMeshes[meshID].staticVertexCount, kPageSize) * kPageSize);
+        }
+
+        struct QuantizationError
+        {
+            float position = 0.f;   ///< Max position error in object space units.
+            float normal = 0.f;     ///< Max normal angle error in degrees.
+            float tangent = 0.f;    ///< Max tangent angle error in degrees.
+            float texCrd = 0.f;     ///< Max texture coordinate error.
+        };
+
+        auto angleError = [](float3 a, float3 b)
+        {
+            return math::degrees(std::atan2(length(cross(a, b)), dot(a, b)));
+        };
+
+        std::vector<VertexQuantization> quantization(mMeshes.size());
+        std::vector<QuantizationError> errors(mMeshes.size());
+
+        auto range = NumericRange<uint32_t>(0, (uint32_t)mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t meshID)
+        {
+            const auto& mesh = mMeshes[meshID];
+            VertexQuantization& q = quantization[meshID];
+            q = {};
+            q.center = mesh.boundingBox.center();
+            q.halfExtent = mesh.boundingBox.extent() * 0.5f;
+
+            QuantizationError& error = errors[meshID];
+            for (uint32_t i = 0; i < mesh.staticVertexCount; ++i)
+            {
+                const StaticVertexData v = mSceneData.meshStaticData[(size_t)mesh.staticVertexOffset + i].unpack();
+                PackedQuantizedVertexData& packed = quantizedData[vertexOffsets[meshID] + i];
+                packed.pack(v, q);
+
+                const StaticVertexData u = packed.unpack(q);
+                error.position = std::max(error.position, length(u.position - v.position));
+                error.normal = std::max(error.normal, angleError(u.normal, v.normal));
+                if (v.tangent.w != 0.f) error.tangent = std::max(error.tangent, angleError(u.tangent.xyz(), v.tangent.xyz()));
+                float2 texCrdError = abs(u.texCrd - v.texCrd);
+                error.texCrd = std::max(error.texCrd, std::max(texCrdError.x, texCrdError.y));
+            }
+        });
+
+        // Report the quantization errors.
+        QuantizationError maxError;
+        float maxRelativePositionError = 0.f;
+        for (size_t meshID = 0; meshID < mMeshes.size(); ++meshID)
+        {
+            const auto& error = errors[meshID];
+            float diagonal = length(mMeshes[meshID].boundingBox.extent());
+            float relativePositionError = diagonal > 0.f ? error.position / diagonal : 0.f;
+            logDebug(
+                "Quantized vertices of mesh '{}': max position error {} ({} of bounds diagonal), normal {} deg, tangent {} deg, texcoord {}.",
+                mMeshes[meshID].name, error.position, relativePositionError, error.normal, error.tangent, error.texCrd
+            );
+
+            maxError.position = std::max(maxError.position, error.position);
+            maxError.normal = std::max(maxError.normal, error.normal);
+            maxError.tangent = std::max(maxError.tangent, error.tangent);
+            maxError.texCrd = std::max(maxError.texCrd, error.texCrd);
+            maxRelativePositionError = std::max(maxRelativePositionError, relativePositionError);
+        }
+
+        const size_t fullByteSize = mSceneData.meshStaticData.getByteSize();
+        const size_t quantizedByteSize = quantizedData.getByteSize();
+        logInfo(
+            "Quantized vertices of {} meshes ({:.1f} MB -> {:.1f} MB). Max errors: position {} ({} of bounds diagonal), normal {} deg, tangent {} deg, texcoord {}.",
+            mMeshes.size(), fullByteSize / (1024.0 * 1024.0), quantizedByteSize / (1024.0 * 1024.0),
+            maxError.position, maxRelativePositionError, maxError.normal, maxError.tangent, maxError.texCrd
+        );
+
+        // Replace the full vertex data.
+        for (size_t meshID = 0; meshID < mMeshes.size(); ++meshID) mMeshes[meshID].staticVertexOffset = vertexOffsets[meshID];
+        mSceneData.meshStaticData = SplitVertexBuffer();
+        mSceneData.meshStaticData.setName("meshStaticData");
+        mSceneData.meshQuantizedData = std::move(quantizedData);
+        mSceneData.meshVertexQuantization = std::move(quantization);
+    }
+
     void SceneBuilder::removeDuplicateSDFGrids()
     {
         // Removes duplicate SDF grids.
@@ -2772,11 +3393,19 @@ namespace Falcor
             // This case is handled by pre-transforming the vertices in the BLAS build.
             FALCOR_ASSERT(!meshList.empty());
             const auto& firstMesh = mMeshes[meshList[0].get()];
-            size_t instanceCount = firstMesh.instances.size();
+
+            // Collect the global matrix IDs of all instances, i.e. the instance nodes followed by the instances in instance sets.
+            std::vector<uint32_t> matrixIDs;
+            for (NodeID nodeID : firstMesh.instances) matrixIDs.push_back(nodeID.getSlang());
+            for (uint32_t setIndex : firstMesh.instanceSets)
+            {
+                const auto& set = mSceneData.instanceSets[setIndex];
+                for (uint32_t i = 0; i < set.getInstanceCount(); i++) matrixIDs.push_back(set.matrixOffset + i);
+            }
+            size_t instanceCount = matrixIDs.size();
 
             FALCOR_ASSERT(instanceCount > 0);
-            auto instIter = firstMesh.instances.cbegin();
-            for (size_t instanceIdx = 0; instanceIdx < instanceCount; instanceIdx++, instIter++)
+            for (size_t instanceIdx = 0; instanceIdx < instanceCount; instanceIdx++)
             {
                 uint32_t blasGeometryIndex = 0;
                 for (const MeshID meshID : meshList)
@@ -2789,16 +3418,17 @@ namespace Falcor
                     // But there is a subtle issue: the lists may be permuted differently depending on the order
                     // in which mesh instances were added. Therefore, use the node ID from the first mesh to get
                     // a consistent ordering across all meshes. This is a requirement for the TLAS build.
-                    FALCOR_ASSERT(instanceCount == mesh.instances.size());
-                    NodeID nodeID = instanceCount == 1
-                        ? *mesh.instances.begin() // non-instanced => use per-mesh transform.
-                        : *instIter; // instanced => get transform from the first mesh.
+                    FALCOR_ASSERT(mesh.instances == firstMesh.instances || !mesh.isInstanced());
+                    FALCOR_ASSERT(mesh.instanceSets == firstMesh.instanceSets);
+                    uint32_t matrixID = !mesh.isInstanced()
+                        ? mesh.instances.begin()->getSlang() // non-instanced => use per-mesh transform.
+                        : matrixIDs[instanceIdx]; // instanced => get transform from the first mesh.
 
                     GeometryType geomType = GeometryType::TriangleMesh;
                     if (meshGroup.isDisplaced) geomType = GeometryType::DisplacedTriangleMesh;
 
                     GeometryInstanceData instance(geomType);
-                    instance.globalMatrixID = nodeID.getSlang();
+                    instance.globalMatrixID = matrixID;
                     instance.materialID = mesh.materialId.getSlang();
                     instance.geometryID = meshID.getSlang();
                     instance.vbOffset = mesh.staticVertexOffset;
@@ -2893,6 +3523,15 @@ namespace Falcor
             FALCOR_ASSERT(mSceneGraph[i].parent.get() <= std::numeric_limits<uint32_t>::max());
             mSceneData.sceneGraph[i] = Scene::Node(mSceneGraph[i].name, mSceneGraph[i].parent, mSceneGraph[i].transform, mSceneGraph[i].meshBind, mSceneGraph[i].localToBindPose);
         }
+
+        // Place the instance set matrices after the scene graph node matrices.
+        size_t matrixOffset = mSceneGraph.size();
+        for (auto& set : mSceneData.instanceSets)
+        {
+            set.matrixOffset = (uint32_t)matrixOffset;
+            matrixOffset += set.getInstanceCount();
+        }
+        if (matrixOffset > std::numeric_limits<uint32_t>::max()) FALCOR_THROW("Scene has too many instance matrices");
     }
 
     void SceneBuilder::createMeshBoundingBoxes()
@@ -2962,6 +3601,10 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("OptimizeVertexLayout", SceneBuilder::Flags::OptimizeVertexLayout);
+        flags.value("UseMeshletLayout", SceneBuilder::Flags::UseMeshletLayout);
+        flags.value("QuantizeVertices", SceneBuilder::Flags::QuantizeVertices);
+        flags.value("SkipTangentsWithoutNormalMaps", SceneBuilder::Flags::SkipTangentsWithoutNormalMaps);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
@@ -3004,7 +3647,73 @@ namespace Falcor
             node.parent = parent;
             return pSceneBuilder->addNode(node);
         }, "name"_a, "transform"_a = Transform(), "parent"_a = NodeID::kInvalidID);
+        sceneBuilder.def("addNodes", [] (SceneBuilder* pSceneBuilder, NdarrayVectors<float, 16> transforms, std::optional<NdarrayScalars<uint32_t>> parents) {
+            FALCOR_CHECK(pSceneBuilder, "'pSceneBuilder' is missing");
+            // Transforms are expected as row-major 4x4 matrices (shape [count, 16]).
+            return pSceneBuilder->addNodes(
+                ndarrayToSpan<float4x4>(transforms),
+                parents ? ndarrayToSpan<NodeID>(*parents) : fstd::span<const NodeID>()
+            );
+        }, "transforms"_a, "parents"_a = pybind11::none());
         sceneBuilder.def("addMeshInstance", &SceneBuilder::addMeshInstance);
+        sceneBuilder.def("addMeshInstances", [] (SceneBuilder* pSceneBuilder, NdarrayScalars<uint32_t> nodeIDs, NdarrayScalars<uint32_t> meshIDs) {
+            FALCOR_CHECK(pSceneBuilder, "'pSceneBuilder' is missing");
+            pSceneBuilder->addMeshInstances(ndarrayToSpan<NodeID>(nodeIDs), ndarrayToSpan<MeshID>(meshIDs));
+        }, "nodeIDs"_a, "meshIDs"_a);
+        sceneBuilder.def("addMeshFromArrays", [] (SceneBuilder* pSceneBuilder, const std::string& name, const ref<Material>& pMaterial,
+                                                  NdarrayVectors<float, 3> positions, NdarrayScalars<uint32_t> indices,
+                                                  std::optional<NdarrayVectors<float, 3>> normals, std::optional<NdarrayVectors<float, 4>> tangents,
+                                                  std::optional<NdarrayVectors<float, 2>> texCoords, bool isFrontFaceCW, bool isAnimated) {
+            FALCOR_CHECK(pSceneBuilder, "'pSceneBuilder' is missing");
+            FALCOR_CHECK(pMaterial, "'material' is missing");
+
+            // The mesh attributes reference the array memory directly, which stays valid until addMesh() has processed the mesh.
+            auto positionData = ndarrayToSpan<float3>(positions);
+            auto indexData = ndarrayToSpan<uint32_t>(indices);
+            FALCOR_CHECK(positionData.size() <= std::numeric_limits<uint32_t>::max(), "Too many vertices ({})", positionData.size());
+            FALCOR_CHECK(indexData.size() % 3 == 0, "'indices' size ({}) is not a multiple of 3", indexData.size());
+            for (uint32_t index : indexData)
+            {
+                FALCOR_CHECK(index < positionData.size(), "Vertex index {} is out of range", index);
+            }
+            auto checkVertexAttribute = [&](size_t count, const char* attribute)
+            {
+                FALCOR_CHECK(count == positionData.size(), "'{}' has {} elements, expected {}", attribute, count, positionData.size());
+            };
+
+            SceneBuilder::Mesh mesh;
+            mesh.name = name;
+            mesh.faceCount = (uint32_t)(indexData.size() / 3);
+            mesh.vertexCount = (uint32_t)positionData.size();
+            mesh.indexCount = (uint32_t)indexData.size();
+            mesh.pIndices = indexData.data();
+            mesh.topology = Vao::Topology::TriangleList;
+            mesh.pMaterial = pMaterial;
+            mesh.isFrontFaceCW = isFrontFaceCW;
+            mesh.isAnimated = isAnimated;
+            mesh.positions = { positionData.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+            if (normals)
+            {
+                auto normalData = ndarrayToSpan<float3>(*normals);
+                checkVertexAttribute(normalData.size(), "normals");
+                mesh.normals = { normalData.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+            }
+            if (tangents)
+            {
+                auto tangentData = ndarrayToSpan<float4>(*tangents);
+                checkVertexAttribute(tangentData.size(), "tangents");
+                mesh.tangents = { tangentData.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+                mesh.useOriginalTangentSpace = true;
+            }
+            if (texCoords)
+            {
+                auto texCoordData = ndarrayToSpan<float2>(*texCoords);
+                checkVertexAttribute(texCoordData.size(), "texCoords");
+                mesh.texCrds = { texCoordData.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+            }
+            return pSceneBuilder->addMesh(mesh);
+        }, "name"_a, "material"_a, "positions"_a, "indices"_a, "normals"_a = pybind11::none(), "tangents"_a = pybind11::none(),
+           "texCoords"_a = pybind11::none(), "isFrontFaceCW"_a = false, "isAnimated"_a = false);
         sceneBuilder.def("addSDFGridInstance", &SceneBuilder::addSDFGridInstance);
         sceneBuilder.def("addCustomPrimitive", &SceneBuilder::addCustomPrimitive);
 
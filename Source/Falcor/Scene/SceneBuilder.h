@@ -63,7 +63,7 @@ namespace Falcor
             DontMergeMaterials              = 0x1,      ///< Don't merge materials that have the same properties. Use this option to preserve the original material names.
             UseOriginalTangentSpace         = 0x2,      ///< Use the original tangent space that was loaded with the mesh. By default, we will ignore it and use MikkTSpace to generate the tangent space. We will always generate tangent space if it is missing.
             AssumeLinearSpaceTextures       = 0x4,      ///< By default, textures representing colors (diffuse/specular) are interpreted as sRGB data. Use this flag to force linear space for color textures.
-            DontMergeMeshes                 = 0x8,      ///< Preserve the original list of meshes in the scene, don't merge meshes with the same material. This flag only applies to scenes imported by 'AssimpImporter'.
+            DontMergeMeshes                 = 0x8,      ///< Preserve the original list of meshes in the scene. Don't merge meshes with the same material in 'AssimpImporter', and don't collapse meshes with identical geometry into instances of one mesh.
             UseSpecGlossMaterials           = 0x10,     ///< Set materials to use Spec-Gloss shading model. Otherwise default is Spec-Gloss for OBJ, Metal-Rough for everything else.
             UseMetalRoughMaterials          = 0x20,     ///< Set materials to use Metal-Rough shading model. Otherwise default is Spec-Gloss for OBJ, Metal-Rough for everything else.
             NonIndexedVertices              = 0x40,     ///< Convert meshes to use non-indexed vertices. This requires more memory but may increase performance.
@@ -77,6 +77,10 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            OptimizeVertexLayout            = 0x20000,  ///< Reorder triangles and vertices of triangle meshes for vertex cache reuse and vertex fetch locality. Vertex-animated meshes are not affected.
+            UseMeshletLayout                = 0x40000,  ///< Group triangles into meshlet-sized clusters when optimizing the vertex layout. Implies OptimizeVertexLayout.
+            QuantizeVertices                = 0x80000,  ///< Store vertices in a compressed format (positions quantized to the mesh bounds, octahedral normal/tangent, fp16 texcoords). Only applied if all meshes are static and not generated from curves.
+            SkipTangentsWithoutNormalMaps   = 0x100000, ///< Don't generate MikkTSpace tangents for meshes with isotropic standard materials without normal or displacement maps. These meshes get an arbitrary tangent orthonormal to the normal. Materials must not be replaced or gain such maps after their meshes are added.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -432,11 +436,21 @@ namespace Falcor
         */
         ProcessedMesh processMesh(const Mesh& mesh, MeshAttributeIndices* pAttributeIndices = nullptr, std::vector<float4>* pTangents = nullptr) const;
 
+        /** Check if the tangent space of meshes using a material needs to be generated with MikkTSpace.
+            With Flags::SkipTangentsWithoutNormalMaps, this is not the case for isotropic standard materials without normal or displacement maps
+            (including pending texture loads), for which any tangent orthonormal to the shading normal gives the same result.
+            \param pMaterial The material.
+            \return True if MikkTSpace tangents are required.
+        */
+        bool requiresTangentSpace(const ref<Material>& pMaterial) const;
+
         /** Generate tangents for a mesh.
             \param mesh The mesh to generate tangents for. If successful, the tangent attribute on the mesh will be set to the output vector.
             \param tangents Output for generated tangents.
+            \param chunkFaceCount Number of faces per chunk when generating tangents on multiple threads, or 0 to use the default.
+                   Meshes with fewer than two chunks of faces are processed at once. The result does not depend on the chunk size.
         */
-        static void generateTangents(Mesh& mesh, std::vector<float4>& tangents);
+        static void generateTangents(Mesh& mesh, std::vector<float4>& tangents, uint32_t chunkFaceCount = 0);
 
         /** Add a pre-processed mesh.
             \param mesh The pre-processed mesh.
@@ -640,6 +654,14 @@ namespace Falcor
         */
         NodeID addNode(const Node& node);
 
+        /** Adds multiple unnamed nodes to the graph.
+            The nodes get consecutive IDs. A node may use any earlier node in the same batch as its parent.
+            \param[in] transforms Local transform of each node.
+            \param[in] parents Parent node ID of each node, or an empty span if the nodes have no parents.
+            \return The node ID of the first node.
+        */
+        NodeID addNodes(fstd::span<const float4x4> transforms, fstd::span<const NodeID> parents);
+
         /** Get how many nodes have been added to the scene graph.
             \return The node count.
         */
@@ -651,6 +673,21 @@ namespace Falcor
         */
         void addMeshInstance(NodeID nodeID, MeshID meshID);
 
+        /** Add multiple mesh instances.
+            \param[in] nodeIDs Node of each instance.
+            \param[in] meshIDs Mesh of each instance. Must either have the same size as nodeIDs, or contain a single mesh that is instanced at all nodes.
+        */
+        void addMeshInstances(fstd::span<const NodeID> nodeIDs, fstd::span<const MeshID> meshIDs);
+
+        /** Add a set of mesh instances.
+            Instance sets are meant for large numbers of instances, e.g. from point instancers. No scene graph nodes are created for the instances.
+            Each instance gets a world matrix computed from the parent node, its own transform and the set's mesh transform,
+            which is used directly for its TLAS instance. Instance sets are not flattened or pre-transformed.
+            \param[in] set The instance set. The matrix offset is assigned by the builder.
+            \param[in] meshIDs Meshes placed at each instance. Skinned meshes are not supported.
+        */
+        void addMeshInstanceSet(Scene::InstanceSet set, fstd::span<const MeshID> meshIDs);
+
         /** Add a curve instance to a node.
         */
         void addCurveInstance(NodeID nodeID, CurveID curveID);
@@ -710,6 +747,7 @@ namespace Falcor
             bool isAnimated = false;                ///< True if the mesh vertices can be modified during rendering (e.g., skinning or inverse rendering).
             AABB boundingBox;                       ///< Mesh bounding-box in object space.
             std::set<NodeID> instances;             ///< IDs of all nodes that instantiate this mesh.
+            std::set<uint32_t> instanceSets;        ///< Indices of all instance sets that instantiate this mesh.
 
             // Pre-processed vertex data.
             std::vector<uint32_t> indexData;    ///< Vertex indices in either 32-bit or 16-bit format packed tightly, or empty if non-indexed.
@@ -737,6 +775,11 @@ namespace Falcor
             {
                 return isSkinned() || isAnimated;
             }
+
+            bool isInstanced() const
+            {
+                return instances.size() > 1 || !instanceSets.empty();
+            }
         };
 
         // TODO: Add support for dynamic curves
@@ -816,6 +859,7 @@ namespace Falcor
         void prepareSceneGraph();
         void prepareMeshes();
         void removeUnusedMeshes();
+        void removeDuplicateMeshes();
         void flattenStaticMeshInstances();
         void optimizeSceneGraph();
         void pretransformStaticMeshes();
@@ -824,12 +868,14 @@ namespace Falcor
         void createMeshGroups();
         void optimizeGeometry();
         void sortMeshes();
+        void optimizeVertexLayout();
         void createGlobalBuffers();
         void createCurveGlobalBuffers();
         void optimizeMaterials();
         void removeDuplicateMaterials();
         void collectVolumeGrids();
         void quantizeTexCoords();
+        void quantizeVertices();
         void removeDuplicateSDFGrids();
 
         // Scene setup
@@ -30,6 +30,7 @@
 #include "Material/HairMaterial.h"
 #include "Material/ClothMaterial.h"
 #include "Material/MaterialTextureLoader.h"
+#include "SDFs/SparseBrickSet/SDFSBS.h"
 #include "Utils/Logger.h"
 
 #include <lz4_stream/lz4_stream.h>
@@ -43,7 +44,7 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 29;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
@@ -343,6 +344,19 @@ namespace Falcor
             writeAnimation(stream, pAnimation);
         }
 
+        writeMarker(stream, "InstanceSets");
+        stream.write((uint32_t)sceneData.instanceSets.size());
+        for (const auto& set : sceneData.instanceSets)
+        {
+            stream.write(set.name);
+            stream.write(set.parent);
+            stream.write(set.meshTransform);
+            stream.write(set.transforms);
+            stream.write(set.keyframes);
+            stream.write(set.keyframesPerInstance);
+            stream.write(set.matrixOffset);
+        }
+
         writeMarker(stream, "Metadata");
         writeMetadata(stream, sceneData.metadata);
 
@@ -377,6 +391,8 @@ namespace Falcor
         stream.write(sceneData.meshDrawCount);
         writeSplitBuffer(stream, sceneData.meshIndexData);
         writeSplitBuffer(stream, sceneData.meshStaticData);
+        writeSplitBuffer(stream, sceneData.meshQuantizedData);
+        stream.write(sceneData.meshVertexQuantization);
         stream.write(sceneData.meshSkinningData);
 
         writeMarker(stream, "Curves");
@@ -401,6 +417,38 @@ namespace Falcor
         stream.write(sceneData.customPrimitiveDesc);
         stream.write(sceneData.customPrimitiveAABBs);
 
+        writeMarker(stream, "SDFGrids");
+        // SDF grids are stored as sparse brick sets built on the CPU, so that loading the cache skips the GPU build.
+        std::vector<SDFSBSBuilder::Data> sdfGridData;
+        try
+        {
+            for (const auto& pSDFGrid : sceneData.sdfGrids)
+            {
+                FALCOR_CHECK(pSDFGrid->getType() == SDFGrid::Type::SparseBrickSet, "SDF grids of type '{}' are not supported.", to_string(pSDFGrid->getType()));
+                sdfGridData.push_back(static_ref_cast<SDFSBS>(pSDFGrid)->buildBrickSetData());
+            }
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("SDF grids are not stored in the scene cache: {}", e.what());
+        }
+        bool hasSDFGrids = sdfGridData.size() == sceneData.sdfGrids.size();
+        stream.write(hasSDFGrids);
+        if (hasSDFGrids)
+        {
+            stream.write((uint32_t)sceneData.sdfGrids.size());
+            for (size_t i = 0; i < sceneData.sdfGrids.size(); ++i) writeSDFGrid(stream, sceneData.sdfGrids[i], sdfGridData[i]);
+            stream.write((uint32_t)sceneData.sdfGridDesc.size());
+            for (const auto& desc : sceneData.sdfGridDesc)
+            {
+                stream.write(desc.sdfGridID);
+                stream.write(desc.materialID);
+                stream.write(desc.instances);
+            }
+            stream.write(sceneData.sdfGridInstances);
+            stream.write(sceneData.sdfGridMaxLODCount);
+        }
+
         writeMarker(stream, "End");
     }
 
@@ -469,6 +517,19 @@ namespace Falcor
         sceneData.animations.resize(stream.read<uint32_t>());
         for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(stream);
 
+        readMarker(stream, "InstanceSets");
+        sceneData.instanceSets.resize(stream.read<uint32_t>());
+        for (auto& set : sceneData.instanceSets)
+        {
+            stream.read(set.name);
+            stream.read(set.parent);
+            stream.read(set.meshTransform);
+            stream.read(set.transforms);
+            stream.read(set.keyframes);
+            stream.read(set.keyframesPerInstance);
+            stream.read(set.matrixOffset);
+        }
+
         readMarker(stream, "Metadata");
         sceneData.metadata = readMetadata(stream);
 
@@ -503,6 +564,8 @@ namespace Falcor
         stream.read(sceneData.meshDrawCount);
         readSplitBuffer(stream, sceneData.meshIndexData);
         readSplitBuffer(stream, sceneData.meshStaticData);
+        readSplitBuffer(stream, sceneData.meshQuantizedData);
+        stream.read(sceneData.meshVertexQuantization);
         stream.read(sceneData.meshSkinningData);
 
         readMarker(stream, "Curves");
@@ -527,6 +590,22 @@ namespace Falcor
         stream.read(sceneData.customPrimitiveDesc);
         stream.read(sceneData.customPrimitiveAABBs);
 
+        readMarker(stream, "SDFGrids");
+        if (stream.read<bool>())
+        {
+            sceneData.sdfGrids.resize(stream.read<uint32_t>());
+            for (auto& pSDFGrid : sceneData.sdfGrids) pSDFGrid = readSDFGrid(stream, pDevice);
+            sceneData.sdfGridDesc.resize(stream.read<uint32_t>());
+            for (auto& desc : sceneData.sdfGridDesc)
+            {
+                stream.read(desc.sdfGridID);
+                stream.read(desc.materialID);
+                stream.read(desc.instances);
+            }
+            stream.read(sceneData.sdfGridInstances);
+            stream.read(sceneData.sdfGridMaxLODCount);
+        }
+
         readMarker(stream, "End");
 
         pMaterialTextureLoader.reset();
@@ -902,6 +981,44 @@ namespace Falcor
         return ref<Grid>(new Grid(pDevice, nanovdb::GridHandle<nanovdb::HostBuffer>(std::move(buffer))));
     }
 
+    // SDFGrid
+
+    void SceneCache::writeSDFGrid(OutputStream& stream, const ref<SDFGrid>& pSDFGrid, const SDFSBSBuilder::Data& data)
+    {
+        stream.write(pSDFGrid->getName());
+        stream.write(data.gridWidth);
+        stream.write(data.brickWidth);
+        stream.write(data.compressed);
+        stream.write(data.virtualBricksPerAxis);
+        stream.write(data.brickCount);
+        stream.write(data.bricksPerAxis);
+        stream.write(data.brickTextureDimensions);
+        stream.write(data.indirection);
+        stream.write(data.brickAABBs);
+        stream.write(data.brickTexture);
+    }
+
+    ref<SDFGrid> SceneCache::readSDFGrid(InputStream& stream, ref<Device> pDevice)
+    {
+        auto name = stream.read<std::string>();
+        SDFSBSBuilder::Data data;
+        stream.read(data.gridWidth);
+        stream.read(data.brickWidth);
+        stream.read(data.compressed);
+        stream.read(data.virtualBricksPerAxis);
+        stream.read(data.brickCount);
+        stream.read(data.bricksPerAxis);
+        stream.read(data.brickTextureDimensions);
+        stream.read(data.indirection);
+        stream.read(data.brickAABBs);
+        stream.read(data.brickTexture);
+
+        auto pSBS = SDFSBS::create(pDevice, data.brickWidth, data.compressed, data.gridWidth);
+        pSBS->setName(name);
+        pSBS->setBrickSetData(std::move(data));
+        return pSBS;
+    }
+
     // EnvMap
 
     void SceneCache::writeEnvMap(OutputStream& stream, const ref<EnvMap>& pEnvMap)
@@ -33,6 +33,7 @@
 #include "Lights/Light.h"
 #include "Volume/Grid.h"
 #include "Volume/GridVolume.h"
+#include "SDFs/SparseBrickSet/SDFSBSBuilder.h"
 #include "Material/BasicMaterial.h"
 #include "Material/MaterialSystem.h"
 #include "Material/MaterialTextureLoader.h"
@@ -112,6 +113,9 @@ namespace Falcor
         static void writeGrid(OutputStream& stream, const ref<Grid>& pGrid);
         static ref<Grid> readGrid(InputStream& stream, ref<Device> pDevice);
 
+        static void writeSDFGrid(OutputStream& stream, const ref<SDFGrid>& pSDFGrid, const SDFSBSBuilder::Data& data);
+        static ref<SDFGrid> readSDFGrid(InputStream& stream, ref<Device> pDevice);
+
         static void writeEnvMap(OutputStream& stream, const ref<EnvMap>& pEnvMap);
         static ref<EnvMap> readEnvMap(InputStream& stream, ref<Device> pDevice);
 
@@ -26,18 +26,128 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TriangleMesh.h"
+#include "PLYReader.h"
 #include "GlobalState.h"
 #include "Core/Error.h"
 #include "Core/Platform/OS.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/API/PythonHelpers.h"
 #include "Utils/Logger.h"
+#include "Utils/Math/BatchTransform.h"
+#include "Utils/Math/FNVHash.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <cmath>
+#include <cstring>
+#include <unordered_map>
 
 namespace Falcor
 {
+    namespace
+    {
+        bool isPLYFile(const std::filesystem::path& path)
+        {
+            if (hasExtension(path, "ply")) return true;
+            return hasExtension(path, "gz") && hasExtension(path.stem(), "ply");
+        }
+
+        template<typename T>
+        struct BitwiseHash
+        {
+            size_t operator()(const T& value) const { return (size_t)fnvHashArray64(&value, sizeof(T)); }
+        };
+
+        template<typename T>
+        struct BitwiseEqual
+        {
+            bool operator()(const T& lhs, const T& rhs) const { return std::memcmp(&lhs, &rhs, sizeof(T)) == 0; }
+        };
+
+        /** Generate normals for a mesh read without normals.
+            Matches the ASSIMP post processing: smooth normals average the face normals of all triangles
+            sharing a vertex position (not just a vertex index), flat normals duplicate the vertices so
+            that every triangle has its own face normal.
+        */
+        void generateNormals(TriangleMesh::VertexList& vertices, TriangleMesh::IndexList& indices, bool smooth)
+        {
+            if (smooth)
+            {
+                // Assign each vertex to a group of vertices with the same position.
+                // Adding zero maps -0 to +0 so that both compare equal.
+                std::unordered_map<float3, uint32_t, BitwiseHash<float3>, BitwiseEqual<float3>> positionToGroup;
+                std::vector<uint32_t> groups(vertices.size());
+                for (size_t i = 0; i < vertices.size(); ++i)
+                {
+                    auto [it, _] = positionToGroup.try_emplace(vertices[i].position + float3(0.f), (uint32_t)positionToGroup.size());
+                    groups[i] = it->second;
+                }
+
+                std::vector<float3> groupNormals(positionToGroup.size(), float3(0.f));
+                for (size_t i = 0; i < indices.size(); i += 3)
+                {
+                    const auto& v0 = vertices[indices[i]];
+                    const auto& v1 = vertices[indices[i + 1]];
+                    const auto& v2 = vertices[indices[i + 2]];
+                    float3 n = cross(v1.position - v0.position, v2.position - v0.position);
+                    float len = length(n);
+                    if (!(len > 0.f)) continue;
+                    n /= len;
+                    for (size_t j = 0; j < 3; ++j) groupNormals[groups[indices[i + j]]] += n;
+                }
+                for (auto& n : groupNormals)
+                {
+                    float len = length(n);
+                    n = len > 0.f ? n / len : float3(0.f);
+                }
+                for (size_t i = 0; i < vertices.size(); ++i) vertices[i].normal = groupNormals[groups[i]];
+            }
+            else
+            {
+                TriangleMesh::VertexList flatVertices(indices.size());
+                for (size_t i = 0; i < indices.size(); i += 3)
+                {
+                    for (size_t j = 0; j < 3; ++j) flatVertices[i + j] = vertices[indices[i + j]];
+                    float3 n = cross(flatVertices[i + 1].position - flatVertices[i].position, flatVertices[i + 2].position - flatVertices[i].position);
+                    float len = length(n);
+                    n = len > 0.f ? n / len : float3(0.f);
+                    for (size_t j = 0; j < 3; ++j)
+                    {
+                        flatVertices[i + j].normal = n;
+                        indices[i + j] = (uint32_t)(i + j);
+                    }
+                }
+                vertices = std::move(flatVertices);
+            }
+        }
+
+        /** Merge vertices with identical position, normal and texture coordinate.
+            Matches aiProcess_JoinIdenticalVertices: vertices are kept in order of first use.
+        */
+        void joinIdenticalVertices(TriangleMesh::VertexList& vertices, TriangleMesh::IndexList& indices)
+        {
+            static_assert(sizeof(TriangleMesh::Vertex) == sizeof(float) * 8, "Vertex is expected to have no padding");
+
+            std::unordered_map<TriangleMesh::Vertex, uint32_t, BitwiseHash<TriangleMesh::Vertex>, BitwiseEqual<TriangleMesh::Vertex>> vertexToIndex;
+            std::vector<uint32_t> remap(vertices.size(), std::numeric_limits<uint32_t>::max());
+            TriangleMesh::VertexList joinedVertices;
+            joinedVertices.reserve(vertices.size());
+            for (auto& index : indices)
+            {
+                uint32_t& newIndex = remap[index];
+                if (newIndex == std::numeric_limits<uint32_t>::max())
+                {
+                    auto [it, inserted] = vertexToIndex.try_emplace(vertices[index], (uint32_t)joinedVertices.size());
+                    if (inserted) joinedVertices.push_back(vertices[index]);
+                    newIndex = it->second;
+                }
+                index = newIndex;
+            }
+            vertices = std::move(joinedVertices);
+        }
+    }
+
     ref<TriangleMesh> TriangleMesh::create()
     {
         return ref<TriangleMesh>(new TriangleMesh());
@@ -48,6 +158,40 @@ namespace Falcor
         return ref<TriangleMesh>(new TriangleMesh(vertices, indices, frontFaceCW));
     }
 
+    ref<TriangleMesh> TriangleMesh::createFromArrays(
+        fstd::span<const float3> positions,
+        fstd::span<const float3> normals,
+        fstd::span<const float2> texCoords,
+        fstd::span<const uint32_t> indices,
+        bool frontFaceCW
+    )
+    {
+        const size_t vertexCount = positions.size();
+        FALCOR_CHECK(vertexCount <= std::numeric_limits<uint32_t>::max(), "Too many vertices ({})", vertexCount);
+        FALCOR_CHECK(normals.empty() || normals.size() == vertexCount, "'normals' has {} elements, expected {}", normals.size(), vertexCount);
+        FALCOR_CHECK(texCoords.empty() || texCoords.size() == vertexCount, "'texCoords' has {} elements, expected {}", texCoords.size(), vertexCount);
+        FALCOR_CHECK(indices.size() % 3 == 0, "'indices' size ({}) is not a multiple of 3", indices.size());
+        for (uint32_t index : indices)
+        {
+            FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range", index);
+        }
+
+        ref<TriangleMesh> pMesh = create();
+        pMesh->mFrontFaceCW = frontFaceCW;
+        pMesh->mIndices.assign(indices.begin(), indices.end());
+        pMesh->mVertices.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            Vertex& v = pMesh->mVertices[i];
+            v.position = positions[i];
+            v.normal = normals.empty() ? float3(0.f) : normals[i];
+            v.texCoord = texCoords.empty() ? float2(0.f) : texCoords[i];
+        }
+        if (normals.empty()) generateNormals(pMesh->mVertices, pMesh->mIndices, true);
+
+        return pMesh;
+    }
+
     ref<TriangleMesh> TriangleMesh::createDummy()
     {
         VertexList vertices = {{{0.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f}}};
@@ -201,6 +345,13 @@ namespace Falcor
             return nullptr;
         }
 
+        // Binary PLY files are read natively, which avoids the ASSIMP scene graph and post processing.
+        // Unsupported PLY variants and files the native reader fails on fall back to ASSIMP.
+        if (isPLYFile(path))
+        {
+            if (auto pMesh = createFromPLY(path, importFlags)) return pMesh;
+        }
+
         Assimp::Importer importer;
 
         unsigned int flags =
@@ -273,6 +424,46 @@ namespace Falcor
         return create(vertices, indices);
     }
 
+    ref<TriangleMesh> TriangleMesh::createFromPLY(const std::filesystem::path& path, ImportFlags importFlags)
+    {
+        PLYReader::Result result;
+        if (hasExtension(path, "gz"))
+        {
+            auto decompressed = decompressFile(path);
+            result = PLYReader::read(decompressed.data(), decompressed.size());
+        }
+        else
+        {
+            MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+            if (!file.isOpen())
+            {
+                logWarning("Native PLY reader failed to open '{}', falling back to ASSIMP", path);
+                return nullptr;
+            }
+            result = PLYReader::read(file.getData(), file.getSize());
+        }
+
+        if (result.status == PLYReader::Status::Unsupported)
+        {
+            logDebug("Using ASSIMP to load '{}': {}", path, result.error);
+            return nullptr;
+        }
+        if (result.status == PLYReader::Status::Error)
+        {
+            logWarning("Native PLY reader failed to load '{}', falling back to ASSIMP: {}", path, result.error);
+            return nullptr;
+        }
+
+        // Apply the same post processing as the ASSIMP path: normal generation followed by vertex joining.
+        if (!result.hasNormals) generateNormals(result.vertices, result.indices, is_set(importFlags, ImportFlags::GenSmoothNormals));
+        if (is_set(importFlags, ImportFlags::JoinIdenticalVertices)) joinIdenticalVertices(result.vertices, result.indices);
+
+        ref<TriangleMesh> pMesh = create();
+        pMesh->mVertices = std::move(result.vertices);
+        pMesh->mIndices = std::move(result.indices);
+        return pMesh;
+    }
+
     ref<TriangleMesh> TriangleMesh::createFromFile(const std::filesystem::path& path, bool smoothNormals)
     {
         ImportFlags flags = smoothNormals ? ImportFlags::GenSmoothNormals : ImportFlags::None;
@@ -302,10 +493,10 @@ namespace Falcor
     {
         auto invTranspose = float3x3(transpose(inverse(transform)));
 
-        for (auto& vertex : mVertices)
+        if (!mVertices.empty())
         {
-            vertex.position = transformPoint(transform, vertex.position);
-            vertex.normal = normalize(transformVector(invTranspose, vertex.normal));
+            transformPoints(transform, &mVertices[0].position, &mVertices[0].position, mVertices.size(), sizeof(Vertex), sizeof(Vertex));
+            transformNormals(invTranspose, &mVertices[0].normal, &mVertices[0].normal, mVertices.size(), sizeof(Vertex), sizeof(Vertex));
         }
 
         // Check if triangle winding has flipped and adjust winding order accordingly.
@@ -346,6 +537,20 @@ namespace Falcor
         triangleMesh.def(pybind11::init(pybind11::overload_cast<>(&TriangleMesh::create)));
         triangleMesh.def("addVertex", &TriangleMesh::addVertex, "position"_a, "normal"_a, "texCoord"_a);
         triangleMesh.def("addTriangle", &TriangleMesh::addTriangle, "i0"_a, "i1"_a, "i2"_a);
+        triangleMesh.def_static("createFromArrays",
+            [](NdarrayVectors<float, 3> positions, NdarrayScalars<uint32_t> indices, std::optional<NdarrayVectors<float, 3>> normals,
+               std::optional<NdarrayVectors<float, 2>> texCoords, bool frontFaceCW)
+            {
+                return TriangleMesh::createFromArrays(
+                    ndarrayToSpan<float3>(positions),
+                    normals ? ndarrayToSpan<float3>(*normals) : fstd::span<const float3>(),
+                    texCoords ? ndarrayToSpan<float2>(*texCoords) : fstd::span<const float2>(),
+                    ndarrayToSpan<uint32_t>(indices),
+                    frontFaceCW
+                );
+            },
+            "positions"_a, "indices"_a, "normals"_a = pybind11::none(), "texCoords"_a = pybind11::none(), "frontFaceCW"_a = false
+        );
         triangleMesh.def_static("createQuad", &TriangleMesh::createQuad, "size"_a = float2(1.f));
         triangleMesh.def_static("createDisk", &TriangleMesh::createDisk, "radius"_a = 1.f, "segments"_a = 32);
         triangleMesh.def_static("createCube", &TriangleMesh::createCube, "size"_a = float3(1.f));
@@ -31,6 +31,7 @@
 #include "Core/Object.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
+#include <fstd/span.h>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -78,6 +79,22 @@ namespace Falcor
         */
         static ref<TriangleMesh> create(const VertexList& vertices, const IndexList& indices, bool frontFaceCW = false);
 
+        /** Creates a triangle mesh from separate vertex attribute arrays.
+            \param[in] positions Vertex positions.
+            \param[in] normals Vertex normals. If empty, smooth normals are generated.
+            \param[in] texCoords Vertex texture coordinates. If empty, texture coordinates are set to zero.
+            \param[in] indices Triangle list indices.
+            \param[in] frontFaceCW Triangle winding.
+            \return Returns the triangle mesh.
+        */
+        static ref<TriangleMesh> createFromArrays(
+            fstd::span<const float3> positions,
+            fstd::span<const float3> normals,
+            fstd::span<const float2> texCoords,
+            fstd::span<const uint32_t> indices,
+            bool frontFaceCW = false
+        );
+
         /** Creates a dummy mesh (single degenerate triangle).
             \return Returns the triangle mesh.
         */
@@ -111,6 +128,7 @@ namespace Falcor
 
         /** Creates a triangle mesh from a file.
             This is using ASSIMP to support a wide variety of asset formats.
+            Binary little-endian PLY files (optionally gzip compressed) are read natively using PLYReader.
             All geometry found in the asset is pre-transformed and merged into the same triangle mesh.
             \param[in] path File path to load mesh from (absolute or relative to working directory).
             \param[in] flags Flags controlling ASSIMP mesh import options.
@@ -190,6 +208,11 @@ namespace Falcor
         TriangleMesh();
         TriangleMesh(const VertexList& vertices, const IndexList& indices, bool frontFaceCW);
 
+        /** Read a mesh using the native PLY reader.
+            \return Returns the triangle mesh or nullptr if the file is not supported by the native reader or failed to load, in which case the caller falls back to ASSIMP.
+        */
+        static ref<TriangleMesh> createFromPLY(const std::filesystem::path& path, ImportFlags flags);
+
         std::string mName;
         std::vector<Vertex> mVertices;
         std::vector<uint32_t> mIndices;
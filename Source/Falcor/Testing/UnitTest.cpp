@@ -42,10 +42,13 @@
 #include <fmt/format.h>
 #include <fmt/color.h>
 #include <pugixml.hpp>
+#include <nlohmann/json.hpp>
 #include <BS_thread_pool/BS_thread_pool_light.hpp>
 
 #include <algorithm>
 #include <chrono>
+#include <numeric>
+#include <fstream>
 #include <regex>
 #include <cstdint>
 
@@ -61,6 +64,7 @@ struct TestDesc
     unittest::Options options;
     CPUTestFunc cpuFunc;
     GPUTestFunc gpuFunc;
+    BenchmarkFunc benchmarkFunc;
 };
 
 struct TestResult
@@ -76,6 +80,7 @@ struct TestResult
     std::vector<std::string> messages;
     std::string extraMessage;
     uint64_t elapsedMS = 0;
+    std::vector<BenchmarkResult> benchmarkResults;
 };
 
 static std::vector<TestDesc>& getTestRegistry()
@@ -143,6 +148,21 @@ void registerGPUTest(std::filesystem::path path, std::string name, unittest::Opt
     getTestRegistry().push_back(desc);
 }
 
+void registerBenchmark(std::filesystem::path path, std::string name, unittest::Options options, BenchmarkFunc func)
+{
+    TestDesc desc;
+    desc.path = std::move(path);
+    desc.name = std::move(name);
+    desc.options = std::move(options);
+    desc.benchmarkFunc = std::move(func);
+    getTestRegistry().push_back(desc);
+}
+
+void useCharPointer(const volatile char* p)
+{
+    (void)p;
+}
+
 /// Prints the UnitTest report line, making sure it is always printed to the console once.
 template<typename... Args>
 void reportLine(const std::string_view format, Args&&... args)
@@ -211,7 +231,105 @@ inline void writeXmlReport(const std::filesystem::path& path, const std::vector<
     doc.save_file(path.native().c_str());
 }
 
-inline TestResult runTest(const Test& test, DevicePool& devicePool)
+/**
+ * Write benchmark results to a JSON file.
+ * The same format is read back by readBenchmarkBaseline().
+ * @param[in] path File path.
+ * @param[in] report List of tests/results.
+ */
+inline void writeBenchmarkReport(const std::filesystem::path& path, const std::vector<std::pair<Test, TestResult>>& report)
+{
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (const auto& [test, result] : report)
+    {
+        for (const auto& r : result.benchmarkResults)
+        {
+            nlohmann::json entry;
+            entry["name"] = r.name;
+            entry["iterations"] = r.iterations;
+            entry["samples"] = r.samples;
+            entry["min_ns"] = r.minNS;
+            entry["max_ns"] = r.maxNS;
+            entry["mean_ns"] = r.meanNS;
+            entry["median_ns"] = r.medianNS;
+            entry["p10_ns"] = r.p10NS;
+            entry["p90_ns"] = r.p90NS;
+            entry["mad_ns"] = r.madNS;
+            if (r.itemsPerIteration > 0)
+            {
+                entry["items_per_iteration"] = r.itemsPerIteration;
+                entry["items_per_second"] = r.getItemsPerSecond();
+            }
+            if (r.bytesPerIteration > 0)
+            {
+                entry["bytes_per_iteration"] = r.bytesPerIteration;
+                entry["bytes_per_second"] = r.getBytesPerSecond();
+            }
+            if (r.baselineMedianNS)
+                entry["baseline_median_ns"] = *r.baselineMedianNS;
+            benchmarks.push_back(entry);
+        }
+    }
+
+    nlohmann::json doc;
+    doc["version"] = getLongVersionString();
+    doc["benchmarks"] = benchmarks;
+
+    std::ofstream ofs(path);
+    if (!ofs)
+        FALCOR_THROW("Failed to write benchmark report to '{}'.", path);
+    ofs << doc.dump(4) << std::endl;
+}
+
+/**
+ * Read baseline benchmark results from a JSON file written by writeBenchmarkReport().
+ * @param[in] path File path.
+ * @return Median time per iteration by benchmark name.
+ */
+inline BenchmarkContext::Baseline readBenchmarkBaseline(const std::filesystem::path& path)
+{
+    std::ifstream ifs(path);
+    if (!ifs)
+        FALCOR_THROW("Failed to open benchmark baseline '{}'.", path);
+
+    nlohmann::json doc = nlohmann::json::parse(ifs, nullptr, false);
+    if (doc.is_discarded() || !doc.contains("benchmarks"))
+        FALCOR_THROW("Benchmark baseline '{}' is not a valid benchmark report.", path);
+
+    BenchmarkContext::Baseline baseline;
+    for (const auto& entry : doc["benchmarks"])
+        baseline[entry.at("name").get<std::string>()] = entry.at("median_ns").get<double>();
+    return baseline;
+}
+
+inline std::string formatDuration(double ns)
+{
+    if (ns < 1e3)
+        return fmt::format("{:.2f} ns", ns);
+    if (ns < 1e6)
+        return fmt::format("{:.2f} us", ns / 1e3);
+    if (ns < 1e9)
+        return fmt::format("{:.2f} ms", ns / 1e6);
+    return fmt::format("{:.2f} s", ns / 1e9);
+}
+
+inline std::string formatRate(double perSecond, const char* unit)
+{
+    if (perSecond < 1e3)
+        return fmt::format("{:.2f} {}/s", perSecond, unit);
+    if (perSecond < 1e6)
+        return fmt::format("{:.2f} K{}/s", perSecond / 1e3, unit);
+    if (perSecond < 1e9)
+        return fmt::format("{:.2f} M{}/s", perSecond / 1e6, unit);
+    return fmt::format("{:.2f} G{}/s", perSecond / 1e9, unit);
+}
+
+inline TestResult runTest(
+    const Test& test,
+    DevicePool& devicePool,
+    const BenchmarkOptions& benchmarkOptions = {},
+    const BenchmarkContext::Baseline* pBaseline = nullptr
+)
 {
     if (!test.skipMessage.empty())
         return {TestResult::Status::Skipped, {test.skipMessage}};
@@ -243,6 +361,29 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
             pDevice->wait();
             devicePool.releaseDevice(std::move(pDevice));
         }
+        else if (test.benchmarkFunc)
+        {
+            ref<Device> pDevice;
+            auto deviceProvider = [&]()
+            {
+                pDevice = devicePool.acquireDevice(test.deviceType);
+                return pDevice;
+            };
+
+            {
+                BenchmarkContext benchmarkCtx(fmt::format("{}:{}", test.suiteName, test.name), benchmarkOptions, deviceProvider, pBaseline);
+                test.benchmarkFunc(benchmarkCtx);
+                result.messages = benchmarkCtx.getFailureMessages();
+                result.benchmarkResults = benchmarkCtx.getResults();
+            }
+
+            if (pDevice)
+            {
+                pDevice->endFrame();
+                pDevice->wait();
+                devicePool.releaseDevice(std::move(pDevice));
+            }
+        }
     }
     catch (const SkippingTestException& e)
     {
@@ -282,6 +423,18 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
     return result;
 }
 
+/// Gather tests to run. Benchmarks are only run when requested, in which case regular tests are not run.
+inline std::vector<Test> gatherTests(const RunOptions& options)
+{
+    std::vector<Test> tests = enumerateTests();
+    tests = filterTests(tests, options.testSuiteFilter, options.testCaseFilter, options.tagFilter, options.deviceDesc.type);
+    tests.erase(
+        std::remove_if(tests.begin(), tests.end(), [&](const Test& test) { return bool(test.benchmarkFunc) != options.benchmark; }),
+        tests.end()
+    );
+    return tests;
+}
+
 inline int32_t runTestsParallel(const RunOptions& options)
 {
     // Abort on Ctrl-C.
@@ -299,8 +452,7 @@ inline int32_t runTestsParallel(const RunOptions& options)
     DevicePool devicePool(options.deviceDesc);
 
     // Gather tests.
-    std::vector<Test> tests = enumerateTests();
-    tests = filterTests(tests, options.testSuiteFilter, options.testCaseFilter, options.tagFilter, options.deviceDesc.type);
+    std::vector<Test> tests = gatherTests(options);
 
     std::vector<TestResult> results(tests.size());
 
@@ -391,8 +543,7 @@ inline int32_t runTestsSerial(const RunOptions& options)
     DevicePool devicePool(options.deviceDesc);
 
     // Gather tests.
-    std::vector<Test> tests = enumerateTests();
-    tests = filterTests(tests, options.testSuiteFilter, options.testCaseFilter, options.tagFilter, options.deviceDesc.type);
+    std::vector<Test> tests = gatherTests(options);
 
     // Split tests into suites.
     std::map<std::string, std::vector<Test>> suites;
@@ -402,6 +553,11 @@ inline int32_t runTestsSerial(const RunOptions& options)
     std::map<std::string, std::vector<Test>> failedTests;
     std::vector<std::pair<Test, TestResult>> report;
 
+    // Load benchmark baseline.
+    std::optional<BenchmarkContext::Baseline> benchmarkBaseline;
+    if (options.benchmark && !options.benchmarkOptions.baselinePath.empty())
+        benchmarkBaseline = readBenchmarkBaseline(options.benchmarkOptions.baselinePath);
+
     size_t suiteCount = suites.size();
     size_t testCount = tests.size();
     int32_t failureCount = 0;
@@ -430,7 +586,8 @@ inline int32_t runTestsSerial(const RunOptions& options)
                 if (options.repeat > 1)
                     repeats = fmt::format("[{}/{}]", repeatIndex + 1, options.repeat);
                 reportLine("[ RUN      ] {}:{}{}", suiteName, test.name, repeats);
-                TestResult result = runTest(test, devicePool);
+                TestResult result =
+                    runTest(test, devicePool, options.benchmarkOptions, benchmarkBaseline ? &*benchmarkBaseline : nullptr);
                 report.emplace_back(test, result);
 
                 std::string statusTag;
@@ -473,6 +630,8 @@ inline int32_t runTestsSerial(const RunOptions& options)
 
     if (!options.xmlReportPath.empty())
         writeXmlReport(options.xmlReportPath, report);
+    if (options.benchmark && !options.benchmarkOptions.reportPath.empty())
+        writeBenchmarkReport(options.benchmarkOptions.reportPath, report);
 
     reportLine(
         "[==========] {} test{} from {} test suite{} ran. ({} ms total)",
@@ -507,7 +666,8 @@ int32_t runTests(const RunOptions& options)
     Threading::start();
     Scripting::start();
 
-    int32_t failureCount = options.parallel > 1 ? runTestsParallel(options) : runTestsSerial(options);
+    // Benchmarks are always run serially to avoid interference between them.
+    int32_t failureCount = (options.parallel > 1 && !options.benchmark) ? runTestsParallel(options) : runTestsSerial(options);
 
     Scripting::shutdown();
     Threading::shutdown();
@@ -531,8 +691,9 @@ std::vector<Test> enumerateTests()
         test.deviceType = Device::Type::Default;
         test.cpuFunc = desc.cpuFunc;
         test.gpuFunc = desc.gpuFunc;
+        test.benchmarkFunc = desc.benchmarkFunc;
 
-        if (test.cpuFunc)
+        if (test.cpuFunc || test.benchmarkFunc)
         {
             tests.push_back(test);
         }
@@ -645,6 +806,122 @@ void UnitTestContext::reportFailure(const std::string& message)
 
 ///////////////////////////////////////////////////////////////////////////
 
+void BenchmarkContext::measure(std::string_view caseName, const SampleFunc& sampleFunc)
+{
+    BenchmarkResult result;
+    result.name = caseName.empty() ? mName : fmt::format("{}/{}", mName, caseName);
+    result.itemsPerIteration = mItemsPerIteration;
+    result.bytesPerIteration = mBytesPerIteration;
+
+    const double warmupNS = mOptions.warmupMS * 1e6;
+    const double minSampleNS = mOptions.minSampleMS * 1e6;
+    const uint64_t maxIterations = std::max<uint64_t>(mOptions.maxIterationsPerSample, 1);
+
+    // Warm up and find the number of iterations needed to reach the minimum sample duration.
+    // The iteration count is grown geometrically based on the last measured time.
+    uint64_t iterations = 1;
+    double warmupElapsedNS = 0.0;
+    while (true)
+    {
+        double elapsedNS = sampleFunc(iterations);
+        warmupElapsedNS += elapsedNS;
+        if (elapsedNS < minSampleNS && iterations < maxIterations)
+        {
+            double scale = elapsedNS > 0.0 ? std::min(1.2 * minSampleNS / elapsedNS, 10.0) : 10.0;
+            iterations = std::clamp<uint64_t>(uint64_t(iterations * scale), iterations + 1, maxIterations);
+            continue;
+        }
+        if (warmupElapsedNS >= warmupNS)
+            break;
+    }
+
+    // Take samples.
+    const uint32_t sampleCount = std::max(mOptions.sampleCount, 1u);
+    std::vector<double> samples(sampleCount);
+    for (uint32_t i = 0; i < sampleCount; ++i)
+        samples[i] = sampleFunc(iterations) / double(iterations);
+    std::sort(samples.begin(), samples.end());
+
+    auto percentile = [](const std::vector<double>& sorted, double p)
+    {
+        double x = p * (sorted.size() - 1);
+        size_t i = size_t(x);
+        size_t j = std::min(i + 1, sorted.size() - 1);
+        return sorted[i] + (sorted[j] - sorted[i]) * (x - double(i));
+    };
+
+    result.iterations = iterations;
+    result.samples = sampleCount;
+    result.minNS = samples.front();
+    result.maxNS = samples.back();
+    result.meanNS = std::accumulate(samples.begin(), samples.end(), 0.0) / sampleCount;
+    result.medianNS = percentile(samples, 0.5);
+    result.p10NS = percentile(samples, 0.1);
+    result.p90NS = percentile(samples, 0.9);
+
+    std::vector<double> deviations(sampleCount);
+    for (uint32_t i = 0; i < sampleCount; ++i)
+        deviations[i] = std::abs(samples[i] - result.medianNS);
+    std::sort(deviations.begin(), deviations.end());
+    result.madNS = percentile(deviations, 0.5);
+
+    std::string throughput;
+    if (result.itemsPerIteration > 0)
+        throughput += fmt::format(", {}", formatRate(result.getItemsPerSecond(), "items"));
+    if (result.bytesPerIteration > 0)
+        throughput += fmt::format(", {}/s", formatByteSize(size_t(result.getBytesPerSecond())));
+
+    reportLine(
+        "[ BENCH    ] {}: median {} (p10 {}, p90 {}, mad {}), {} x {} iteration{}{}",
+        result.name,
+        formatDuration(result.medianNS),
+        formatDuration(result.p10NS),
+        formatDuration(result.p90NS),
+        formatDuration(result.madNS),
+        result.samples,
+        result.iterations,
+        plural(result.iterations, "s"),
+        throughput
+    );
+
+    // Compare against baseline.
+    if (mpBaseline)
+    {
+        if (auto it = mpBaseline->find(result.name); it != mpBaseline->end())
+        {
+            double baselineNS = it->second;
+            result.baselineMedianNS = baselineNS;
+            double change = baselineNS > 0.0 ? result.medianNS / baselineNS - 1.0 : 0.0;
+            reportLine("[ BASELINE ] {}: median {} ({:+.1f}%)", result.name, formatDuration(baselineNS), change * 100.0);
+            if (change > mOptions.regressionThreshold)
+            {
+                reportFailure(fmt::format(
+                    "{}: median {} is {:.1f}% slower than baseline {} (threshold {:.1f}%)",
+                    result.name,
+                    formatDuration(result.medianNS),
+                    change * 100.0,
+                    formatDuration(baselineNS),
+                    mOptions.regressionThreshold * 100.0
+                ));
+            }
+        }
+    }
+
+    mResults.push_back(std::move(result));
+}
+
+const ref<Device>& BenchmarkContext::getDevice()
+{
+    if (!mpDevice)
+    {
+        FALCOR_CHECK(mDeviceProvider, "No device available for benchmark '{}'.", mName);
+        mpDevice = mDeviceProvider();
+    }
+    return mpDevice;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 void GPUUnitTestContext::createProgram(
     const std::filesystem::path& path,
     const std::string& entry,
@@ -798,4 +1075,21 @@ CPU_TEST(TestTags, TAGS("tag1", "tag2", "tag3"))
     EXPECT(true);
 }
 
+CPU_BENCHMARK(TestBenchmark)
+{
+    std::vector<float> values(1024, 1.f);
+    ctx.setItemsPerIteration(values.size());
+    ctx.setBytesPerIteration(values.size() * sizeof(float));
+    ctx.run(
+        [&]()
+        {
+            float sum = std::accumulate(values.begin(), values.end(), 0.f);
+            unittest::doNotOptimizeAway(sum);
+        }
+    );
+
+    EXPECT_EQ(ctx.getResults().size(), 1u);
+    EXPECT_GT(ctx.getResults()[0].iterations, 0u);
+}
+
 } // namespace Falcor
@@ -37,9 +37,12 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
@@ -84,6 +87,25 @@ public:
     SkippingTestException(const std::string& what) : std::runtime_error(what.c_str()) {}
 };
 
+/// Options controlling how benchmarks are measured and reported.
+struct BenchmarkOptions
+{
+    /// Minimum time spent running the benchmark before measuring.
+    double warmupMS = 50.0;
+    /// Minimum duration of a single sample. The iteration count per sample is adapted to reach it.
+    double minSampleMS = 10.0;
+    /// Number of samples to take per benchmark.
+    uint32_t sampleCount = 21;
+    /// Upper bound on the number of iterations in a single sample.
+    uint64_t maxIterationsPerSample = uint64_t(1) << 30;
+    /// Benchmark results are written to this JSON file (optional).
+    std::filesystem::path reportPath;
+    /// Benchmark results are compared against the results in this JSON file (optional).
+    std::filesystem::path baselinePath;
+    /// Relative slowdown of the median time (compared to the baseline) that is reported as a failure.
+    double regressionThreshold = 0.1;
+};
+
 struct RunOptions
 {
     Device::Desc deviceDesc;
@@ -93,15 +115,20 @@ struct RunOptions
     std::filesystem::path xmlReportPath;
     uint32_t parallel = 1;
     uint32_t repeat = 1;
+    /// Run benchmarks instead of tests.
+    bool benchmark = false;
+    BenchmarkOptions benchmarkOptions;
 };
 
 FALCOR_API int32_t runTests(const RunOptions& options);
 
 class CPUUnitTestContext;
 class GPUUnitTestContext;
+class BenchmarkContext;
 
 using CPUTestFunc = std::function<void(CPUUnitTestContext& ctx)>;
 using GPUTestFunc = std::function<void(GPUUnitTestContext& ctx)>;
+using BenchmarkFunc = std::function<void(BenchmarkContext& ctx)>;
 
 struct Test
 {
@@ -113,6 +140,7 @@ struct Test
 
     CPUTestFunc cpuFunc;
     GPUTestFunc gpuFunc;
+    BenchmarkFunc benchmarkFunc;
 };
 
 /// Enumerate all tests.
@@ -279,6 +307,136 @@ private:
     std::map<std::string, ref<Buffer>> mStructuredBuffers;
 };
 
+/**
+ * Statistics of a single measured benchmark. All times are per iteration.
+ */
+struct BenchmarkResult
+{
+    std::string name;             ///< Full benchmark name in the form "suite:benchmark" or "suite:benchmark/case".
+    uint64_t iterations = 0;      ///< Number of iterations per sample.
+    uint32_t samples = 0;         ///< Number of samples.
+    double minNS = 0.0;           ///< Fastest sample.
+    double maxNS = 0.0;           ///< Slowest sample.
+    double meanNS = 0.0;          ///< Mean over all samples.
+    double medianNS = 0.0;        ///< Median over all samples.
+    double p10NS = 0.0;           ///< 10th percentile.
+    double p90NS = 0.0;           ///< 90th percentile.
+    double madNS = 0.0;           ///< Median absolute deviation.
+    uint64_t itemsPerIteration = 0;
+    uint64_t bytesPerIteration = 0;
+    std::optional<double> baselineMedianNS; ///< Median of the baseline run (if a baseline was available).
+
+    double getItemsPerSecond() const { return medianNS > 0.0 ? itemsPerIteration * 1e9 / medianNS : 0.0; }
+    double getBytesPerSecond() const { return medianNS > 0.0 ? bytesPerIteration * 1e9 / medianNS : 0.0; }
+};
+
+/// Opaque sink used by doNotOptimizeAway().
+FALCOR_API void useCharPointer(const volatile char* p);
+
+/**
+ * Prevent the compiler from optimizing away a value computed in a benchmark.
+ */
+template<typename T>
+inline void doNotOptimizeAway(T&& value)
+{
+#if FALCOR_MSVC
+    useCharPointer(&reinterpret_cast<const volatile char&>(value));
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * Context passed to benchmarks registered with CPU_BENCHMARK.
+ * A benchmark sets up its data and then calls run() with the code to measure.
+ * The measured function is first run for a warm-up period, then the number of iterations
+ * per sample is adapted such that each sample runs for at least BenchmarkOptions::minSampleMS.
+ */
+class FALCOR_API BenchmarkContext : public UnitTestContext
+{
+public:
+    using DeviceProvider = std::function<ref<Device>()>;
+    /// Median time per iteration (in ns) by full benchmark name.
+    using Baseline = std::map<std::string, double>;
+
+    /**
+     * Constructor.
+     * @param[in] name Benchmark name in the form "suite:benchmark".
+     * @param[in] options Benchmark options.
+     * @param[in] deviceProvider Function returning a GPU device, called on first use of getDevice().
+     * @param[in] pBaseline Optional baseline results to compare against.
+     */
+    BenchmarkContext(std::string name, const BenchmarkOptions& options, DeviceProvider deviceProvider, const Baseline* pBaseline = nullptr)
+        : mName(std::move(name)), mOptions(options), mDeviceProvider(std::move(deviceProvider)), mpBaseline(pBaseline)
+    {}
+
+    /**
+     * Set the number of items processed per iteration. Enables items/s reporting for subsequent runs.
+     */
+    void setItemsPerIteration(uint64_t items) { mItemsPerIteration = items; }
+
+    /**
+     * Set the number of bytes processed per iteration. Enables bytes/s reporting for subsequent runs.
+     */
+    void setBytesPerIteration(uint64_t bytes) { mBytesPerIteration = bytes; }
+
+    /**
+     * Measure a function.
+     * @param[in] caseName Name of the benchmark case, appended to the benchmark name. Can be empty.
+     * @param[in] func Function to measure. Called many times.
+     */
+    template<typename Func>
+    void run(std::string_view caseName, Func&& func)
+    {
+        measure(caseName, [&func](uint64_t iterations) { return timeIterations(func, iterations); });
+    }
+
+    /**
+     * Measure a function. Same as run("", func).
+     */
+    template<typename Func>
+    void run(Func&& func)
+    {
+        run("", std::forward<Func>(func));
+    }
+
+    /**
+     * Returns a GPU device for benchmarks that need to create resources.
+     * The device is acquired on first use.
+     */
+    const ref<Device>& getDevice();
+
+    /**
+     * Returns the results measured so far.
+     */
+    const std::vector<BenchmarkResult>& getResults() const { return mResults; }
+
+private:
+    using SampleFunc = std::function<double(uint64_t)>;
+
+    template<typename Func>
+    static double timeIterations(Func& func, uint64_t iterations)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+            func();
+        auto endTime = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(endTime - startTime).count();
+    }
+
+    void measure(std::string_view caseName, const SampleFunc& sampleFunc);
+
+    std::string mName;
+    BenchmarkOptions mOptions;
+    DeviceProvider mDeviceProvider;
+    const Baseline* mpBaseline = nullptr;
+    ref<Device> mpDevice;
+    uint64_t mItemsPerIteration = 0;
+    uint64_t mBytesPerIteration = 0;
+    std::vector<BenchmarkResult> mResults;
+};
+
 struct Tags
 {
     Tags(std::string tag) { tags.push_back(std::move(tag)); }
@@ -351,6 +509,7 @@ void applyArgs(Options& options, Args&&... args)
 
 FALCOR_API void registerCPUTest(std::filesystem::path path, std::string name, unittest::Options options, CPUTestFunc func);
 FALCOR_API void registerGPUTest(std::filesystem::path path, std::string name, unittest::Options options, GPUTestFunc func);
+FALCOR_API void registerBenchmark(std::filesystem::path path, std::string name, unittest::Options options, BenchmarkFunc func);
 
 /**
  * StreamSink is a utility class used by the testing framework that either
@@ -533,6 +692,7 @@ inline std::optional<std::string> createBinaryMessage(std::string_view lhsStr, s
 using UnitTestContext = unittest::UnitTestContext;
 using CPUUnitTestContext = unittest::CPUUnitTestContext;
 using GPUUnitTestContext = unittest::GPUUnitTestContext;
+using BenchmarkContext = unittest::BenchmarkContext;
 
 /**
  * Macro to define a CPU unit test. The optional arguments include:
@@ -609,6 +769,40 @@ using GPUUnitTestContext = unittest::GPUUnitTestContext;
     } RegisterGPUTest##name;                                                    \
     static void GPUUnitTest##name(GPUUnitTestContext& ctx) /* over to the user for the braces */
 
+/**
+ * Macro to define a CPU benchmark. Benchmarks are only run when FalcorTest is
+ * invoked with --benchmark. The optional arguments are the same as for CPU_TEST.
+ *
+ * The benchmark body sets up its data and calls ctx.run() with the code to measure:
+ *
+ * CPU_BENCHMARK(SortFloats)
+ * {
+ *     std::vector<float> data = ...;
+ *     ctx.setItemsPerIteration(data.size());
+ *     ctx.run([&]() {
+ *         auto copy = data;
+ *         std::sort(copy.begin(), copy.end());
+ *         unittest::doNotOptimizeAway(copy);
+ *     });
+ * }
+ *
+ * Note: All benchmarks are implicitly tagged with "benchmark".
+ */
+#define CPU_BENCHMARK(name, ...)                                                   \
+    static void CPUBenchmark##name(BenchmarkContext& ctx);                         \
+    struct CPUBenchmarkRegisterer##name                                            \
+    {                                                                              \
+        CPUBenchmarkRegisterer##name()                                             \
+        {                                                                          \
+            std::filesystem::path path = __FILE__;                                 \
+            unittest::Options options;                                             \
+            applyArgs(options, ##__VA_ARGS__);                                     \
+            options.tags.insert("benchmark");                                      \
+            unittest::registerBenchmark(path, #name, options, CPUBenchmark##name); \
+        }                                                                          \
+    } RegisterCPUBenchmark##name;                                                  \
+    static void CPUBenchmark##name(BenchmarkContext& ctx) /* over to the user for the braces */
+
 // clang-format off
 
 /// Used as an argument of CPU_TEST/GPU_TEST to tag a test with a set of strings.
@@ -26,15 +26,22 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "Core/Macros.h"
 #include "Core/Error.h"
 #include <unordered_map>
 #include <any>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <typeinfo>
+#include <vector>
 
 namespace Falcor
 {
-class Dictionary
+template<typename T>
+class DictionaryKey;
+
+class FALCOR_API Dictionary
 {
 public:
     class Value
@@ -55,6 +62,13 @@ public:
             return std::any_cast<T>(mValue);
         }
 
+        /// Get a pointer to the stored value. Returns nullptr if the value is empty or of a different type.
+        template<typename T>
+        T* tryGet()
+        {
+            return std::any_cast<T>(&mValue);
+        }
+
     private:
         std::any mValue;
     };
@@ -63,6 +77,12 @@ public:
 
     Dictionary() = default;
     Dictionary(const Dictionary& d) : mContainer(d.mContainer) {}
+    Dictionary& operator=(const Dictionary& d)
+    {
+        mContainer = d.mContainer;
+        mKeyCache.clear();
+        return *this;
+    }
 
     Value& operator[](const std::string& key) { return mContainer[key]; }
     const Value& operator[](const std::string& key) const { return mContainer.at(key); }
@@ -95,7 +115,90 @@ public:
         return it != mContainer.end() ? it->second : defaultValue;
     }
 
+    /// Get value by typed key. Returns the specified default value if key does not exist. Throws an exception if the value is of a different type.
+    template<typename T>
+    T getValue(const DictionaryKey<T>& key, const T& defaultValue)
+    {
+        Value* pValue = findValue(key.getID(), key.getName(), false);
+        if (!pValue)
+            return defaultValue;
+        const T* pData = pValue->tryGet<T>();
+        FALCOR_CHECK(pData, "Value of key '{}' has a different type than '{}'", key.getName(), typeid(T).name());
+        return *pData;
+    }
+
+    /// Set value by typed key.
+    template<typename T>
+    void setValue(const DictionaryKey<T>& key, const T& value)
+    {
+        Value* pValue = findValue(key.getID(), key.getName(), true);
+        if (T* pData = pValue->tryGet<T>())
+            *pData = value;
+        else
+            *pValue = value;
+    }
+
+    /**
+     * Intern a key name.
+     * @param[in] name Key name.
+     * @return Process-wide unique ID of the key name.
+     */
+    static uint32_t internKey(const std::string& name);
+
 private:
+    /**
+     * Find the value of an interned key.
+     * The container never erases entries, so the value pointer is cached per key ID to avoid hashing the key name on later lookups.
+     * @param[in] id Key ID.
+     * @param[in] name Key name.
+     * @param[in] create Create the entry if it does not exist.
+     * @return Pointer to the value or nullptr if it does not exist and create is false.
+     */
+    Value* findValue(uint32_t id, const std::string& name, bool create)
+    {
+        if (id < mKeyCache.size() && mKeyCache[id])
+            return mKeyCache[id];
+
+        Value* pValue = nullptr;
+        if (create)
+        {
+            pValue = &mContainer[name];
+        }
+        else
+        {
+            auto it = mContainer.find(name);
+            if (it == mContainer.end())
+                return nullptr;
+            pValue = &it->second;
+        }
+
+        if (id >= mKeyCache.size())
+            mKeyCache.resize(id + 1, nullptr);
+        mKeyCache[id] = pValue;
+        return pValue;
+    }
+
     Container mContainer;
+    std::vector<Value*> mKeyCache; ///< Pointers into mContainer indexed by interned key ID.
+};
+
+/**
+ * Dictionary key with an associated value type.
+ * The key name is interned on construction, so accessing a dictionary with a typed key
+ * does not hash the key name after the first access.
+ * Typed keys and string keys with the same name refer to the same dictionary entry.
+ */
+template<typename T>
+class DictionaryKey
+{
+public:
+    explicit DictionaryKey(const char* name) : mName(name), mID(Dictionary::internKey(mName)) {}
+
+    const std::string& getName() const { return mName; }
+    uint32_t getID() const { return mID; }
+
+private:
+    std::string mName;
+    uint32_t mID;
 };
 } // namespace Falcor
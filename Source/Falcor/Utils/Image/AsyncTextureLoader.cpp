@@ -28,6 +28,7 @@
 #include "AsyncTextureLoader.h"
 #include "Core/API/Device.h"
 #include "Utils/Threading.h"
+#include "Utils/Timing/Profiler.h"
 
 namespace Falcor
 {
@@ -57,7 +58,7 @@ std::future<ref<Texture>> AsyncTextureLoader::loadMippedFromFiles(
 )
 {
     std::lock_guard<std::mutex> lock(mMutex);
-    mLoadRequestQueue.push(LoadRequest{{paths.begin(), paths.end()}, false, loadAsSrgb, bindFlags, importFlags, callback});
+    mLoadRequestQueue.push(LoadRequest{{paths.begin(), paths.end()}, false, loadAsSrgb, bindFlags, importFlags, callback, Profiler::beginFlow()});
     mCondition.notify_one();
     return mLoadRequestQueue.back().promise.get_future();
 }
@@ -72,7 +73,7 @@ std::future<ref<Texture>> AsyncTextureLoader::loadFromFile(
 )
 {
     std::lock_guard<std::mutex> lock(mMutex);
-    mLoadRequestQueue.push(LoadRequest{{path}, generateMipLevels, loadAsSrgb, bindFlags, importFlags, callback});
+    mLoadRequestQueue.push(LoadRequest{{path}, generateMipLevels, loadAsSrgb, bindFlags, importFlags, callback, Profiler::beginFlow()});
     mCondition.notify_one();
     return mLoadRequestQueue.back().promise.get_future();
 }
@@ -103,6 +104,8 @@ void AsyncTextureLoader::runWorker()
     // To avoid the upload heap growing too large, we synchronize the threads and
     // issue a global GPU flush at regular intervals.
 
+    Profiler::setThreadName("AsyncTextureLoader");
+
     while (true)
     {
         // Wait on condition until more work is ready.
@@ -134,22 +137,28 @@ void AsyncTextureLoader::runWorker()
 
         // Load the textures (this part is running in parallel).
         ref<Texture> pTexture;
-        if (request.paths.size() == 1)
-        {
-            pTexture = Texture::createFromFile(
-                mpDevice, request.paths[0], request.generateMipLevels, request.loadAsSRGB, request.bindFlags, request.importFlags
-            );
-        }
-        else
-        {
-            pTexture = Texture::createMippedFromFiles(mpDevice, request.paths, request.loadAsSRGB, request.bindFlags, request.importFlags);
-        }
-
-        request.promise.set_value(pTexture);
-
-        if (request.callback)
         {
-            request.callback(pTexture);
+            FALCOR_PROFILE_CPU("loadTexture");
+            Profiler::endFlow(request.flowID);
+
+            if (request.paths.size() == 1)
+            {
+                pTexture = Texture::createFromFile(
+                    mpDevice, request.paths[0], request.generateMipLevels, request.loadAsSRGB, request.bindFlags, request.importFlags
+                );
+            }
+            else
+            {
+                pTexture =
+                    Texture::createMippedFromFiles(mpDevice, request.paths, request.loadAsSRGB, request.bindFlags, request.importFlags);
+            }
+
+            request.promise.set_value(pTexture);
+
+            if (request.callback)
+            {
+                request.callback(pTexture);
+            }
         }
 
         lock.lock();
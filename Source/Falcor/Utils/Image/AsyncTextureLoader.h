@@ -113,6 +113,7 @@ private:
         ResourceBindFlags bindFlags;
         Bitmap::ImportFlags importFlags;
         LoadCallback callback;
+        uint32_t flowID; ///< Profiler flow ID connecting the request to its load in traces.
         std::promise<ref<Texture>> promise;
     };
 
@@ -30,6 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/NumericRange.h"
+#include "Utils/Timing/Profiler.h"
 
 #include <execution>
 
@@ -416,6 +417,7 @@ void TextureManager::endDeferredLoading()
         jobRange.end(),
         [&](size_t i)
         {
+            FALCOR_PROFILE_CPU("loadTexture");
             const auto& job = jobs[i];
             auto& desc = getDesc(job.handle);
             if (job.key.fullPaths.size() == 1)
@@ -0,0 +1,478 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BatchTransform.h"
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#define FALCOR_BATCH_TRANSFORM_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FALCOR_BATCH_TRANSFORM_SSE 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FALCOR_BATCH_TRANSFORM_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if FALCOR_BATCH_TRANSFORM_AVX2 || FALCOR_BATCH_TRANSFORM_SSE || FALCOR_BATCH_TRANSFORM_NEON
+#define FALCOR_BATCH_TRANSFORM_SIMD 1
+#else
+#define FALCOR_BATCH_TRANSFORM_SIMD 0
+#endif
+
+namespace Falcor
+{
+namespace
+{
+// The kernels below are templated on the lane type, which is either float (used for the remainder of an array)
+// or SimdFloat (one element per SIMD lane). Both perform identical operations, so results don't depend on the array size.
+
+#if FALCOR_BATCH_TRANSFORM_AVX2
+struct SimdFloat
+{
+    static constexpr size_t kWidth = 8;
+    __m256 v;
+};
+inline SimdFloat simdLoad(const float* p) { return {_mm256_loadu_ps(p)}; }
+inline void simdStore(float* p, SimdFloat a) { _mm256_storeu_ps(p, a.v); }
+inline SimdFloat simdSplat(float x) { return {_mm256_set1_ps(x)}; }
+inline SimdFloat operator+(SimdFloat a, SimdFloat b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline SimdFloat operator-(SimdFloat a, SimdFloat b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline SimdFloat operator*(SimdFloat a, SimdFloat b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline SimdFloat operator/(SimdFloat a, SimdFloat b) { return {_mm256_div_ps(a.v, b.v)}; }
+// Same semantics as math::min/max (x < y ? x : y), including signed zeros and NaNs.
+inline SimdFloat laneMin(SimdFloat a, SimdFloat b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline SimdFloat laneMax(SimdFloat a, SimdFloat b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline SimdFloat laneSqrt(SimdFloat a) { return {_mm256_sqrt_ps(a.v)}; }
+#elif FALCOR_BATCH_TRANSFORM_SSE
+struct SimdFloat
+{
+    static constexpr size_t kWidth = 4;
+    __m128 v;
+};
+inline SimdFloat simdLoad(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void simdStore(float* p, SimdFloat a) { _mm_storeu_ps(p, a.v); }
+inline SimdFloat simdSplat(float x) { return {_mm_set1_ps(x)}; }
+inline SimdFloat operator+(SimdFloat a, SimdFloat b) { return {_mm_add_ps(a.v, b.v)}; }
+inline SimdFloat operator-(SimdFloat a, SimdFloat b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline SimdFloat operator*(SimdFloat a, SimdFloat b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline SimdFloat operator/(SimdFloat a, SimdFloat b) { return {_mm_div_ps(a.v, b.v)}; }
+// Same semantics as math::min/max (x < y ? x : y), including signed zeros and NaNs.
+inline SimdFloat laneMin(SimdFloat a, SimdFloat b) { return {_mm_min_ps(a.v, b.v)}; }
+inline SimdFloat laneMax(SimdFloat a, SimdFloat b) { return {_mm_max_ps(a.v, b.v)}; }
+inline SimdFloat laneSqrt(SimdFloat a) { return {_mm_sqrt_ps(a.v)}; }
+#elif FALCOR_BATCH_TRANSFORM_NEON
+struct SimdFloat
+{
+    static constexpr size_t kWidth = 4;
+    float32x4_t v;
+};
+inline SimdFloat simdLoad(const float* p) { return {vld1q_f32(p)}; }
+inline void simdStore(float* p, SimdFloat a) { vst1q_f32(p, a.v); }
+inline SimdFloat simdSplat(float x) { return {vdupq_n_f32(x)}; }
+inline SimdFloat operator+(SimdFloat a, SimdFloat b) { return {vaddq_f32(a.v, b.v)}; }
+inline SimdFloat operator-(SimdFloat a, SimdFloat b) { return {vsubq_f32(a.v, b.v)}; }
+inline SimdFloat operator*(SimdFloat a, SimdFloat b) { return {vmulq_f32(a.v, b.v)}; }
+inline SimdFloat operator/(SimdFloat a, SimdFloat b) { return {vdivq_f32(a.v, b.v)}; }
+// vminq/vmaxq handle signed zeros and NaNs differently from math::min/max, so select explicitly.
+inline SimdFloat laneMin(SimdFloat a, SimdFloat b) { return {vbslq_f32(vcltq_f32(a.v, b.v), a.v, b.v)}; }
+inline SimdFloat laneMax(SimdFloat a, SimdFloat b) { return {vbslq_f32(vcgtq_f32(a.v, b.v), a.v, b.v)}; }
+inline SimdFloat laneSqrt(SimdFloat a) { return {vsqrtq_f32(a.v)}; }
+#endif
+
+template<typename V>
+V splat(float x);
+template<>
+inline float splat<float>(float x)
+{
+    return x;
+}
+#if FALCOR_BATCH_TRANSFORM_SIMD
+template<>
+inline SimdFloat splat<SimdFloat>(float x)
+{
+    return simdSplat(x);
+}
+#endif
+
+inline float laneMin(float a, float b) { return a < b ? a : b; }
+inline float laneMax(float a, float b) { return a > b ? a : b; }
+inline float laneSqrt(float a) { return std::sqrt(a); }
+
+enum class VectorOp
+{
+    Point,   ///< transformPoint() with a 4x4 matrix.
+    Vector4, ///< transformVector() with a 4x4 matrix.
+    Vector3, ///< transformVector() with a 3x3 matrix.
+    Normal,  ///< normalize(transformVector()) with a 3x3 matrix.
+};
+
+/// Upper 3x4 part of a matrix in row-major order.
+using Matrix3x4 = float[3][4];
+
+/// Transform vectors. Follows the operation order of dot() in mul(matrix, vector) and normalize().
+template<VectorOp op, typename V>
+inline void transformLanes(const Matrix3x4& m, V& x, V& y, V& z)
+{
+    V r[3];
+    for (int i = 0; i < 3; i++)
+    {
+        V s = splat<V>(m[i][0]) * x;
+        s = s + splat<V>(m[i][1]) * y;
+        s = s + splat<V>(m[i][2]) * z;
+        if constexpr (op == VectorOp::Point)
+            s = s + splat<V>(m[i][3]);
+        if constexpr (op == VectorOp::Vector4)
+            s = s + splat<V>(m[i][3] * 0.f);
+        r[i] = s;
+    }
+    if constexpr (op == VectorOp::Normal)
+    {
+        V d = r[0] * r[0];
+        d = d + r[1] * r[1];
+        d = d + r[2] * r[2];
+        V s = splat<V>(1.f) / laneSqrt(d);
+        for (int i = 0; i < 3; i++)
+            r[i] = r[i] * s;
+    }
+    x = r[0];
+    y = r[1];
+    z = r[2];
+}
+
+template<VectorOp op>
+void transformArray(const Matrix3x4& m, const float3* pSrc, float3* pDst, size_t count, size_t srcStride, size_t dstStride)
+{
+    const uint8_t* pSrcBytes = reinterpret_cast<const uint8_t*>(pSrc);
+    uint8_t* pDstBytes = reinterpret_cast<uint8_t*>(pDst);
+    auto src = [&](size_t i) -> const float3& { return *reinterpret_cast<const float3*>(pSrcBytes + i * srcStride); };
+    auto dst = [&](size_t i) -> float3& { return *reinterpret_cast<float3*>(pDstBytes + i * dstStride); };
+
+    size_t i = 0;
+#if FALCOR_BATCH_TRANSFORM_SIMD
+    constexpr size_t kWidth = SimdFloat::kWidth;
+    float x[kWidth], y[kWidth], z[kWidth];
+    for (; i + kWidth <= count; i += kWidth)
+    {
+        for (size_t j = 0; j < kWidth; j++)
+        {
+            const float3& v = src(i + j);
+            x[j] = v.x;
+            y[j] = v.y;
+            z[j] = v.z;
+        }
+        SimdFloat vx = simdLoad(x), vy = simdLoad(y), vz = simdLoad(z);
+        transformLanes<op>(m, vx, vy, vz);
+        simdStore(x, vx);
+        simdStore(y, vy);
+        simdStore(z, vz);
+        for (size_t j = 0; j < kWidth; j++)
+            dst(i + j) = float3(x[j], y[j], z[j]);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        float3 v = src(i);
+        transformLanes<op>(m, v.x, v.y, v.z);
+        dst(i) = v;
+    }
+}
+
+void toMatrix3x4(const float4x4& m, Matrix3x4& result)
+{
+    for (int r = 0; r < 3; r++)
+        for (int c = 0; c < 4; c++)
+            result[r][c] = m[r][c];
+}
+
+void toMatrix3x4(const float3x3& m, Matrix3x4& result)
+{
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+            result[r][c] = m[r][c];
+        result[r][3] = 0.f;
+    }
+}
+
+/// Transform bounding boxes. Follows the operation order of AABB::transform().
+template<typename V>
+inline void transformAABBLanes(const V (&m)[3][4], const V (&minPoint)[3], const V (&maxPoint)[3], V (&newMin)[3], V (&newMax)[3])
+{
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            V a = m[r][c] * minPoint[c];
+            V b = m[r][c] * maxPoint[c];
+            V lo = laneMin(a, b);
+            V hi = laneMax(a, b);
+            newMin[r] = c == 0 ? lo : newMin[r] + lo;
+            newMax[r] = c == 0 ? hi : newMax[r] + hi;
+        }
+        newMin[r] = newMin[r] + m[r][3];
+        newMax[r] = newMax[r] + m[r][3];
+    }
+}
+
+/// Compute the inverse transpose of affine matrices from the upper 3x4 part.
+/// The result's upper 3x3 part is the transposed inverse of the linear part, its last row is the transformed negated translation.
+template<typename V>
+inline void inverseTransposeAffineLanes(const V (&m)[3][4], V (&result)[4][3])
+{
+    const V& a = m[0][0];
+    const V& b = m[0][1];
+    const V& c = m[0][2];
+    const V& d = m[1][0];
+    const V& e = m[1][1];
+    const V& f = m[1][2];
+    const V& g = m[2][0];
+    const V& h = m[2][1];
+    const V& i = m[2][2];
+
+    // Cofactors of the linear part. The cofactor matrix divided by the determinant is the inverse transpose.
+    V cof[3][3] = {
+        {e * i - f * h, f * g - d * i, d * h - e * g},
+        {c * h - b * i, a * i - c * g, b * g - a * h},
+        {b * f - c * e, c * d - a * f, a * e - b * d},
+    };
+    V det = a * cof[0][0] + b * cof[0][1] + c * cof[0][2];
+    V invDet = splat<V>(1.f) / det;
+
+    for (int r = 0; r < 3; r++)
+        for (int col = 0; col < 3; col++)
+            result[r][col] = cof[r][col] * invDet;
+
+    // Translation of the inverse: -inverse(A) * t, with inverse(A)[col][k] = result[k][col].
+    for (int col = 0; col < 3; col++)
+    {
+        V s = result[0][col] * m[0][3];
+        s = s + result[1][col] * m[1][3];
+        s = s + result[2][col] * m[2][3];
+        result[3][col] = splat<V>(0.f) - s;
+    }
+}
+
+bool isAffine(const float4x4& m)
+{
+    return m[3][0] == 0.f && m[3][1] == 0.f && m[3][2] == 0.f && m[3][3] == 1.f;
+}
+
+float4x4 toInverseTranspose(const float (&result)[4][3])
+{
+    float4x4 m;
+    for (int r = 0; r < 4; r++)
+    {
+        for (int c = 0; c < 3; c++)
+            m[r][c] = result[r][c];
+        m[r][3] = r == 3 ? 1.f : 0.f;
+    }
+    return m;
+}
+} // namespace
+
+const char* getBatchTransformBackend()
+{
+#if FALCOR_BATCH_TRANSFORM_AVX2
+    return "AVX2";
+#elif FALCOR_BATCH_TRANSFORM_SSE
+    return "SSE";
+#elif FALCOR_BATCH_TRANSFORM_NEON
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
+
+void transformPoints(const float4x4& m, const float3* pSrc, float3* pDst, size_t count, size_t srcStride, size_t dstStride)
+{
+    Matrix3x4 m3x4;
+    toMatrix3x4(m, m3x4);
+    transformArray<VectorOp::Point>(m3x4, pSrc, pDst, count, srcStride, dstStride);
+}
+
+void transformVectors(const float4x4& m, const float3* pSrc, float3* pDst, size_t count, size_t srcStride, size_t dstStride)
+{
+    Matrix3x4 m3x4;
+    toMatrix3x4(m, m3x4);
+    transformArray<VectorOp::Vector4>(m3x4, pSrc, pDst, count, srcStride, dstStride);
+}
+
+void transformVectors(const float3x3& m, const float3* pSrc, float3* pDst, size_t count, size_t srcStride, size_t dstStride)
+{
+    Matrix3x4 m3x4;
+    toMatrix3x4(m, m3x4);
+    transformArray<VectorOp::Vector3>(m3x4, pSrc, pDst, count, srcStride, dstStride);
+}
+
+void transformNormals(const float3x3& m, const float3* pSrc, float3* pDst, size_t count, size_t srcStride, size_t dstStride)
+{
+    Matrix3x4 m3x4;
+    toMatrix3x4(m, m3x4);
+    transformArray<VectorOp::Normal>(m3x4, pSrc, pDst, count, srcStride, dstStride);
+}
+
+void transformAABBs(const float4x4* pMatrices, const AABB* pSrc, AABB* pDst, size_t count)
+{
+    size_t i = 0;
+#if FALCOR_BATCH_TRANSFORM_SIMD
+    constexpr size_t kWidth = SimdFloat::kWidth;
+    float lanes[3][4][kWidth], minLanes[3][kWidth], maxLanes[3][kWidth];
+    for (; i + kWidth <= count; i += kWidth)
+    {
+        for (size_t j = 0; j < kWidth; j++)
+        {
+            const float4x4& m = pMatrices[i + j];
+            for (int r = 0; r < 3; r++)
+                for (int c = 0; c < 4; c++)
+                    lanes[r][c][j] = m[r][c];
+            for (int c = 0; c < 3; c++)
+            {
+                minLanes[c][j] = pSrc[i + j].minPoint[c];
+                maxLanes[c][j] = pSrc[i + j].maxPoint[c];
+            }
+        }
+
+        SimdFloat m[3][4], minPoint[3], maxPoint[3], newMin[3], newMax[3];
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 4; c++)
+                m[r][c] = simdLoad(lanes[r][c]);
+            minPoint[r] = simdLoad(minLanes[r]);
+            maxPoint[r] = simdLoad(maxLanes[r]);
+        }
+        transformAABBLanes(m, minPoint, maxPoint, newMin, newMax);
+        for (int r = 0; r < 3; r++)
+        {
+            simdStore(minLanes[r], newMin[r]);
+            simdStore(maxLanes[r], newMax[r]);
+        }
+
+        for (size_t j = 0; j < kWidth; j++)
+        {
+            // Validity is checked on the source box, as in AABB::transform().
+            if (pSrc[i + j].valid())
+                pDst[i + j] = AABB(float3(minLanes[0][j], minLanes[1][j], minLanes[2][j]), float3(maxLanes[0][j], maxLanes[1][j], maxLanes[2][j]));
+            else
+                pDst[i + j] = AABB();
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        if (!pSrc[i].valid())
+        {
+            pDst[i] = AABB();
+            continue;
+        }
+        float m[3][4], minPoint[3], maxPoint[3], newMin[3], newMax[3];
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 4; c++)
+                m[r][c] = pMatrices[i][r][c];
+            minPoint[r] = pSrc[i].minPoint[r];
+            maxPoint[r] = pSrc[i].maxPoint[r];
+        }
+        transformAABBLanes(m, minPoint, maxPoint, newMin, newMax);
+        pDst[i] = AABB(float3(newMin[0], newMin[1], newMin[2]), float3(newMax[0], newMax[1], newMax[2]));
+    }
+}
+
+void inverseTransposeAffine(const float4x4* pSrc, float4x4* pDst, size_t count)
+{
+    size_t i = 0;
+#if FALCOR_BATCH_TRANSFORM_SIMD
+    constexpr size_t kWidth = SimdFloat::kWidth;
+    float lanes[3][4][kWidth], resultLanes[4][3][kWidth];
+    for (; i + kWidth <= count; i += kWidth)
+    {
+        for (size_t j = 0; j < kWidth; j++)
+            for (int r = 0; r < 3; r++)
+                for (int c = 0; c < 4; c++)
+                    lanes[r][c][j] = pSrc[i + j][r][c];
+
+        SimdFloat m[3][4], result[4][3];
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 4; c++)
+                m[r][c] = simdLoad(lanes[r][c]);
+        inverseTransposeAffineLanes(m, result);
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 3; c++)
+                simdStore(resultLanes[r][c], result[r][c]);
+
+        for (size_t j = 0; j < kWidth; j++)
+        {
+            if (!isAffine(pSrc[i + j]))
+            {
+                pDst[i + j] = transpose(inverse(pSrc[i + j]));
+                continue;
+            }
+            float laneResult[4][3];
+            for (int r = 0; r < 4; r++)
+                for (int c = 0; c < 3; c++)
+                    laneResult[r][c] = resultLanes[r][c][j];
+            pDst[i + j] = toInverseTranspose(laneResult);
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        if (!isAffine(pSrc[i]))
+        {
+            pDst[i] = transpose(inverse(pSrc[i]));
+            continue;
+        }
+        float m[3][4], result[4][3];
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 4; c++)
+                m[r][c] = pSrc[i][r][c];
+        inverseTransposeAffineLanes(m, result);
+        pDst[i] = toInverseTranspose(result);
+    }
+}
+
+void aosToSoa(const float3* pSrc, float* pX, float* pY, float* pZ, size_t count, size_t srcStride)
+{
+    const uint8_t* pSrcBytes = reinterpret_cast<const uint8_t*>(pSrc);
+    for (size_t i = 0; i < count; i++)
+    {
+        const float3& v = *reinterpret_cast<const float3*>(pSrcBytes + i * srcStride);
+        pX[i] = v.x;
+        pY[i] = v.y;
+        pZ[i] = v.z;
+    }
+}
+
+void soaToAos(const float* pX, const float* pY, const float* pZ, float3* pDst, size_t count, size_t dstStride)
+{
+    uint8_t* pDstBytes = reinterpret_cast<uint8_t*>(pDst);
+    for (size_t i = 0; i < count; i++)
+        *reinterpret_cast<float3*>(pDstBytes + i * dstStride) = float3(pX[i], pY[i], pZ[i]);
+}
+} // namespace Falcor
@@ -0,0 +1,155 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "AABB.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Vector.h"
+#include <cstddef>
+
+namespace Falcor
+{
+/**
+ * Batch transform kernels.
+ *
+ * These functions apply a transform to arrays of points, vectors, normals, bounding boxes or matrices.
+ * They use AVX2, SSE or NEON depending on the instruction sets enabled at build time, and fall back to scalar code otherwise.
+ *
+ * The kernels perform the same floating-point operations in the same order as the scalar functions they replace
+ * (transformPoint(), transformVector(), normalize(), AABB::transform()), so results are bit-identical as long as the
+ * compiler does not contract multiply-adds into FMAs. The exception is inverseTransposeAffine(), which uses a
+ * specialized affine inverse and differs from transpose(inverse(m)) by a few ULPs.
+ *
+ * Point and vector functions take strides in bytes, so they can operate on members of vertex structs.
+ * The source and destination can be the same array (in-place), but must not otherwise overlap.
+ */
+
+/**
+ * Get the name of the SIMD backend selected at build time.
+ * @return "AVX2", "SSE", "NEON" or "Scalar".
+ */
+FALCOR_API const char* getBatchTransformBackend();
+
+/**
+ * Transform points by a 4x4 matrix. Equivalent to pDst[i] = transformPoint(m, pSrc[i]).
+ * @param[in] m Transform matrix.
+ * @param[in] pSrc Source points.
+ * @param[out] pDst Destination points.
+ * @param[in] count Number of points.
+ * @param[in] srcStride Stride between source points in bytes.
+ * @param[in] dstStride Stride between destination points in bytes.
+ */
+FALCOR_API void transformPoints(
+    const float4x4& m,
+    const float3* pSrc,
+    float3* pDst,
+    size_t count,
+    size_t srcStride = sizeof(float3),
+    size_t dstStride = sizeof(float3)
+);
+
+/**
+ * Transform vectors by a 4x4 matrix. Equivalent to pDst[i] = transformVector(m, pSrc[i]).
+ * See transformPoints() for a description of the parameters.
+ */
+FALCOR_API void transformVectors(
+    const float4x4& m,
+    const float3* pSrc,
+    float3* pDst,
+    size_t count,
+    size_t srcStride = sizeof(float3),
+    size_t dstStride = sizeof(float3)
+);
+
+/**
+ * Transform vectors by a 3x3 matrix. Equivalent to pDst[i] = transformVector(m, pSrc[i]).
+ * See transformPoints() for a description of the parameters.
+ */
+FALCOR_API void transformVectors(
+    const float3x3& m,
+    const float3* pSrc,
+    float3* pDst,
+    size_t count,
+    size_t srcStride = sizeof(float3),
+    size_t dstStride = sizeof(float3)
+);
+
+/**
+ * Transform and normalize vectors by a 3x3 matrix. Equivalent to pDst[i] = normalize(transformVector(m, pSrc[i])).
+ * To transform normals, pass the inverse transpose of the transform.
+ * See transformPoints() for a description of the parameters.
+ */
+FALCOR_API void transformNormals(
+    const float3x3& m,
+    const float3* pSrc,
+    float3* pDst,
+    size_t count,
+    size_t srcStride = sizeof(float3),
+    size_t dstStride = sizeof(float3)
+);
+
+/**
+ * Transform bounding boxes by one matrix each. Equivalent to pDst[i] = pSrc[i].transform(pMatrices[i]).
+ * @param[in] pMatrices Transform matrices.
+ * @param[in] pSrc Source bounding boxes.
+ * @param[out] pDst Destination bounding boxes.
+ * @param[in] count Number of bounding boxes.
+ */
+FALCOR_API void transformAABBs(const float4x4* pMatrices, const AABB* pSrc, AABB* pDst, size_t count);
+
+/**
+ * Compute the inverse transpose of matrices. Equivalent to pDst[i] = transpose(inverse(pSrc[i])) up to rounding.
+ * Affine matrices (last row 0,0,0,1) use a specialized kernel, other matrices fall back to the general inverse.
+ * @param[in] pSrc Source matrices.
+ * @param[out] pDst Destination matrices.
+ * @param[in] count Number of matrices.
+ */
+FALCOR_API void inverseTransposeAffine(const float4x4* pSrc, float4x4* pDst, size_t count);
+
+/**
+ * Convert an array of 3-component vectors to separate component arrays.
+ * @param[in] pSrc Source vectors.
+ * @param[out] pX Destination x components.
+ * @param[out] pY Destination y components.
+ * @param[out] pZ Destination z components.
+ * @param[in] count Number of vectors.
+ * @param[in] srcStride Stride between source vectors in bytes.
+ */
+FALCOR_API void aosToSoa(const float3* pSrc, float* pX, float* pY, float* pZ, size_t count, size_t srcStride = sizeof(float3));
+
+/**
+ * Convert separate component arrays to an array of 3-component vectors.
+ * @param[in] pX Source x components.
+ * @param[in] pY Source y components.
+ * @param[in] pZ Source z components.
+ * @param[out] pDst Destination vectors.
+ * @param[in] count Number of vectors.
+ * @param[in] dstStride Stride between destination vectors in bytes.
+ */
+FALCOR_API void soaToAos(const float* pX, const float* pY, const float* pZ, float3* pDst, size_t count, size_t dstStride = sizeof(float3));
+} // namespace Falcor
@@ -184,6 +184,25 @@ public:
         return result;
     }
 
+    /**
+     * Evaluates a section at multiple points.
+     * Gives the same results as calling interpolate() per point. The evaluation itself is scalar,
+     * the batch only saves looking up the section's coefficients for every point.
+     * @param[in] section Section index
+     * @param[in] points Array of points to evaluate the section at
+     * @param[in] pointCount Number of points
+     * @param[out] results Array receiving one result per point
+     */
+    void interpolate(uint32_t section, const float* points, uint32_t pointCount, T* results) const
+    {
+        const CubicCoeff coeff = mCoefficient[section];
+        for (uint32_t i = 0; i < pointCount; i++)
+        {
+            const float point = points[i];
+            results[i] = (((coeff.d * point) + coeff.c) * point + coeff.b) * point + coeff.a;
+        }
+    }
+
 private:
     struct CubicCoeff
     {
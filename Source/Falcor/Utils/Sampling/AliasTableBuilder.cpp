@@ -0,0 +1,162 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AliasTableBuilder.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+#include <limits>
+
+namespace Falcor
+{
+namespace
+{
+struct WorkItem
+{
+    uint32_t index;
+    double weight; ///< Residual weight.
+};
+
+float getWeight(const float* pWeights, size_t stride, size_t i)
+{
+    return *reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(pWeights) + i * stride);
+}
+
+/**
+ * Pair below-average items with above-average items.
+ * Each pairing finalizes the entry of the below-average item and removes some weight from the above-average item,
+ * which is moved to the below-average list once its residual weight drops below the average.
+ * Items that can not be paired are appended to 'leftovers'.
+ */
+void pairItems(std::vector<WorkItem>& low, std::vector<WorkItem>& high, double avgWeight, AliasTableEntry* entries, std::vector<WorkItem>& leftovers)
+{
+    while (!low.empty() && !high.empty())
+    {
+        WorkItem l = low.back();
+        low.pop_back();
+        WorkItem& h = high.back();
+
+        entries[l.index] = {float(l.weight / avgWeight), h.index};
+
+        h.weight -= avgWeight - l.weight;
+        if (h.weight < avgWeight)
+        {
+            low.push_back(h);
+            high.pop_back();
+        }
+    }
+
+    leftovers.insert(leftovers.end(), low.begin(), low.end());
+    leftovers.insert(leftovers.end(), high.begin(), high.end());
+}
+
+template<typename Func>
+void forEachChunk(size_t chunkCount, bool parallel, Func func)
+{
+    auto range = NumericRange<size_t>(0, chunkCount);
+    if (parallel)
+        std::for_each(std::execution::par, range.begin(), range.end(), func);
+    else
+        std::for_each(range.begin(), range.end(), func);
+}
+} // namespace
+
+AliasTableData AliasTableBuilder::build(const float* pWeights, size_t count, size_t stride, bool parallel)
+{
+    // Use >= since we reserve 0xFFFFFFFFu as an invalid index.
+    if (count >= std::numeric_limits<uint32_t>::max())
+        FALCOR_THROW("Too many entries for alias table.");
+
+    AliasTableData result;
+    if (count == 0)
+        return result;
+
+    FALCOR_CHECK(pWeights != nullptr && stride >= sizeof(float), "Invalid alias table weights.");
+
+    const size_t chunkCount = (count + kChunkSize - 1) / kChunkSize;
+    parallel = parallel && chunkCount > 1;
+
+    // Sum element weights per chunk, use double to minimize precision issues.
+    std::vector<double> chunkSums(chunkCount, 0.0);
+    forEachChunk(
+        chunkCount,
+        parallel,
+        [&](size_t chunk)
+        {
+            const size_t end = std::min(count, (chunk + 1) * kChunkSize);
+            double sum = 0.0;
+            for (size_t i = chunk * kChunkSize; i < end; ++i)
+                sum += getWeight(pWeights, stride, i);
+            chunkSums[chunk] = sum;
+        }
+    );
+    for (double sum : chunkSums)
+        result.weightSum += sum;
+
+    const double avgWeight = result.weightSum / double(count);
+    result.entries.resize(count);
+    AliasTableEntry* entries = result.entries.data();
+
+    // Pair items within each chunk.
+    std::vector<std::vector<WorkItem>> chunkLeftovers(chunkCount);
+    forEachChunk(
+        chunkCount,
+        parallel,
+        [&](size_t chunk)
+        {
+            const size_t begin = chunk * kChunkSize;
+            const size_t end = std::min(count, begin + kChunkSize);
+            std::vector<WorkItem> low, high;
+            low.reserve(end - begin);
+            high.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i)
+            {
+                double w = getWeight(pWeights, stride, i);
+                (w < avgWeight ? low : high).push_back({uint32_t(i), w});
+            }
+            pairItems(low, high, avgWeight, entries, chunkLeftovers[chunk]);
+        }
+    );
+
+    // Merge the items left over in the chunks and pair them serially.
+    std::vector<WorkItem> low, high, leftovers;
+    for (const auto& chunk : chunkLeftovers)
+    {
+        for (const auto& item : chunk)
+            (item.weight < avgWeight ? low : high).push_back(item);
+    }
+    pairItems(low, high, avgWeight, entries, leftovers);
+
+    // All remaining items have (within numerical precision) the average weight and select themselves.
+    // This is also the case if all weights are zero, in which case the table samples uniformly.
+    for (const auto& item : leftovers)
+        entries[item.index] = {1.f, item.index};
+
+    return result;
+}
+} // namespace Falcor
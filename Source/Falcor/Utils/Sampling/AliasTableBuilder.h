@@ -0,0 +1,95 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Alias table entry.
+ * Entry i selects item i with probability 'threshold' and item 'alias' otherwise.
+ */
+struct AliasTableEntry
+{
+    float threshold; ///< Probability of selecting the entry's own item.
+    uint32_t alias;  ///< Item selected with probability 1 - threshold.
+};
+
+/**
+ * Alias table built on the CPU.
+ */
+struct AliasTableData
+{
+    std::vector<AliasTableEntry> entries; ///< One entry per item.
+    double weightSum = 0.0;               ///< Sum of all weights, accumulated in double precision.
+};
+
+/**
+ * CPU builder for alias tables using the O(N) algorithm from Vose 1991, "A linear algorithm for generating
+ * random numbers with a given distribution".
+ *
+ * The items are split into fixed size chunks. The weight sum is computed with one parallel pass over the chunks
+ * (partial sums in double precision). Then each chunk pairs its below-average items with its above-average items
+ * independently. The items a chunk can not pair (its remaining below- or above-average items, with their residual
+ * weights) are merged and paired serially in a final step. Since each chunk is roughly balanced for typical
+ * inputs, the merge step only sees a small fraction of the items.
+ *
+ * The table is built in place: entry i always refers to item i, so no permutation needs to be stored.
+ */
+class FALCOR_API AliasTableBuilder
+{
+public:
+    /// Number of items per chunk.
+    static constexpr size_t kChunkSize = 16384;
+
+    /**
+     * Build an alias table.
+     * The weights don't need to be normalized to sum up to 1. If all weights are zero, the table samples uniformly.
+     * @param[in] pWeights Pointer to the first weight.
+     * @param[in] count Number of weights.
+     * @param[in] stride Stride between weights in bytes. This allows reading weights directly from an array of structs.
+     * @param[in] parallel Build the table in parallel.
+     * @return The alias table.
+     */
+    static AliasTableData build(const float* pWeights, size_t count, size_t stride = sizeof(float), bool parallel = true);
+
+    /**
+     * Build an alias table.
+     * @param[in] weights The weights we'd like to sample each entry proportional to.
+     * @param[in] parallel Build the table in parallel.
+     * @return The alias table.
+     */
+    static AliasTableData build(const std::vector<float>& weights, bool parallel = true)
+    {
+        return build(weights.data(), weights.size(), sizeof(float), parallel);
+    }
+};
+} // namespace Falcor
@@ -0,0 +1,107 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SumTree.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace Falcor
+{
+void SumTree::build(const float* pWeights, size_t count, size_t stride)
+{
+    FALCOR_CHECK(count == 0 || (pWeights != nullptr && stride >= sizeof(float)), "Invalid sum tree weights.");
+
+    mCount = count;
+    mLeafOffset = 1;
+    while (mLeafOffset < count)
+        mLeafOffset *= 2;
+    mNodes.assign(2 * mLeafOffset, 0.0);
+
+    const uint8_t* pData = reinterpret_cast<const uint8_t*>(pWeights);
+    for (size_t i = 0; i < count; ++i)
+    {
+        float weight = *reinterpret_cast<const float*>(pData + i * stride);
+        FALCOR_ASSERT(weight >= 0.f);
+        mNodes[mLeafOffset + i] = weight;
+    }
+    for (size_t node = mLeafOffset - 1; node > 0; --node)
+        mNodes[node] = mNodes[2 * node] + mNodes[2 * node + 1];
+}
+
+void SumTree::setWeight(size_t index, float weight)
+{
+    FALCOR_CHECK(index < mCount, "Sum tree index out of range.");
+    FALCOR_ASSERT(weight >= 0.f);
+
+    // Recompute the sums from the children rather than propagating a delta, so no error accumulates over updates.
+    size_t node = mLeafOffset + index;
+    mNodes[node] = weight;
+    for (node /= 2; node > 0; node /= 2)
+        mNodes[node] = mNodes[2 * node] + mNodes[2 * node + 1];
+}
+
+float SumTree::getWeight(size_t index) const
+{
+    FALCOR_CHECK(index < mCount, "Sum tree index out of range.");
+    return float(mNodes[mLeafOffset + index]);
+}
+
+size_t SumTree::sample(double u) const
+{
+    FALCOR_CHECK(mCount > 0, "Can't sample an empty sum tree.");
+
+    const double weightSum = getWeightSum();
+    if (weightSum <= 0.0)
+        return std::min(mCount - 1, size_t(u * double(mCount)));
+
+    double target = u * weightSum;
+    size_t node = 1;
+    while (node < mLeafOffset)
+    {
+        double left = mNodes[2 * node];
+        // Never descend into a subtree with zero weight. This guards against precision issues when u is close to 1.
+        if (target < left || mNodes[2 * node + 1] <= 0.0)
+        {
+            node = 2 * node;
+        }
+        else
+        {
+            target -= left;
+            node = 2 * node + 1;
+        }
+    }
+    return node - mLeafOffset;
+}
+
+double SumTree::evalPdf(size_t index) const
+{
+    FALCOR_CHECK(index < mCount, "Sum tree index out of range.");
+    const double weightSum = getWeightSum();
+    return weightSum > 0.0 ? mNodes[mLeafOffset + index] / weightSum : 1.0 / double(mCount);
+}
+} // namespace Falcor
@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Sum tree for sampling from a discrete probability distribution whose weights change frequently.
+ *
+ * The weights are stored in the leaves of a complete binary tree where each inner node stores the sum of its
+ * children (in double precision). Building the tree is O(N), and both updating a single weight and drawing a
+ * sample are O(log N). This is preferable over rebuilding an alias table when only a few weights change between
+ * samples, or when the weights change every frame and only a moderate number of samples is drawn on the CPU.
+ */
+class FALCOR_API SumTree
+{
+public:
+    SumTree() = default;
+
+    /**
+     * Create a sum tree.
+     * @param[in] weights The weights we'd like to sample each entry proportional to.
+     */
+    explicit SumTree(const std::vector<float>& weights) { build(weights.data(), weights.size()); }
+
+    /**
+     * Rebuild the tree from a list of weights.
+     * @param[in] pWeights Pointer to the first weight.
+     * @param[in] count Number of weights.
+     * @param[in] stride Stride between weights in bytes.
+     */
+    void build(const float* pWeights, size_t count, size_t stride = sizeof(float));
+
+    /**
+     * Set the weight of a single item.
+     * @param[in] index Item index.
+     * @param[in] weight New weight (must be non-negative).
+     */
+    void setWeight(size_t index, float weight);
+
+    /**
+     * Get the weight of a single item.
+     */
+    float getWeight(size_t index) const;
+
+    /**
+     * Get the number of items in the tree.
+     */
+    size_t getCount() const { return mCount; }
+
+    /**
+     * Get the total sum of all weights.
+     */
+    double getWeightSum() const { return mNodes.empty() ? 0.0 : mNodes[1]; }
+
+    /**
+     * Sample an item proportional to the weights.
+     * Items with zero weight are never sampled. If all weights are zero, the items are sampled uniformly.
+     * @param[in] u Uniform random number in [0..1).
+     * @return Returns the sampled item index.
+     */
+    size_t sample(double u) const;
+
+    /**
+     * Evaluate the probability of sampling an item.
+     * @param[in] index Item index.
+     * @return Returns the probability of sampling the item.
+     */
+    double evalPdf(size_t index) const;
+
+private:
+    size_t mCount = 0;         ///< Number of items.
+    size_t mLeafOffset = 0;    ///< Index of the first leaf node (power of two).
+    std::vector<double> mNodes; ///< Nodes in heap layout. Node 1 is the root, node 0 is unused.
+};
+} // namespace Falcor
@@ -42,21 +42,17 @@ namespace Falcor
  * @brief Represents a cpu/gpu buffer, that handles the GPU limit on 4GB buffers, up to 4 billion items.
  *
  * GPU's currently handle at most 4GB buffers. If we want to store more data, it has to be split into multiple buffers.
- * This class facilitates this for objects with the power-of-2 byte size, by using the upper bits of the 32b index
- * to select which 4GB buffer. The number of buffers is equal to the size of the stored object, i.e.,
+ * This class facilitates this by using the upper bits of the 32b index to select which 4GB buffer.
+ * For objects with the power-of-2 byte size, the number of buffers is equal to the size of the stored object, i.e.,
  * for uint32_t, we can have up to 2^30 in a single 4GB buffer, leaving only 2 bits for buffer selection.
- * This naturally limites the size to the total of 2^32 items.
+ * This naturally limites the size to the total of 2^32 items. Other sizes get the number of buffers
+ * left over by the element index bits needed to address a full buffer (e.g. 16 buffers for a 20B object).
  *
  * @tparam T - Type of the object stored in the buffer.
  */
 template<typename T, bool TByteBuffer>
 class SplitBuffer
 {
-    /// We are encoding the buffer index in the top bits of the index,
-    /// so we can only have as many buffers as it the sizeof(T) rounded down
-    /// to the nearest power of two
-    static_assert((sizeof(T) & (sizeof(T) - 1)) == 0, "Size has to be power of 2");
-
 public:
     using ElementType = T;
 
@@ -281,6 +277,7 @@ private:
     static constexpr size_t kMaxElementCount = (kBufferSizeLimit + 1 - sizeof(T)) / sizeof(T);
     static_assert(kMaxElementCount * sizeof(T) <= kBufferSizeLimit);
     static constexpr size_t kElementIndexBits = bitCount(kMaxElementCount - 1);
+    static_assert(kElementIndexBits < 32, "Element index has to leave room for the buffer index");
     static constexpr size_t kBufferIndexBits = 32 - kElementIndexBits;
     static constexpr size_t kMaxBufferCount = (1u << kBufferIndexBits);
 
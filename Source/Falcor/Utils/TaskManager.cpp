@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TaskManager.h"
+#include "Utils/Timing/Profiler.h"
 
 namespace Falcor
 {
@@ -38,14 +39,20 @@ TaskManager::TaskManager(bool startPaused)
 
 void TaskManager::addTask(CpuTask&& task)
 {
+    uint32_t flowID = Profiler::beginFlow();
     std::lock_guard<std::mutex> l(mTaskMutex);
     ++mCurrentlyScheduled;
     mThreadPool.push_task(
-        [task = std::move(task), this]() mutable
+        [task = std::move(task), flowID, this]() mutable
         {
             ++mCurrentlyRunning;
             --mCurrentlyScheduled;
-            executeCpuTask(std::move(task));
+            {
+                Profiler::setThreadName("TaskManager");
+                FALCOR_PROFILE_CPU("task");
+                Profiler::endFlow(flowID);
+                executeCpuTask(std::move(task));
+            }
             size_t running = --mCurrentlyRunning;
             // If nothing is running, lets wake up and try to exit.
             if (running == 0)
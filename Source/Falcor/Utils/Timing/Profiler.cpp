@@ -31,7 +31,14 @@
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <deque>
 #include <fstream>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -46,6 +53,212 @@ const float kSigma = 0.98f;
 // for computing statistics (min, max, mean, stddev) over the recent history.
 const size_t kMaxHistorySize = 512;
 
+// Capacity of the per-thread ring buffers of low-overhead CPU events (number of records).
+// Must be a power of two.
+const size_t kCpuEventBufferCapacity = 1 << 16;
+
+// Name of the parent event of all low-overhead CPU events.
+const char kCpuRootEventName[] = "CPU";
+
+enum class CpuEventType : uint32_t
+{
+    Begin,      ///< Begin of a low-overhead CPU event.
+    End,        ///< End of a low-overhead CPU event.
+    TraceBegin, ///< Begin of a regular profiler event, only recorded during trace capture.
+    TraceEnd,   ///< End of a regular profiler event, only recorded during trace capture.
+    FlowStart,  ///< Start of a flow arrow. The record ID is the flow ID.
+    FlowEnd,    ///< End of a flow arrow. The record ID is the flow ID.
+};
+
+struct CpuEventRecord
+{
+    CpuTimer::TimePoint::rep timestamp; ///< Time point in clock ticks.
+    Profiler::EventID id;
+    CpuEventType type;
+};
+
+/**
+ * Single-producer/single-consumer ring buffer of low-overhead CPU event records.
+ * The owning thread writes the records and the profiler consumes them in endFrame().
+ */
+struct CpuEventBuffer
+{
+    struct OpenEvent
+    {
+        Profiler::EventID id;
+        CpuTimer::TimePoint::rep timestamp;
+        bool traceOnly;
+    };
+
+    std::unique_ptr<CpuEventRecord[]> records{new CpuEventRecord[kCpuEventBufferCapacity]};
+    std::atomic<uint64_t> writeIndex{0};
+    std::atomic<uint64_t> readIndex{0};
+    std::atomic<uint64_t> droppedCount{0};
+    std::atomic<bool> threadExited{false};
+
+    uint32_t threadIndex = 0; ///< Thread ID used in traces.
+    std::string threadName;   ///< Thread name used in traces. Written by the owning thread under the profiler buffers lock.
+
+    /// Consumer state: stack of events that began but did not end yet.
+    std::vector<OpenEvent> openEvents;
+
+    void record(Profiler::EventID id, CpuEventType type)
+    {
+        uint64_t index = writeIndex.load(std::memory_order_relaxed);
+        if (index - readIndex.load(std::memory_order_acquire) >= kCpuEventBufferCapacity)
+        {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        records[index & (kCpuEventBufferCapacity - 1)] = {
+            CpuTimer::getCurrentTimePoint().time_since_epoch().count(), id, type};
+        writeIndex.store(index + 1, std::memory_order_release);
+    }
+};
+
+} // namespace
+
+/// Ring buffers of the threads that recorded low-overhead CPU events for a profiler.
+struct Profiler::CpuEventBuffers
+{
+    /// Guards the buffer list, the thread names and the consumer state of the buffers.
+    std::mutex buffersMutex;
+    std::vector<std::shared_ptr<CpuEventBuffer>> buffers;
+    uint32_t nextThreadIndex = 1; ///< Thread index 0 is reserved for the GPU lane in traces.
+};
+
+namespace
+{
+/// Global state of the low-overhead CPU events.
+struct CpuEventRegistry
+{
+    std::mutex namesMutex;
+    std::unordered_map<std::string, Profiler::EventID> nameToID;
+    std::deque<std::string> names;
+
+    /// Buffers of the enabled and unpaused profilers. Threads cache their own buffers of these profilers.
+    std::mutex recordingMutex;
+    std::vector<std::shared_ptr<Profiler::CpuEventBuffers>> recordingBuffers;
+    std::atomic<uint64_t> recordingGeneration{0}; ///< Incremented whenever recordingBuffers changes.
+    std::atomic<uint32_t> recordingCount{0};      ///< Number of enabled and unpaused profilers.
+
+    std::atomic<uint32_t> nextFlowID{1};
+
+    void setRecording(const std::shared_ptr<Profiler::CpuEventBuffers>& pBuffers, bool recording)
+    {
+        std::lock_guard<std::mutex> lock(recordingMutex);
+        if (recording)
+            recordingBuffers.push_back(pBuffers);
+        else
+            recordingBuffers.erase(std::remove(recordingBuffers.begin(), recordingBuffers.end(), pBuffers), recordingBuffers.end());
+        recordingCount.store((uint32_t)recordingBuffers.size(), std::memory_order_relaxed);
+        recordingGeneration.fetch_add(1, std::memory_order_release);
+    }
+};
+
+CpuEventRegistry& getCpuEventRegistry()
+{
+    static CpuEventRegistry registry;
+    return registry;
+}
+
+/// Ring buffers of the calling thread, one per profiler it recorded events for.
+struct ThreadCpuEventBuffers
+{
+    struct Entry
+    {
+        std::weak_ptr<Profiler::CpuEventBuffers> pProfilerBuffers;
+        std::shared_ptr<CpuEventBuffer> pBuffer;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<CpuEventBuffer*> recordingBuffers; ///< Buffers of the recording profilers.
+    uint64_t generation = uint64_t(-1);            ///< Registry generation recordingBuffers was built for.
+    std::string threadName;                        ///< Thread name used in traces, empty if not set.
+
+    ~ThreadCpuEventBuffers()
+    {
+        for (auto& entry : entries)
+            entry.pBuffer->threadExited.store(true, std::memory_order_release);
+    }
+
+    /// Get the buffer of this thread for a profiler, creating and registering it on first use.
+    CpuEventBuffer& getBuffer(const std::shared_ptr<Profiler::CpuEventBuffers>& pProfilerBuffers)
+    {
+        for (const auto& entry : entries)
+        {
+            if (!entry.pProfilerBuffers.owner_before(pProfilerBuffers) && !pProfilerBuffers.owner_before(entry.pProfilerBuffers))
+                return *entry.pBuffer;
+        }
+
+        // Release the buffers of destroyed profilers. The cached recording buffers may point to them, so force a rebuild.
+        auto isExpired = [](const Entry& entry) { return entry.pProfilerBuffers.expired(); };
+        auto it = std::remove_if(entries.begin(), entries.end(), isExpired);
+        if (it != entries.end())
+        {
+            entries.erase(it, entries.end());
+            generation = uint64_t(-1);
+        }
+
+        auto pBuffer = std::make_shared<CpuEventBuffer>();
+        {
+            std::lock_guard<std::mutex> lock(pProfilerBuffers->buffersMutex);
+            pBuffer->threadIndex = pProfilerBuffers->nextThreadIndex++;
+            pBuffer->threadName = threadName.empty() ? fmt::format("Thread {}", pBuffer->threadIndex) : threadName;
+            pProfilerBuffers->buffers.push_back(pBuffer);
+        }
+        entries.push_back({pProfilerBuffers, pBuffer});
+        return *pBuffer;
+    }
+
+    /// Get the buffers of this thread for all recording profilers. This only takes a lock when the set of recording profilers changed.
+    const std::vector<CpuEventBuffer*>& getRecordingBuffers()
+    {
+        auto& registry = getCpuEventRegistry();
+        if (registry.recordingGeneration.load(std::memory_order_acquire) != generation)
+        {
+            std::vector<std::shared_ptr<Profiler::CpuEventBuffers>> profilerBuffers;
+            {
+                std::lock_guard<std::mutex> lock(registry.recordingMutex);
+                profilerBuffers = registry.recordingBuffers;
+                generation = registry.recordingGeneration.load(std::memory_order_relaxed);
+            }
+            recordingBuffers.clear();
+            for (const auto& pProfilerBuffers : profilerBuffers)
+                recordingBuffers.push_back(&getBuffer(pProfilerBuffers));
+        }
+        return recordingBuffers;
+    }
+};
+
+bool isCpuEventRecording()
+{
+    return getCpuEventRegistry().recordingCount.load(std::memory_order_relaxed) != 0;
+}
+
+ThreadCpuEventBuffers& getThreadCpuEventBuffers()
+{
+    thread_local ThreadCpuEventBuffers buffers;
+    return buffers;
+}
+
+/// Get the estimated cost of recording a single CPU event record in milliseconds.
+float getCpuEventRecordCost()
+{
+    static const float cost = []()
+    {
+        // Record into a private buffer so that the measurement does not show up in the profile.
+        const uint32_t kRecordCount = 4096;
+        CpuEventBuffer buffer;
+        auto start = CpuTimer::getCurrentTimePoint();
+        for (uint32_t i = 0; i < kRecordCount; ++i)
+            buffer.record(0, (i & 1) == 0 ? CpuEventType::Begin : CpuEventType::End);
+        auto end = CpuTimer::getCurrentTimePoint();
+        return (float)(CpuTimer::calcDuration(start, end) / kRecordCount);
+    }();
+    return cost;
+}
+
 pybind11::dict toPython(const Profiler::Stats& stats)
 {
     pybind11::dict d;
@@ -160,6 +373,8 @@ void Profiler::Event::start(Profiler& profiler, uint32_t frameIndex)
 
     // Update CPU time.
     frameData.cpuStartTime = CpuTimer::getCurrentTimePoint();
+    if (frameData.currentTimer == 0)
+        frameData.cpuFirstStartTime = frameData.cpuStartTime;
 
     // Update GPU time.
     FALCOR_ASSERT(frameData.pActiveTimer == nullptr);
@@ -309,12 +524,181 @@ void Profiler::Capture::finalize()
     mFinalized = true;
 }
 
+// Profiler::TraceCapture
+
+double Profiler::TraceCapture::toMicroseconds(CpuTimer::TimePoint::rep ticks) const
+{
+    auto duration = CpuTimer::TimePoint::duration(ticks) - mStartTime.time_since_epoch();
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+std::string Profiler::TraceCapture::toJsonString() const
+{
+    // Resolve the interned names once.
+    std::unordered_map<EventID, std::string> names;
+    auto getName = [&names](EventID id) -> const std::string&
+    {
+        auto it = names.find(id);
+        if (it == names.end())
+            it = names.emplace(id, getInternedName(id)).first;
+        return it->second;
+    };
+
+    nlohmann::json traceEvents = nlohmann::json::array();
+
+    auto addThreadName = [&traceEvents](uint32_t tid, const std::string& name)
+    {
+        traceEvents.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", tid}, {"args", {{"name", name}}}});
+        traceEvents.push_back({{"name", "thread_sort_index"}, {"ph", "M"}, {"pid", 1}, {"tid", tid}, {"args", {{"sort_index", tid}}}});
+    };
+    traceEvents.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", 1}, {"args", {{"name", "Falcor"}}}});
+    addThreadName(0, "GPU");
+    for (const auto& [tid, name] : mThreadNames)
+        addThreadName(tid, name);
+
+    for (const auto& event : mEvents)
+    {
+        nlohmann::json e = {{"ph", std::string(1, event.phase)}, {"pid", 1}, {"tid", event.tid}, {"ts", event.ts}};
+        if (event.phase == 'X')
+        {
+            e["name"] = getName(event.nameID);
+            e["cat"] = event.tid == 0 ? "gpu" : "cpu";
+            e["dur"] = event.dur;
+        }
+        else
+        {
+            e["name"] = "task";
+            e["cat"] = "flow";
+            e["id"] = event.flowID;
+            if (event.phase == 'f')
+                e["bp"] = "e";
+        }
+        traceEvents.push_back(std::move(e));
+    }
+
+    nlohmann::json trace = {{"traceEvents", std::move(traceEvents)}, {"displayTimeUnit", "ms"}};
+    return trace.dump();
+}
+
+void Profiler::TraceCapture::writeToFile(const std::filesystem::path& path) const
+{
+    auto json = toJsonString();
+    std::ofstream ofs(path);
+    ofs.write(json.data(), json.size());
+}
+
 // Profiler
 
 Profiler::Profiler(ref<Device> pDevice) : mpDevice(pDevice)
 {
     mpFence = mpDevice->createFence();
     mpFence->breakStrongReferenceToDevice();
+    mpCpuEventBuffers = std::make_shared<CpuEventBuffers>();
+
+    // Measure the recording cost up front so that it doesn't skew the first profiled frame.
+    getCpuEventRecordCost();
+
+    setThreadName("Main");
+}
+
+Profiler::~Profiler()
+{
+    if (mCpuEventRecording)
+        getCpuEventRegistry().setRecording(mpCpuEventBuffers, false);
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    mEnabled = enabled;
+    updateCpuEventRecording();
+}
+
+void Profiler::setPaused(bool paused)
+{
+    mPaused = paused;
+    updateCpuEventRecording();
+}
+
+void Profiler::updateCpuEventRecording()
+{
+    bool recording = mEnabled && !mPaused;
+    if (recording == mCpuEventRecording)
+        return;
+
+    if (recording)
+    {
+        // Drop events left open from the last time recording was stopped.
+        std::lock_guard<std::mutex> lock(mpCpuEventBuffers->buffersMutex);
+        for (auto& pBuffer : mpCpuEventBuffers->buffers)
+            pBuffer->openEvents.clear();
+    }
+    getCpuEventRegistry().setRecording(mpCpuEventBuffers, recording);
+    mCpuEventRecording = recording;
+}
+
+Profiler::EventID Profiler::internName(std::string_view name)
+{
+    FALCOR_ASSERT(name.find('/') == std::string_view::npos);
+    auto& registry = getCpuEventRegistry();
+    std::lock_guard<std::mutex> lock(registry.namesMutex);
+    auto [it, inserted] = registry.nameToID.try_emplace(std::string(name), (EventID)registry.names.size());
+    if (inserted)
+        registry.names.emplace_back(name);
+    return it->second;
+}
+
+std::string Profiler::getInternedName(EventID id)
+{
+    auto& registry = getCpuEventRegistry();
+    std::lock_guard<std::mutex> lock(registry.namesMutex);
+    FALCOR_CHECK(id < registry.names.size(), "Invalid event name ID {}.", id);
+    return registry.names[id];
+}
+
+void Profiler::recordCpuEvent(EventID id, bool begin)
+{
+    if (!isCpuEventRecording())
+        return;
+    auto type = begin ? CpuEventType::Begin : CpuEventType::End;
+    for (CpuEventBuffer* pBuffer : getThreadCpuEventBuffers().getRecordingBuffers())
+        pBuffer->record(id, type);
+}
+
+uint32_t Profiler::beginFlow()
+{
+    if (!isCpuEventRecording())
+        return 0;
+    uint32_t flowID = getCpuEventRegistry().nextFlowID.fetch_add(1, std::memory_order_relaxed);
+    if (flowID == 0)
+        flowID = getCpuEventRegistry().nextFlowID.fetch_add(1, std::memory_order_relaxed);
+    for (CpuEventBuffer* pBuffer : getThreadCpuEventBuffers().getRecordingBuffers())
+        pBuffer->record(flowID, CpuEventType::FlowStart);
+    return flowID;
+}
+
+void Profiler::endFlow(uint32_t flowID)
+{
+    if (flowID == 0 || !isCpuEventRecording())
+        return;
+    for (CpuEventBuffer* pBuffer : getThreadCpuEventBuffers().getRecordingBuffers())
+        pBuffer->record(flowID, CpuEventType::FlowEnd);
+}
+
+void Profiler::setThreadName(std::string_view name)
+{
+    auto& threadBuffers = getThreadCpuEventBuffers();
+    // Only the owning thread writes the name, so it can be compared without locking.
+    if (threadBuffers.threadName == name)
+        return;
+    threadBuffers.threadName = name;
+    for (auto& entry : threadBuffers.entries)
+    {
+        if (auto pProfilerBuffers = entry.pProfilerBuffers.lock())
+        {
+            std::lock_guard<std::mutex> lock(pProfilerBuffers->buffersMutex);
+            entry.pBuffer->threadName = name;
+        }
+    }
 }
 
 void Profiler::startEvent(RenderContext* pRenderContext, const std::string& name, Flags flags)
@@ -328,17 +712,18 @@ void Profiler::startEvent(RenderContext* pRenderContext, const std::string& name
             return;
         }
 
-        mCurrentEventName = mCurrentEventName + "/" + name;
-
-        Event* pEvent = getEvent(mCurrentEventName);
+        // Resolve the nested event through its parent, which avoids building the full event name on every call.
+        Event* pEvent = getChildEvent(mEventStack.empty() ? nullptr : mEventStack.back(), name);
         FALCOR_ASSERT(pEvent != nullptr);
+        mEventStack.push_back(pEvent);
         if (!mPaused)
-            pEvent->start(*this, mFrameIndex);
-
-        if (std::find(mCurrentFrameEvents.begin(), mCurrentFrameEvents.end(), pEvent) == mCurrentFrameEvents.end())
         {
-            mCurrentFrameEvents.push_back(pEvent);
+            pEvent->start(*this, mFrameIndex);
+            if (mpTraceCapture)
+                getThreadCpuEventBuffers().getBuffer(mpCpuEventBuffers).record(pEvent->mNameID, CpuEventType::TraceBegin);
         }
+
+        addFrameEvent(pEvent);
     }
     if (is_set(flags, Flags::Pix))
     {
@@ -352,15 +737,17 @@ void Profiler::endEvent(RenderContext* pRenderContext, const std::string& name,
     if (mEnabled && is_set(flags, Flags::Internal))
     {
         // '/' is used as a "path delimiter", so it cannot be used in the event name.
-        if (name.find('/') != std::string::npos)
+        if (name.find('/') != std::string::npos || mEventStack.empty())
             return;
 
-        Event* pEvent = getEvent(mCurrentEventName);
-        FALCOR_ASSERT(pEvent != nullptr);
+        Event* pEvent = mEventStack.back();
+        mEventStack.pop_back();
         if (!mPaused)
+        {
+            if (mpTraceCapture)
+                getThreadCpuEventBuffers().getBuffer(mpCpuEventBuffers).record(pEvent->mNameID, CpuEventType::TraceEnd);
             pEvent->end(mFrameIndex);
-
-        mCurrentEventName.erase(mCurrentEventName.find_last_of("/"));
+        }
     }
 
     if (is_set(flags, Flags::Pix))
@@ -387,10 +774,17 @@ void Profiler::endFrame(RenderContext* pRenderContext)
     if (mFenceValue != uint64_t(-1))
         mpFence->wait();
 
+    aggregateCpuEvents();
+
+    std::vector<Event*> updatedEvents;
     for (Event* pEvent : mCurrentFrameEvents)
     {
+        if (mpTraceCapture && pEvent->mFrameData[(mFrameIndex + 1) % 2].valid)
+            updatedEvents.push_back(pEvent);
         pEvent->endFrame(mFrameIndex);
     }
+    if (mpTraceCapture)
+        captureGpuTrace(updatedEvents);
 
     // Flush and insert signal for synchronization of GPU timings.
     pRenderContext->submit(false);
@@ -435,9 +829,27 @@ bool Profiler::isCapturing() const
     return mpCapture != nullptr;
 }
 
+void Profiler::startTraceCapture()
+{
+    setEnabled(true);
+    mpTraceCapture = std::make_shared<TraceCapture>(CpuTimer::getCurrentTimePoint());
+}
+
+std::shared_ptr<Profiler::TraceCapture> Profiler::endTraceCapture()
+{
+    // Consume the events recorded since the last frame.
+    if (mpTraceCapture)
+        aggregateCpuEvents();
+
+    std::shared_ptr<TraceCapture> pTraceCapture;
+    std::swap(pTraceCapture, mpTraceCapture);
+    return pTraceCapture;
+}
+
 Profiler::Event* Profiler::createEvent(const std::string& name)
 {
     auto pEvent = std::shared_ptr<Event>(new Event(name));
+    pEvent->mNameID = internName(std::string_view(name).substr(name.find_last_of('/') + 1));
     mEvents.emplace(name, pEvent);
     return pEvent.get();
 }
@@ -448,6 +860,198 @@ Profiler::Event* Profiler::findEvent(const std::string& name)
     return (event == mEvents.end()) ? nullptr : event->second.get();
 }
 
+Profiler::Event* Profiler::getChildEvent(Event* pParent, const std::string& name)
+{
+    auto& children = pParent ? pParent->mChildren : mRootEvents;
+    auto it = children.find(name);
+    if (it != children.end())
+        return it->second;
+
+    Event* pEvent = getEvent((pParent ? pParent->mName : std::string()) + "/" + name);
+    children.emplace(name, pEvent);
+    return pEvent;
+}
+
+Profiler::Event* Profiler::getCpuChildEvent(Event* pParent, EventID id)
+{
+    FALCOR_ASSERT(pParent);
+    auto it = pParent->mCpuChildren.find(id);
+    if (it != pParent->mCpuChildren.end())
+        return it->second;
+
+    Event* pEvent = getEvent(pParent->mName + "/" + getInternedName(id));
+    pParent->mCpuChildren.emplace(id, pEvent);
+    return pEvent;
+}
+
+void Profiler::addFrameEvent(Event* pEvent)
+{
+    if (pEvent->mLastFrameIndex != mFrameIndex)
+    {
+        pEvent->mLastFrameIndex = mFrameIndex;
+        mCurrentFrameEvents.push_back(pEvent);
+    }
+}
+
+void Profiler::aggregateCpuEvents()
+{
+    CpuTimer timer;
+    timer.update();
+
+    // The lock is held while consuming, as the open events are also reset when recording is restarted.
+    std::lock_guard<std::mutex> lock(mpCpuEventBuffers->buffersMutex);
+    auto& buffers = mpCpuEventBuffers->buffers;
+
+    // Release the buffers of exited threads that have been fully consumed.
+    auto isDone = [](const std::shared_ptr<CpuEventBuffer>& pBuffer)
+    {
+        return pBuffer->threadExited.load(std::memory_order_acquire) &&
+               pBuffer->readIndex.load(std::memory_order_relaxed) == pBuffer->writeIndex.load(std::memory_order_acquire);
+    };
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(), isDone), buffers.end());
+    if (mpTraceCapture)
+    {
+        for (const auto& pBuffer : buffers)
+            mpTraceCapture->mThreadNames[pBuffer->threadIndex] = pBuffer->threadName;
+    }
+
+    TraceCapture* pTrace = mpTraceCapture.get();
+    auto startTicks = pTrace ? pTrace->mStartTime.time_since_epoch().count() : 0;
+
+    CpuEventStats stats;
+    auto accumulate = [this](Event* pEvent, double time)
+    {
+        auto& frameData = pEvent->mFrameData[mFrameIndex % 2];
+        frameData.cpuTotalTime += (float)time;
+        frameData.valid = true;
+    };
+
+    for (auto& pBuffer : buffers)
+    {
+        uint64_t readIndex = pBuffer->readIndex.load(std::memory_order_relaxed);
+        uint64_t writeIndex = pBuffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t droppedCount = pBuffer->droppedCount.exchange(0, std::memory_order_relaxed);
+        if (readIndex == writeIndex && droppedCount == 0)
+            continue;
+
+        stats.threadCount++;
+        stats.recordCount += writeIndex - readIndex;
+        stats.droppedCount += droppedCount;
+
+        auto& openEvents = pBuffer->openEvents;
+        for (; readIndex < writeIndex; ++readIndex)
+        {
+            const CpuEventRecord& record = pBuffer->records[readIndex & (kCpuEventBufferCapacity - 1)];
+            switch (record.type)
+            {
+            case CpuEventType::Begin:
+            case CpuEventType::TraceBegin:
+                openEvents.push_back({record.id, record.timestamp, record.type == CpuEventType::TraceBegin});
+                continue;
+            case CpuEventType::FlowStart:
+            case CpuEventType::FlowEnd:
+                if (pTrace && record.timestamp >= startTicks)
+                {
+                    char phase = record.type == CpuEventType::FlowStart ? 's' : 'f';
+                    pTrace->mEvents.push_back({phase, pBuffer->threadIndex, 0, pTrace->toMicroseconds(record.timestamp), 0.0, record.id});
+                }
+                continue;
+            default:
+                break;
+            }
+
+            // Find the matching begin record. End records without one (e.g. if it was dropped) are ignored.
+            bool traceOnly = record.type == CpuEventType::TraceEnd;
+            auto it = std::find_if(
+                openEvents.rbegin(),
+                openEvents.rend(),
+                [&record, traceOnly](const auto& e) { return e.id == record.id && e.traceOnly == traceOnly; }
+            );
+            if (it == openEvents.rend())
+                continue;
+            size_t depth = std::distance(it, openEvents.rend()) - 1;
+            auto beginTimestamp = openEvents[depth].timestamp;
+
+            if (pTrace && beginTimestamp >= startTicks)
+            {
+                double ts = pTrace->toMicroseconds(beginTimestamp);
+                pTrace->mEvents.push_back({'X', pBuffer->threadIndex, record.id, ts, pTrace->toMicroseconds(record.timestamp) - ts, 0});
+            }
+
+            // Regular profiler events are already timed by the profiler, they are only recorded for the trace.
+            if (!traceOnly)
+            {
+                // Resolve the nested event and register it and its parents for the current frame.
+                if (!mpCpuRootEvent)
+                    mpCpuRootEvent = getChildEvent(nullptr, kCpuRootEventName);
+                addFrameEvent(mpCpuRootEvent);
+                Event* pEvent = mpCpuRootEvent;
+                size_t level = 0;
+                for (size_t i = 0; i <= depth; ++i)
+                {
+                    if (openEvents[i].traceOnly)
+                        continue;
+                    ++level;
+                    pEvent = getCpuChildEvent(pEvent, openEvents[i].id);
+                    addFrameEvent(pEvent);
+                }
+
+                auto duration = CpuTimer::TimePoint::duration(record.timestamp - beginTimestamp);
+                double time = std::chrono::duration<double, std::milli>(duration).count();
+                accumulate(pEvent, time);
+                if (level == 1)
+                    accumulate(mpCpuRootEvent, time);
+            }
+
+            // Events nested in the ended one that are still open have lost their end record.
+            openEvents.resize(depth);
+        }
+
+        pBuffer->readIndex.store(writeIndex, std::memory_order_release);
+    }
+
+    timer.update();
+    stats.recordOverhead = stats.recordCount * getCpuEventRecordCost();
+    stats.aggregationTime = (float)(timer.delta() * 1000.0);
+    mCpuEventStats = stats;
+}
+
+void Profiler::captureGpuTrace(const std::vector<Event*>& events)
+{
+    // GPU timers only measure elapsed times. Each event is placed at the CPU time its first range was issued,
+    // but not before the end of the previous event on the same nesting level and not past the end of its parent,
+    // so that the slices on the GPU lane nest properly and don't overlap.
+    struct Level
+    {
+        double end;    ///< End of the event on this level.
+        double cursor; ///< End of the last child event.
+    };
+    std::vector<Level> levels;
+
+    TraceCapture& trace = *mpTraceCapture;
+    for (Event* pEvent : events)
+    {
+        const auto& frameData = pEvent->mFrameData[(mFrameIndex + 1) % 2];
+        if (pEvent->mGpuTime <= 0.f || frameData.cpuFirstStartTime < trace.mStartTime)
+            continue;
+
+        // Event names are paths starting with a '/'.
+        size_t depth = std::count(pEvent->mName.begin(), pEvent->mName.end(), '/') - 1;
+        levels.resize(std::min(depth, levels.size()));
+
+        double& cursor = levels.empty() ? trace.mGpuCursor : levels.back().cursor;
+        double parentEnd = levels.empty() ? std::numeric_limits<double>::infinity() : levels.back().end;
+        double start = std::max(trace.toMicroseconds(frameData.cpuFirstStartTime.time_since_epoch().count()), cursor);
+        double end = std::min(start + pEvent->mGpuTime * 1000.0, parentEnd);
+        if (end <= start)
+            continue;
+
+        trace.mEvents.push_back({'X', 0, pEvent->mNameID, start, end - start, 0});
+        cursor = end;
+        levels.push_back({end, start});
+    }
+}
+
 void Profiler::breakStrongReferenceToDevice()
 {
     mpDevice.breakStrongReference();
@@ -502,6 +1106,33 @@ FALCOR_SCRIPT_BINDING(Profiler)
     profiler.def("end_capture", endCapture);
     profiler.def("end_frame", [](Profiler& self) { self.endFrame(self.getDevice()->getRenderContext()); });
     profiler.def("reset_stats", &Profiler::resetStats);
+    profiler.def_property_readonly("is_trace_capturing", &Profiler::isTraceCapturing);
+    profiler.def("start_trace_capture", &Profiler::startTraceCapture);
+    profiler.def(
+        "end_trace_capture",
+        [](Profiler* pProfiler)
+        {
+            std::optional<std::string> result;
+            auto pTraceCapture = pProfiler->endTraceCapture();
+            if (pTraceCapture)
+                result = pTraceCapture->toJsonString();
+            return result;
+        }
+    );
+    profiler.def_property_readonly(
+        "cpu_event_stats",
+        [](const Profiler& self)
+        {
+            const auto& stats = self.getCpuEventStats();
+            pybind11::dict d;
+            d["record_count"] = stats.recordCount;
+            d["dropped_count"] = stats.droppedCount;
+            d["thread_count"] = stats.threadCount;
+            d["record_overhead"] = stats.recordOverhead;
+            d["aggregation_time"] = stats.aggregationTime;
+            return d;
+        }
+    );
 
     pybind11::class_<PythonProfilerEvent>(m, "ProfilerEvent")
         .def(pybind11::init<RenderContext*, std::string_view>())
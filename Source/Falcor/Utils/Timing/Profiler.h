@@ -31,8 +31,10 @@
 #include "Core/API/GpuTimer.h"
 #include "Core/API/Fence.h"
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -46,6 +48,15 @@ class RenderContext;
  * It automatically creates event hierarchies based on the order and nesting of the calls made.
  * This class uses a double-buffering scheme for GPU profiling to avoid GPU stalls.
  * ProfilerEvent is a wrapper class which together with scoping can simplify event profiling.
+ *
+ * For profiling hot code paths and worker threads, the profiler also supports low-overhead CPU-only events
+ * (see FALCOR_PROFILE_CPU). Their names are interned into stable IDs on first use, and begin/end timestamps
+ * are recorded into per-thread ring buffers without locking. The records are aggregated into events below
+ * the "CPU" event once per frame in endFrame(), which also reports the measured profiler overhead.
+ *
+ * A trace capture (see startTraceCapture()) records the events of all threads along with flow arrows
+ * between async tasks and GPU timings, and exports them in the Chrome trace event format, which can be
+ * viewed in Perfetto (ui.perfetto.dev) or chrome://tracing.
  */
 class FALCOR_API Profiler
 {
@@ -59,6 +70,21 @@ public:
         Default = Internal | Pix
     };
 
+    /// Interned event name (see internName()).
+    using EventID = uint32_t;
+
+    /**
+     * Statistics of the low-overhead CPU events for the last frame.
+     */
+    struct CpuEventStats
+    {
+        uint64_t recordCount = 0;    ///< Number of begin/end records aggregated.
+        uint64_t droppedCount = 0;   ///< Number of records dropped because a thread's ring buffer was full.
+        uint32_t threadCount = 0;    ///< Number of threads that recorded events.
+        float recordOverhead = 0.f;  ///< Estimated time spent recording the events in ms, summed over all threads.
+        float aggregationTime = 0.f; ///< Time spent aggregating the events in endFrame() in ms.
+    };
+
     struct Stats
     {
         float min;
@@ -107,10 +133,16 @@ public:
 
         uint32_t mTriggered = 0; ///< Keeping track of nested calls to start().
 
+        std::unordered_map<std::string, Event*> mChildren; ///< Nested events by name.
+        std::unordered_map<EventID, Event*> mCpuChildren;  ///< Nested low-overhead CPU events by name ID.
+        uint32_t mLastFrameIndex = uint32_t(-1);           ///< Index of the last frame the event was registered for.
+        EventID mNameID = 0;                               ///< Interned name (last component of the nested name) used in traces.
+
         struct FrameData
         {
-            CpuTimer::TimePoint cpuStartTime; ///< Last event CPU start time.
-            float cpuTotalTime = 0.0;         ///< Total accumulated CPU time.
+            CpuTimer::TimePoint cpuStartTime;      ///< Last event CPU start time.
+            CpuTimer::TimePoint cpuFirstStartTime; ///< First event CPU start time in the frame.
+            float cpuTotalTime = 0.0;              ///< Total accumulated CPU time.
 
             std::vector<ref<GpuTimer>> pTimers; ///< Pool of GPU timers.
             size_t currentTimer = 0;            ///< Next GPU timer to use from the pool.
@@ -154,10 +186,52 @@ public:
         friend class Profiler;
     };
 
+    /**
+     * Trace of the CPU events of all threads and the GPU timings, recorded by a trace capture.
+     */
+    class FALCOR_API TraceCapture
+    {
+    public:
+        TraceCapture(CpuTimer::TimePoint startTime) : mStartTime(startTime) {}
+
+        size_t getEventCount() const { return mEvents.size(); }
+
+        /**
+         * Convert the trace to JSON in the Chrome trace event format.
+         */
+        std::string toJsonString() const;
+
+        /**
+         * Write the trace to a JSON file in the Chrome trace event format.
+         */
+        void writeToFile(const std::filesystem::path& path) const;
+
+    private:
+        struct TraceEvent
+        {
+            char phase;     ///< Trace event phase: 'X' (complete event), 's' (flow start) or 'f' (flow end).
+            uint32_t tid;   ///< Thread ID, 0 for the GPU lane.
+            EventID nameID; ///< Interned event name.
+            double ts;      ///< Start time in microseconds relative to the start of the capture.
+            double dur;     ///< Duration in microseconds.
+            uint32_t flowID;
+        };
+
+        double toMicroseconds(CpuTimer::TimePoint::rep ticks) const;
+
+        CpuTimer::TimePoint mStartTime;
+        std::vector<TraceEvent> mEvents;
+        std::map<uint32_t, std::string> mThreadNames;
+        double mGpuCursor = 0.0; ///< End of the last top-level GPU event.
+
+        friend class Profiler;
+    };
+
     /**
      * Constructor.
      */
     Profiler(ref<Device> pDevice);
+    ~Profiler();
 
     const Device* getDevice() const { return mpDevice.get(); }
 
@@ -171,7 +245,7 @@ public:
      * Enable/disable the profiler.
      * @param[in] enabled True to enable the profiler.
      */
-    void setEnabled(bool enabled) { mEnabled = enabled; }
+    void setEnabled(bool enabled);
 
     /**
      * Check if the profiler is paused.
@@ -183,7 +257,7 @@ public:
      * Pause/resume the profiler.
      * @param[in] paused True to pause the profiler.
      */
-    void setPaused(bool paused) { mPaused = paused; }
+    void setPaused(bool paused);
 
     /**
      * Start profile capture.
@@ -203,6 +277,23 @@ public:
      */
     bool isCapturing() const;
 
+    /**
+     * Start trace capture. Enables the profiler.
+     * While capturing, the CPU events of all threads, flow arrows between async tasks and GPU timings are recorded.
+     */
+    void startTraceCapture();
+
+    /**
+     * End trace capture.
+     * @return Returns the captured trace, or nullptr if no trace capture was active.
+     */
+    std::shared_ptr<TraceCapture> endTraceCapture();
+
+    /**
+     * Check if the profiler is capturing a trace.
+     */
+    bool isTraceCapturing() const { return mpTraceCapture != nullptr; }
+
     /**
      * Finish profiling for the entire frame.
      * Note: Must be called once at the end of each frame.
@@ -244,8 +335,59 @@ public:
      */
     void resetStats();
 
+    /**
+     * Get the statistics of the low-overhead CPU events aggregated in the last call to endFrame().
+     */
+    const CpuEventStats& getCpuEventStats() const { return mCpuEventStats; }
+
+    /**
+     * Intern an event name for use with low-overhead CPU events.
+     * Interning the same name again returns the same ID. This function is thread-safe.
+     * @param[in] name The event name. Must not contain '/'.
+     * @return Returns the name ID.
+     */
+    static EventID internName(std::string_view name);
+
+    /**
+     * Get the name of an interned event name ID.
+     * @param[in] id The name ID.
+     * @return Returns the event name.
+     */
+    static std::string getInternedName(EventID id);
+
+    /**
+     * Record the begin or end of a low-overhead CPU event on the calling thread.
+     * The event is recorded for every enabled and unpaused profiler. This function is thread-safe and only takes a lock
+     * when the set of recording profilers changed. Records are dropped while no profiler is enabled.
+     * @param[in] id The interned event name.
+     * @param[in] begin True to record the beginning, false to record the end of the event.
+     */
+    static void recordCpuEvent(EventID id, bool begin);
+
+    /**
+     * Start a flow arrow from the currently running event on the calling thread, for example when submitting an async task.
+     * This function is thread-safe.
+     * @return Returns the flow ID to pass to endFlow(), or 0 if no profiler is recording.
+     */
+    static uint32_t beginFlow();
+
+    /**
+     * End a flow arrow at the currently running event on the calling thread, for example when starting an async task.
+     * @param[in] flowID Flow ID returned by beginFlow(). Ignored if 0.
+     */
+    static void endFlow(uint32_t flowID);
+
+    /**
+     * Set the name of the calling thread shown in traces.
+     * @param[in] name The thread name.
+     */
+    static void setThreadName(std::string_view name);
+
     void breakStrongReferenceToDevice();
 
+    /// Ring buffers of the low-overhead CPU events recorded for a profiler. Defined in Profiler.cpp.
+    struct CpuEventBuffers;
+
 private:
     /**
      * Create a new event.
@@ -261,20 +403,53 @@ private:
      */
     Event* findEvent(const std::string& name);
 
+    /**
+     * Get a nested event, or create it if it does not yet exist.
+     * @param[in] pParent Parent event, or nullptr for a top-level event.
+     * @param[in] name The event name.
+     * @return Returns the event.
+     */
+    Event* getChildEvent(Event* pParent, const std::string& name);
+
+    /**
+     * Get a nested low-overhead CPU event, or create it if it does not yet exist.
+     * @param[in] pParent Parent event.
+     * @param[in] id The interned event name.
+     * @return Returns the event.
+     */
+    Event* getCpuChildEvent(Event* pParent, EventID id);
+
+    /// Register an event for the current frame.
+    void addFrameEvent(Event* pEvent);
+
+    /// Aggregate the low-overhead CPU events recorded since the last frame and add them to the trace capture.
+    void aggregateCpuEvents();
+
+    /// Add the GPU timings of the last frame's events to the trace capture.
+    void captureGpuTrace(const std::vector<Event*>& events);
+
+    /// Enable/disable recording of low-overhead CPU events based on the enabled/paused state.
+    void updateCpuEventRecording();
+
     BreakableReference<Device> mpDevice;
 
     bool mEnabled = false;
     bool mPaused = false;
+    bool mCpuEventRecording = false; ///< True if this profiler has enabled recording of low-overhead CPU events.
+    std::shared_ptr<CpuEventBuffers> mpCpuEventBuffers; ///< Low-overhead CPU events recorded for this profiler.
 
     std::unordered_map<std::string, std::shared_ptr<Event>> mEvents; ///< Events by name.
     std::vector<Event*> mCurrentFrameEvents;                         ///< Events registered for current frame.
     std::vector<Event*> mLastFrameEvents;                            ///< Events from last frame.
-    std::string mCurrentEventName;                                   ///< Current nested event name.
-    uint32_t mCurrentLevel = 0;                                      ///< Current nesting level.
+    std::unordered_map<std::string, Event*> mRootEvents;             ///< Top-level events by name.
+    std::vector<Event*> mEventStack;                                 ///< Stack of currently running nested events.
+    Event* mpCpuRootEvent = nullptr;                                 ///< Parent event of the low-overhead CPU events.
+    CpuEventStats mCpuEventStats;                                    ///< Low-overhead CPU event statistics for the last frame.
     uint32_t mFrameIndex = 0;                                        ///< Current frame index.
     bool mPendingReset = false;                                      ///< Reset profiler stats at the next call to endFrame().
 
-    std::shared_ptr<Capture> mpCapture; ///< Currently active capture.
+    std::shared_ptr<Capture> mpCapture;           ///< Currently active capture.
+    std::shared_ptr<TraceCapture> mpTraceCapture; ///< Currently active trace capture.
 
     ref<Fence> mpFence;
     uint64_t mFenceValue = uint64_t(-1);
@@ -299,6 +474,20 @@ private:
     const std::string mName;
     Profiler::Flags mFlags;
 };
+
+/**
+ * Helper class for recording low-overhead CPU events using RAII.
+ * The FALCOR_PROFILE_CPU macro wraps interning of the event name and creation of local ScopedCpuProfilerEvent objects.
+ */
+class ScopedCpuProfilerEvent
+{
+public:
+    ScopedCpuProfilerEvent(Profiler::EventID id) : mID(id) { Profiler::recordCpuEvent(mID, true); }
+    ~ScopedCpuProfilerEvent() { Profiler::recordCpuEvent(mID, false); }
+
+private:
+    Profiler::EventID mID;
+};
 } // namespace Falcor
 
 #if FALCOR_ENABLE_PROFILER
@@ -306,7 +495,13 @@ private:
     Falcor::ScopedProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(_pRenderContext, _name)
 #define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags) \
     Falcor::ScopedProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(_pRenderContext, _name, _flags)
+/// Low-overhead CPU-only profiler event. The name is interned once per call site, so it must be constant.
+/// Can be used on any thread.
+#define FALCOR_PROFILE_CPU(_name) \
+    static const Falcor::Profiler::EventID FALCOR_CONCAT_STRINGS(_profileEventID, __LINE__) = Falcor::Profiler::internName(_name); \
+    Falcor::ScopedCpuProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(FALCOR_CONCAT_STRINGS(_profileEventID, __LINE__))
 #else
 #define FALCOR_PROFILE(_pRenderContext, _name)
 #define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags)
+#define FALCOR_PROFILE_CPU(_name)
 #endif
@@ -653,7 +653,7 @@ namespace Mogwai
         }
 
         // Execute graph.
-        pGraph->getPassesDictionary()[kRenderPassRefreshFlags] = RenderPassRefreshFlags::None;
+        pGraph->getPassesDictionary().setValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
         pGraph->execute(pRenderContext);
     }
 
@@ -130,7 +130,7 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
     {
         // Query refresh flags passed down from the application and other passes.
         auto& dict = renderData.getDictionary();
-        auto refreshFlags = dict.getValue(kRenderPassRefreshFlags, RenderPassRefreshFlags::None);
+        auto refreshFlags = dict.getValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
 
         // If any refresh flag is set, we reset frame accumulation.
         if (refreshFlags != RenderPassRefreshFlags::None)
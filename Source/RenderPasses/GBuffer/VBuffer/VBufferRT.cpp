@@ -112,7 +112,7 @@ void VBufferRT::execute(RenderContext* pRenderContext, const RenderData& renderD
         mComputeDOF = mUseDOF && mpScene->getCamera()->getApertureRadius() > 0.f;
         if (mUseDOF)
         {
-            renderData.getDictionary()[Falcor::kRenderPassPRNGDimension] = mComputeDOF ? 2u : 0u;
+            renderData.getDictionary().setValue(Falcor::kRenderPassPRNGDimensionKey, mComputeDOF ? 2u : 0u);
         }
 
         mUseTraceRayInline ? executeCompute(pRenderContext, renderData) : executeRaytrace(pRenderContext, renderData);
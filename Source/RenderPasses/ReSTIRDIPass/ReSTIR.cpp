@@ -697,10 +697,10 @@ bool ReSTIRDIPass::beginFrame(RenderContext* pRenderContext, const RenderData& r
         if (mOptionsChanged)
         {
             auto& dict = renderData.getDictionary();
-            auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
+            auto flags = dict.getValue(kRenderPassRefreshFlagsKey, Falcor::RenderPassRefreshFlags::None);
             if (mOptionsChanged)
                 flags |= Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
-            dict[Falcor::kRenderPassRefreshFlags] = flags;
+            dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags);
         }
         return false;
     }
@@ -715,12 +715,12 @@ bool ReSTIRDIPass::beginFrame(RenderContext* pRenderContext, const RenderData& r
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged || lightingChanged)
     {
-        auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, Falcor::RenderPassRefreshFlags::None);
         if (mOptionsChanged)
             flags |= Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
         if (lightingChanged)
             flags |= Falcor::RenderPassRefreshFlags::LightingChanged;
-        dict[Falcor::kRenderPassRefreshFlags] = flags;
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags);
         mOptionsChanged = false;
     }
 
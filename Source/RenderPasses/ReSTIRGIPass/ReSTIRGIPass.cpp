@@ -1284,9 +1284,9 @@ bool ReSTIRGIPass::beginFrame(RenderContext* pRenderContext, const RenderData& r
         if (mOptionsChanged)
         {
             auto& dict = renderData.getDictionary();
-            auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
+            auto flags = dict.getValue(kRenderPassRefreshFlagsKey, Falcor::RenderPassRefreshFlags::None);
             if (mOptionsChanged) flags |= Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
-            dict[Falcor::kRenderPassRefreshFlags] = flags;
+            dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags);
         }
 
         return false;
@@ -1306,15 +1306,15 @@ bool ReSTIRGIPass::beginFrame(RenderContext* pRenderContext, const RenderData& r
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged || lightingChanged)
     {
-        auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, Falcor::RenderPassRefreshFlags::None);
         if (mOptionsChanged) flags |= Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
         if (lightingChanged) flags |= Falcor::RenderPassRefreshFlags::LightingChanged;
-        dict[Falcor::kRenderPassRefreshFlags] = flags;
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags);
         mOptionsChanged = false;
     }
 
     // Check if GBuffer has adjusted shading normals enabled.
-    bool gbufferAdjustShadingNormals = dict.getValue(Falcor::kRenderPassGBufferAdjustShadingNormals, false);
+    bool gbufferAdjustShadingNormals = dict.getValue(Falcor::kRenderPassGBufferAdjustShadingNormalsKey, false);
     if (gbufferAdjustShadingNormals != mGBufferAdjustShadingNormals)
     {
         mGBufferAdjustShadingNormals = gbufferAdjustShadingNormals;
@@ -411,16 +411,16 @@ void SceneDebugger::renderPixelDataUI(Gui::Widgets& widget)
             g.text(text);
 
             // Print the list of scene graph nodes affecting this mesh instance.
+            // Instances in instance sets start at the parent node of the set, which may not exist.
             std::vector<NodeID> nodes;
             {
-                NodeID nodeID{instance.globalMatrixID};
+                NodeID nodeID = mpScene->getMatrixNodeID(instance.globalMatrixID);
                 while (nodeID != NodeID::Invalid())
                 {
                     nodes.push_back(nodeID);
                     nodeID = mpScene->getParentNodeID(nodeID);
                 }
             }
-            FALCOR_ASSERT(!nodes.empty());
 
             g.text("Scene graph (root first):");
             const auto& localMatrices = mpScene->getAnimationController()->getLocalMatrices();
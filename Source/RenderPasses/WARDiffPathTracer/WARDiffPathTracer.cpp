@@ -562,10 +562,10 @@ bool WARDiffPathTracer::beginFrame(RenderContext* pRenderContext, const RenderDa
         if (mOptionsChanged)
         {
             auto& dict = renderData.getDictionary();
-            auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
+            auto flags = dict.getValue(kRenderPassRefreshFlagsKey, Falcor::RenderPassRefreshFlags::None);
             if (mOptionsChanged)
                 flags |= Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
-            dict[Falcor::kRenderPassRefreshFlags] = flags;
+            dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags);
         }
 
         return false;
@@ -581,12 +581,12 @@ bool WARDiffPathTracer::beginFrame(RenderContext* pRenderContext, const RenderDa
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged || lightingChanged)
     {
-        auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, Falcor::RenderPassRefreshFlags::None);
         if (mOptionsChanged)
             flags |= Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
         if (lightingChanged)
             flags |= Falcor::RenderPassRefreshFlags::LightingChanged;
-        dict[Falcor::kRenderPassRefreshFlags] = flags;
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags);
         mOptionsChanged = false;
     }
 
@@ -131,8 +131,8 @@ void WhittedRayTracer::execute(RenderContext* pRenderContext, const RenderData&
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged)
     {
-        auto flags = dict.getValue(kRenderPassRefreshFlags, RenderPassRefreshFlags::None);
-        dict[Falcor::kRenderPassRefreshFlags] = flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged);
         mOptionsChanged = false;
     }
 
@@ -175,7 +175,7 @@ void WhittedRayTracer::execute(RenderContext* pRenderContext, const RenderData&
     // Set constants.
     auto var = mTracer.pVars->getRootVar();
     var["CB"]["gFrameCount"] = mFrameCount;
-    var["CB"]["gPRNGDimension"] = dict.keyExists(kRenderPassPRNGDimension) ? dict[kRenderPassPRNGDimension] : 0u;
+    var["CB"]["gPRNGDimension"] = dict.getValue(kRenderPassPRNGDimensionKey, 0u);
     // Set up screen space pixel angle for texture LOD using ray cones
     var["CB"]["gScreenSpacePixelSpreadAngle"] = mpScene->getCamera()->computeScreenSpacePixelSpreadAngle(targetDim.y);
 
@@ -56,6 +56,14 @@ int runMain(int argc, char** argv)
     args::ValueFlag<std::string> tagFilterFlag(parser, "tags", "Filter test cases by tags.", {'t', "tags"});
     args::ValueFlag<std::string> xmlReportFlag(parser, "path", "XML report output file.", {'x', "xml-report"});
     args::ValueFlag<uint32_t> repeatFlag(parser, "N", "Number of times to repeat the test.", {'r', "repeat"});
+    args::Flag benchmarkFlag(parser, "", "Run benchmarks instead of tests.", {'b', "benchmark"});
+    args::ValueFlag<std::string> benchmarkReportFlag(parser, "path", "Benchmark JSON report output file.", {"benchmark-report"});
+    args::ValueFlag<std::string> benchmarkBaselineFlag(parser, "path", "Benchmark JSON report to compare against.", {"benchmark-baseline"});
+    args::ValueFlag<double> benchmarkThresholdFlag(
+        parser, "fraction", "Relative slowdown against the baseline reported as failure (default: 0.1).", {"benchmark-threshold"}
+    );
+    args::ValueFlag<uint32_t> benchmarkSamplesFlag(parser, "N", "Number of samples per benchmark (default: 21).", {"benchmark-samples"});
+    args::ValueFlag<double> benchmarkMinTimeFlag(parser, "ms", "Minimum duration of a benchmark sample (default: 10).", {"benchmark-min-time"});
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag enableAftermathFlag(parser, "", "Enable Aftermath GPU crash dump.", {"enable-aftermath"});
 
@@ -129,6 +137,18 @@ int runMain(int argc, char** argv)
         options.parallel = args::get(parallelFlag);
     if (repeatFlag)
         options.repeat = args::get(repeatFlag);
+    if (benchmarkFlag)
+        options.benchmark = true;
+    if (benchmarkReportFlag)
+        options.benchmarkOptions.reportPath = args::get(benchmarkReportFlag);
+    if (benchmarkBaselineFlag)
+        options.benchmarkOptions.baselinePath = args::get(benchmarkBaselineFlag);
+    if (benchmarkThresholdFlag)
+        options.benchmarkOptions.regressionThreshold = args::get(benchmarkThresholdFlag);
+    if (benchmarkSamplesFlag)
+        options.benchmarkOptions.sampleCount = args::get(benchmarkSamplesFlag);
+    if (benchmarkMinTimeFlag)
+        options.benchmarkOptions.minSampleMS = args::get(benchmarkMinTimeFlag);
 
     if (listTestSuites || listTestCases || listTags)
     {
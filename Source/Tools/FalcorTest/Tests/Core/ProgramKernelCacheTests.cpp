@@ -0,0 +1,164 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Program/ProgramKernelCache.h"
+
+#include <fstream>
+#include <string>
+
+namespace Falcor
+{
+namespace
+{
+ProgramKernelCache::Key makeKey(const std::string& str)
+{
+    return SHA1::compute(str.data(), str.size());
+}
+
+std::vector<uint8_t> makeData(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++)
+        data[i] = uint8_t(seed + i * 7);
+    return data;
+}
+} // namespace
+
+CPU_TEST(ProgramKernelCache_GetSet)
+{
+    const std::filesystem::path directory = "test_kernel_cache_1";
+    std::filesystem::remove_all(directory);
+
+    {
+        ProgramKernelCache cache(directory, 0);
+        std::vector<uint8_t> data;
+
+        EXPECT_FALSE(cache.get(makeKey("a"), data));
+        EXPECT(data.empty());
+
+        const auto dataA = makeData(1000, 1);
+        const auto dataB = makeData(10, 2);
+        cache.set(makeKey("a"), dataA.data(), dataA.size());
+        cache.set(makeKey("b"), dataB.data(), dataB.size());
+
+        EXPECT_TRUE(cache.get(makeKey("a"), data));
+        EXPECT(data == dataA);
+        EXPECT_TRUE(cache.get(makeKey("b"), data));
+        EXPECT(data == dataB);
+
+        // Replace an entry.
+        cache.set(makeKey("a"), dataB.data(), dataB.size());
+        EXPECT_TRUE(cache.get(makeKey("a"), data));
+        EXPECT(data == dataB);
+
+        auto stats = cache.getStats();
+        EXPECT_EQ(stats.hitCount, 3);
+        EXPECT_EQ(stats.missCount, 1);
+        EXPECT_EQ(stats.writeCount, 3);
+    }
+
+    // Entries persist across instances.
+    {
+        ProgramKernelCache cache(directory, 0);
+        std::vector<uint8_t> data;
+        EXPECT_TRUE(cache.get(makeKey("b"), data));
+        EXPECT(data == makeData(10, 2));
+
+        cache.clear();
+        EXPECT_FALSE(cache.get(makeKey("b"), data));
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(ProgramKernelCache_Corruption)
+{
+    const std::filesystem::path directory = "test_kernel_cache_2";
+    std::filesystem::remove_all(directory);
+
+    ProgramKernelCache cache(directory, 0);
+    const auto data = makeData(100, 3);
+    cache.set(makeKey("a"), data.data(), data.size());
+
+    // Corrupt the last byte of the entry.
+    const auto path = directory / (SHA1::toString(makeKey("a")) + ".kernel");
+    ASSERT_TRUE(std::filesystem::exists(path));
+    {
+        std::fstream fs(path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        fs.seekp(-1, std::ios_base::end);
+        fs.put('x');
+    }
+
+    std::vector<uint8_t> result;
+    EXPECT_FALSE(cache.get(makeKey("a"), result));
+    EXPECT_FALSE(std::filesystem::exists(path));
+    EXPECT_EQ(cache.getStats().corruptCount, 1);
+
+    // Truncated entries are detected as well.
+    cache.set(makeKey("a"), data.data(), data.size());
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 10);
+    EXPECT_FALSE(cache.get(makeKey("a"), result));
+    EXPECT_EQ(cache.getStats().corruptCount, 2);
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(ProgramKernelCache_Eviction)
+{
+    const std::filesystem::path directory = "test_kernel_cache_3";
+    std::filesystem::remove_all(directory);
+
+    // Each entry is slightly larger than 1000 bytes, so at most four entries fit.
+    ProgramKernelCache cache(directory, 4500);
+    std::vector<uint8_t> data;
+
+    for (int i = 0; i < 4; i++)
+    {
+        const auto entry = makeData(1000, uint8_t(i));
+        cache.set(makeKey(std::to_string(i)), entry.data(), entry.size());
+        // Make sure modification times are distinct.
+        auto path = directory / (SHA1::toString(makeKey(std::to_string(i))) + ".kernel");
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - std::chrono::seconds(100 - i));
+    }
+    EXPECT_EQ(cache.getStats().evictionCount, 0);
+
+    // Use entry 0, which makes entry 1 the least recently used.
+    EXPECT_TRUE(cache.get(makeKey("0"), data));
+
+    // Adding another entry evicts the least recently used entries.
+    const auto entry = makeData(1000, 4);
+    cache.set(makeKey("4"), entry.data(), entry.size());
+    EXPECT_GT(cache.getStats().evictionCount, 0);
+
+    EXPECT_TRUE(cache.get(makeKey("0"), data));
+    EXPECT_FALSE(cache.get(makeKey("1"), data));
+    EXPECT_TRUE(cache.get(makeKey("4"), data));
+
+    std::filesystem::remove_all(directory);
+}
+} // namespace Falcor
@@ -0,0 +1,167 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Program/ProgramManager.h"
+
+namespace Falcor
+{
+namespace
+{
+const char kShader[] =
+    "RWStructuredBuffer<uint> result;\n"
+    "[numthreads(1, 1, 1)]\n"
+    "void main(uint3 threadID : SV_DispatchThreadID)\n"
+    "{\n"
+    "    result[threadID.x] = VALUE;\n"
+    "}\n";
+
+const char kBrokenShader[] = "void main() { undefinedFunction(); }\n";
+
+ProgramManager::CompileRequest createRequest(const char* source, const std::string& value)
+{
+    ProgramManager::CompileRequest request;
+    request.desc.addShaderModule().addString(source, "ProgramManagerTests.cs.slang");
+    request.desc.csEntry("main");
+    request.defineList.add("VALUE", value);
+    return request;
+}
+} // namespace
+
+GPU_TEST(ProgramManagerCompileAsync)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ProgramManager* pProgramManager = pDevice->getProgramManager();
+
+    std::vector<ProgramManager::CompileRequest> requests = {
+        createRequest(kShader, "1"),
+        createRequest(kShader, "2"),
+        createRequest(kShader, "1"),
+    };
+    auto futures = pProgramManager->compileProgramsAsync(requests);
+    ASSERT_EQ(futures.size(), requests.size());
+
+    ref<Program> pProgram0 = futures[0].get();
+    ref<Program> pProgram1 = futures[1].get();
+    ref<Program> pProgram2 = futures[2].get();
+    ASSERT(pProgram0 && pProgram1 && pProgram2);
+
+    // Each request gets its own program, but identical in-flight requests share the compiled version.
+    EXPECT(pProgram0 != pProgram2);
+    EXPECT(pProgram0 != pProgram1);
+    EXPECT(pProgram0->getActiveVersion() == pProgram2->getActiveVersion());
+    EXPECT(pProgram0->getActiveVersion() != pProgram1->getActiveVersion());
+    EXPECT_EQ(pProgram1->getDefines().at("VALUE"), "2");
+
+    // The kernels are linked on the workers and shared as well.
+    pProgramManager->resetCompilationStats();
+    auto pKernels0 = pProgram0->getActiveVersion()->getKernels(pDevice.get(), nullptr);
+    auto pKernels2 = pProgram2->getActiveVersion()->getKernels(pDevice.get(), nullptr);
+    EXPECT(pKernels0 && pKernels0 == pKernels2);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programKernelsCount, 0u);
+
+    // The shared version stays valid when one of its programs is released.
+    const ProgramVersion* pSharedVersion = pProgram2->getActiveVersion().get();
+    pProgram0 = nullptr;
+    EXPECT(pSharedVersion->getProgram() != nullptr);
+
+    // Compilation errors are reported through the future.
+    auto failedFutures = pProgramManager->compileProgramsAsync({createRequest(kBrokenShader, "0")});
+    ASSERT_EQ(failedFutures.size(), 1u);
+    bool threw = false;
+    try
+    {
+        failedFutures[0].get();
+    }
+    catch (const std::exception&)
+    {
+        threw = true;
+    }
+    EXPECT(threw);
+}
+
+GPU_TEST(ProgramManagerPrewarm)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ProgramManager* pProgramManager = pDevice->getProgramManager();
+
+    auto request = createRequest(kShader, "3");
+    ref<Program> pProgram = Program::create(pDevice, request.desc, request.defineList);
+
+    // Prewarming installs a compiled version, so first use compiles nothing.
+    pProgramManager->prewarmPrograms();
+    pProgramManager->resetCompilationStats();
+    ASSERT(pProgram->getActiveVersion() != nullptr);
+    EXPECT(pProgram->getActiveVersion()->getKernels(pDevice.get(), nullptr) != nullptr);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, 0u);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programKernelsCount, 0u);
+}
+
+CPU_TEST(DefineListHash)
+{
+    DefineList a{{"A", "1"}, {"B", "2"}};
+    DefineList b;
+    b.add("B", "2").add("A", "1");
+    EXPECT_EQ(a.getHash(), b.getHash());
+
+    // The hash can be updated incrementally.
+    uint64_t hash = a.getHash() - DefineList::hashDefine("A", "1") + DefineList::hashDefine("A", "3");
+    a.add("A", "3");
+    EXPECT_EQ(a.getHash(), hash);
+    EXPECT_NE(a.getHash(), b.getHash());
+
+    hash -= DefineList::hashDefine("B", "2");
+    a.remove("B");
+    EXPECT_EQ(a.getHash(), hash);
+    EXPECT_EQ(DefineList().getHash(), 0u);
+}
+
+GPU_TEST(ProgramVersionReuse)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ProgramManager* pProgramManager = pDevice->getProgramManager();
+
+    auto request = createRequest(kShader, "1");
+    ref<Program> pProgram = Program::create(pDevice, request.desc, request.defineList);
+    auto pVersion1 = pProgram->getActiveVersion();
+
+    EXPECT(pProgram->addDefine("VALUE", "2"));
+    EXPECT(pProgram->addDefine("EXTRA"));
+    auto pVersion2 = pProgram->getActiveVersion();
+    EXPECT(pVersion1 != pVersion2);
+
+    // Switching back to previous defines reuses the existing program versions.
+    pProgramManager->resetCompilationStats();
+    EXPECT(pProgram->removeDefine("EXTRA"));
+    EXPECT(pProgram->addDefine("VALUE", "1"));
+    EXPECT(pProgram->getActiveVersion() == pVersion1);
+    EXPECT(pProgram->setDefines(DefineList{{"VALUE", "2"}, {"EXTRA", ""}}));
+    EXPECT(pProgram->getActiveVersion() == pVersion2);
+    EXPECT(!pProgram->addDefines(DefineList{{"EXTRA", ""}}));
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, 0u);
+}
+} // namespace Falcor
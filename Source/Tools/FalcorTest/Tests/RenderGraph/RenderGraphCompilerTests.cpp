@@ -0,0 +1,101 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Core/Plugin.h"
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraph.h"
+
+namespace Falcor
+{
+GPU_TEST(RenderGraphIncrementalCompile)
+{
+    PluginManager::instance().loadPluginByName("DebugPasses");
+
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    ref<Fbo> pTargetFbo = Fbo::create2D(pDevice, 4, 4, ResourceFormat::BGRA8UnormSrgb);
+    ref<Texture> pInput = pDevice->createTexture2D(4, 4, ResourceFormat::R32Float, 1, 1);
+
+    auto addPass = [&](ref<RenderGraph> pGraph, const std::string& name)
+    {
+        ref<RenderPass> pPass = RenderPass::create("InvalidPixelDetectionPass", pDevice);
+        if (!pPass)
+            FALCOR_THROW("Could not create render pass 'InvalidPixelDetectionPass'");
+        pGraph->addPass(pPass, name);
+        pGraph->setInput(name + ".src", pInput);
+        pGraph->markOutput(name + ".dst");
+    };
+
+    ref<RenderGraph> pGraph = RenderGraph::create(pDevice, "Incremental Compile");
+    addPass(pGraph, "A");
+    pGraph->onResize(pTargetFbo.get());
+
+    // Initial compilation compiles everything.
+    EXPECT(pGraph->compile(pRenderContext));
+    const RenderGraphExe::CompileReport* pReport = pGraph->getCompileReport();
+    ASSERT(pReport != nullptr);
+    EXPECT_EQ(pReport->compiledPasses.size(), 1u);
+    EXPECT_EQ(pReport->skippedPassCount, 0u);
+    EXPECT_EQ(pReport->allocatedResources.size(), 1u);
+    EXPECT_EQ(pReport->reusedResourceCount, 0u);
+    ref<Resource> pOutputA = pGraph->getOutput("A.dst");
+
+    // Adding an unconnected pass only compiles the new pass and keeps the existing resources.
+    addPass(pGraph, "B");
+    EXPECT(pGraph->compile(pRenderContext));
+    pReport = pGraph->getCompileReport();
+    ASSERT(pReport != nullptr);
+    ASSERT_EQ(pReport->compiledPasses.size(), 1u);
+    EXPECT_EQ(pReport->compiledPasses[0], "B");
+    EXPECT_EQ(pReport->skippedPassCount, 1u);
+    ASSERT_EQ(pReport->allocatedResources.size(), 1u);
+    EXPECT_EQ(pReport->allocatedResources[0], "B.dst");
+    EXPECT_EQ(pReport->reusedResourceCount, 1u);
+    EXPECT(pGraph->getOutput("A.dst") == pOutputA);
+
+    // Resizing to the same size recompiles all passes, but reuses all resources.
+    pGraph->onResize(pTargetFbo.get());
+    EXPECT(pGraph->compile(pRenderContext));
+    pReport = pGraph->getCompileReport();
+    ASSERT(pReport != nullptr);
+    EXPECT_EQ(pReport->compiledPasses.size(), 2u);
+    EXPECT_EQ(pReport->allocatedResources.size(), 0u);
+    EXPECT_EQ(pReport->reusedResourceCount, 2u);
+    EXPECT(pGraph->getOutput("A.dst") == pOutputA);
+
+    // Resizing to a different size reallocates all resources.
+    ref<Fbo> pLargerFbo = Fbo::create2D(pDevice, 8, 8, ResourceFormat::BGRA8UnormSrgb);
+    pGraph->onResize(pLargerFbo.get());
+    EXPECT(pGraph->compile(pRenderContext));
+    pReport = pGraph->getCompileReport();
+    ASSERT(pReport != nullptr);
+    EXPECT_EQ(pReport->allocatedResources.size(), 2u);
+    EXPECT_EQ(pReport->reusedResourceCount, 0u);
+    EXPECT(pGraph->getOutput("A.dst") != pOutputA);
+}
+} // namespace Falcor
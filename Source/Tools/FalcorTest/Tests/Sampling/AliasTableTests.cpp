@@ -1,5 +1,5 @@
 /***************************************************************************
- # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
  #
  # Redistribution and use in source and binary forms, with or without
  # modification, are permitted provided that the following conditions
@@ -27,6 +27,8 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Sampling/AliasTable.h"
+#include "Utils/Sampling/AliasTableBuilder.h"
+#include "Utils/Sampling/SumTree.h"
 
 #include <hypothesis/hypothesis.h>
 
@@ -137,8 +139,112 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
         }
     }
 }
+
+std::vector<float> generateWeights(uint32_t N, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> uniform;
+    std::vector<float> weights(N);
+    for (auto& w : weights)
+        w = uniform(rng);
+    return weights;
+}
+
+void testAliasTableBuilder(CPUUnitTestContext& ctx, const std::vector<float>& weights, bool parallel)
+{
+    const size_t N = weights.size();
+    AliasTableData table = AliasTableBuilder::build(weights, parallel);
+    ASSERT_EQ(table.entries.size(), N);
+
+    double weightSum = 0.0;
+    for (float w : weights)
+        weightSum += w;
+    EXPECT_LE(std::abs(table.weightSum - weightSum), 1e-9 * weightSum);
+
+    // Compute the exact probability of each item from the table and compare to the normalized weights.
+    std::vector<double> pdf(N, 0.0);
+    for (size_t i = 0; i < N; ++i)
+    {
+        const auto& entry = table.entries[i];
+        EXPECT(entry.threshold >= 0.f && entry.threshold <= 1.f);
+        ASSERT_LT(entry.alias, N);
+        pdf[i] += entry.threshold / double(N);
+        pdf[entry.alias] += (1.0 - entry.threshold) / double(N);
+    }
+    for (size_t i = 0; i < N; ++i)
+    {
+        double expected = weightSum > 0.0 ? weights[i] / weightSum : 1.0 / double(N);
+        EXPECT_LE(std::abs(pdf[i] - expected), 1e-6 * expected + 1e-12) << "i=" << i;
+    }
+}
 } // namespace
 
+CPU_TEST(AliasTableBuilder)
+{
+    std::mt19937 rng;
+
+    for (bool parallel : {false, true})
+    {
+        testAliasTableBuilder(ctx, {1.f}, parallel);
+        testAliasTableBuilder(ctx, {1.f, 2.f}, parallel);
+        testAliasTableBuilder(ctx, {0.f, 0.f, 0.f}, parallel);
+        testAliasTableBuilder(ctx, generateWeights(1000, rng), parallel);
+
+        // Use a count that is not a multiple of the chunk size.
+        uint32_t N = uint32_t(AliasTableBuilder::kChunkSize) * 5 + 17;
+        std::vector<float> weights = generateWeights(N, rng);
+        testAliasTableBuilder(ctx, weights, parallel);
+
+        // Put all the weight in the last chunk so that most items are paired in the merge step.
+        for (uint32_t i = 0; i < N; ++i)
+            weights[i] = i + AliasTableBuilder::kChunkSize < N ? 0.f : weights[i];
+        testAliasTableBuilder(ctx, weights, parallel);
+    }
+
+    // Read the weights from an array of structs.
+    struct Item
+    {
+        uint32_t id;
+        float weight;
+    };
+    std::vector<Item> items = {{0, 1.f}, {1, 0.f}, {2, 3.f}};
+    AliasTableData table = AliasTableBuilder::build(&items[0].weight, items.size(), sizeof(Item));
+    EXPECT_EQ(table.weightSum, 4.0);
+    EXPECT_EQ(table.entries[1].threshold, 0.f);
+}
+
+CPU_TEST(SumTree)
+{
+    SumTree tree({1.f, 0.f, 3.f, 0.f, 4.f});
+    EXPECT_EQ(tree.getCount(), 5u);
+    EXPECT_EQ(tree.getWeightSum(), 8.0);
+
+    // Sampling maps u to the item whose CDF interval contains u.
+    EXPECT_EQ(tree.sample(0.0), 0u);
+    EXPECT_EQ(tree.sample(0.12), 0u);
+    EXPECT_EQ(tree.sample(0.13), 2u);
+    EXPECT_EQ(tree.sample(0.49), 2u);
+    EXPECT_EQ(tree.sample(0.51), 4u);
+    EXPECT_EQ(tree.sample(0.999999), 4u);
+    EXPECT_EQ(tree.evalPdf(2), 3.0 / 8.0);
+    EXPECT_EQ(tree.evalPdf(3), 0.0);
+
+    // Update weights.
+    tree.setWeight(4, 0.f);
+    tree.setWeight(1, 4.f);
+    EXPECT_EQ(tree.getWeightSum(), 8.0);
+    EXPECT_EQ(tree.getWeight(1), 4.f);
+    EXPECT_EQ(tree.sample(0.2), 1u);
+    EXPECT_EQ(tree.sample(0.999999), 2u);
+
+    // All weights zero samples uniformly.
+    tree.build(nullptr, 0);
+    EXPECT_EQ(tree.getCount(), 0u);
+    SumTree zeroTree({0.f, 0.f});
+    EXPECT_EQ(zeroTree.sample(0.25), 0u);
+    EXPECT_EQ(zeroTree.sample(0.75), 1u);
+    EXPECT_EQ(zeroTree.evalPdf(1), 0.5);
+}
+
 GPU_TEST(AliasTable)
 {
     testAliasTable(ctx, 1, {1.f});
@@ -146,4 +252,51 @@ GPU_TEST(AliasTable)
     testAliasTable(ctx, 100);
     testAliasTable(ctx, 1000);
 }
+
+CPU_BENCHMARK(AliasTableConstruction)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    for (uint32_t N : {1000u, 1000000u})
+    {
+        std::mt19937 rng;
+        std::uniform_real_distribution<float> uniform;
+        std::vector<float> weights(N);
+        for (auto& w : weights)
+            w = uniform(rng);
+
+        ctx.setItemsPerIteration(N);
+        ctx.run(std::to_string(N), [&]() { AliasTable aliasTable(pDevice, weights, rng); });
+    }
+}
+
+CPU_BENCHMARK(WeightedSamplingConstruction)
+{
+    for (uint32_t N : {1000u, 1000000u})
+    {
+        std::mt19937 rng;
+        std::vector<float> weights = generateWeights(N, rng);
+        const std::string suffix = "/" + std::to_string(N);
+
+        ctx.setItemsPerIteration(N);
+        ctx.run("aliasTableSerial" + suffix, [&]() { AliasTableBuilder::build(weights, false); });
+        ctx.run("aliasTableParallel" + suffix, [&]() { AliasTableBuilder::build(weights, true); });
+        ctx.run("sumTree" + suffix, [&]() { SumTree tree(weights); });
+
+        // Per-frame update of 1% of the weights.
+        SumTree tree(weights);
+        std::uniform_int_distribution<uint32_t> index(0, N - 1);
+        std::uniform_real_distribution<float> uniform;
+        const uint32_t updateCount = std::max(1u, N / 100);
+        ctx.setItemsPerIteration(updateCount);
+        ctx.run(
+            "sumTreeUpdate" + suffix,
+            [&]()
+            {
+                for (uint32_t i = 0; i < updateCount; ++i)
+                    tree.setWeight(index(rng), uniform(rng));
+            }
+        );
+    }
+}
 } // namespace Falcor
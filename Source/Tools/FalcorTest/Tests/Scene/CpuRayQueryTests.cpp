@@ -0,0 +1,193 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/CpuRayQuery.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+
+#include <memory>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Reference ray/triangle intersection (Moller-Trumbore). Returns the hit distance or infinity.
+float intersectTriangle(const Ray& ray, const float3& v0, const float3& v1, const float3& v2)
+{
+    float3 e1 = v1 - v0;
+    float3 e2 = v2 - v0;
+    float3 p = cross(ray.dir, e2);
+    float det = dot(e1, p);
+    if (det == 0.f)
+        return std::numeric_limits<float>::infinity();
+    float invDet = 1.f / det;
+    float3 s = ray.origin - v0;
+    float u = dot(s, p) * invDet;
+    float3 q = cross(s, e1);
+    float v = dot(ray.dir, q) * invDet;
+    float t = dot(e2, q) * invDet;
+    if (u < 0.f || v < 0.f || u + v > 1.f || t < ray.tMin || t > ray.tMax)
+        return std::numeric_limits<float>::infinity();
+    return t;
+}
+
+CpuRayQuery::MeshDesc createRandomMesh(std::mt19937& rng, uint32_t triangleCount)
+{
+    std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+    CpuRayQuery::MeshDesc mesh;
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        float3 center(uniform(rng), uniform(rng), uniform(rng));
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            mesh.positions.push_back(center + 0.1f * float3(uniform(rng), uniform(rng), uniform(rng)));
+            mesh.indices.push_back(i * 3 + j);
+        }
+    }
+    return mesh;
+}
+} // namespace
+
+CPU_TEST(CpuRayQuery)
+{
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+
+    // Two meshes, one indexed and one non-indexed, with three instances.
+    std::vector<CpuRayQuery::MeshDesc> meshes;
+    meshes.push_back(createRandomMesh(rng, 1000));
+    meshes.push_back(createRandomMesh(rng, 100));
+    meshes[1].indices.clear();
+
+    std::vector<CpuRayQuery::InstanceDesc> instances = {
+        {0, 10, float4x4::identity()},
+        {1, 20, math::matrixFromTranslation(float3(2.f, 0.f, 0.f))},
+        {0, 30, mul(math::matrixFromTranslation(float3(0.f, 3.f, 0.f)), math::matrixFromScaling(float3(0.5f)))},
+    };
+
+    CpuRayQuery rayQuery(meshes, instances, CpuRayQuery::Options());
+    EXPECT_EQ(rayQuery.getStats().triangleCount, 1000u + 100u);
+    EXPECT_EQ(rayQuery.getStats().instanceCount, 3u);
+
+    std::vector<Ray> rays;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        float3 origin = float3(uniform(rng), uniform(rng), uniform(rng)) * 4.f;
+        float3 target = float3(uniform(rng) + 1.f, uniform(rng) + 1.f, uniform(rng));
+        rays.emplace_back(origin, normalize(target - origin));
+    }
+
+    std::vector<CpuRayQuery::Hit> hits(rays.size());
+    rayQuery.traceRays(rays.data(), hits.data(), rays.size());
+    std::unique_ptr<bool[]> visible(new bool[rays.size()]);
+    rayQuery.traceVisibilityRays(rays.data(), visible.get(), rays.size());
+
+    uint32_t hitCount = 0;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        const Ray& ray = rays[i];
+
+        // Brute force reference.
+        float refT = std::numeric_limits<float>::infinity();
+        uint32_t refInstanceID = CpuRayQuery::kInvalidIndex;
+        uint32_t refPrimitiveIndex = CpuRayQuery::kInvalidIndex;
+        for (const auto& instance : instances)
+        {
+            const auto& mesh = meshes[instance.meshIndex];
+            const bool indexed = !mesh.indices.empty();
+            uint32_t triangleCount = (uint32_t)(indexed ? mesh.indices.size() : mesh.positions.size()) / 3;
+            for (uint32_t t = 0; t < triangleCount; ++t)
+            {
+                float3 v[3];
+                for (uint32_t j = 0; j < 3; ++j)
+                    v[j] = transformPoint(instance.transform, mesh.positions[indexed ? mesh.indices[t * 3 + j] : t * 3 + j]);
+                float hitT = intersectTriangle(ray, v[0], v[1], v[2]);
+                if (hitT < refT)
+                {
+                    refT = hitT;
+                    refInstanceID = instance.instanceID;
+                    refPrimitiveIndex = t;
+                }
+            }
+        }
+
+        const auto& hit = hits[i];
+        EXPECT_EQ(hit.isValid(), refInstanceID != CpuRayQuery::kInvalidIndex) << "ray " << i;
+        EXPECT_EQ(visible[i], !hit.isValid()) << "ray " << i;
+        if (hit.isValid() && refInstanceID != CpuRayQuery::kInvalidIndex)
+        {
+            ++hitCount;
+            EXPECT_EQ(hit.instanceID, refInstanceID) << "ray " << i;
+            EXPECT_EQ(hit.primitiveIndex, refPrimitiveIndex) << "ray " << i;
+            EXPECT_LE(std::abs(hit.t - refT), 1e-4f * std::max(1.f, refT)) << "ray " << i;
+        }
+    }
+    EXPECT_GT(hitCount, 0u);
+
+    // Moving the instances away should result in misses.
+    std::vector<float4x4> transforms(instances.size(), math::matrixFromTranslation(float3(100.f)));
+    rayQuery.setInstanceTransforms(transforms);
+    EXPECT_FALSE(rayQuery.traceRay(rays[0]).isValid());
+}
+
+GPU_TEST(CpuRayQueryFromScene)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Two unit cubes, centered at the origin and at (3, 0, 0).
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::DontMergeMeshes);
+    auto pMaterial = StandardMaterial::create(pDevice, "Material");
+    MeshID meshID = builder.addTriangleMesh(TriangleMesh::createCube(float3(1.f)), pMaterial);
+    for (float x : {0.f, 3.f})
+    {
+        SceneBuilder::Node node;
+        node.name = "Cube";
+        node.transform = math::matrixFromTranslation(float3(x, 0.f, 0.f));
+        builder.addMeshInstance(builder.addNode(node), meshID);
+    }
+    ref<Scene> pScene = builder.getScene();
+
+    CpuRayQuery rayQuery(*pScene, CpuRayQuery::Options());
+    EXPECT_EQ(rayQuery.getStats().instanceCount, 2u);
+    EXPECT_EQ(rayQuery.getStats().triangleCount, 12u * pScene->getMeshCount());
+
+    // Rays along -z hit the front face of each cube at z = 0.5 and miss in between.
+    CpuRayQuery::Hit hit0 = rayQuery.traceRay(Ray(float3(0.1f, 0.2f, 5.f), float3(0.f, 0.f, -1.f)));
+    CpuRayQuery::Hit hit1 = rayQuery.traceRay(Ray(float3(3.1f, -0.2f, 5.f), float3(0.f, 0.f, -1.f)));
+    EXPECT(hit0.isValid());
+    EXPECT(hit1.isValid());
+    EXPECT_LE(std::abs(hit0.t - 4.5f), 1e-5f);
+    EXPECT_LE(std::abs(hit1.t - 4.5f), 1e-5f);
+    EXPECT_LT(hit0.instanceID, pScene->getGeometryInstanceCount());
+    EXPECT_LT(hit1.instanceID, pScene->getGeometryInstanceCount());
+    EXPECT_NE(hit0.instanceID, hit1.instanceID);
+    EXPECT_FALSE(rayQuery.traceRay(Ray(float3(1.5f, 0.f, 5.f), float3(0.f, 0.f, -1.f))).isValid());
+    EXPECT(rayQuery.traceVisibilityRay(Ray(float3(0.f, 0.f, 5.f), float3(0.f, 0.f, -1.f))));
+}
+} // namespace Falcor
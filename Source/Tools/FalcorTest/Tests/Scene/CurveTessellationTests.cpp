@@ -0,0 +1,434 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Curves/CurveTessellation.h"
+#include "Utils/Math/CubicSpline.h"
+#include "Utils/Math/MathConstants.slangh"
+#include "Utils/Math/MathHelpers.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Quaternion.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kSubdivPerSegment = 4;
+const uint32_t kPointCountPerCrossSection = 4;
+
+struct Curves
+{
+    std::vector<uint32_t> vertexCounts;
+    std::vector<float3> controlPoints;
+    std::vector<float> widths;
+    std::vector<float2> UVs;
+    std::vector<uint32_t> pointOffsets;
+};
+
+/** Generate random strands, some with repeated control points.
+*/
+Curves generateCurves(uint32_t strandCount)
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> u(-1.f, 1.f);
+
+    Curves curves;
+    for (uint32_t i = 0; i < strandCount; i++)
+    {
+        uint32_t vertexCount = 2 + rng() % 10;
+        curves.vertexCounts.push_back(vertexCount);
+        curves.pointOffsets.push_back((uint32_t)curves.controlPoints.size());
+
+        float3 p(u(rng), u(rng), u(rng));
+        for (uint32_t j = 0; j < vertexCount; j++)
+        {
+            // Repeat the previous control point once in a while, but always keep the first and last ones distinct.
+            if (j == 0 || j == vertexCount - 1 || rng() % 4 != 0)
+                p += float3(0.1f * u(rng), 0.1f, 0.1f * u(rng));
+            curves.controlPoints.push_back(p);
+            curves.widths.push_back(0.01f + 0.005f * u(rng));
+            curves.UVs.push_back(float2(u(rng), u(rng)));
+        }
+    }
+    return curves;
+}
+
+template<typename T>
+void expectEqual(CPUUnitTestContext& ctx, const fast_vector<T>& result, const std::vector<T>& expected, const char* name)
+{
+    ASSERT_EQ(result.size(), expected.size()) << name;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT(all(result[i] == expected[i])) << name << " i=" << i;
+    }
+}
+
+void expectEqual(CPUUnitTestContext& ctx, const fast_vector<uint32_t>& result, const std::vector<uint32_t>& expected, const char* name)
+{
+    ASSERT_EQ(result.size(), expected.size()) << name;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(result[i], expected[i]) << name << " i=" << i;
+    }
+}
+
+void expectEqual(CPUUnitTestContext& ctx, const fast_vector<float>& result, const std::vector<float>& expected, const char* name)
+{
+    ASSERT_EQ(result.size(), expected.size()) << name;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(result[i], expected[i]) << name << " i=" << i;
+    }
+}
+
+/** Serial reference tessellation, kept from the implementation before strands were tessellated in parallel.
+    Every sample is evaluated with a separate CubicSpline::interpolate() call.
+*/
+struct ReferenceStrand
+{
+    std::vector<float3> controlPoints;
+    std::vector<float> widths;
+    std::vector<float2> UVs;
+};
+
+float sanitizeWidth(float w)
+{
+    return std::max(w, (float)std::numeric_limits<float16_t>::min());
+}
+
+ReferenceStrand removeDuplicates(const Curves& curves, uint32_t pointOffset, uint32_t vertexCount)
+{
+    ReferenceStrand strand;
+    for (uint32_t j = 0; j < vertexCount - 1; j++)
+    {
+        if (any(curves.controlPoints[pointOffset + j] != curves.controlPoints[pointOffset + j + 1]))
+        {
+            strand.controlPoints.push_back(curves.controlPoints[pointOffset + j]);
+            strand.widths.push_back(curves.widths[pointOffset + j]);
+            strand.UVs.push_back(curves.UVs[pointOffset + j]);
+        }
+    }
+    strand.controlPoints.push_back(curves.controlPoints[pointOffset + vertexCount - 1]);
+    strand.widths.push_back(curves.widths[pointOffset + vertexCount - 1]);
+    strand.UVs.push_back(curves.UVs[pointOffset + vertexCount - 1]);
+    return strand;
+}
+
+template<typename T>
+void sampleSpline(const CubicSpline<T>& spline, uint32_t controlPointCount, uint32_t keepOneEveryXVerticesPerStrand, std::vector<T>& results)
+{
+    uint32_t tmpCount = 0;
+    for (uint32_t j = 0; j < controlPointCount - 1; j++)
+    {
+        for (uint32_t k = 0; k < kSubdivPerSegment; k++)
+        {
+            if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
+                results.push_back(spline.interpolate(j, (float)k / (float)kSubdivPerSegment));
+            tmpCount++;
+        }
+    }
+
+    // Always keep the last vertex.
+    results.push_back(spline.interpolate(controlPointCount - 2, 1.f));
+}
+
+struct ReferenceSweptSphere
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> points;
+    std::vector<float> radius;
+    std::vector<float2> texCrds;
+};
+
+ReferenceSweptSphere referenceLinearSweptSphere(const Curves& curves, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, const float4x4& xform)
+{
+    ReferenceSweptSphere result;
+    const float scale = std::sqrt(xform[0][0] * xform[0][0] + xform[0][1] * xform[0][1] + xform[0][2] * xform[0][2]);
+    for (uint32_t i = 0; i < curves.vertexCounts.size(); i += keepOneEveryXStrands)
+    {
+        ReferenceStrand strand = removeDuplicates(curves, curves.pointOffsets[i], curves.vertexCounts[i]);
+        uint32_t count = (uint32_t)strand.controlPoints.size();
+
+        std::vector<float3> points;
+        std::vector<float> widths;
+        sampleSpline(CubicSpline<float3>(strand.controlPoints.data(), count), count, keepOneEveryXVerticesPerStrand, points);
+        sampleSpline(CubicSpline<float>(strand.widths.data(), count), count, keepOneEveryXVerticesPerStrand, widths);
+        sampleSpline(CubicSpline<float2>(strand.UVs.data(), count), count, keepOneEveryXVerticesPerStrand, result.texCrds);
+
+        for (size_t j = 0; j < points.size(); j++)
+        {
+            if (j + 1 < points.size())
+                result.indices.push_back((uint32_t)result.points.size());
+            result.points.push_back(transformPoint(xform, points[j]));
+            result.radius.push_back(sanitizeWidth(widths[j] * 0.5f) * scale);
+        }
+    }
+    return result;
+}
+
+struct ReferenceMesh
+{
+    std::vector<float3> vertices;
+    std::vector<float3> normals;
+    std::vector<float4> tangents;
+    std::vector<float2> texCrds;
+    std::vector<float> radii;
+    std::vector<uint32_t> faceVertexCounts;
+    std::vector<uint32_t> faceVertexIndices;
+};
+
+void updateCurveFrame(const std::vector<float3>& controlPoints, float3& fwd, float3& s, float3& t, uint32_t j)
+{
+    float3 prevFwd;
+    if (j <= 0 || j >= controlPoints.size() || controlPoints.size() == 2)
+    {
+        prevFwd = fwd;
+    }
+    else if (j == 1)
+    {
+        prevFwd = normalize(controlPoints[j] - controlPoints[j - 1]);
+        fwd = normalize(controlPoints[j + 1] - controlPoints[j - 1]);
+    }
+    else if (j < controlPoints.size() - 2)
+    {
+        prevFwd = normalize(controlPoints[j] - controlPoints[j - 2]);
+        fwd = normalize(controlPoints[j + 1] - controlPoints[j - 1]);
+    }
+    else if (j == controlPoints.size() - 1)
+    {
+        prevFwd = normalize(controlPoints[j] - controlPoints[j - 2]);
+        fwd = normalize(controlPoints[j] - controlPoints[j - 1]);
+    }
+
+    quatf rotQuat = math::quatFromRotationBetweenVectors(prevFwd, fwd);
+    s = mul(rotQuat, s);
+    t = normalize(cross(fwd, s));
+    s = normalize(cross(t, fwd));
+}
+
+ReferenceMesh referencePolytube(const Curves& curves, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand)
+{
+    // Curves tessellated to quad-tubes are widened by 1.11 to match the curve width on average.
+    const float kMeshCompensationScale = 1.11f;
+
+    ReferenceMesh result;
+    uint32_t meshVertexOffset = 0;
+    for (uint32_t i = 0; i < curves.vertexCounts.size(); i += keepOneEveryXStrands)
+    {
+        ReferenceStrand strand = removeDuplicates(curves, curves.pointOffsets[i], curves.vertexCounts[i]);
+        uint32_t count = (uint32_t)strand.controlPoints.size();
+
+        std::vector<float3> points;
+        std::vector<float> widths;
+        std::vector<float2> UVs;
+        sampleSpline(CubicSpline<float3>(strand.controlPoints.data(), count), count, keepOneEveryXVerticesPerStrand, points);
+        sampleSpline(CubicSpline<float>(strand.widths.data(), count), count, keepOneEveryXVerticesPerStrand, widths);
+        sampleSpline(CubicSpline<float2>(strand.UVs.data(), count), count, keepOneEveryXVerticesPerStrand, UVs);
+        for (float& w : widths)
+            w = sanitizeWidth(kMeshCompensationScale * w);
+
+        float3 fwd = normalize(points[1] - points[0]);
+        float3 s, t;
+        buildFrame(fwd, s, t);
+
+        const uint32_t n = kPointCountPerCrossSection;
+        for (uint32_t j = 0; j < points.size(); j++)
+        {
+            updateCurveFrame(points, fwd, s, t, j);
+
+            for (uint32_t k = 0; k < n; k++)
+            {
+                float phi = (float)k / (float)n * (float)M_PI * 2.f;
+                float3 vNormal = std::cos(phi) * s + std::sin(phi) * t;
+                float curveRadius = 0.5f * widths[j];
+                result.vertices.push_back(points[j] + curveRadius * vNormal);
+                result.normals.push_back(vNormal);
+                result.tangents.push_back(float4(fwd.x, fwd.y, fwd.z, 1));
+                result.radii.push_back(curveRadius);
+                result.texCrds.push_back(UVs[j]);
+            }
+
+            if (j < points.size() - 1)
+            {
+                for (uint32_t k = 0; k < n; k++)
+                {
+                    uint32_t base = meshVertexOffset + j * n;
+                    result.faceVertexCounts.push_back(3);
+                    result.faceVertexIndices.push_back(base + k);
+                    result.faceVertexIndices.push_back(base + (k + 1) % n);
+                    result.faceVertexIndices.push_back(base + n + (k + 1) % n);
+
+                    result.faceVertexCounts.push_back(3);
+                    result.faceVertexIndices.push_back(base + k);
+                    result.faceVertexIndices.push_back(base + n + (k + 1) % n);
+                    result.faceVertexIndices.push_back(base + n + k);
+                }
+            }
+        }
+        meshVertexOffset += n * (uint32_t)points.size();
+    }
+    return result;
+}
+
+template<typename T>
+void append(std::vector<T>& dst, const fast_vector<T>& src)
+{
+    dst.insert(dst.end(), src.begin(), src.end());
+}
+
+void appendIndices(std::vector<uint32_t>& dst, const fast_vector<uint32_t>& src, uint32_t indexOffset)
+{
+    for (uint32_t index : src)
+        dst.push_back(index + indexOffset);
+}
+} // namespace
+
+CPU_TEST(CubicSplineBatchInterpolate)
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> u(-1.f, 1.f);
+    std::vector<float3> points(8);
+    for (auto& p : points)
+        p = float3(u(rng), u(rng), u(rng));
+
+    CubicSpline<float3> spline(points.data(), (uint32_t)points.size());
+
+    std::vector<float> params = {0.f, 0.1f, 0.25f, 0.5f, 0.75f, 0.9f, 1.f};
+    std::vector<float3> results(params.size());
+    for (uint32_t section = 0; section < points.size() - 1; section++)
+    {
+        spline.interpolate(section, params.data(), (uint32_t)params.size(), results.data());
+        for (size_t i = 0; i < params.size(); i++)
+        {
+            EXPECT(all(results[i] == spline.interpolate(section, params[i]))) << "section=" << section << " i=" << i;
+        }
+    }
+}
+
+CPU_TEST(CurveTessellationSweptSphere)
+{
+    // Tessellating all strands at once (in parallel) must give the same result as tessellating them one by one and concatenating.
+    const uint32_t strandCount = 1000;
+    const Curves curves = generateCurves(strandCount);
+    const float4x4 xform = mul(math::matrixFromTranslation(float3(1.f, 2.f, 3.f)), math::matrixFromScaling(float3(2.f)));
+
+    for (uint32_t keepOneEveryXVerticesPerStrand : {1u, 3u})
+    {
+        auto result = CurveTessellation::convertToLinearSweptSphere(
+            strandCount, curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), curves.UVs.data(),
+            1, kSubdivPerSegment, 2, keepOneEveryXVerticesPerStrand, 1.f, xform
+        );
+
+        std::vector<uint32_t> indices;
+        std::vector<float3> points;
+        std::vector<float> radius;
+        std::vector<float2> texCrds;
+        for (uint32_t i = 0; i < strandCount; i += 2)
+        {
+            uint32_t offset = curves.pointOffsets[i];
+            auto strand = CurveTessellation::convertToLinearSweptSphere(
+                1, &curves.vertexCounts[i], &curves.controlPoints[offset], &curves.widths[offset], &curves.UVs[offset],
+                1, kSubdivPerSegment, 1, keepOneEveryXVerticesPerStrand, 1.f, xform
+            );
+            EXPECT_EQ(strand.indices.size() + 1, strand.points.size());
+            appendIndices(indices, strand.indices, (uint32_t)points.size());
+            append(points, strand.points);
+            append(radius, strand.radius);
+            append(texCrds, strand.texCrds);
+        }
+
+        expectEqual(ctx, result.indices, indices, "indices");
+        expectEqual(ctx, result.points, points, "points");
+        expectEqual(ctx, result.radius, radius, "radius");
+        expectEqual(ctx, result.texCrds, texCrds, "texCrds");
+
+        // The result must also match the serial reference tessellation.
+        ReferenceSweptSphere reference = referenceLinearSweptSphere(curves, 2, keepOneEveryXVerticesPerStrand, xform);
+        expectEqual(ctx, result.indices, reference.indices, "reference indices");
+        expectEqual(ctx, result.points, reference.points, "reference points");
+        expectEqual(ctx, result.radius, reference.radius, "reference radius");
+        expectEqual(ctx, result.texCrds, reference.texCrds, "reference texCrds");
+    }
+}
+
+CPU_TEST(CurveTessellationPolytube)
+{
+    // Tessellating all strands at once (in parallel) must give the same result as tessellating them one by one and concatenating.
+    const uint32_t strandCount = 1000;
+    const Curves curves = generateCurves(strandCount);
+
+    for (uint32_t keepOneEveryXVerticesPerStrand : {1u, 3u})
+    {
+        auto result = CurveTessellation::convertToPolytube(
+            strandCount, curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), curves.UVs.data(), kSubdivPerSegment,
+            2, keepOneEveryXVerticesPerStrand, 1.f, kPointCountPerCrossSection
+        );
+
+        std::vector<float3> vertices;
+        std::vector<float3> normals;
+        std::vector<float4> tangents;
+        std::vector<float2> texCrds;
+        std::vector<float> radii;
+        std::vector<uint32_t> faceVertexCounts;
+        std::vector<uint32_t> faceVertexIndices;
+        for (uint32_t i = 0; i < strandCount; i += 2)
+        {
+            uint32_t offset = curves.pointOffsets[i];
+            auto strand = CurveTessellation::convertToPolytube(
+                1, &curves.vertexCounts[i], &curves.controlPoints[offset], &curves.widths[offset], &curves.UVs[offset], kSubdivPerSegment, 1,
+                keepOneEveryXVerticesPerStrand, 1.f, kPointCountPerCrossSection
+            );
+            appendIndices(faceVertexIndices, strand.faceVertexIndices, (uint32_t)vertices.size());
+            append(vertices, strand.vertices);
+            append(normals, strand.normals);
+            append(tangents, strand.tangents);
+            append(texCrds, strand.texCrds);
+            append(radii, strand.radii);
+            append(faceVertexCounts, strand.faceVertexCounts);
+        }
+
+        expectEqual(ctx, result.vertices, vertices, "vertices");
+        expectEqual(ctx, result.normals, normals, "normals");
+        expectEqual(ctx, result.tangents, tangents, "tangents");
+        expectEqual(ctx, result.texCrds, texCrds, "texCrds");
+        expectEqual(ctx, result.radii, radii, "radii");
+        expectEqual(ctx, result.faceVertexCounts, faceVertexCounts, "faceVertexCounts");
+        expectEqual(ctx, result.faceVertexIndices, faceVertexIndices, "faceVertexIndices");
+
+        // The result must also match the serial reference tessellation.
+        ReferenceMesh reference = referencePolytube(curves, 2, keepOneEveryXVerticesPerStrand);
+        expectEqual(ctx, result.vertices, reference.vertices, "reference vertices");
+        expectEqual(ctx, result.normals, reference.normals, "reference normals");
+        expectEqual(ctx, result.tangents, reference.tangents, "reference tangents");
+        expectEqual(ctx, result.texCrds, reference.texCrds, "reference texCrds");
+        expectEqual(ctx, result.radii, reference.radii, "reference radii");
+        expectEqual(ctx, result.faceVertexCounts, reference.faceVertexCounts, "reference faceVertexCounts");
+        expectEqual(ctx, result.faceVertexIndices, reference.faceVertexIndices, "reference faceVertexIndices");
+    }
+}
+} // namespace Falcor
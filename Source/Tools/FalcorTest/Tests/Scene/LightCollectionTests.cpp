@@ -0,0 +1,111 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Lights/LightCollection.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+const float3 kEmissiveA = float3(1.f, 0.5f, 0.25f);
+const float3 kEmissiveB = float3(0.5f, 1.f, 2.f);
+const float3 kUpdatedEmissiveA = float3(3.f, 0.f, 1.f);
+
+/** Build a scene with two emissive quads, using materials "A" and "B".
+*/
+ref<Scene> buildScene(ref<Device> pDevice, const float3& emissiveA, ref<StandardMaterial>* ppMaterialA = nullptr)
+{
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::None);
+    auto pQuad = TriangleMesh::createQuad(float2(1.f));
+
+    ref<StandardMaterial> pMaterialA = StandardMaterial::create(pDevice, "A");
+    pMaterialA->setEmissiveColor(emissiveA);
+    ref<StandardMaterial> pMaterialB = StandardMaterial::create(pDevice, "B");
+    pMaterialB->setEmissiveColor(kEmissiveB);
+    if (ppMaterialA)
+        *ppMaterialA = pMaterialA;
+
+    NodeID nodeA = builder.addNode({"A", math::matrixFromTranslation(float3(-1.f, 0.f, 0.f)), float4x4::identity()});
+    NodeID nodeB = builder.addNode({"B", math::matrixFromTranslation(float3(1.f, 0.f, 0.f)), float4x4::identity()});
+    builder.addMeshInstance(nodeA, builder.addTriangleMesh(pQuad, pMaterialA));
+    builder.addMeshInstance(nodeB, builder.addTriangleMesh(pQuad, pMaterialB));
+    return builder.getScene();
+}
+} // namespace
+
+GPU_TEST(LightCollectionEmissiveUpdate)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    ref<StandardMaterial> pMaterialA;
+    ref<Scene> pScene = buildScene(pDevice, kEmissiveA, &pMaterialA);
+    pScene->update(pRenderContext, 0.0);
+    ref<LightCollection> pLightCollection = pScene->getLightCollection(pRenderContext);
+    ASSERT(pLightCollection != nullptr);
+    ASSERT_EQ(pLightCollection->getTotalLightCount(), 4u);
+
+    ILightCollection::UpdateFlags updateFlags = ILightCollection::UpdateFlags::None;
+    sigs::Connection connection =
+        pLightCollection->getUpdateFlagsSignal().connect([&](ILightCollection::UpdateFlags flags) { updateFlags |= flags; });
+
+    // Changing the emission of a material updates the flux of its triangles in place.
+    pMaterialA->setEmissiveColor(kUpdatedEmissiveA);
+    pScene->update(pRenderContext, 0.0);
+    EXPECT(pScene->getLightCollection(pRenderContext) == pLightCollection);
+    EXPECT(is_set(updateFlags, ILightCollection::UpdateFlags::FluxChanged));
+
+    // Only the two triangles of the quad using material A are re-integrated.
+    uint32_t changedTriangleCount = 0;
+    for (const auto& range : pLightCollection->getChangedTriangleRanges())
+        changedTriangleCount += range.count;
+    EXPECT_EQ(changedTriangleCount, 2u);
+
+    // The updated flux matches a light collection built with the new emission from the start.
+    ref<Scene> pReferenceScene = buildScene(pDevice, kUpdatedEmissiveA);
+    pReferenceScene->update(pRenderContext, 0.0);
+    const auto& triangles = pLightCollection->getMeshLightTriangles(pRenderContext);
+    const auto& referenceTriangles = pReferenceScene->getLightCollection(pRenderContext)->getMeshLightTriangles(pRenderContext);
+    ASSERT_EQ(triangles.size(), referenceTriangles.size());
+    for (size_t i = 0; i < triangles.size(); i++)
+    {
+        const float tolerance = 1e-5f * std::max(1.f, referenceTriangles[i].flux);
+        EXPECT_LE(std::abs(triangles[i].flux - referenceTriangles[i].flux), tolerance) << "i=" << i;
+        for (uint32_t c = 0; c < 3; c++)
+            EXPECT_LE(std::abs(triangles[i].averageRadiance[c] - referenceTriangles[i].averageRadiance[c]), 1e-5f) << "i=" << i;
+    }
+
+    // The active triangle list is finalized by a later update once the flux has been read back.
+    pRenderContext->submit(true);
+    pScene->update(pRenderContext, 0.0);
+    EXPECT_EQ(pLightCollection->getActiveLightCount(pRenderContext), 4u);
+}
+} // namespace Falcor
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Core/AssetResolver.h"
+#include "Core/Platform/OS.h"
 #include "Scene/Material/MERLFile.h"
 #include "Scene/Material/MERLMaterialData.slang"
 
@@ -37,8 +38,12 @@ GPU_TEST(MERLFile)
     // TODO: This is not ideal, we should only access files in the runtime directory.
     const std::filesystem::path path = getProjectDirectory() / "media/test_scenes/materials/data/gray-lambert.binary";
 
+    // Keep the cache files out of the source tree.
+    const std::filesystem::path cacheDirectory = getTempFilePath();
+    std::filesystem::create_directories(cacheDirectory);
+
     MERLFile merlFile;
-    bool result = merlFile.loadBRDF(path);
+    bool result = merlFile.loadBRDF(path, cacheDirectory);
     ASSERT(result);
 
     const auto desc = merlFile.getDesc();
@@ -46,15 +51,30 @@ GPU_TEST(MERLFile)
 
     const auto data = merlFile.getData();
     EXPECT_EQ(data.size(), 90 * 90 * 360 / 2);
+    EXPECT_EQ(desc.hash.size(), 40);
+
+    // The converted data is cached in the cache directory.
+    EXPECT(std::filesystem::is_regular_file(cacheDirectory / "gray-lambert.merl16"));
+
+    // Loading the same BRDF again shares the data.
+    {
+        MERLFile merlFile2(path, cacheDirectory);
+        EXPECT_EQ(merlFile2.getDesc().hash, desc.hash);
+        EXPECT_EQ(merlFile2.getData().data(), data.data());
+    }
 
+    // Albedo is computed from fp16 samples.
     const float3 expected = float3(0.5f);
+    const float epsilon = 1e-3f;
     auto lut = merlFile.prepareAlbedoLUT(ctx.getDevice());
     EXPECT_EQ(lut.size(), MERLMaterialData::kAlbedoLUTSize);
     for (auto v : lut)
     {
-        EXPECT_EQ(v.x, expected.x);
-        EXPECT_EQ(v.y, expected.y);
-        EXPECT_EQ(v.z, expected.z);
+        EXPECT_LE(std::abs(v.x - expected.x), epsilon);
+        EXPECT_LE(std::abs(v.y - expected.y), epsilon);
+        EXPECT_LE(std::abs(v.z - expected.z), epsilon);
     }
+
+    std::filesystem::remove_all(cacheDirectory);
 }
 } // namespace Falcor
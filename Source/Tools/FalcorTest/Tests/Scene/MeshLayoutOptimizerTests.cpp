@@ -0,0 +1,158 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/MeshLayoutOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kGridSize = 64;
+const uint32_t kGridVertexCount = (kGridSize + 1) * (kGridSize + 1);
+
+/** Create a regular grid of triangles and shuffle the triangle order.
+*/
+std::vector<uint32_t> createShuffledGrid()
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < kGridSize; y++)
+    {
+        for (uint32_t x = 0; x < kGridSize; x++)
+        {
+            uint32_t i = y * (kGridSize + 1) + x;
+            triangles.push_back({i, i + 1, i + kGridSize + 2});
+            triangles.push_back({i, i + kGridSize + 2, i + kGridSize + 1});
+        }
+    }
+
+    std::mt19937 rng(0);
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+
+    std::vector<uint32_t> indices;
+    for (const auto& t : triangles)
+        indices.insert(indices.end(), t.begin(), t.end());
+    return indices;
+}
+
+/** Get the sorted list of triangles, with the vertices of each triangle rotated so that the winding is preserved.
+*/
+std::vector<std::array<uint32_t, 3>> getSortedTriangles(const std::vector<uint32_t>& indices)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<uint32_t, 3> t = {indices[i], indices[i + 1], indices[i + 2]};
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        triangles.push_back(t);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+} // namespace
+
+CPU_TEST(MeshLayoutOptimizerAnalyze)
+{
+    // Single strip of triangles sharing edges. With a large enough cache every vertex is transformed once.
+    std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5};
+    auto stats = MeshLayoutOptimizer::analyzeVertexCache(indices.data(), (uint32_t)indices.size(), 6, 16);
+    EXPECT_EQ(stats.triangleCount, 4u);
+    EXPECT_EQ(stats.vertexCount, 6u);
+    EXPECT_EQ(stats.cacheMissCount, 6u);
+    EXPECT_EQ(stats.getACMR(), 1.5f);
+    EXPECT_EQ(stats.getATVR(), 1.f);
+
+    // With a cache of a single entry, only consecutive references hit.
+    stats = MeshLayoutOptimizer::analyzeVertexCache(indices.data(), (uint32_t)indices.size(), 6, 1);
+    EXPECT_EQ(stats.cacheMissCount, 10u);
+}
+
+CPU_TEST(MeshLayoutOptimizerVertexCache)
+{
+    const std::vector<uint32_t> input = createShuffledGrid();
+    std::vector<uint32_t> indices = input;
+    MeshLayoutOptimizer::optimizeVertexCache(indices.data(), (uint32_t)indices.size(), kGridVertexCount);
+
+    EXPECT(getSortedTriangles(indices) == getSortedTriangles(input));
+
+    auto before = MeshLayoutOptimizer::analyzeVertexCache(input.data(), (uint32_t)input.size(), kGridVertexCount);
+    auto after = MeshLayoutOptimizer::analyzeVertexCache(indices.data(), (uint32_t)indices.size(), kGridVertexCount);
+    EXPECT_GT(before.getACMR(), 2.5f);
+    EXPECT_LT(after.getACMR(), 0.8f);
+    EXPECT_LT(after.getATVR(), 1.6f);
+}
+
+CPU_TEST(MeshLayoutOptimizerMeshlets)
+{
+    const std::vector<uint32_t> input = createShuffledGrid();
+    std::vector<uint32_t> indices = input;
+    const uint32_t maxVertices = 64;
+    const uint32_t maxTriangles = 124;
+    auto meshlets = MeshLayoutOptimizer::buildMeshlets(indices.data(), (uint32_t)indices.size(), kGridVertexCount, maxVertices, maxTriangles);
+
+    EXPECT(getSortedTriangles(indices) == getSortedTriangles(input));
+
+    // Meshlets cover the index buffer in order and respect the limits.
+    uint32_t triangleOffset = 0;
+    for (const auto& meshlet : meshlets)
+    {
+        EXPECT_EQ(meshlet.triangleOffset, triangleOffset);
+        EXPECT_LE(meshlet.triangleCount, maxTriangles);
+        EXPECT_LE(meshlet.vertexCount, maxVertices);
+
+        std::vector<uint32_t> vertices(indices.begin() + 3 * meshlet.triangleOffset, indices.begin() + 3 * (meshlet.triangleOffset + meshlet.triangleCount));
+        std::sort(vertices.begin(), vertices.end());
+        EXPECT_EQ((uint32_t)(std::unique(vertices.begin(), vertices.end()) - vertices.begin()), meshlet.vertexCount);
+
+        triangleOffset += meshlet.triangleCount;
+    }
+    EXPECT_EQ(triangleOffset, indices.size() / 3);
+
+    auto after = MeshLayoutOptimizer::analyzeVertexCache(indices.data(), (uint32_t)indices.size(), kGridVertexCount);
+    EXPECT_LT(after.getACMR(), 1.f);
+}
+
+CPU_TEST(MeshLayoutOptimizerVertexFetch)
+{
+    // Vertex 4 is unreferenced.
+    const std::vector<uint32_t> input = {3, 5, 1, 1, 5, 0, 2, 3, 1};
+    std::vector<uint32_t> indices = input;
+    auto vertexOrder = MeshLayoutOptimizer::optimizeVertexFetch(indices.data(), (uint32_t)indices.size(), 6);
+
+    EXPECT(vertexOrder == std::vector<uint32_t>({3, 5, 1, 0, 2, 4}));
+    EXPECT(indices == std::vector<uint32_t>({0, 1, 2, 2, 1, 3, 4, 0, 2}));
+    for (size_t i = 0; i < indices.size(); i++)
+        EXPECT_EQ(vertexOrder[indices[i]], input[i]);
+
+    std::vector<float> vertices = {0.f, 1.f, 2.f, 3.f, 4.f, 5.f};
+    MeshLayoutOptimizer::applyVertexOrder(vertices, vertexOrder);
+    EXPECT(vertices == std::vector<float>({3.f, 5.f, 1.f, 0.f, 2.f, 4.f}));
+}
+} // namespace Falcor
@@ -0,0 +1,140 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Plugin.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/ImporterError.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+namespace Falcor
+{
+namespace
+{
+/// Returns a trianglemesh shape with the given number of separate triangles at depth z.
+std::string createTriangleMesh(uint32_t triangleCount, float z)
+{
+    std::string P, indices;
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        P += fmt::format("{} 0 {} {} 0 {} {} 1 {} ", i, z, i + 1, z, i, z);
+        indices += fmt::format("{} {} {} ", i * 3, i * 3 + 1, i * 3 + 2);
+    }
+    return fmt::format("Shape \"trianglemesh\" \"point3 P\" [ {}] \"integer indices\" [ {}]\n", P, indices);
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& text)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    file.write(text.data(), text.size());
+}
+
+/// Returns the triangle counts of all meshes in the scene, sorted.
+std::vector<uint32_t> getTriangleCounts(const Scene& scene)
+{
+    std::vector<uint32_t> counts;
+    for (uint32_t i = 0; i < scene.getMeshCount(); ++i)
+        counts.push_back(scene.getMesh(MeshID(i)).getTriangleCount());
+    std::sort(counts.begin(), counts.end());
+    return counts;
+}
+} // namespace
+
+GPU_TEST(PBRTImporterIncludeImport)
+{
+    PluginManager::instance().loadPluginByName("PBRTImporter");
+
+    std::filesystem::path dir = getTempFilePath();
+    std::filesystem::create_directories(dir);
+
+    // The root file includes 'a.pbrt', which includes 'c.pbrt', and imports 'b.pbrt'.
+    // The transform set in the imported file must not leak into the root file.
+    writeFile(dir / "a.pbrt", createTriangleMesh(2, 0.f) + "Include \"c.pbrt\"\n");
+    writeFile(dir / "b.pbrt", "Translate 0 0 -10\n" + createTriangleMesh(4, 0.f));
+    writeFile(dir / "c.pbrt", createTriangleMesh(3, 0.f));
+    writeFile(
+        dir / "root.pbrt",
+        "WorldBegin\n"
+        "Include \"a.pbrt\"\n"
+        "Import \"b.pbrt\"\n" +
+            createTriangleMesh(1, 20.f)
+    );
+
+    ref<Scene> pScene = SceneBuilder(ctx.getDevice(), dir / "root.pbrt", Settings(), SceneBuilder::Flags::DontMergeMeshes).getScene();
+    ASSERT(pScene != nullptr);
+
+    const std::vector<uint32_t> expectedCounts = {1, 2, 3, 4};
+    EXPECT(getTriangleCounts(*pScene) == expectedCounts);
+    EXPECT_EQ(pScene->getSceneBounds().minPoint.z, -10.f);
+    EXPECT_EQ(pScene->getSceneBounds().maxPoint.z, 20.f);
+
+    // Errors in included files are reported.
+    writeFile(dir / "bad.pbrt", "WorldBegin\nInclude \"missing.pbrt\"\n");
+    EXPECT_THROW_AS(SceneBuilder(ctx.getDevice(), dir / "bad.pbrt", Settings()), ImporterError);
+
+    std::filesystem::remove_all(dir);
+}
+
+GPU_TEST(PBRTImporterParameters)
+{
+    PluginManager::instance().loadPluginByName("PBRTImporter");
+
+    std::filesystem::path dir = getTempFilePath();
+    std::filesystem::create_directories(dir);
+
+    // Parameter lists mixing numeric, string and texture parameters, with quoted strings that look like numbers.
+    writeFile(
+        dir / "params.pbrt",
+        "WorldBegin\n"
+        "Texture \"1\" \"spectrum\" \"constant\" \"rgb value\" [ 0.1 0.2 0.3 ]\n"
+        "MakeNamedMaterial \"0.5\" \"string type\" [ \"diffuse\" ] \"texture reflectance\" [ \"1\" ] \"float displacement\" [ 0 ]\n"
+        "NamedMaterial \"0.5\"\n" +
+            createTriangleMesh(1, 0.f)
+    );
+
+    ref<Scene> pScene = SceneBuilder(ctx.getDevice(), dir / "params.pbrt", Settings()).getScene();
+    ASSERT(pScene != nullptr);
+    auto pMaterial = dynamic_ref_cast<StandardMaterial>(pScene->getMaterialByName("0.5"));
+    ASSERT(pMaterial != nullptr);
+    float3 baseColor = pMaterial->getBaseColor3();
+    EXPECT_LE(std::abs(baseColor.x - 0.1f), 0.02f);
+    EXPECT_LE(std::abs(baseColor.y - 0.2f), 0.02f);
+    EXPECT_LE(std::abs(baseColor.z - 0.3f), 0.02f);
+
+    // Mixing numbers and strings within a single parameter is an error.
+    writeFile(dir / "mixed.pbrt", "WorldBegin\nMakeNamedMaterial \"m\" \"string type\" [ \"diffuse\" 1 ]\n");
+    EXPECT_THROW_AS(SceneBuilder(ctx.getDevice(), dir / "mixed.pbrt", Settings()), ImporterError);
+    writeFile(dir / "mixed2.pbrt", "WorldBegin\nMakeNamedMaterial \"m\" \"string type\" \"diffuse\" \"float roughness\" [ 0.5 \"0.5\" ]\n");
+    EXPECT_THROW_AS(SceneBuilder(ctx.getDevice(), dir / "mixed2.pbrt", Settings()), ImporterError);
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
@@ -0,0 +1,209 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/PLYReader.h"
+#include "Scene/TriangleMesh.h"
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct PLYWriter
+{
+    std::vector<uint8_t> data;
+
+    void header(const std::string& text) { data.insert(data.end(), text.begin(), text.end()); }
+
+    template<typename T>
+    void write(T value)
+    {
+        size_t offset = data.size();
+        data.resize(offset + sizeof(T));
+        std::memcpy(data.data() + offset, &value, sizeof(T));
+    }
+};
+
+const float3 kPositions[5] = {{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}, {1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}, {2.f, 0.f, 0.f}};
+
+/// Writes a mesh with a triangle and a quad. Vertices have positions, an unused property and texture coordinates.
+PLYWriter writeTestMesh(const std::string& format)
+{
+    PLYWriter w;
+    w.header(
+        "ply\n"
+        "format " + format + " 1.0\n"
+        "comment test mesh\n"
+        "element vertex 5\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "property uchar red\n"
+        "property float u\n"
+        "property float v\n"
+        "element face 2\n"
+        "property uchar flags\n"
+        "property list uchar int vertex_indices\n"
+        "element edge 1\n"
+        "property int vertex1\n"
+        "property int vertex2\n"
+        "end_header\n"
+    );
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        w.write(kPositions[i].x);
+        w.write(kPositions[i].y);
+        w.write(kPositions[i].z);
+        w.write(uint8_t(255));
+        w.write(kPositions[i].x * 0.5f);
+        w.write(kPositions[i].y * 0.25f);
+    }
+    // Triangle.
+    w.write(uint8_t(0));
+    w.write(uint8_t(3));
+    for (int32_t i : {1, 4, 2})
+        w.write(i);
+    // Quad.
+    w.write(uint8_t(0));
+    w.write(uint8_t(4));
+    for (int32_t i : {0, 1, 2, 3})
+        w.write(i);
+    // Edge.
+    w.write(int32_t(0));
+    w.write(int32_t(1));
+    return w;
+}
+} // namespace
+
+CPU_TEST(PLYReader)
+{
+    PLYWriter w = writeTestMesh("binary_little_endian");
+    PLYReader::Result result = PLYReader::read(w.data.data(), w.data.size());
+    ASSERT(result.status == PLYReader::Status::Success);
+    EXPECT(!result.hasNormals);
+    EXPECT(result.hasTexCoords);
+
+    ASSERT_EQ(result.vertices.size(), 5);
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        const auto& v = result.vertices[i];
+        EXPECT(all(v.position == kPositions[i]));
+        // Texture coordinates are flipped in v.
+        EXPECT_EQ(v.texCoord.x, kPositions[i].x * 0.5f);
+        EXPECT_EQ(v.texCoord.y, 1.f - kPositions[i].y * 0.25f);
+    }
+
+    const std::vector<uint32_t> expectedIndices = {1, 4, 2, 0, 1, 2, 0, 2, 3};
+    EXPECT(result.indices == expectedIndices);
+
+    // Truncated data is reported as an error.
+    PLYReader::Result truncated = PLYReader::read(w.data.data(), w.data.size() - 20);
+    EXPECT(truncated.status == PLYReader::Status::Error);
+    EXPECT(truncated.vertices.empty());
+
+    // Out of bounds indices are reported as an error.
+    PLYWriter bad = writeTestMesh("binary_little_endian");
+    int32_t invalidIndex = 5;
+    std::memcpy(bad.data.data() + bad.data.size() - 8 - 4, &invalidIndex, sizeof(int32_t));
+    EXPECT(PLYReader::read(bad.data.data(), bad.data.size()).status == PLYReader::Status::Error);
+
+    // ASCII and big-endian files are left to the fallback importer.
+    for (const char* format : {"ascii", "binary_big_endian"})
+    {
+        PLYWriter other = writeTestMesh(format);
+        EXPECT(PLYReader::read(other.data.data(), other.data.size()).status == PLYReader::Status::Unsupported);
+    }
+
+    // Not a PLY file.
+    const char text[] = "solid cube\n";
+    EXPECT(PLYReader::read(text, sizeof(text) - 1).status == PLYReader::Status::Error);
+}
+
+CPU_TEST(PLYReaderPostProcess)
+{
+    // Two triangles with unshared vertices that meet at a 90 degree edge from (0,0,0) to (1,0,0).
+    const float3 positions[6] = {{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {1.f, 0.f, 0.f}, {0.f, 0.f, 0.f}, {0.f, 0.f, 1.f}};
+    PLYWriter w;
+    w.header(
+        "ply\n"
+        "format binary_little_endian 1.0\n"
+        "element vertex 6\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "element face 2\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n"
+    );
+    for (const float3& p : positions)
+    {
+        w.write(p.x);
+        w.write(p.y);
+        w.write(p.z);
+    }
+    for (int32_t t = 0; t < 2; ++t)
+    {
+        w.write(uint8_t(3));
+        for (int32_t i = 0; i < 3; ++i)
+            w.write(t * 3 + i);
+    }
+
+    std::filesystem::path path = getTempFilePath().replace_extension(".ply");
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(w.data.data()), w.data.size());
+    }
+
+    // Smooth normals are averaged over vertices with the same position, as with ASSIMP.
+    auto pSmooth = TriangleMesh::createFromFile(path, TriangleMesh::ImportFlags::GenSmoothNormals);
+    ASSERT(pSmooth != nullptr);
+    ASSERT_EQ(pSmooth->getVertices().size(), 6);
+    const float3 edgeNormal = normalize(float3(0.f, 1.f, 1.f));
+    for (uint32_t i : {0, 1, 3, 4})
+        EXPECT_LE(length(pSmooth->getVertices()[i].normal - edgeNormal), 1e-6f) << "vertex " << i;
+    EXPECT(all(pSmooth->getVertices()[2].normal == float3(0.f, 0.f, 1.f)));
+    EXPECT(all(pSmooth->getVertices()[5].normal == float3(0.f, 1.f, 0.f)));
+
+    // Joining identical vertices welds the edge vertices, which now have identical normals.
+    auto pJoined = TriangleMesh::createFromFile(path, TriangleMesh::ImportFlags::GenSmoothNormals | TriangleMesh::ImportFlags::JoinIdenticalVertices);
+    ASSERT(pJoined != nullptr);
+    EXPECT_EQ(pJoined->getVertices().size(), 4);
+    const std::vector<uint32_t> expectedIndices = {0, 1, 2, 1, 0, 3};
+    EXPECT(pJoined->getIndices() == expectedIndices);
+
+    // Flat normals keep one vertex per triangle corner, even when joining.
+    auto pFlat = TriangleMesh::createFromFile(path, TriangleMesh::ImportFlags::JoinIdenticalVertices);
+    ASSERT(pFlat != nullptr);
+    EXPECT_EQ(pFlat->getVertices().size(), 6);
+
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
@@ -0,0 +1,167 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SDFBrickGrid.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Math/MathConstants.slangh"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<float> generateSphereValues(uint32_t gridWidth, float radius)
+{
+    const uint32_t w = gridWidth + 1;
+    std::vector<float> values(w * w * w);
+    for (uint32_t z = 0; z < w; z++)
+    {
+        for (uint32_t y = 0; y < w; y++)
+        {
+            for (uint32_t x = 0; x < w; x++)
+            {
+                float3 p = float3(x, y, z) / float(gridWidth) - 0.5f;
+                values[x + w * (y + w * z)] = length(p) - radius;
+            }
+        }
+    }
+    return values;
+}
+
+std::vector<int8_t> normalizeValues(const std::vector<float>& values, float normalizationFactor)
+{
+    // Same normalization as the sparse SDF grid types.
+    std::vector<int8_t> result(values.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        float integerScale = std::clamp(values[i] * normalizationFactor, -1.0f, 1.0f) * float(INT8_MAX);
+        result[i] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+    }
+    return result;
+}
+} // namespace
+
+CPU_TEST(SDFBrickGrid)
+{
+    // Use a grid width that is not a multiple of the brick width.
+    const uint32_t gridWidth = 60;
+    const float normalizationFactor = 2.0f * gridWidth / float(M_SQRT3);
+    std::vector<float> values = generateSphereValues(gridWidth, 0.3f);
+    std::vector<int8_t> expected = normalizeValues(values, normalizationFactor);
+
+    SDFBrickGrid::Options options;
+    SDFBrickGrid grid = SDFBrickGrid::createFromValues(values, gridWidth, options);
+    EXPECT_EQ(grid.getGridWidth(), gridWidth);
+    EXPECT_EQ(grid.getBrickGridWidth(), 8u);
+
+    // Only the narrow band is stored.
+    uint32_t brickGridCount = grid.getBrickGridWidth() * grid.getBrickGridWidth() * grid.getBrickGridWidth();
+    EXPECT_GT(grid.getBrickCount(), 0u);
+    EXPECT_LT(grid.getBrickCount(), brickGridCount / 2);
+
+    // Without quantization, the normalized values are identical to normalizing the dense grid.
+    std::vector<int8_t> normalized;
+    grid.getNormalizedValues(normalizationFactor, normalized);
+    EXPECT(normalized == expected);
+
+    // Write and read back, and compare to converting the dense file directly.
+    std::filesystem::path densePath = getTempFilePath();
+    std::filesystem::path sparsePath = getTempFilePath();
+    std::filesystem::path convertedPath = getTempFilePath();
+    {
+        std::ofstream file(densePath, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&gridWidth), sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    }
+    EXPECT(grid.writeToFile(sparsePath));
+    EXPECT(SDFBrickGrid::convertDenseFile(densePath, convertedPath, options));
+    EXPECT(SDFBrickGrid::isBrickGridFile(sparsePath));
+    EXPECT(!SDFBrickGrid::isBrickGridFile(densePath));
+
+    for (const auto& path : {sparsePath, convertedPath})
+    {
+        SDFBrickGrid loaded;
+        ASSERT(loaded.readFromFile(path));
+        EXPECT_EQ(loaded.getBrickCount(), grid.getBrickCount());
+        EXPECT_EQ(loaded.getBandWidth(), grid.getBandWidth());
+        loaded.getNormalizedValues(normalizationFactor, normalized);
+        EXPECT(normalized == expected);
+    }
+
+    // Files with out of range header fields are rejected before anything is allocated.
+    {
+        std::ifstream file(sparsePath, std::ios::in | std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        ASSERT_GE(bytes.size(), 24u);
+
+        // Header fields are the magic, version, grid width, brick width, band width and brick count.
+        auto writePatched = [&](size_t offset, uint32_t value)
+        {
+            std::vector<char> patched = bytes;
+            std::memcpy(patched.data() + offset, &value, sizeof(value));
+            std::ofstream out(convertedPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            out.write(patched.data(), patched.size());
+        };
+
+        // A brick count that is valid for the grid but doesn't fit in the file is rejected as well.
+        const uint32_t extraBrickCount = (uint32_t)grid.getBrickCount() + 1;
+        for (auto [offset, value] : {std::pair<size_t, uint32_t>{8, 0xffffffffu}, {8, 1625}, {12, 0xffffffffu}, {20, 0xffffffffu}, {20, extraBrickCount}})
+        {
+            writePatched(offset, value);
+            SDFBrickGrid corrupt;
+            EXPECT(!corrupt.readFromFile(convertedPath)) << "offset=" << offset << " value=" << value;
+            EXPECT_EQ(corrupt.getBrickCount(), 0u);
+        }
+    }
+
+    std::filesystem::remove(densePath);
+    std::filesystem::remove(sparsePath);
+    std::filesystem::remove(convertedPath);
+
+    // Quantized bricks are within one quantization step of the clamped values.
+    for (auto quantization : {SDFBrickGrid::Quantization::UNorm16, SDFBrickGrid::Quantization::UNorm8})
+    {
+        options.quantization = quantization;
+        SDFBrickGrid quantized = SDFBrickGrid::createFromValues(values, gridWidth, options);
+        EXPECT_EQ(quantized.getBrickCount(), grid.getBrickCount());
+        EXPECT_LT(quantized.getDataSize(), grid.getDataSize());
+
+        std::vector<float> dense;
+        quantized.getDenseValues(dense);
+        float bandWidth = quantized.getBandWidth();
+        float maxError = 2.f * bandWidth / (quantization == SDFBrickGrid::Quantization::UNorm16 ? 65535.f : 255.f);
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            float clamped = std::clamp(values[i], -bandWidth, bandWidth);
+            EXPECT_LE(std::abs(dense[i] - clamped), maxError) << "i=" << i;
+        }
+    }
+}
+} // namespace Falcor
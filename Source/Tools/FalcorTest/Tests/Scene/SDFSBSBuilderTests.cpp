@@ -0,0 +1,248 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SparseBrickSet/SDFSBS.h"
+#include "Scene/SDFs/SparseBrickSet/SDFSBSBuilder.h"
+#include "Utils/Math/MathConstants.slangh"
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kGridWidth = 60;
+const float kRadius = 0.3f;
+
+std::vector<float> generateSphereValues(uint32_t gridWidth, float radius)
+{
+    const uint32_t w = gridWidth + 1;
+    std::vector<float> values(w * w * w);
+    for (uint32_t z = 0; z < w; z++)
+    {
+        for (uint32_t y = 0; y < w; y++)
+        {
+            for (uint32_t x = 0; x < w; x++)
+            {
+                float3 p = float3(x, y, z) / float(gridWidth) - 0.5f;
+                values[x + w * (y + w * z)] = length(p) - radius;
+            }
+        }
+    }
+    return values;
+}
+
+int32_t toSnorm(float value)
+{
+    float integerScale = std::clamp(value, -1.0f, 1.0f) * float(INT8_MAX);
+    return integerScale >= 0.0f ? int32_t(integerScale + 0.5f) : int32_t(integerScale - 0.5f);
+}
+
+/** Fetch a snorm texel from the brick texture.
+*/
+int32_t fetchTexel(const SDFSBSBuilder::Data& data, uint2 texelCoords)
+{
+    if (!data.compressed) return int8_t(data.brickTexture[texelCoords.y * data.brickTextureDimensions.x + texelCoords.x]);
+
+    uint2 blockCoords = texelCoords / 4u;
+    uint64_t compressedBlock;
+    std::memcpy(&compressedBlock, &data.brickTexture[(blockCoords.y * (data.brickTextureDimensions.x / 4) + blockCoords.x) * sizeof(uint64_t)], sizeof(uint64_t));
+    int32_t block[16];
+    SDFSBSBuilder::decompressBC4Block(compressedBlock, block);
+    return block[(texelCoords.y % 4) * 4 + texelCoords.x % 4];
+}
+
+/** Check that the brick set is consistent and that the bricks hold the expected snorm values.
+*/
+void checkBrickSet(CPUUnitTestContext& ctx, const SDFSBSBuilder::Data& data, std::function<int32_t(uint3)> expectedValue, int32_t tolerance)
+{
+    const uint32_t vb = data.virtualBricksPerAxis;
+    const uint32_t brickWidthInValues = data.brickWidth + 1;
+    ASSERT_EQ(data.indirection.size(), vb * vb * vb);
+    ASSERT_EQ(data.brickAABBs.size(), data.brickCount);
+
+    uint32_t nextBrickID = 0;
+    for (uint32_t virtualBrickID = 0; virtualBrickID < data.indirection.size(); virtualBrickID++)
+    {
+        uint32_t brickID = data.indirection[virtualBrickID];
+        if (brickID == std::numeric_limits<uint32_t>::max()) continue;
+
+        // Bricks are assigned IDs in virtual brick order.
+        ASSERT_EQ(brickID, nextBrickID++);
+
+        uint3 brickGridCoords = uint3(virtualBrickID % vb, (virtualBrickID / vb) % vb, virtualBrickID / (vb * vb)) * data.brickWidth;
+        const AABB& aabb = data.brickAABBs[brickID];
+        EXPECT(all(aabb.minPoint >= float3(-0.5f)) && all(aabb.maxPoint <= float3(0.5f)) && all(aabb.minPoint < aabb.maxPoint));
+
+        uint2 brickTextureCoords = uint2(brickID % data.bricksPerAxis.x, brickID / data.bricksPerAxis.x) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues);
+        for (uint32_t z = 0; z < brickWidthInValues; z++)
+        {
+            for (uint32_t y = 0; y < brickWidthInValues; y++)
+            {
+                for (uint32_t x = 0; x < brickWidthInValues; x++)
+                {
+                    uint3 gridCoords = brickGridCoords + uint3(x, y, z);
+                    int32_t expected = any(gridCoords >= data.gridWidth) ? INT8_MAX : expectedValue(gridCoords);
+                    int32_t value = fetchTexel(data, brickTextureCoords + uint2(x + z * brickWidthInValues, y));
+                    EXPECT_LE(std::abs(std::max(value, -INT8_MAX) - std::max(expected, -INT8_MAX)), tolerance) << "brickID = " << brickID;
+                }
+            }
+        }
+    }
+    EXPECT_EQ(nextBrickID, data.brickCount);
+}
+} // namespace
+
+CPU_TEST(SDFSBSBuilderBC4)
+{
+    // Constant blocks are compressed without error.
+    int32_t block[16];
+    int32_t decompressed[16];
+    for (int32_t value : {-128, -37, 0, 1, 127})
+    {
+        std::fill(block, block + 16, value);
+        SDFSBSBuilder::decompressBC4Block(SDFSBSBuilder::compressBC4Block(block), decompressed);
+        for (uint32_t i = 0; i < 16; i++) EXPECT_EQ(std::max(decompressed[i], -INT8_MAX), std::max(value, -INT8_MAX));
+    }
+
+    // The error of random blocks is bounded by the codebook spacing.
+    std::mt19937 rng;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        int32_t base = int32_t(rng() % 256) - 128;
+        int32_t range = int32_t(rng() % 64) + 1;
+        for (uint32_t j = 0; j < 16; j++) block[j] = std::clamp(base + int32_t(rng() % range), -128, 127);
+
+        SDFSBSBuilder::decompressBC4Block(SDFSBSBuilder::compressBC4Block(block), decompressed);
+        for (uint32_t j = 0; j < 16; j++) EXPECT_LE(std::abs(decompressed[j] - block[j]), range / 7 + 2) << "block = " << i;
+    }
+}
+
+CPU_TEST(SDFSBSBuilderFromValues)
+{
+    std::vector<float> values = generateSphereValues(kGridWidth, kRadius);
+    const float normalizationFactor = 2.0f * kGridWidth / float(M_SQRT3);
+    auto expectedValue = [&](uint3 c) { return toSnorm(values[c.x + (kGridWidth + 1) * (c.y + (kGridWidth + 1) * c.z)] * normalizationFactor); };
+
+    for (bool compressed : {false, true})
+    {
+        SDFSBSBuilder::Options options;
+        options.brickWidth = 7;
+        options.compressed = compressed;
+        SDFSBSBuilder::Data data = SDFSBSBuilder::buildFromCornerValues(values, kGridWidth, options);
+
+        EXPECT_EQ(data.gridWidth, kGridWidth);
+        EXPECT_EQ(data.virtualBricksPerAxis, 9u);
+        EXPECT_GT(data.brickCount, 0u);
+        EXPECT_LT(data.brickCount, 9u * 9u * 9u);
+        // The BC4 error is bounded by half the spacing of the 5-value codebook over the full snorm range.
+        checkBrickSet(ctx, data, expectedValue, compressed ? 26 : 0);
+
+        // The parallel build is deterministic.
+        options.parallel = false;
+        SDFSBSBuilder::Data serialData = SDFSBSBuilder::buildFromCornerValues(values, kGridWidth, options);
+        EXPECT(serialData.indirection == data.indirection);
+        EXPECT(serialData.brickTexture == data.brickTexture);
+    }
+}
+
+CPU_TEST(SDFSBSBuilderFromPrimitives)
+{
+    SDF3DPrimitive sphere = {};
+    sphere.shapeType = SDF3DShapeType::Sphere;
+    sphere.shapeData = float3(kRadius);
+    sphere.operationType = SDFOperationType::Union;
+    sphere.translation = float3(0.f);
+    sphere.invRotationScale = float3x3::identity();
+
+    SDFSBSBuilder::Options options;
+    options.brickWidth = 7;
+    SDFSBSBuilder::Data data = SDFSBSBuilder::buildFromPrimitives({sphere}, kGridWidth, options);
+
+    // The grid width is increased to brickWidth * 4^n.
+    EXPECT_EQ(data.virtualBricksPerAxis, 16u);
+    EXPECT_EQ(data.gridWidth, 7u * 16u);
+
+    const float normalizationFactor = 2.0f * data.gridWidth / float(M_SQRT3);
+    auto expectedValue = [&](uint3 c) { return toSnorm((length(float3(c) / float(data.gridWidth) - 0.5f) - kRadius) * normalizationFactor); };
+    checkBrickSet(ctx, data, expectedValue, 1);
+
+    // Without primitives, a single empty brick is created.
+    SDFSBSBuilder::Data emptyData = SDFSBSBuilder::buildFromPrimitives({}, kGridWidth, options);
+    EXPECT_EQ(emptyData.brickCount, 1u);
+    EXPECT_EQ(emptyData.indirection[0], 0u);
+}
+
+GPU_TEST(SDFSBSBuilderMatchesGPU)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+    std::vector<float> values = generateSphereValues(kGridWidth, kRadius);
+
+    for (bool compressed : {false, true})
+    {
+        ref<SDFSBS> pSBS = SDFSBS::create(pDevice, 7, compressed);
+        pSBS->setValues(values, kGridWidth);
+        SDFSBSBuilder::Data data = pSBS->buildBrickSetData();
+        pSBS->createResources(pRenderContext);
+
+        ASSERT_EQ(pSBS->getAABBCount(), data.brickCount);
+
+        std::vector<uint8_t> indirection = pRenderContext->readTextureSubresource(pSBS->getIndirectionTexture().get(), 0);
+        ASSERT_EQ(indirection.size(), data.indirection.size() * sizeof(uint32_t));
+        EXPECT(std::memcmp(indirection.data(), data.indirection.data(), indirection.size()) == 0);
+
+        std::vector<AABB> aabbs = pSBS->getAABBBuffer()->getElements<AABB>(0, data.brickCount);
+        for (uint32_t i = 0; i < data.brickCount; i++)
+        {
+            EXPECT(all(aabbs[i].minPoint == data.brickAABBs[i].minPoint) && all(aabbs[i].maxPoint == data.brickAABBs[i].maxPoint)) << "brickID = " << i;
+        }
+
+        // Compare the texels of all bricks. The brick texture is padded with unused bricks, which are left uninitialized by the GPU.
+        std::vector<uint8_t> bricks = pRenderContext->readTextureSubresource(pSBS->getBrickTexture().get(), 0);
+        ASSERT_EQ(bricks.size(), data.brickTexture.size());
+        const uint32_t brickWidthInValues = 8;
+        const uint32_t texelsPerUnit = compressed ? 4 : 1;
+        const uint32_t bytesPerUnit = compressed ? 8 : 1;
+        const size_t rowPitch = data.brickTextureDimensions.x / texelsPerUnit * bytesPerUnit;
+        for (uint32_t brickID = 0; brickID < data.brickCount; brickID++)
+        {
+            uint2 origin = uint2(brickID % data.bricksPerAxis.x, brickID / data.bricksPerAxis.x) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues) / texelsPerUnit;
+            for (uint32_t row = 0; row < brickWidthInValues / texelsPerUnit; row++)
+            {
+                size_t offset = (origin.y + row) * rowPitch + origin.x * bytesPerUnit;
+                size_t size = brickWidthInValues * brickWidthInValues / texelsPerUnit * bytesPerUnit;
+                EXPECT(std::memcmp(bricks.data() + offset, data.brickTexture.data() + offset, size) == 0) << "brickID = " << brickID;
+            }
+        }
+    }
+}
+} // namespace Falcor
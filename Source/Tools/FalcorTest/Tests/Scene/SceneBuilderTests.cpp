@@ -0,0 +1,401 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/ObjectPython.h"
+#include "Scene/CpuRayQuery.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Utils/Scripting/Scripting.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+namespace Falcor
+{
+namespace
+{
+/** Wavy grid with a texture coordinate seam through the middle and some degenerate triangles.
+    Vertices on the seam are duplicated with different texture coordinates, so corners at the same position are not welded.
+*/
+struct TangentTestMesh
+{
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> texCrds;
+    std::vector<uint32_t> indices;
+
+    TangentTestMesh(uint32_t width)
+    {
+        const uint32_t w = width + 1;
+        const uint32_t seam = width / 2;
+        auto addVertex = [&](uint32_t x, uint32_t y, float u)
+        {
+            float fx = float(x) / width, fy = float(y) / width;
+            positions.push_back(float3(fx, fy, 0.1f * std::sin(8.f * fx) * std::cos(5.f * fy)));
+            normals.push_back(normalize(float3(-0.8f * std::cos(8.f * fx) * std::cos(5.f * fy), 0.5f * std::sin(8.f * fx) * std::sin(5.f * fy), 1.f)));
+            texCrds.push_back(float2(u, fy));
+            return (uint32_t)positions.size() - 1;
+        };
+
+        std::vector<uint32_t> left(w * w), right(w * w);
+        for (uint32_t y = 0; y < w; y++)
+        {
+            for (uint32_t x = 0; x < w; x++)
+            {
+                // The seam column gets a second vertex, mirroring the texture coordinates of the right half.
+                uint32_t i = x + y * w;
+                left[i] = addVertex(x, y, float(x) / width);
+                right[i] = x == seam ? addVertex(x, y, 2.f - float(x) / width) : left[i];
+                if (x > seam) texCrds[left[i]].x = 2.f - texCrds[left[i]].x;
+            }
+        }
+
+        for (uint32_t y = 0; y < width; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                const auto& v = x < seam ? left : right;
+                uint32_t i = x + y * w;
+                indices.insert(indices.end(), {v[i], v[i + 1], v[i + w + 1], v[i], v[i + w + 1], v[i + w]});
+            }
+        }
+
+        // Degenerate triangles: a single repeated vertex, two repeated vertices and collinear vertices.
+        indices.insert(indices.end(), {left[0], left[0], left[0], left[w + 1], left[w + 1], left[w + 2], left[0], left[1], left[2]});
+    }
+
+    SceneBuilder::Mesh getMesh() const
+    {
+        SceneBuilder::Mesh mesh;
+        mesh.name = "TangentTestMesh";
+        mesh.faceCount = (uint32_t)indices.size() / 3;
+        mesh.vertexCount = (uint32_t)positions.size();
+        mesh.indexCount = (uint32_t)indices.size();
+        mesh.pIndices = indices.data();
+        mesh.topology = Vao::Topology::TriangleList;
+        mesh.positions = {positions.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex};
+        mesh.normals = {normals.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex};
+        mesh.texCrds = {texCrds.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex};
+        return mesh;
+    }
+};
+} // namespace
+
+CPU_TEST(SceneBuilderChunkedTangents)
+{
+    TangentTestMesh testMesh(48);
+    SceneBuilder::Mesh mesh = testMesh.getMesh();
+
+    // Process the whole mesh at once.
+    std::vector<float4> expected;
+    SceneBuilder::generateTangents(mesh, expected, mesh.faceCount);
+    ASSERT_EQ(expected.size(), mesh.indexCount);
+
+    // Chunk sizes that do and don't divide the face count. Chunks are small enough to split the seam and the degenerate faces.
+    for (uint32_t chunkFaceCount : {200u, 600u, 1537u})
+    {
+        mesh = testMesh.getMesh();
+        std::vector<float4> tangents;
+        SceneBuilder::generateTangents(mesh, tangents, chunkFaceCount);
+        ASSERT_EQ(tangents.size(), expected.size());
+        EXPECT(std::memcmp(tangents.data(), expected.data(), expected.size() * sizeof(float4)) == 0) << "chunkFaceCount=" << chunkFaceCount;
+    }
+}
+
+GPU_TEST(SceneBuilderSkipTangentsWithoutNormalMaps)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    TangentTestMesh testMesh(8);
+    SceneBuilder::Mesh mesh = testMesh.getMesh();
+    mesh.pMaterial = StandardMaterial::create(pDevice, "Material");
+
+    std::vector<float4> expected;
+    SceneBuilder::Mesh mikkTSpaceMesh = mesh;
+    SceneBuilder::generateTangents(mikkTSpaceMesh, expected);
+
+    // By default, MikkTSpace tangents are generated even if the material has no normal map, as it may get one later.
+    {
+        SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::None);
+        std::vector<float4> tangents;
+        builder.processMesh(mesh, nullptr, &tangents);
+        ASSERT_EQ(tangents.size(), expected.size());
+        EXPECT(std::memcmp(tangents.data(), expected.data(), expected.size() * sizeof(float4)) == 0);
+    }
+
+    // With the flag, tangents are only required to be orthonormal to the normal.
+    {
+        SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::SkipTangentsWithoutNormalMaps);
+        std::vector<float4> tangents;
+        builder.processMesh(mesh, nullptr, &tangents);
+        ASSERT_EQ(tangents.size(), mesh.indexCount);
+        for (uint32_t i = 0; i < mesh.indexCount; i++)
+        {
+            float3 normal = mesh.getNormal(i / 3, i % 3);
+            EXPECT_LT(std::abs(dot(tangents[i].xyz(), normal)), 1e-5f) << "i=" << i;
+        }
+    }
+}
+
+GPU_TEST(SceneBuilderRemoveDuplicateMeshes)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    auto pCube = TriangleMesh::createCube(float3(1.f));
+    const float3 cachedPosition(0.f, 0.f, 10.f);
+
+    auto buildScene = [&](SceneBuilder::Flags flags)
+    {
+        SceneBuilder builder(pDevice, Settings(), flags);
+
+        // Materials A and B are equal but separate objects. Material C differs.
+        ref<StandardMaterial> pMaterialA = StandardMaterial::create(pDevice, "A");
+        ref<StandardMaterial> pMaterialB = StandardMaterial::create(pDevice, "B");
+        ref<StandardMaterial> pMaterialC = StandardMaterial::create(pDevice, "C");
+        pMaterialC->setBaseColor(float4(1.f, 0.f, 0.f, 1.f));
+
+        std::vector<NodeID> nodeIDs;
+        for (uint32_t i = 0; i < 5; i++)
+            nodeIDs.push_back(builder.addNode({fmt::format("Node{}", i), math::matrixFromTranslation(float3(2.f * i, 0.f, 0.f)), float4x4::identity()}));
+
+        // Only the mesh with material B on its own node is a mergeable duplicate of the mesh with material A.
+        builder.addMeshInstance(nodeIDs[0], builder.addTriangleMesh(pCube, pMaterialA));
+        builder.addMeshInstance(nodeIDs[1], builder.addTriangleMesh(pCube, pMaterialB));
+        builder.addMeshInstance(nodeIDs[0], builder.addTriangleMesh(pCube, pMaterialA));
+        builder.addMeshInstance(nodeIDs[2], builder.addTriangleMesh(pCube, pMaterialA, true));
+        builder.addMeshInstance(nodeIDs[3], builder.addTriangleMesh(pCube, pMaterialC));
+
+        // The vertex-animated mesh is added last, so its ID changes when a duplicate is removed.
+        MeshID cachedMeshID = builder.addTriangleMesh(pCube, pMaterialA);
+        builder.addMeshInstance(nodeIDs[4], cachedMeshID);
+        CachedMesh cachedMesh;
+        cachedMesh.meshID = cachedMeshID;
+        cachedMesh.timeSamples = {0.0, 1.0};
+        StaticVertexData vertex = {cachedPosition, float3(0.f, 0.f, 1.f), float4(1.f, 0.f, 0.f, 1.f), float2(0.f), 0.f};
+        cachedMesh.vertexData.assign(2, std::vector<PackedStaticVertexData>(pCube->getVertices().size(), PackedStaticVertexData(vertex)));
+        builder.addCachedMesh(std::move(cachedMesh));
+
+        return builder.getScene();
+    };
+
+    auto getInstanceCounts = [](const Scene& scene)
+    {
+        std::vector<uint32_t> counts(scene.getMeshCount(), 0);
+        for (uint32_t i = 0; i < scene.getGeometryInstanceCount(); i++)
+        {
+            const auto& instance = scene.getGeometryInstance(i);
+            if (instance.getType() == GeometryType::TriangleMesh) counts.at(instance.geometryID)++;
+        }
+        return counts;
+    };
+
+    {
+        ref<Scene> pScene = buildScene(SceneBuilder::Flags::None);
+        ASSERT_EQ(pScene->getMeshCount(), 5u);
+        EXPECT_EQ(pScene->getGeometryInstanceCount(), 6u);
+
+        // The two duplicates collapse into one mesh with instances on both nodes. All other meshes keep a single instance.
+        auto counts = getInstanceCounts(*pScene);
+        EXPECT_EQ(std::count(counts.begin(), counts.end(), 1u), 4);
+        auto it = std::find(counts.begin(), counts.end(), 2u);
+        ASSERT(it != counts.end());
+        MeshID mergedMeshID{(uint32_t)std::distance(counts.begin(), it)};
+        std::vector<uint32_t> matrixIDs;
+        for (uint32_t i = 0; i < pScene->getGeometryInstanceCount(); i++)
+        {
+            const auto& instance = pScene->getGeometryInstance(i);
+            if (instance.geometryID == mergedMeshID.get()) matrixIDs.push_back(instance.globalMatrixID);
+        }
+        ASSERT_EQ(matrixIDs.size(), 2u);
+        EXPECT_NE(matrixIDs[0], matrixIDs[1]);
+
+        // The animated meshes are kept, and the vertex cache animates the remapped mesh.
+        pScene->update(ctx.getRenderContext(), 0.5);
+        uint32_t animatedCount = 0;
+        uint32_t cachedCount = 0;
+        for (MeshID meshID{0}; meshID.get() < pScene->getMeshCount(); ++meshID)
+        {
+            const auto& mesh = pScene->getMesh(meshID);
+            if (!mesh.isAnimated()) continue;
+            animatedCount++;
+            EXPECT(meshID != mergedMeshID);
+
+            std::map<std::string, ref<Buffer>> buffers = {
+                {"positions", pDevice->createStructuredBuffer(sizeof(float3), mesh.vertexCount)},
+                {"texcrds", pDevice->createStructuredBuffer(sizeof(float3), mesh.vertexCount)},
+                {"triangleIndices", pDevice->createStructuredBuffer(sizeof(uint3), mesh.getTriangleCount())},
+            };
+            pScene->getMeshVerticesAndIndices(meshID, buffers);
+            std::vector<float3> positions = buffers["positions"]->getElements<float3>();
+            if (std::all_of(positions.begin(), positions.end(), [&](const float3& p) { return all(p == cachedPosition); })) cachedCount++;
+        }
+        EXPECT_EQ(animatedCount, 2u);
+        EXPECT_EQ(cachedCount, 1u);
+    }
+
+    // Disabling mesh merging, or material merging which makes the materials of the duplicates differ, keeps all meshes.
+    for (auto flags : {SceneBuilder::Flags::DontMergeMeshes, SceneBuilder::Flags::DontMergeMaterials})
+    {
+        ref<Scene> pScene = buildScene(flags);
+        EXPECT_EQ(pScene->getMeshCount(), 6u);
+        auto counts = getInstanceCounts(*pScene);
+        EXPECT(std::all_of(counts.begin(), counts.end(), [](uint32_t count) { return count == 1; }));
+    }
+}
+
+GPU_TEST(SceneBuilderInstanceSet)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Two cubes of size 0.5, placed by an instance set at x = 0 and x = 3 below a parent node at y = 1.
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::None);
+    auto pMaterial = StandardMaterial::create(pDevice, "Material");
+    MeshID meshID = builder.addTriangleMesh(TriangleMesh::createCube(float3(1.f)), pMaterial);
+
+    SceneBuilder::Node parent;
+    parent.name = "Parent";
+    parent.transform = math::matrixFromTranslation(float3(0.f, 1.f, 0.f));
+    NodeID parentID = builder.addNode(parent);
+
+    Scene::InstanceSet set;
+    set.name = "Cubes";
+    set.parent = parentID;
+    set.meshTransform = math::matrixFromScaling(float3(0.5f));
+    for (float x : {0.f, 3.f}) set.transforms.push_back(math::matrixFromTranslation(float3(x, 0.f, 0.f)));
+    builder.addMeshInstanceSet(set, {&meshID, 1});
+    EXPECT_EQ(builder.getNodeCount(), 1u);
+
+    ref<Scene> pScene = builder.getScene();
+    ASSERT_EQ(pScene->getInstanceSets().size(), 1u);
+    ASSERT_EQ(pScene->getGeometryInstanceCount(), 2u);
+    EXPECT(!pScene->hasAnimation());
+
+    // Each instance has its own matrix after the scene graph nodes, computed from the parent node.
+    const auto& globalMatrices = pScene->getAnimationController()->getGlobalMatrices();
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        const auto& instance = pScene->getGeometryInstance(i);
+        EXPECT_EQ(instance.globalMatrixID, pScene->getInstanceSets()[0].matrixOffset + i);
+        EXPECT(pScene->getMatrixNodeID(instance.globalMatrixID) == parentID);
+        float3 origin = transformPoint(globalMatrices[instance.globalMatrixID], float3(0.f));
+        EXPECT_EQ(origin.x, i == 0 ? 0.f : 3.f);
+        EXPECT_EQ(origin.y, 1.f);
+        EXPECT_EQ(origin.z, 0.f);
+    }
+
+    // Rays along -z hit the front face of each cube at z = 0.25 and miss in between.
+    CpuRayQuery rayQuery(*pScene, CpuRayQuery::Options());
+    CpuRayQuery::Hit hit0 = rayQuery.traceRay(Ray(float3(0.1f, 1.1f, 5.f), float3(0.f, 0.f, -1.f)));
+    CpuRayQuery::Hit hit1 = rayQuery.traceRay(Ray(float3(3.1f, 0.9f, 5.f), float3(0.f, 0.f, -1.f)));
+    EXPECT(hit0.isValid());
+    EXPECT(hit1.isValid());
+    EXPECT_LE(std::abs(hit0.t - 4.75f), 1e-5f);
+    EXPECT_LE(std::abs(hit1.t - 4.75f), 1e-5f);
+    EXPECT_NE(hit0.instanceID, hit1.instanceID);
+    EXPECT_FALSE(rayQuery.traceRay(Ray(float3(1.5f, 1.f, 5.f), float3(0.f, 0.f, -1.f))).isValid());
+    EXPECT_FALSE(rayQuery.traceRay(Ray(float3(0.f, 0.f, 5.f), float3(0.f, 0.f, -1.f))).isValid());
+}
+
+GPU_TEST(SceneBuilderAnimatedInstanceSet)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    // One cube moving from x = 0 to x = 2 over one second.
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::None);
+    auto pMaterial = StandardMaterial::create(pDevice, "Material");
+    MeshID meshID = builder.addTriangleMesh(TriangleMesh::createCube(float3(1.f)), pMaterial);
+
+    Scene::InstanceSet set;
+    set.name = "Cube";
+    set.keyframesPerInstance = 2;
+    set.keyframes.resize(2);
+    set.keyframes[1].time = 1.0;
+    set.keyframes[1].translation = float3(2.f, 0.f, 0.f);
+    builder.addMeshInstanceSet(set, {&meshID, 1});
+
+    ref<Scene> pScene = builder.getScene();
+    EXPECT(pScene->hasAnimation());
+    ASSERT_EQ(pScene->getGeometryInstanceCount(), 1u);
+    uint32_t matrixID = pScene->getGeometryInstance(0).globalMatrixID;
+    EXPECT(pScene->getMatrixNodeID(matrixID) == NodeID::Invalid());
+
+    pScene->update(ctx.getRenderContext(), 0.5);
+    float3 origin = transformPoint(pScene->getAnimationController()->getGlobalMatrices()[matrixID], float3(0.f));
+    EXPECT_LE(std::abs(origin.x - 1.f), 1e-5f);
+}
+
+GPU_TEST(SceneBuilderAddMeshFromArrays)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::None);
+    ref<Material> pMaterial = StandardMaterial::create(pDevice, "Material");
+
+    Scripting::Context context;
+    context.setObject("sceneBuilder", &builder);
+    context.setObject("material", pMaterial);
+    Scripting::runScript(
+        R"(
+import numpy as np
+positions = np.array([[0, 0, 0], [1, 0, 0], [0, 1, 0]], dtype=np.float32)
+meshID = sceneBuilder.addMeshFromArrays("Triangle", material, positions, np.array([0, 1, 2], dtype=np.uint32))
+    )",
+        context
+    );
+    EXPECT_EQ(context.getObject<uint32_t>("meshID"), 0u);
+
+    // Indices must reference existing vertices and form whole triangles.
+    EXPECT_THROW(Scripting::runScript(
+        R"(sceneBuilder.addMeshFromArrays("OutOfRange", material, positions, np.array([0, 1, 3], dtype=np.uint32)))", context
+    ));
+    EXPECT_THROW(Scripting::runScript(
+        R"(sceneBuilder.addMeshFromArrays("Partial", material, positions, np.array([0, 1, 2, 0], dtype=np.uint32)))", context
+    ));
+}
+
+GPU_TEST(SceneBuilderInstanceSetValidation)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::None);
+    auto pMaterial = StandardMaterial::create(pDevice, "Material");
+    MeshID meshID = builder.addTriangleMesh(TriangleMesh::createCube(float3(1.f)), pMaterial);
+
+    Scene::InstanceSet empty;
+    EXPECT_THROW_AS(builder.addMeshInstanceSet(empty, {&meshID, 1}), RuntimeError);
+
+    Scene::InstanceSet badParent;
+    badParent.parent = NodeID{ 5 };
+    badParent.transforms.push_back(float4x4::identity());
+    EXPECT_THROW_AS(builder.addMeshInstanceSet(badParent, {&meshID, 1}), RuntimeError);
+
+    Scene::InstanceSet badKeyframes;
+    badKeyframes.keyframesPerInstance = 2;
+    badKeyframes.keyframes.resize(3);
+    EXPECT_THROW_AS(builder.addMeshInstanceSet(badKeyframes, {&meshID, 1}), RuntimeError);
+}
+} // namespace Falcor
@@ -0,0 +1,272 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/SceneTypes.slang"
+#include "Scene/Material/StandardMaterial.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const char kShaderFile[] = "Tests/Scene/VertexQuantizationTests.slang";
+
+float angleDegrees(float3 a, float3 b)
+{
+    return math::degrees(std::atan2(length(cross(a, b)), dot(a, b)));
+}
+
+float3 randomDirection(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(-1.f, 1.f);
+    float3 d;
+    do
+    {
+        d = float3(u(rng), u(rng), u(rng));
+    } while (dot(d, d) > 1.f || dot(d, d) < 1e-4f);
+    return normalize(d);
+}
+
+/** Build a scene with a sphere and a box, which have different bounds and therefore different quantization parameters.
+*/
+ref<Scene> buildScene(ref<Device> pDevice, SceneBuilder::Flags flags)
+{
+    SceneBuilder builder(pDevice, Settings(), flags);
+
+    ref<Camera> pCamera = Camera::create("Camera");
+    pCamera->setPosition(float3(0.5f, 0.f, 8.f));
+    pCamera->setTarget(float3(0.5f, 0.f, 0.f));
+    pCamera->setUpVector(float3(0.f, 1.f, 0.f));
+    pCamera->setAspectRatio(1.f);
+    builder.addCamera(pCamera);
+
+    ref<StandardMaterial> pMaterial = StandardMaterial::create(pDevice, "Material");
+    NodeID sphereNode = builder.addNode(
+        {"Sphere", mul(math::matrixFromTranslation(float3(-0.5f, 0.25f, 0.f)), math::matrixFromScaling(float3(1.5f))), float4x4::identity()}
+    );
+    NodeID boxNode = builder.addNode({"Box", math::matrixFromTranslation(float3(2.f, 0.f, 0.f)), float4x4::identity()});
+    builder.addMeshInstance(sphereNode, builder.addTriangleMesh(TriangleMesh::createSphere(0.75f), pMaterial));
+    builder.addMeshInstance(boxNode, builder.addTriangleMesh(TriangleMesh::createCube(float3(1.f, 0.5f, 2.f)), pMaterial));
+    return builder.getScene();
+}
+} // namespace
+
+CPU_TEST(VertexQuantizationRoundTrip)
+{
+    VertexQuantization q = {};
+    q.center = float3(10.f, -3.f, 0.5f);
+    q.halfExtent = float3(4.f, 0.25f, 100.f);
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> u(-1.f, 1.f);
+    std::uniform_real_distribution<float> uv(-8.f, 8.f);
+
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        StaticVertexData v = {};
+        v.position = q.center + float3(u(rng), u(rng), u(rng)) * q.halfExtent;
+        v.normal = randomDirection(rng);
+        v.tangent = float4(randomDirection(rng), (i & 1) ? 1.f : -1.f);
+        v.texCrd = float2(uv(rng), uv(rng));
+
+        PackedQuantizedVertexData packed(v, q);
+        StaticVertexData r = packed.unpack(q);
+
+        // Positions are within one quantization step per axis.
+        float3 step = q.halfExtent / 32767.f;
+        for (int j = 0; j < 3; j++)
+            EXPECT_LE(std::abs(r.position[j] - v.position[j]), step[j]);
+
+        // 16-bit octahedral directions have errors well below 0.01 degrees.
+        EXPECT_LT(angleDegrees(r.normal, v.normal), 0.01f);
+        EXPECT_LT(angleDegrees(r.tangent.xyz(), v.tangent.xyz()), 0.01f);
+        EXPECT_EQ(r.tangent.w, v.tangent.w);
+
+        // fp16 texture coordinates in [-8,8] have an error of at most 2^-9.
+        EXPECT_LE(std::abs(r.texCrd.x - v.texCrd.x), 1.f / 512.f);
+        EXPECT_LE(std::abs(r.texCrd.y - v.texCrd.y), 1.f / 512.f);
+        EXPECT_EQ(r.curveRadius, 0.f);
+    }
+}
+
+CPU_TEST(VertexQuantizationFlatMesh)
+{
+    // A mesh that is flat along y has zero extent along that axis, which must decode exactly.
+    VertexQuantization q = {};
+    q.center = float3(0.f, 2.f, 0.f);
+    q.halfExtent = float3(1.f, 0.f, 1.f);
+
+    StaticVertexData v = {};
+    v.position = float3(1.f, 2.f, -1.f);
+    v.normal = float3(0.f, 1.f, 0.f);
+    v.tangent = float4(1.f, 0.f, 0.f, 0.f);
+    v.texCrd = float2(0.5f, 0.25f);
+
+    StaticVertexData r = PackedQuantizedVertexData(v, q).unpack(q);
+    EXPECT_EQ(r.position.x, 1.f);
+    EXPECT_EQ(r.position.y, 2.f);
+    EXPECT_EQ(r.position.z, -1.f);
+    EXPECT_EQ(r.normal.y, 1.f);
+    EXPECT_EQ(r.texCrd.x, 0.5f);
+    EXPECT_EQ(r.texCrd.y, 0.25f);
+
+    // A missing tangent is encoded as a zero tangent sign.
+    EXPECT_EQ(r.tangent.w, 0.f);
+}
+
+GPU_TEST(VertexQuantizationScene)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    ref<Scene> pScene = buildScene(pDevice, SceneBuilder::Flags::QuantizeVertices);
+    ref<Scene> pReferenceScene = buildScene(pDevice, SceneBuilder::Flags::None);
+    pScene->update(pRenderContext, 0.0);
+    ASSERT(pScene->hasQuantizedVertices());
+    ASSERT(!pReferenceScene->hasQuantizedVertices());
+    ASSERT_EQ(pScene->getMeshCount(), pReferenceScene->getMeshCount());
+
+    // Hit points and rasterized positions are compared in world space against positions fetched from the same quantized data,
+    // so they only differ by floating-point precision. A mismatched decoding would be off by a large fraction of the mesh size.
+    const float kWorldTolerance = 1e-4f;
+
+    // Fetch the vertices in a shader (see VertexData.slang) and compare with the CPU decoding and the full format.
+    {
+        ProgramDesc desc;
+        desc.addShaderModules(pScene->getShaderModules());
+        desc.addShaderLibrary(kShaderFile).csEntry("fetchVertices");
+        desc.addTypeConformances(pScene->getTypeConformances());
+        ctx.createProgram(desc, pScene->getSceneDefines());
+
+        for (uint32_t meshID = 0; meshID < pScene->getMeshCount(); ++meshID)
+        {
+            const auto& mesh = pScene->getMesh(MeshID(meshID));
+            ASSERT_EQ(mesh.vertexCount, pReferenceScene->getMesh(MeshID(meshID)).vertexCount);
+
+            pScene->bindShaderData(ctx["gScene"]);
+            ctx["CB"]["gVbOffset"] = mesh.vbOffset;
+            ctx["CB"]["gVertexCount"] = mesh.vertexCount;
+            ctx.allocateStructuredBuffer("positions", mesh.vertexCount);
+            ctx.allocateStructuredBuffer("vertexPositions", mesh.vertexCount);
+            ctx.allocateStructuredBuffer("normals", mesh.vertexCount);
+            ctx.allocateStructuredBuffer("texCrds", mesh.vertexCount);
+            ctx.runProgram(mesh.vertexCount, 1, 1);
+
+            std::vector<float3> positions = ctx.readBuffer<float3>("positions");
+            std::vector<float3> vertexPositions = ctx.readBuffer<float3>("vertexPositions");
+            std::vector<float3> normals = ctx.readBuffer<float3>("normals");
+            std::vector<float2> texCrds = ctx.readBuffer<float2>("texCrds");
+
+            // Positions are within one quantization step per axis of the full format, relative to the mesh bounds.
+            AABB bounds;
+            for (uint32_t i = 0; i < mesh.vertexCount; ++i)
+                bounds.include(pReferenceScene->getMeshVertex(MeshID(meshID), i).position);
+            const float3 step = bounds.extent() * 0.5f / 32767.f + 1e-6f;
+
+            for (uint32_t i = 0; i < mesh.vertexCount; ++i)
+            {
+                const StaticVertexData v = pScene->getMeshVertex(MeshID(meshID), i);
+                const StaticVertexData full = pReferenceScene->getMeshVertex(MeshID(meshID), i);
+                for (int j = 0; j < 3; j++)
+                {
+                    EXPECT_LE(std::abs(positions[i][j] - v.position[j]), 1e-6f) << "mesh " << meshID << " vertex " << i;
+                    EXPECT_LE(std::abs(vertexPositions[i][j] - v.position[j]), 1e-6f) << "mesh " << meshID << " vertex " << i;
+                    EXPECT_LE(std::abs(positions[i][j] - full.position[j]), step[j]) << "mesh " << meshID << " vertex " << i;
+                }
+                EXPECT_LT(angleDegrees(normals[i], full.normal), 0.01f) << "mesh " << meshID << " vertex " << i;
+                EXPECT_LE(std::abs(texCrds[i].x - v.texCrd.x), 1e-6f) << "mesh " << meshID << " vertex " << i;
+                EXPECT_LE(std::abs(texCrds[i].y - v.texCrd.y), 1e-6f) << "mesh " << meshID << " vertex " << i;
+            }
+        }
+    }
+
+    // Trace rays against the BLAS, which decodes the positions with the per-mesh dequantization transform.
+    if (pDevice->isFeatureSupported(Device::SupportedFeatures::RaytracingTier1_1))
+    {
+        ProgramDesc desc;
+        desc.addShaderModules(pScene->getShaderModules());
+        desc.addShaderLibrary(kShaderFile).csEntry("traceRays");
+        desc.addTypeConformances(pScene->getTypeConformances());
+        ctx.createProgram(desc, pScene->getSceneDefines());
+
+        const uint2 rayCount = uint2(96, 64);
+        pScene->bindShaderDataForRaytracing(pRenderContext, ctx["gScene"]);
+        ctx["CB"]["gRayCount"] = rayCount;
+        ctx["CB"]["gRayOrigin"] = float3(-2.f, -1.5f, 10.f);
+        ctx["CB"]["gRaySpacing"] = 0.05f;
+        ctx.allocateStructuredBuffer("rayErrors", rayCount.x * rayCount.y);
+        ctx.runProgram(rayCount.x, rayCount.y, 1);
+
+        std::vector<float4> rayErrors = ctx.readBuffer<float4>("rayErrors");
+        uint32_t hitCount = 0;
+        for (size_t i = 0; i < rayErrors.size(); ++i)
+        {
+            if (rayErrors[i].w == 0.f) continue;
+            hitCount++;
+            EXPECT_LE(length(rayErrors[i].xyz()), kWorldTolerance) << "ray " << i;
+        }
+        EXPECT_GT(hitCount, 0u);
+    }
+
+    // Rasterize the scene, which decodes the vertex attributes fetched by the VAO (see Raster.slang).
+    {
+        const uint32_t kFrameDim = 64;
+        ProgramDesc desc;
+        desc.addShaderModules(pScene->getShaderModules());
+        desc.addShaderLibrary(kShaderFile).vsEntry("vsMain").psEntry("psMain");
+        desc.addTypeConformances(pScene->getTypeConformances());
+        ref<Program> pProgram = Program::create(pDevice, desc, pScene->getSceneDefines());
+        ref<ProgramVars> pVars = ProgramVars::create(pDevice, pProgram.get());
+
+        ref<Fbo> pFbo = Fbo::create2D(pDevice, kFrameDim, kFrameDim, ResourceFormat::RGBA32Float, ResourceFormat::D32Float);
+        ref<GraphicsState> pState = GraphicsState::create(pDevice);
+        pState->setProgram(pProgram);
+        pState->setFbo(pFbo);
+
+        pRenderContext->clearFbo(pFbo.get(), float4(0.f), 1.f, 0, FboAttachmentType::All);
+        pScene->rasterize(pRenderContext, pState.get(), pVars.get(), RasterizerState::CullMode::None);
+
+        std::vector<uint8_t> data = pRenderContext->readTextureSubresource(pFbo->getColorTexture(0).get(), 0);
+        ASSERT_EQ(data.size(), kFrameDim * kFrameDim * sizeof(float4));
+        std::vector<float4> pixels(kFrameDim * kFrameDim);
+        std::memcpy(pixels.data(), data.data(), data.size());
+
+        uint32_t coveredCount = 0;
+        for (size_t i = 0; i < pixels.size(); ++i)
+        {
+            if (pixels[i].w == 0.f) continue;
+            coveredCount++;
+            EXPECT_LE(length(pixels[i].xyz()), kWorldTolerance) << "pixel " << i;
+        }
+        EXPECT_GT(coveredCount, 0u);
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,204 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Math/BatchTransform.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+// The kernels are bit-identical to the scalar functions unless the compiler contracts multiply-adds.
+#if defined(__FMA__)
+const float kEpsilon = 1e-5f;
+#else
+const float kEpsilon = 0.f;
+#endif
+
+// Array sizes covering empty arrays, partial SIMD blocks and remainders.
+const size_t kCounts[] = {0, 1, 3, 4, 7, 8, 13, 100};
+
+bool isClose(float a, float b, float epsilon)
+{
+    return a == b || std::abs(a - b) <= epsilon * std::max(1.f, std::abs(b));
+}
+
+bool isClose(const float3& a, const float3& b, float epsilon)
+{
+    return isClose(a.x, b.x, epsilon) && isClose(a.y, b.y, epsilon) && isClose(a.z, b.z, epsilon);
+}
+
+float4x4 randomAffineMatrix(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(-10.f, 10.f);
+    float4x4 m = float4x4::identity();
+    for (int r = 0; r < 3; r++)
+        for (int c = 0; c < 4; c++)
+            m[r][c] = u(rng);
+    return m;
+}
+
+std::vector<float3> randomVectors(std::mt19937& rng, size_t count)
+{
+    std::uniform_real_distribution<float> u(-10.f, 10.f);
+    std::vector<float3> v(count);
+    for (auto& p : v)
+        p = float3(u(rng), u(rng), u(rng));
+    return v;
+}
+} // namespace
+
+CPU_TEST(BatchTransform_Vectors)
+{
+    std::mt19937 rng;
+    const float4x4 m = randomAffineMatrix(rng);
+    const float3x3 m3x3 = float3x3(m);
+
+    for (size_t count : kCounts)
+    {
+        const std::vector<float3> src = randomVectors(rng, count);
+        std::vector<float3> dst(count);
+
+        transformPoints(m, src.data(), dst.data(), count);
+        for (size_t i = 0; i < count; i++)
+            EXPECT(isClose(dst[i], transformPoint(m, src[i]), kEpsilon)) << "i=" << i;
+
+        transformVectors(m, src.data(), dst.data(), count);
+        for (size_t i = 0; i < count; i++)
+            EXPECT(isClose(dst[i], transformVector(m, src[i]), kEpsilon)) << "i=" << i;
+
+        transformVectors(m3x3, src.data(), dst.data(), count);
+        for (size_t i = 0; i < count; i++)
+            EXPECT(isClose(dst[i], transformVector(m3x3, src[i]), kEpsilon)) << "i=" << i;
+
+        transformNormals(m3x3, src.data(), dst.data(), count);
+        for (size_t i = 0; i < count; i++)
+            EXPECT(isClose(dst[i], normalize(transformVector(m3x3, src[i])), kEpsilon)) << "i=" << i;
+    }
+}
+
+CPU_TEST(BatchTransform_Strided)
+{
+    struct Vertex
+    {
+        float3 position;
+        float3 normal;
+        float2 texCoord;
+    };
+
+    std::mt19937 rng;
+    const float4x4 m = randomAffineMatrix(rng);
+    const size_t count = 13;
+
+    std::vector<Vertex> vertices(count);
+    for (auto& v : vertices)
+    {
+        v.position = randomVectors(rng, 1)[0];
+        v.normal = randomVectors(rng, 1)[0];
+        v.texCoord = float2(0.25f, 0.75f);
+    }
+    const std::vector<Vertex> original = vertices;
+
+    // Transform positions in place.
+    transformPoints(m, &vertices[0].position, &vertices[0].position, count, sizeof(Vertex), sizeof(Vertex));
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT(isClose(vertices[i].position, transformPoint(m, original[i].position), kEpsilon)) << "i=" << i;
+        EXPECT(all(vertices[i].normal == original[i].normal));
+        EXPECT(all(vertices[i].texCoord == original[i].texCoord));
+    }
+
+    // Round trip through SoA layout.
+    std::vector<float> x(count), y(count), z(count);
+    aosToSoa(&vertices[0].normal, x.data(), y.data(), z.data(), count, sizeof(Vertex));
+    for (size_t i = 0; i < count; i++)
+        EXPECT(all(float3(x[i], y[i], z[i]) == original[i].normal));
+
+    std::vector<float3> normals(count);
+    soaToAos(x.data(), y.data(), z.data(), normals.data(), count);
+    for (size_t i = 0; i < count; i++)
+        EXPECT(all(normals[i] == original[i].normal));
+}
+
+CPU_TEST(BatchTransform_AABBs)
+{
+    std::mt19937 rng;
+
+    for (size_t count : kCounts)
+    {
+        std::vector<float4x4> matrices(count);
+        std::vector<AABB> src(count), dst(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            matrices[i] = randomAffineMatrix(rng);
+            // Leave every fifth box invalid.
+            if (i % 5 != 4)
+            {
+                auto points = randomVectors(rng, 2);
+                src[i] = AABB(points[0]).include(points[1]);
+            }
+        }
+
+        transformAABBs(matrices.data(), src.data(), dst.data(), count);
+        for (size_t i = 0; i < count; i++)
+        {
+            AABB expected = src[i].transform(matrices[i]);
+            EXPECT_EQ(dst[i].valid(), expected.valid()) << "i=" << i;
+            if (expected.valid())
+            {
+                EXPECT(isClose(dst[i].minPoint, expected.minPoint, kEpsilon)) << "i=" << i;
+                EXPECT(isClose(dst[i].maxPoint, expected.maxPoint, kEpsilon)) << "i=" << i;
+            }
+        }
+    }
+}
+
+CPU_TEST(BatchTransform_InverseTranspose)
+{
+    std::mt19937 rng;
+
+    for (size_t count : kCounts)
+    {
+        std::vector<float4x4> src(count), dst(count);
+        for (auto& m : src)
+            m = randomAffineMatrix(rng);
+        // Add a projective matrix to exercise the general fallback.
+        if (count > 2)
+            src[2][3][1] = 0.5f;
+
+        inverseTransposeAffine(src.data(), dst.data(), count);
+        for (size_t i = 0; i < count; i++)
+        {
+            float4x4 expected = transpose(inverse(src[i]));
+            for (int r = 0; r < 4; r++)
+                for (int c = 0; c < 4; c++)
+                    EXPECT(isClose(dst[i][r][c], expected[r][c], 1e-4f)) << "i=" << i << " r=" << r << " c=" << c;
+        }
+    }
+}
+} // namespace Falcor
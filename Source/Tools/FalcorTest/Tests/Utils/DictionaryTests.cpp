@@ -0,0 +1,77 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Dictionary.h"
+
+namespace Falcor
+{
+CPU_TEST(Dictionary_TypedKey)
+{
+    const DictionaryKey<uint32_t> kUintKey{"uintKey"};
+    const DictionaryKey<bool> kBoolKey{"boolKey"};
+    const DictionaryKey<uint32_t> kUintKeyAgain{"uintKey"};
+
+    EXPECT_EQ(kUintKey.getID(), kUintKeyAgain.getID());
+    EXPECT_NE(kUintKey.getID(), kBoolKey.getID());
+
+    Dictionary dict;
+
+    // Missing keys return the default value.
+    EXPECT_EQ(dict.getValue(kUintKey, 7u), 7u);
+    EXPECT(!dict.keyExists("uintKey"));
+
+    // Typed and string keys refer to the same entry.
+    dict.setValue(kUintKey, 3u);
+    EXPECT(dict.keyExists("uintKey"));
+    EXPECT_EQ(dict.getValue<uint32_t>("uintKey"), 3u);
+    EXPECT_EQ(dict.getValue(kUintKeyAgain, 0u), 3u);
+
+    dict["uintKey"] = 5u;
+    EXPECT_EQ(dict.getValue(kUintKey, 0u), 5u);
+
+    // Values of a different type throw, as with string keys.
+    dict["boolKey"] = 1u;
+    EXPECT_THROW_AS(dict.getValue(kBoolKey, false), RuntimeError);
+    EXPECT_THROW(dict.getValue<bool>("boolKey", false));
+    dict.setValue(kBoolKey, true);
+    EXPECT_EQ(dict.getValue(kBoolKey, false), true);
+
+    // Copies don't share the cached entries.
+    Dictionary copy(dict);
+    copy.setValue(kUintKey, 9u);
+    EXPECT_EQ(dict.getValue(kUintKey, 0u), 5u);
+    EXPECT_EQ(copy.getValue(kUintKey, 0u), 9u);
+
+    Dictionary assigned;
+    assigned.setValue(kUintKey, 1u);
+    assigned = dict;
+    assigned.setValue(kUintKey, 11u);
+    EXPECT_EQ(dict.getValue(kUintKey, 0u), 5u);
+    EXPECT_EQ(assigned.getValue(kUintKey, 0u), 11u);
+}
+} // namespace Falcor
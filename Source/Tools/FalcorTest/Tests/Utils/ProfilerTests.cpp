@@ -0,0 +1,228 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/Profiler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+const Profiler::Event* findEvent(const Profiler& profiler, const std::string& name)
+{
+    const auto& events = profiler.getEvents();
+    auto it = std::find_if(events.begin(), events.end(), [&name](const Profiler::Event* pEvent) { return pEvent->getName() == name; });
+    return it != events.end() ? *it : nullptr;
+}
+
+void spin(double ms)
+{
+    auto start = CpuTimer::getCurrentTimePoint();
+    while (CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint()) < ms)
+        ;
+}
+} // namespace
+
+CPU_TEST(ProfilerInternName)
+{
+    Profiler::EventID a = Profiler::internName("ProfilerTestA");
+    Profiler::EventID b = Profiler::internName("ProfilerTestB");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(Profiler::internName("ProfilerTestA"), a);
+    EXPECT_EQ(Profiler::getInternedName(a), "ProfilerTestA");
+    EXPECT_EQ(Profiler::getInternedName(b), "ProfilerTestB");
+}
+
+GPU_TEST(ProfilerCpuEvents)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+    Profiler& profiler = *pDevice->getProfiler();
+
+    bool wasEnabled = profiler.isEnabled();
+    profiler.setEnabled(true);
+
+    const uint32_t kThreadCount = 4;
+    Profiler::EventID outerID = Profiler::internName("cpuOuter");
+    Profiler::EventID innerID = Profiler::internName("cpuInner");
+
+    // CPU events are aggregated at the end of the frame and reported one frame later.
+    for (uint32_t frame = 0; frame < 2; ++frame)
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < kThreadCount; ++i)
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    ScopedCpuProfilerEvent outer(outerID);
+                    spin(1.0);
+                    {
+                        ScopedCpuProfilerEvent inner(innerID);
+                        spin(1.0);
+                    }
+                }
+            );
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        profiler.endFrame(pRenderContext);
+    }
+
+    const auto& stats = profiler.getCpuEventStats();
+    EXPECT_EQ(stats.recordCount, kThreadCount * 4);
+    EXPECT_EQ(stats.droppedCount, 0u);
+    EXPECT_EQ(stats.threadCount, kThreadCount);
+    EXPECT_GT(stats.recordOverhead, 0.f);
+
+    const Profiler::Event* pRoot = findEvent(profiler, "/CPU");
+    const Profiler::Event* pOuter = findEvent(profiler, "/CPU/cpuOuter");
+    const Profiler::Event* pInner = findEvent(profiler, "/CPU/cpuOuter/cpuInner");
+    ASSERT(pRoot && pOuter && pInner);
+
+    // Times are summed over all threads.
+    EXPECT_GE(pOuter->getCpuTime(), 2.f * kThreadCount);
+    EXPECT_GE(pInner->getCpuTime(), 1.f * kThreadCount);
+    EXPECT_LT(pInner->getCpuTime(), pOuter->getCpuTime());
+    EXPECT_EQ(pRoot->getCpuTime(), pOuter->getCpuTime());
+
+    profiler.setEnabled(wasEnabled);
+}
+
+GPU_TEST(ProfilerCpuEventsMultipleProfilers)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+
+    // Each profiler consumes its own copy of the CPU events.
+    Profiler profilerA(pDevice);
+    Profiler profilerB(pDevice);
+    profilerA.setEnabled(true);
+    profilerB.setEnabled(true);
+
+    Profiler::EventID eventID = Profiler::internName("cpuShared");
+    for (uint32_t frame = 0; frame < 2; ++frame)
+    {
+        std::thread thread(
+            [&]()
+            {
+                ScopedCpuProfilerEvent event(eventID);
+                spin(1.0);
+            }
+        );
+        thread.join();
+
+        profilerA.endFrame(pRenderContext);
+        profilerB.endFrame(pRenderContext);
+    }
+
+    for (const Profiler* pProfiler : {&profilerA, &profilerB})
+    {
+        EXPECT_EQ(pProfiler->getCpuEventStats().recordCount, 2u);
+        EXPECT_EQ(pProfiler->getCpuEventStats().threadCount, 1u);
+        const Profiler::Event* pEvent = findEvent(*pProfiler, "/CPU/cpuShared");
+        ASSERT(pEvent);
+        EXPECT_GE(pEvent->getCpuTime(), 1.f);
+    }
+
+    // Events are not recorded for a paused profiler.
+    profilerB.setPaused(true);
+    {
+        ScopedCpuProfilerEvent event(eventID);
+    }
+    profilerB.setPaused(false);
+    profilerA.endFrame(pRenderContext);
+    profilerB.endFrame(pRenderContext);
+    EXPECT_EQ(profilerA.getCpuEventStats().recordCount, 2u);
+    EXPECT_EQ(profilerB.getCpuEventStats().recordCount, 0u);
+}
+
+GPU_TEST(ProfilerTraceCapture)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+    Profiler& profiler = *pDevice->getProfiler();
+
+    bool wasEnabled = profiler.isEnabled();
+    EXPECT(!profiler.isTraceCapturing());
+    profiler.startTraceCapture();
+    EXPECT(profiler.isTraceCapturing());
+
+    const uint32_t kThreadCount = 4;
+    Profiler::EventID taskID = Profiler::internName("traceTask");
+
+    // Each frame runs a regular profiler event on the main thread and async tasks connected by flows.
+    for (uint32_t frame = 0; frame < 3; ++frame)
+    {
+        {
+            FALCOR_PROFILE(pRenderContext, "traceFrame");
+            std::vector<std::thread> threads;
+            for (uint32_t i = 0; i < kThreadCount; ++i)
+            {
+                uint32_t flowID = Profiler::beginFlow();
+                EXPECT_NE(flowID, 0u);
+                threads.emplace_back(
+                    [&, flowID]()
+                    {
+                        Profiler::setThreadName("TraceWorker");
+                        ScopedCpuProfilerEvent task(taskID);
+                        Profiler::endFlow(flowID);
+                        spin(0.1);
+                    }
+                );
+            }
+            for (auto& thread : threads)
+                thread.join();
+        }
+
+        profiler.endFrame(pRenderContext);
+    }
+
+    auto pTrace = profiler.endTraceCapture();
+    EXPECT(!profiler.isTraceCapturing());
+    ASSERT(pTrace != nullptr);
+
+    // One complete event per task and regular event, and a flow start/end per task.
+    EXPECT_GE(pTrace->getEventCount(), 3 * (kThreadCount * 3 + 1));
+
+    std::string json = pTrace->toJsonString();
+    EXPECT(json.find("\"traceEvents\"") != std::string::npos);
+    EXPECT(json.find("\"TraceWorker\"") != std::string::npos);
+    EXPECT(json.find("\"traceTask\"") != std::string::npos);
+    EXPECT(json.find("\"traceFrame\"") != std::string::npos);
+
+    // Flows are not recorded while no profiler is enabled.
+    profiler.setEnabled(false);
+    EXPECT_EQ(Profiler::beginFlow(), 0u);
+
+    profiler.setEnabled(wasEnabled);
+}
+} // namespace Falcor
@@ -38,8 +38,15 @@
 #include "Utils/Logger.h"
 
 #include <fast_float/fast_float.h>
+#include <BS_thread_pool/BS_thread_pool.hpp>
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <unordered_set>
 #include <utility>
 #include <charconv>
 
@@ -95,6 +102,11 @@ std::unique_ptr<Tokenizer> Tokenizer::createFromFile(const std::filesystem::path
     }
     else
     {
+        auto pMappedFile = std::make_unique<MemoryMappedFile>(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+        if (pMappedFile->isOpen())
+            return std::make_unique<Tokenizer>(std::move(pMappedFile), path);
+
+        // Fall back to reading the file (e.g. for empty files that cannot be mapped).
         std::string str = readFile(path);
         return std::make_unique<Tokenizer>(std::move(str), path);
     }
@@ -107,13 +119,33 @@ std::unique_ptr<Tokenizer> Tokenizer::createFromString(std::string str)
 
 Tokenizer::Tokenizer(std::string str, const std::filesystem::path& path) : mPath(path), mContents(std::move(str))
 {
-    auto pFilename = std::make_unique<std::string>(path.string());
-    mLoc = FileLoc(*pFilename);
-    getFilenames().push_back(std::move(pFilename));
+    init(mContents.data(), mContents.size());
+}
+
+Tokenizer::Tokenizer(std::unique_ptr<MemoryMappedFile> pMappedFile, const std::filesystem::path& path)
+    : mPath(path), mpMappedFile(std::move(pMappedFile))
+{
+    FALCOR_ASSERT(mpMappedFile && mpMappedFile->isOpen());
+    init(static_cast<const char*>(mpMappedFile->getData()), mpMappedFile->getSize());
+}
+
+std::string_view Tokenizer::internFilename(const std::string& filename)
+{
+    // Filenames are shared by all tokenizers, which are created concurrently when parsing
+    // included and imported files in parallel. References to set elements are stable.
+    static std::mutex mutex;
+    static std::unordered_set<std::string> filenames;
+    std::lock_guard<std::mutex> lock(mutex);
+    return *filenames.insert(filename).first;
+}
+
+void Tokenizer::init(const char* pData, size_t size)
+{
+    mLoc = FileLoc(internFilename(mPath.string()));
 
-    mPos = mContents.data();
-    mEnd = mPos + mContents.size();
-    if (isUTF16(mContents.data(), mContents.size()))
+    mPos = pData;
+    mEnd = pData + size;
+    if (isUTF16(pData, size))
         throwError("File is encoded with UTF-16, which is not currently supported.");
 }
 
@@ -222,6 +254,102 @@ std::optional<Token> Tokenizer::next()
     }
 }
 
+static bool isDelimiter(char ch)
+{
+    return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '"' || ch == '[' || ch == ']';
+}
+
+void Tokenizer::skipSpaceAndComments()
+{
+    while (mPos != mEnd)
+    {
+        char ch = *mPos;
+        if (ch == '\n')
+        {
+            ++mLoc.line;
+            mLoc.column = 0;
+        }
+        else if (ch == ' ' || ch == '\t' || ch == '\r')
+        {
+            ++mLoc.column;
+        }
+        else if (ch == '#')
+        {
+            // Comment: skip to EOL (or EOF).
+            while (mPos != mEnd && *mPos != '\n' && *mPos != '\r')
+            {
+                ++mPos;
+                ++mLoc.column;
+            }
+            continue;
+        }
+        else
+        {
+            break;
+        }
+        ++mPos;
+    }
+}
+
+template<typename T, typename ParseFunc>
+size_t Tokenizer::readNumbers(std::vector<T>& values, ParseFunc parse)
+{
+    size_t count = 0;
+    while (true)
+    {
+        skipSpaceAndComments();
+        if (mPos == mEnd)
+            break;
+
+        const char* begin = mPos;
+        const char* end = begin;
+        while (end != mEnd && !isDelimiter(*end))
+            ++end;
+
+        // Skip '+' character, std::from_chars (and fast_float::from_chars) doesn't handle '+'.
+        const char* first = *begin == '+' ? begin + 1 : begin;
+        T value;
+        if (first == end || !parse(first, end, value))
+            break; // Not a number, leave it for the regular tokenizer.
+
+        values.push_back(value);
+        mLoc.column += uint32_t(end - begin);
+        mPos = end;
+        ++count;
+    }
+    return count;
+}
+
+size_t Tokenizer::readFloats(std::vector<Float>& values)
+{
+    return readNumbers(
+        values,
+        [](const char* begin, const char* end, Float& value)
+        {
+            auto result = fast_float::from_chars(begin, end, value);
+            return result.ec == std::errc() && result.ptr == end;
+        }
+    );
+}
+
+size_t Tokenizer::readInts(std::vector<int>& values)
+{
+    return readNumbers(
+        values,
+        [](const char* begin, const char* end, int& value)
+        {
+            int64_t v;
+            auto result = std::from_chars(begin, end, v);
+            if (result.ec != std::errc() || result.ptr != end)
+                return false;
+            if (v < std::numeric_limits<int32_t>::lowest() || v > std::numeric_limits<int32_t>::max())
+                return false;
+            value = (int)v;
+            return true;
+        }
+    );
+}
+
 static int32_t parseInt(const Token& t)
 {
     auto begin = t.token.data();
@@ -280,7 +408,7 @@ constexpr uint32_t TokenOptional = 0;
 constexpr uint32_t TokenRequired = 1;
 
 template<typename Next, typename Unget>
-static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
+static ParsedParameterVector parseParameters(Tokenizer& tokenizer, Next nextToken, Unget ungetToken)
 {
     ParsedParameterVector parameterVector;
 
@@ -342,6 +470,10 @@ static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
         if (param.type == "integer")
             valType = Int;
 
+        // Parameters declared with a non-numeric type keep going through the token by token path
+        // below, which determines the value type from the tokens just like for a single value.
+        const bool isNumericDecl = param.type != "string" && param.type != "texture" && param.type != "bool";
+
         auto addVal = [&](const Token& t)
         {
             if (isQuotedString(t.token))
@@ -429,6 +561,17 @@ static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
 
         if (val.token == "[")
         {
+            // Fast path for numeric arrays: parse values directly into the parameter storage.
+            // Anything else (strings, bools, malformed numbers) is handled token by token below.
+            if (valType == Int)
+            {
+                tokenizer.readInts(param.ints);
+            }
+            else if (isNumericDecl && tokenizer.readFloats(param.floats) > 0)
+            {
+                valType = Float;
+            }
+
             while (true)
             {
                 val = *nextToken(TokenRequired);
@@ -442,60 +585,326 @@ static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
             addVal(val);
         }
 
-        parameterVector.push_back(param);
+        parameterVector.push_back(std::move(param));
     }
 
     return parameterVector;
 }
 
-void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
+/**
+ * ParserTarget recording all calls so they can be replayed into another target later.
+ * Included and imported files are parsed into separate command buffers on worker threads.
+ * The command buffers are replayed in file order, so the calls received by the final
+ * target are independent of how the parsing work was scheduled.
+ *
+ * The root file uses a streaming command buffer, which forwards calls to the final target
+ * immediately. Calls are only recorded while an earlier included file is still being parsed,
+ * and are forwarded as soon as that file's commands have been replayed. Included files are
+ * fully buffered before they are replayed.
+ */
+class CommandBuffer : public ParserTarget
 {
-    static std::atomic<bool> warnedTransformBeginEndDeprecated{false};
-
-    logInfo("PBRTImporter: Started parsing '{}'.", tokenizer->getPath().string());
+public:
+    using Command = std::function<void(ParserTarget&)>;
+    using Future = std::shared_future<std::shared_ptr<CommandBuffer>>;
 
-    auto searchPath = tokenizer->getPath().parent_path();
-
-    std::vector<std::unique_ptr<Tokenizer>> fileStack;
-    fileStack.push_back(std::move(tokenizer));
-
-    std::optional<Token> ungetToken;
+    /**
+     * Create a command buffer.
+     * @param pTarget If not nullptr, commands are forwarded to this target as soon as possible instead of being recorded.
+     */
+    explicit CommandBuffer(ParserTarget* pTarget = nullptr) : mpTarget(pTarget) {}
 
     /**
-     * Helper function that handles the file stack, returning the next token from
-     * the file until reaching EOF, at which point it switches to the next file (if any).
+     * Record replaying the command buffer of another file.
+     * @param future Future of the command buffer of the file.
+     * @param scoped If true, the commands are wrapped in an attribute block (used for 'Import').
+     * @param loc Location of the directive.
      */
-    std::function<std::optional<Token>(uint32_t flags)> nextToken;
-    nextToken = [&](uint32_t flags) -> std::optional<Token>
+    void onFile(Future future, bool scoped, FileLoc loc)
     {
-        if (ungetToken.has_value())
-            return std::exchange(ungetToken, {});
+        flushReady();
+        mCommands.push_back(
+            {[future, scoped, loc](ParserTarget& t)
+             {
+                 // Rethrows parsing errors of the file (in file order).
+                 const std::shared_ptr<CommandBuffer>& pBuffer = future.get();
+                 if (scoped)
+                     t.onAttributeBegin(loc);
+                 pBuffer->replay(t);
+                 if (scoped)
+                     t.onAttributeEnd(loc);
+             },
+             future}
+        );
+    }
 
-        if (fileStack.empty())
+    /**
+     * Replay all recorded commands into a target. The recorded commands are released while replaying.
+     */
+    void replay(ParserTarget& target)
+    {
+        while (!mCommands.empty())
         {
-            if ((flags & TokenRequired) != 0)
-                throwError("Premature end of file.");
-            return {};
+            Command c = std::move(mCommands.front().command);
+            mCommands.pop_front();
+            c(target);
         }
+    }
 
-        std::optional<Token> tok = fileStack.back()->next();
+    /**
+     * Forward all remaining commands of a streaming command buffer, waiting for included files to be parsed.
+     */
+    void flush()
+    {
+        FALCOR_ASSERT(mpTarget);
+        replay(*mpTarget);
+    }
 
-        if (!tok)
+    void onScale(Float sx, Float sy, Float sz, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onScale(sx, sy, sz, loc); });
+    }
+    void onShape(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onShape, name, std::move(params), loc);
+    }
+    void onOption(const std::string& name, const std::string& value, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onOption(name, value, loc); });
+    }
+    void onIdentity(FileLoc loc) override { record([=](ParserTarget& t) { t.onIdentity(loc); }); }
+    void onTranslate(Float dx, Float dy, Float dz, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onTranslate(dx, dy, dz, loc); });
+    }
+    void onRotate(Float angle, Float ax, Float ay, Float az, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onRotate(angle, ax, ay, az, loc); });
+    }
+    void onLookAt(Float ex, Float ey, Float ez, Float lx, Float ly, Float lz, Float ux, Float uy, Float uz, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onLookAt(ex, ey, ez, lx, ly, lz, ux, uy, uz, loc); });
+    }
+    void onConcatTransform(Float transform[16], FileLoc loc) override
+    {
+        std::array<Float, 16> m;
+        std::copy(transform, transform + 16, m.begin());
+        record([=](ParserTarget& t) mutable { t.onConcatTransform(m.data(), loc); });
+    }
+    void onTransform(Float transform[16], FileLoc loc) override
+    {
+        std::array<Float, 16> m;
+        std::copy(transform, transform + 16, m.begin());
+        record([=](ParserTarget& t) mutable { t.onTransform(m.data(), loc); });
+    }
+    void onCoordinateSystem(const std::string& name, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onCoordinateSystem(name, loc); });
+    }
+    void onCoordSysTransform(const std::string& name, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onCoordSysTransform(name, loc); });
+    }
+    void onActiveTransformAll(FileLoc loc) override { record([=](ParserTarget& t) { t.onActiveTransformAll(loc); }); }
+    void onActiveTransformEndTime(FileLoc loc) override { record([=](ParserTarget& t) { t.onActiveTransformEndTime(loc); }); }
+    void onActiveTransformStartTime(FileLoc loc) override { record([=](ParserTarget& t) { t.onActiveTransformStartTime(loc); }); }
+    void onTransformTimes(Float start, Float end, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onTransformTimes(start, end, loc); });
+    }
+
+    void onColorSpace(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onColorSpace(name, loc); }); }
+    void onPixelFilter(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onPixelFilter, name, std::move(params), loc);
+    }
+    void onFilm(const std::string& type, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onFilm, type, std::move(params), loc);
+    }
+    void onAccelerator(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onAccelerator, name, std::move(params), loc);
+    }
+    void onIntegrator(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onIntegrator, name, std::move(params), loc);
+    }
+    void onCamera(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onCamera, name, std::move(params), loc);
+    }
+    void onMakeNamedMedium(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onMakeNamedMedium, name, std::move(params), loc);
+    }
+    void onMediumInterface(const std::string& insideName, const std::string& outsideName, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onMediumInterface(insideName, outsideName, loc); });
+    }
+    void onSampler(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onSampler, name, std::move(params), loc);
+    }
+
+    void onWorldBegin(FileLoc loc) override { record([=](ParserTarget& t) { t.onWorldBegin(loc); }); }
+    void onAttributeBegin(FileLoc loc) override { record([=](ParserTarget& t) { t.onAttributeBegin(loc); }); }
+    void onAttributeEnd(FileLoc loc) override { record([=](ParserTarget& t) { t.onAttributeEnd(loc); }); }
+    void onAttribute(const std::string& target, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onAttribute, target, std::move(params), loc);
+    }
+    void onTexture(const std::string& name, const std::string& type, const std::string& texname, ParsedParameterVector params, FileLoc loc)
+        override
+    {
+        record([=, params = std::move(params)](ParserTarget& t) mutable { t.onTexture(name, type, texname, std::move(params), loc); });
+    }
+    void onMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onMaterial, name, std::move(params), loc);
+    }
+    void onMakeNamedMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onMakeNamedMaterial, name, std::move(params), loc);
+    }
+    void onNamedMaterial(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onNamedMaterial(name, loc); }); }
+    void onLightSource(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onLightSource, name, std::move(params), loc);
+    }
+    void onAreaLightSource(const std::string& name, ParsedParameterVector params, FileLoc loc) override
+    {
+        recordParams(&ParserTarget::onAreaLightSource, name, std::move(params), loc);
+    }
+    void onReverseOrientation(FileLoc loc) override { record([=](ParserTarget& t) { t.onReverseOrientation(loc); }); }
+    void onObjectBegin(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onObjectBegin(name, loc); }); }
+    void onObjectEnd(FileLoc loc) override { record([=](ParserTarget& t) { t.onObjectEnd(loc); }); }
+    void onObjectInstance(const std::string& name, FileLoc loc) override
+    {
+        record([=](ParserTarget& t) { t.onObjectInstance(name, loc); });
+    }
+
+    void onEndOfFiles() override {}
+
+private:
+    struct Entry
+    {
+        Command command;
+        Future file; ///< Valid if the command replays an included file.
+    };
+
+    template<typename F>
+    void record(F&& f)
+    {
+        if (mpTarget)
         {
-            // We've reached EOF in the current file. Anything more to parse?
-            logInfo("PBRTImporter: Finished parsing '{}'.", fileStack.back()->getPath().string());
-            fileStack.pop_back();
-            return nextToken(flags);
+            flushReady();
+            if (mCommands.empty())
+            {
+                f(*mpTarget);
+                return;
+            }
         }
-        else if (tok->token[0] == '#')
+        mCommands.push_back({Command(std::forward<F>(f)), {}});
+    }
+
+    /**
+     * Forward the recorded commands of a streaming command buffer up to the first included file that is still being parsed.
+     */
+    void flushReady()
+    {
+        if (!mpTarget)
+            return;
+        while (!mCommands.empty())
         {
-            // Swallow comments.
-            return nextToken(flags);
+            const Future& file = mCommands.front().file;
+            if (file.valid() && file.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                break;
+            Command c = std::move(mCommands.front().command);
+            mCommands.pop_front();
+            c(*mpTarget);
         }
-        else
+    }
+
+    void recordParams(
+        void (ParserTarget::*apiFunc)(const std::string&, ParsedParameterVector, FileLoc),
+        const std::string& name,
+        ParsedParameterVector params,
+        FileLoc loc
+    )
+    {
+        record([=, params = std::move(params)](ParserTarget& t) mutable { (t.*apiFunc)(name, std::move(params), loc); });
+    }
+
+    ParserTarget* mpTarget = nullptr;
+    std::deque<Entry> mCommands;
+};
+
+/**
+ * State shared by all files parsed as part of a scene.
+ */
+struct ParseContext
+{
+    std::filesystem::path searchPath; ///< Path used for resolving 'Include' and 'Import' file names.
+    BS::thread_pool threadPool;       ///< Thread pool used for parsing files in parallel.
+};
+
+static void parse(CommandBuffer& target, Tokenizer& tokenizer, ParseContext& ctx);
+
+/**
+ * Parse a file on the thread pool.
+ * Parsing of a file does not depend on the state of the including file, so files are
+ * parsed as soon as they are referenced. Nested files are again parsed asynchronously.
+ * Tasks never wait on other tasks, which makes this safe on a fixed size thread pool.
+ */
+static CommandBuffer::Future parseFileAsync(const std::filesystem::path& path, ParseContext& ctx)
+{
+    return ctx.threadPool
+        .submit(
+            [path, &ctx]()
+            {
+                auto tokenizer = Tokenizer::createFromFile(path);
+                auto pBuffer = std::make_shared<CommandBuffer>();
+                parse(*pBuffer, *tokenizer, ctx);
+                logInfo("PBRTImporter: Finished parsing '{}'.", path.string());
+                return pBuffer;
+            }
+        )
+        .share();
+}
+
+static void parse(CommandBuffer& target, Tokenizer& tokenizer, ParseContext& ctx)
+{
+    static std::atomic<bool> warnedTransformBeginEndDeprecated{false};
+
+    logInfo("PBRTImporter: Started parsing '{}'.", tokenizer.getPath().string());
+
+    std::optional<Token> ungetToken;
+
+    /**
+     * Helper function returning the next token from the file, skipping comments.
+     * Note that statements cannot span multiple files, as included files are parsed separately.
+     */
+    auto nextToken = [&](uint32_t flags) -> std::optional<Token>
+    {
+        if (ungetToken.has_value())
+            return std::exchange(ungetToken, {});
+
+        while (true)
         {
-            // Regular token.
-            return tok;
+            std::optional<Token> tok = tokenizer.next();
+
+            if (!tok)
+            {
+                if ((flags & TokenRequired) != 0)
+                    throwError("Premature end of file.");
+                return {};
+            }
+            else if (tok->token[0] != '#')
+            {
+                // Regular token (comments are swallowed).
+                return tok;
+            }
         }
     };
 
@@ -514,7 +923,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         Token t = *nextToken(TokenRequired);
         std::string_view dequoted = dequoteString(t);
         std::string n = toString(dequoted);
-        ParsedParameterVector parameterVector = parseParameters(nextToken, unget);
+        ParsedParameterVector parameterVector = parseParameters(tokenizer, nextToken, unget);
         (target.*apiFunc)(n, std::move(parameterVector), loc);
     };
 
@@ -628,18 +1037,14 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
             {
                 basicParamListEntrypoint(&ParserTarget::onIntegrator, tok->loc);
             }
-            else if (tok->token == "Include")
+            else if (tok->token == "Include" || tok->token == "Import")
             {
+                // Included files are replayed in place. Imported files are replayed within an attribute
+                // block, so the graphics state at the 'Import' directive applies but changes don't leak out.
                 Token filenameToken = *nextToken(TokenRequired);
                 std::string filename = toString(dequoteString(filenameToken));
-                auto path = searchPath / filename;
-                std::unique_ptr<Tokenizer> includeTokenizer = Tokenizer::createFromFile(path);
-                logInfo("PBRTImporter: Started parsing '{}'.", includeTokenizer->getPath().string());
-                fileStack.push_back(std::move(includeTokenizer));
-            }
-            else if (tok->token == "Import")
-            {
-                throwError(tok->loc, "'Import' directive not supported yet.");
+                auto path = ctx.searchPath / filename;
+                target.onFile(parseFileAsync(path, ctx), tok->token == "Import", tok->loc);
             }
             else if (tok->token == "Identity")
             {
@@ -850,7 +1255,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 Token t = *nextToken(TokenRequired);
                 std::string_view dequoted = dequoteString(t);
                 std::string texName = toString(dequoted);
-                ParsedParameterVector params = parseParameters(nextToken, unget);
+                ParsedParameterVector params = parseParameters(tokenizer, nextToken, unget);
                 target.onTexture(name, type, texName, std::move(params), tok->loc);
             }
             else
@@ -876,18 +1281,30 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
     }
 }
 
+static void parseRoot(ParserTarget& target, Tokenizer& tokenizer)
+{
+    ParseContext ctx;
+    ctx.searchPath = tokenizer.getPath().parent_path();
+
+    // The root file is parsed on the calling thread while referenced files are parsed on the thread pool.
+    // Commands of the root file are streamed to the target while parsing.
+    CommandBuffer commandBuffer(&target);
+    parse(commandBuffer, tokenizer, ctx);
+    logInfo("PBRTImporter: Finished parsing '{}'.", tokenizer.getPath().string());
+    commandBuffer.flush();
+    target.onEndOfFiles();
+}
+
 void parseFile(ParserTarget& target, const std::filesystem::path& path)
 {
     auto tokenizer = Tokenizer::createFromFile(path);
-    parse(target, std::move(tokenizer));
-    target.onEndOfFiles();
+    parseRoot(target, *tokenizer);
 }
 
 void parseString(ParserTarget& target, std::string str)
 {
     auto tokenizer = Tokenizer::createFromString(std::move(str));
-    parse(target, std::move(tokenizer));
-    target.onEndOfFiles();
+    parseRoot(target, *tokenizer);
 }
 
 } // namespace Falcor::pbrt
@@ -35,6 +35,7 @@
 
 #include "Types.h"
 #include "Parameters.h"
+#include "Core/Platform/MemoryMappedFile.h"
 #include <functional>
 #include <filesystem>
 #include <memory>
@@ -101,6 +102,12 @@ public:
     virtual void onEndOfFiles() = 0;
 };
 
+/**
+ * Parse a scene file (or string) and forward the directives to the target.
+ * Files referenced by 'Include' and 'Import' directives are parsed in parallel and the results
+ * are forwarded in file order. The contents of imported files are forwarded within an
+ * attribute block. Statements must not span multiple files.
+ */
 void parseFile(ParserTarget& target, const std::filesystem::path& path);
 void parseString(ParserTarget& target, std::string str);
 
@@ -117,7 +124,12 @@ class Tokenizer
 {
 public:
     Tokenizer(std::string str, const std::filesystem::path& path);
+    Tokenizer(std::unique_ptr<MemoryMappedFile> pMappedFile, const std::filesystem::path& path);
 
+    /**
+     * Create a tokenizer for a file.
+     * Uncompressed files are memory mapped and tokens directly reference the mapped memory.
+     */
     static std::unique_ptr<Tokenizer> createFromFile(const std::filesystem::path& path);
     static std::unique_ptr<Tokenizer> createFromString(std::string str);
 
@@ -127,18 +139,33 @@ public:
      */
     std::optional<Token> next();
 
+    /**
+     * Read a sequence of floating-point numbers directly from the input, skipping whitespace and comments.
+     * This is a fast path for reading numeric arrays without creating tokens. Reading stops before
+     * the first token that is not a valid number (e.g. the closing bracket of an array).
+     * @param values Vector to append the values to.
+     * @return Number of values read.
+     */
+    size_t readFloats(std::vector<Float>& values);
+
+    /**
+     * Read a sequence of integers directly from the input, skipping whitespace and comments.
+     * Reading stops before the first token that is not a valid 32-bit integer.
+     * @param values Vector to append the values to.
+     * @return Number of values read.
+     */
+    size_t readInts(std::vector<int>& values);
+
     const std::filesystem::path& getPath() const { return mPath; }
 
 private:
     /**
-     * Static list of filenames to allow file locations (FileLoc::filename) to be valid
+     * Intern a filename to allow file locations (FileLoc::filename) to be valid
      * even after the tokenizer is destroyed.
      */
-    static std::vector<std::unique_ptr<std::string>>& getFilenames()
-    {
-        static std::vector<std::unique_ptr<std::string>> filenames;
-        return filenames;
-    }
+    static std::string_view internFilename(const std::string& filename);
+
+    void init(const char* pData, size_t size);
 
     bool isUTF16(const void* ptr, size_t len) const;
 
@@ -170,9 +197,16 @@ private:
         }
     }
 
-    std::filesystem::path mPath; ///< File path we're reading from.
-    FileLoc mLoc;                ///< File location.
-    std::string mContents;       ///< File contents we're parsing.
+    /// Skip whitespace and comments.
+    void skipSpaceAndComments();
+
+    template<typename T, typename ParseFunc>
+    size_t readNumbers(std::vector<T>& values, ParseFunc parse);
+
+    std::filesystem::path mPath;                    ///< File path we're reading from.
+    FileLoc mLoc;                                   ///< File location.
+    std::string mContents;                          ///< File contents we're parsing (if not memory mapped).
+    std::unique_ptr<MemoryMappedFile> mpMappedFile; ///< Memory mapped file we're parsing (if any).
 
     const char* mPos; ///< Current position in the file.
     const char* mEnd; ///< End of the file (one past).
@@ -1159,38 +1159,173 @@ namespace Falcor
             // Add instances of prototypes to scene builder. Because SceneBuilder only supports instanced meshes, and not
             // general instancing, we effectively replicate each Prototype's subgraph. We could in theory collapse the subgraph
             // if all of the transformations are static, but time-sampled transformations require us to use a more general approach.
-            for (const auto& instance : ctx.prototypeInstances)
+            //
+            // Point instancers whose prototypes only consist of static, non-skinned meshes are the exception. They are added
+            // as SceneBuilder instance sets, which place the meshes at each instance without creating any scene graph nodes.
+            //
+            // Instances are traversed using lightweight references to the prototype instances and to entries in the flat point
+            // instancer tables, so no per-instance data is copied. Nodes created for point instances are left unnamed.
+            struct InstanceRef
+            {
+                const UsdPrim* pProtoPrim = nullptr;                ///< Prototype prim.
+                const std::string* pName = nullptr;                 ///< Instance name, or nullptr for unnamed instances.
+                const std::string* pAnimationName = nullptr;        ///< Name used for the instance animation, if any.
+                float4x4 xform;                                     ///< Instance transformation.
+                const Animation::Keyframe* pKeyframes = nullptr;    ///< Keyframes for animated instance transformation, if any.
+                size_t keyframeCount = 0;                           ///< Number of keyframes.
+                NodeID parentID{ NodeID::kInvalidID };              ///< SceneBuilder parent node id.
+            };
+
+            auto getPrototypeInstance = [](const PrototypeInstance& instance, NodeID parentID)
+            {
+                InstanceRef instanceRef;
+                instanceRef.pProtoPrim = &instance.protoPrim;
+                instanceRef.pName = &instance.name;
+                instanceRef.pAnimationName = &instance.name;
+                instanceRef.xform = instance.xform;
+                instanceRef.pKeyframes = instance.keyframes.data();
+                instanceRef.keyframeCount = instance.keyframes.size();
+                instanceRef.parentID = parentID;
+                return instanceRef;
+            };
+
+            auto getPointInstance = [](const PointInstanceSet& set, size_t index, NodeID parentID)
+            {
+                InstanceRef instanceRef;
+                instanceRef.pProtoPrim = &set.protoPrims[set.protoIndices[index]];
+                instanceRef.pAnimationName = &set.name;
+                if (set.keyframesPerInstance > 0)
+                {
+                    instanceRef.xform = float4x4::identity();
+                    instanceRef.pKeyframes = set.keyframes.data() + index * set.keyframesPerInstance;
+                    instanceRef.keyframeCount = set.keyframesPerInstance;
+                }
+                else
+                {
+                    instanceRef.xform = set.xforms[index];
+                }
+                instanceRef.parentID = parentID;
+                return instanceRef;
+            };
+
+            // Returns the prototype if it can be added as an instance set, i.e. it only contains static, non-skinned meshes.
+            auto getInstanceSetPrototype = [&](const UsdPrim& protoPrim) -> const PrototypeGeom*
+            {
+                if (!protoPrim.IsValid() || !ctx.hasPrototype(protoPrim)) return nullptr;
+
+                const PrototypeGeom& protoGeom = ctx.getPrototypeGeom(protoPrim);
+                if (!protoGeom.prototypeInstances.empty() || !protoGeom.pointInstanceSets.empty() || !protoGeom.animations.empty()) return nullptr;
+
+                for (const auto& inst : protoGeom.geomInstances)
+                {
+                    if (!inst.prim.IsA<UsdGeomMesh>()) return nullptr;
+                    const auto& processedMeshes = ctx.getMesh(inst.prim).processedMeshes;
+                    if (std::any_of(processedMeshes.begin(), processedMeshes.end(), [](const auto& m) { return !m.skinningData.empty(); })) return nullptr;
+                }
+                return &protoGeom;
+            };
+
+            std::vector<InstanceRef> instanceStack;
+
+            // Adds the instances of a point instancer. Instances of prototypes that can be added as instance sets get one set per
+            // distinct mesh transform within the prototype. The remaining instances are pushed onto the instance stack.
+            auto addPointInstanceSet = [&](const PointInstanceSet& set, NodeID parentID)
+            {
+                std::vector<std::vector<uint32_t>> protoInstances(set.protoPrims.size());
+                for (uint32_t i = 0; i < (uint32_t)set.getInstanceCount(); ++i) protoInstances[set.protoIndices[i]].push_back(i);
+
+                for (size_t protoIndex = 0; protoIndex < set.protoPrims.size(); ++protoIndex)
+                {
+                    const auto& instances = protoInstances[protoIndex];
+                    if (instances.empty()) continue;
+
+                    const PrototypeGeom* pProtoGeom = getInstanceSetPrototype(set.protoPrims[protoIndex]);
+                    if (!pProtoGeom)
+                    {
+                        // Push in reverse order to maintain traversal ordering.
+                        for (auto it = instances.rbegin(); it != instances.rend(); ++it) instanceStack.push_back(getPointInstance(set, *it, parentID));
+                        continue;
+                    }
+
+                    // Compute the transform of each mesh relative to the prototype root and group the meshes by transform.
+                    std::vector<std::pair<float4x4, std::vector<MeshID>>> meshGroups;
+                    for (const auto& inst : pProtoGeom->geomInstances)
+                    {
+                        float4x4 meshTransform = inst.xform;
+                        for (NodeID nodeID = inst.parentID; nodeID != NodeID::Invalid(); nodeID = pProtoGeom->nodes[nodeID.get()].parent)
+                        {
+                            meshTransform = mul(pProtoGeom->nodes[nodeID.get()].transform, meshTransform);
+                        }
+
+                        auto it = std::find_if(meshGroups.begin(), meshGroups.end(), [&](const auto& group) { return group.first == meshTransform; });
+                        if (it == meshGroups.end()) it = meshGroups.emplace(meshGroups.end(), meshTransform, std::vector<MeshID>());
+                        const auto& meshIDs = ctx.getMesh(inst.prim).meshIDs;
+                        it->second.insert(it->second.end(), meshIDs.begin(), meshIDs.end());
+                    }
+
+                    for (const auto& [meshTransform, meshIDs] : meshGroups)
+                    {
+                        if (meshIDs.empty()) continue;
+
+                        Scene::InstanceSet instanceSet;
+                        instanceSet.name = set.name;
+                        instanceSet.parent = parentID;
+                        instanceSet.meshTransform = meshTransform;
+                        if (set.keyframesPerInstance > 0)
+                        {
+                            instanceSet.keyframesPerInstance = (uint32_t)set.keyframesPerInstance;
+                            instanceSet.keyframes.reserve(instances.size() * set.keyframesPerInstance);
+                            for (uint32_t i : instances)
+                            {
+                                auto first = set.keyframes.begin() + i * set.keyframesPerInstance;
+                                instanceSet.keyframes.insert(instanceSet.keyframes.end(), first, first + set.keyframesPerInstance);
+                            }
+                        }
+                        else
+                        {
+                            instanceSet.transforms.reserve(instances.size());
+                            for (uint32_t i : instances) instanceSet.transforms.push_back(set.xforms[i]);
+                        }
+                        ctx.builder.addMeshInstanceSet(std::move(instanceSet), meshIDs);
+                    }
+                }
+            };
+
+            auto addInstances = [&]()
             {
-                std::vector<std::pair<PrototypeInstance, NodeID>> protoInstanceStack = { std::make_pair(instance, instance.parentID) };
-                while (!protoInstanceStack.empty())
+                while (!instanceStack.empty())
                 {
-                    PrototypeInstance protoInstance = protoInstanceStack.back().first;
-                    NodeID parentID = protoInstanceStack.back().second;
-                    protoInstanceStack.pop_back();
+                    InstanceRef protoInstance = instanceStack.back();
+                    instanceStack.pop_back();
+
+                    // Instances of point instancer prototypes that don't exist have already been reported.
+                    if (!protoInstance.pProtoPrim->IsValid()) continue;
 
                     // Add root node for this prototype instance, parented appropriately.
-                    NodeID rootNodeID = ctx.builder.addNode(makeNode(protoInstance.name, protoInstance.xform, float4x4::identity(), parentID));
+                    const std::string instanceName = protoInstance.pName ? *protoInstance.pName : std::string();
+                    NodeID rootNodeID = ctx.builder.addNode(makeNode(instanceName, protoInstance.xform, float4x4::identity(), protoInstance.parentID));
 
                     // If there are keyframes, create an animation from them targeting the root node we just created.
                     // This could be more cleanly addressed if a Falcor::Animation could target more than one node.
-                    if (protoInstance.keyframes.size() > 0)
+                    if (protoInstance.keyframeCount > 0)
                     {
-                        ref<Animation> pAnimation = Animation::create(protoInstance.name, rootNodeID, protoInstance.keyframes.back().time);
-                        for (const auto& keyframe : protoInstance.keyframes)
+                        const Animation::Keyframe* pKeyframes = protoInstance.pKeyframes;
+                        ref<Animation> pAnimation = Animation::create(*protoInstance.pAnimationName, rootNodeID, pKeyframes[protoInstance.keyframeCount - 1].time);
+                        for (size_t i = 0; i < protoInstance.keyframeCount; ++i)
                         {
-                            pAnimation->addKeyframe(keyframe);
+                            pAnimation->addKeyframe(pKeyframes[i]);
                         }
                         ctx.builder.addAnimation(pAnimation);
                     }
 
                     // Get a reference to the prototype
-                    if (!ctx.hasPrototype(protoInstance.protoPrim))
+                    if (!ctx.hasPrototype(*protoInstance.pProtoPrim))
                     {
-                        logError("Cannot create instance of '{}'; no prototype exists.", protoInstance.protoPrim.GetPath().GetString());
+                        logError("Cannot create instance of '{}'; no prototype exists.", protoInstance.pProtoPrim->GetPath().GetString());
                         continue;
                     }
 
-                    const PrototypeGeom& protoGeom = ctx.getPrototypeGeom(protoInstance.protoPrim);
+                    const PrototypeGeom& protoGeom = ctx.getPrototypeGeom(*protoInstance.pProtoPrim);
 
                     // Parent IDs of nodes in the PrototypeGeom are relative to the ID of the prototype's root, zero.
                     // Get the current builder node count, which will be the SceneBuilder node ID of the prototype root node.
@@ -1200,6 +1335,7 @@ namespace Falcor
                     for (const auto& node : protoGeom.nodes)
                     {
                         SceneBuilder::Node builderNode = node;
+                        if (!protoInstance.pName) builderNode.name.clear();
                         builderNode.parent = (node.parent == NodeID::Invalid()) ? rootNodeID : NodeID{ node.parent.get() + protoRootID.get() };
                         ctx.builder.addNode(builderNode);
                     }
@@ -1210,7 +1346,7 @@ namespace Falcor
                     {
                         // Use the name of the target node as the animation name. Note that this will result in multiple animations with the same name
                         // if the prototype is instantiated multiple times.
-                        std::string animationName = protoGeom.nodes[animation.targetNodeID.get()].name;
+                        const std::string& animationName = protoGeom.nodes[animation.targetNodeID.get()].name;
                         NodeID targetNodeID{ animation.targetNodeID.get() + protoRootID.get() };
                         ref<Animation> pAnimation = Animation::create(animationName, targetNodeID, animation.keyframes.back().time);
                         for (const auto& keyframe : animation.keyframes)
@@ -1223,14 +1359,15 @@ namespace Falcor
                     // Add all of the prototype's geom instances (currently limited to meshes)
                     for (const auto& inst : protoGeom.geomInstances)
                     {
-                        std::string instName = protoInstance.name + "/" + inst.name;
+                        std::string instName = protoInstance.pName ? *protoInstance.pName + "/" + inst.name : std::string();
+                        NodeID parentID{ inst.parentID.get() + protoRootID.get() };
                         if (inst.prim.IsA<UsdGeomMesh>())
                         {
-                            addSubmeshes(inst.prim, instName, inst.xform, float4x4::identity(), NodeID{ inst.parentID.get() + protoRootID.get() });
+                            addSubmeshes(inst.prim, instName, inst.xform, float4x4::identity(), parentID);
                         }
                         else if (inst.prim.IsA<UsdGeomBasisCurves>())
                         {
-                            auto nodeId = ctx.builder.addNode(makeNode(instName, inst.xform, float4x4::identity(), NodeID{ inst.parentID.get() + protoRootID.get() }));
+                            auto nodeId = ctx.builder.addNode(makeNode(instName, inst.xform, float4x4::identity(), parentID));
                             const auto& curve = ctx.getCurve(inst.prim);
 
                             if (curve.tessellationMode == CurveTessellationMode::LinearSweptSphere)
@@ -1244,16 +1381,33 @@ namespace Falcor
                         }
                         else
                         {
-                            logError("Instanced geometry '{}' is of an unsupported type.", instName);
+                            logError("Instanced geometry '{}' is of an unsupported type.", inst.name);
                         }
                     }
 
-                    // Push child prototype instances, and the current nodeID as the parent, onto the stack. Do so in reverse order to maintain traversal ordering.
+                    // Add child point instances and push child prototype instances, with the current nodeID as the parent, onto the stack.
+                    // Do so in reverse order to maintain traversal ordering.
+                    for (auto it = protoGeom.pointInstanceSets.rbegin(); it != protoGeom.pointInstanceSets.rend(); ++it)
+                    {
+                        addPointInstanceSet(*it, NodeID{ it->parentID.get() + protoRootID.get() });
+                    }
                     for (auto it = protoGeom.prototypeInstances.rbegin(); it != protoGeom.prototypeInstances.rend(); ++it)
                     {
-                        protoInstanceStack.push_back(std::make_pair(*it, NodeID{ it->parentID.get() + protoRootID.get() }));
+                        instanceStack.push_back(getPrototypeInstance(*it, NodeID{ it->parentID.get() + protoRootID.get() }));
                     }
                 }
+            };
+
+            for (const auto& instance : ctx.prototypeInstances)
+            {
+                instanceStack.push_back(getPrototypeInstance(instance, instance.parentID));
+                addInstances();
+            }
+
+            for (const auto& set : ctx.pointInstanceSets)
+            {
+                addPointInstanceSet(set, set.parentID);
+                addInstances();
             }
 
             timeReport.measure("Create instances");
@@ -1643,7 +1797,7 @@ namespace Falcor
         return true;
     }
 
-    bool ImporterContext::createPointInstanceKeyframes(const UsdGeomPointInstancer& instancer, std::vector<std::vector<Animation::Keyframe>>& keyframes)
+    bool ImporterContext::createPointInstanceKeyframes(const UsdGeomPointInstancer& instancer, std::vector<Animation::Keyframe>& keyframes, size_t& keyframesPerInstance)
     {
         logDebug("Creating PointInstancer keyframes for '{}'.", instancer.GetPath().GetString());
 
@@ -1672,27 +1826,29 @@ namespace Falcor
 
         // instXforms is a vector of length equal to the number of time codes.
         // Each element of the vector holds an array of size equal to the number of instances.
-        // We need to, in effect, transpose this layout when constructing the vector of Animations.
-        keyframes.resize(instXforms[0].size());
+        // We need to, in effect, transpose this layout so that the keyframes of each instance are consecutive.
         FALCOR_ASSERT(instXforms.size() == times.size());
+        const size_t instanceCount = instXforms[0].size();
+        keyframesPerInstance = times.size();
+        keyframes.resize(instanceCount * keyframesPerInstance);
 
         // For each time sample
         for (uint32_t i = 0; i < instXforms.size(); ++i)
         {
             const auto& matrices = instXforms[i];
             double time = times[i];
+            FALCOR_ASSERT(matrices.size() == instanceCount);
 
             // For each instance
-            for (uint32_t j = 0; j < matrices.size(); ++j)
+            for (size_t j = 0; j < instanceCount; ++j)
             {
                 const auto& matrix = matrices[j];
                 float4x4 glmMat = toFalcor(matrix);
-                Animation::Keyframe keyframe;
+                Animation::Keyframe& keyframe = keyframes[j * keyframesPerInstance + i];
                 float3 skew;
                 float4 persp;
                 math::decompose(glmMat, keyframe.scaling, keyframe.rotation, keyframe.translation, skew, persp);
                 keyframe.time = time / timeCodesPerSecond;
-                keyframes[j].push_back(keyframe);
             }
         }
 
@@ -2120,10 +2276,14 @@ namespace Falcor
 
         // We make use of the the same machinery used to create general instances, namely
         // traversal of a Prototype prim to create an underlying prototype, followed by adding instances.
+        // The instances themselves are stored compactly in a PointInstanceSet.
+        PointInstanceSet instanceSet;
+        instanceSet.name = primName;
+        instanceSet.parentID = proto ? proto->nodeStack.back() : nodeStack.back();
 
         // Prototypes prims are gathered during iteration over the prototype paths.  Most often, prototypes are
         // specified as children of the PointInstancer, but this isn't guaranteed.
-        std::vector<UsdPrim> protoPrims;
+        auto& protoPrims = instanceSet.protoPrims;
 
         for (auto path : prototypePaths)
         {
@@ -2133,6 +2293,8 @@ namespace Falcor
             if (!protoPrim.IsDefined())
             {
                 logError("Point instancer '{}' references nonexistent prim '{}'. Ignoring.", primName, path.GetString());
+                // Keep an invalid prim to preserve the indexing of the prototypes.
+                protoPrims.push_back(UsdPrim());
                 continue;
             }
 
@@ -2151,14 +2313,12 @@ namespace Falcor
             }
         }
 
-        std::vector<std::vector<Animation::Keyframe>> keyframes;
-        VtMatrix4dArray instXforms;
-
-        if (createPointInstanceKeyframes(instancer, keyframes))
+        if (createPointInstanceKeyframes(instancer, instanceSet.keyframes, instanceSet.keyframesPerInstance))
         {
-            if (protoIndices.size() != keyframes.size())
+            size_t keyframedCount = instanceSet.keyframes.size() / instanceSet.keyframesPerInstance;
+            if (protoIndices.size() != keyframedCount)
             {
-                logError("Point instancer '{}' has {} prototype indices but {} sampled transforms.", primName, protoIndices.size(), keyframes.size());
+                logError("Point instancer '{}' has {} prototype indices but {} sampled transforms.", primName, protoIndices.size(), keyframedCount);
                 return;
             }
         }
@@ -2166,6 +2326,7 @@ namespace Falcor
         {
             // Compute 4x4 transforms for each instance at the earliest time sample.
             // The prototype xform is included in its definition, so we exclude it in the computed instance xforms.
+            VtMatrix4dArray instXforms;
             if (!instancer.ComputeInstanceTransformsAtTime(&instXforms, UsdTimeCode::EarliestTime(), UsdTimeCode::EarliestTime(), UsdGeomPointInstancer::ProtoXformInclusion::ExcludeProtoXform))
             {
                 logError("Error occurred computing point instancer transforms for '{}'. Ignoring prim.", primName);
@@ -2176,33 +2337,32 @@ namespace Falcor
                 logError("Point instancer '{}' has {} prototype indices but {} transforms.", primName, protoIndices.size(), instXforms.size());
                 return;
             }
+            instanceSet.xforms.resize(instXforms.size());
+            for (size_t i = 0; i < instXforms.size(); ++i)
+            {
+                instanceSet.xforms[i] = toFalcor(instXforms[i]);
+            }
         }
 
-        // Create instances from the prototypes.
+        instanceSet.protoIndices.resize(protoIndices.size());
         for (size_t i = 0; i < protoIndices.size(); ++i)
         {
-            UsdPrim& protoPrim(protoPrims[protoIndices[i]]);
-            std::string instanceName(protoPrim.GetPath().GetString() + "_" + std::to_string(i));
-            PrototypeInstance protoInst = {instanceName, protoPrim};
-            if (keyframes.size() > 0)
+            int protoIndex = protoIndices[i];
+            if (protoIndex < 0 || (size_t)protoIndex >= protoPrims.size())
             {
-                protoInst.keyframes = std::move(keyframes[i]);
-            }
-            else
-            {
-                protoInst.xform = toFalcor(instXforms[i]);
+                logError("Point instancer '{}' has out of range prototype index {}. Ignoring prim.", primName, protoIndex);
+                return;
             }
+            instanceSet.protoIndices[i] = (uint32_t)protoIndex;
+        }
 
-            if (proto)
-            {
-                protoInst.parentID = proto->nodeStack.back();
-                proto->addPrototypeInstance(protoInst);
-            }
-            else
-            {
-                protoInst.parentID = nodeStack.back();
-                addPrototypeInstance(protoInst);
-            }
+        if (proto)
+        {
+            proto->pointInstanceSets.push_back(std::move(instanceSet));
+        }
+        else
+        {
+            pointInstanceSets.push_back(std::move(instanceSet));
         }
     }
 
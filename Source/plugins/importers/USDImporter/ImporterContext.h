@@ -87,6 +87,23 @@ namespace Falcor
         std::vector<Animation::Keyframe> keyframes;     ///< Keyframes for animated instance transformation, if any.
     };
 
+    /** Represents the instances created by a UsdGeomPointInstancer.
+        Point instancers commonly have millions of entries, so per-instance data is kept in flat
+        arrays instead of creating a named PrototypeInstance for each entry.
+    */
+    struct PointInstanceSet
+    {
+        std::string name;                               ///< Point instancer name, used for naming animations.
+        std::vector<UsdPrim> protoPrims;                ///< Prototype prims, indexed by protoIndices. Invalid for prototypes that don't exist.
+        NodeID parentID{ NodeID::kInvalidID };          ///< SceneBuilder parent node id.
+        std::vector<uint32_t> protoIndices;             ///< Prototype index per instance.
+        std::vector<float4x4> xforms;                   ///< Transformation per instance, if not animated.
+        std::vector<Animation::Keyframe> keyframes;     ///< Keyframes for animated instance transformations, keyframesPerInstance consecutive keyframes per instance.
+        size_t keyframesPerInstance = 0;                ///< Number of keyframes per instance, or zero if the transformations are not animated.
+
+        size_t getInstanceCount() const { return protoIndices.size(); }
+    };
+
     /** Mesh processing task parameters
     */
     struct MeshProcessingTask
@@ -148,6 +165,7 @@ namespace Falcor
         UsdPrim protoPrim;                                          ///< Prototype prim.
         std::vector<GeomInstance> geomInstances;                    ///< Geom instances making up the prototype.
         std::vector<PrototypeInstance> prototypeInstances;          ///< Prototype instances contained in the prototype.
+        std::vector<PointInstanceSet> pointInstanceSets;            ///< Point instancers contained in the prototype.
         std::vector<SceneBuilder::Node> nodes;                      ///< Prototype subgraph nodes.
         std::vector<AnimationKeyframes> animations;                 ///< Animations targeting subgraph nodes, if any.
         std::vector<NodeID> nodeStack;                              ///< Current node stack.
@@ -296,10 +314,10 @@ namespace Falcor
         // Create animation from time-sampled transforms on a prim, such as for rigid body animations.
         NodeID createAnimation(const UsdGeomXformable& xformable);
 
-        // Initialize a vector of keyframes, one for each instance in a point instancer.
+        // Initialize the keyframes of all instances in a point instancer. The keyframes of each instance are stored consecutively.
         // Returns false, and does not initialize keyframes, if the instance transforms are not animated.
         // Returns true otherwise.
-        bool createPointInstanceKeyframes(const UsdGeomPointInstancer& instancer, std::vector<std::vector<Animation::Keyframe>>& keyframes);
+        bool createPointInstanceKeyframes(const UsdGeomPointInstancer& instancer, std::vector<Animation::Keyframe>& keyframes, size_t& keyframesPerInstance);
 
         // Transforms
 
@@ -364,6 +382,7 @@ namespace Falcor
         std::vector<MeshProcessingTask> meshTasks;                                                   ///< List of mesh processing tasks (non time-sampled, and first time-samples)
         std::vector<MeshProcessingTask> meshKeyframeTasks;                                           ///< List of processing tasks for time-sampled mesh vertex data
         std::vector<PrototypeInstance> prototypeInstances;                                           ///< List of prototype instances.
+        std::vector<PointInstanceSet> pointInstanceSets;                                             ///< List of point instancers.
         std::unordered_map<UsdObject, size_t, UsdObjHash> geomMap;                                   ///< Map from prim to mesh.
         std::unordered_map<UsdObject, size_t, UsdObjHash> prototypeGeomMap;                          ///< Map from prim to prototype mesh.
         std::vector<Skeleton> skeletons;                                                             ///< List of skeletons. One per SkelRoot prim.